@@ -1,6 +1,10 @@
 #include <benchmark/benchmark.h>
 #include <cdfpp/chrono/cdf-chrono.hpp>
+#include <cdfpp/chrono/cdf-time-format.hpp>
+#include <cdfpp/chrono/cdf-time-parse.hpp>
+#include <algorithm>
 #include <cstring>
+#include <random>
 
 inline constexpr std::size_t mega(std::size_t n)
 {
@@ -165,4 +169,193 @@ BENCHMARK_CAPTURE(BM_to_ns_from_1970, epoch_entry_point,
     ->Complexity()
     ->UseRealTime();
 
+template <typename time_t, typename func_t>
+static void BM_to_ns_from_1970_shuffled(
+    benchmark::State& state, func_t func, time_t start, time_t end)
+{
+    auto time_vect = generate_sorted_time_vectors<time_t>(start, end, state.range(0));
+    std::shuffle(std::begin(time_vect), std::end(time_vect), std::mt19937_64 { 42 });
+    no_init_vector<int64_t> output(time_vect.size());
+    for (auto _ : state)
+    {
+        benchmark::ClobberMemory();
+        func(time_vect, output.data());
+        benchmark::DoNotOptimize(output);
+    }
+    state.counters["Epochs"] = std::size(time_vect);
+    state.counters["epochs_per_second"]
+        = benchmark::Counter(std::size(time_vect), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+using tt2000_to_ns_t = void (*)(const std::span<const cdf::tt2000_t>&, int64_t* const);
+using epoch16_to_ns_t = void (*)(const std::span<const cdf::epoch16>&, int64_t* const);
+
+// 1990 -> 2006, archive data where every value needs a leap second lookup
+#define CDFPP_BENCH_TT2000_PRE_2017(bench, name, func)                                            \
+    BENCHMARK_CAPTURE(bench, name, static_cast<tt2000_to_ns_t>(func),                              \
+        cdf::tt2000_t { -315575942816000000 }, cdf::tt2000_t { 189345665184000000 })               \
+        ->RangeMultiplier(4)                                                                     \
+        ->Range(10, mega(256))                                                                   \
+        ->Complexity()                                                                           \
+        ->UseRealTime();
+
+CDFPP_BENCH_TT2000_PRE_2017(
+    BM_to_ns_from_1970, tt2000_pre_2017_scalar, cdf::chrono::_impl::scalar_to_ns_from_1970)
+CDFPP_BENCH_TT2000_PRE_2017(BM_to_ns_from_1970, tt2000_pre_2017_vectorized,
+    vectorized_to_ns_from_1970)
+CDFPP_BENCH_TT2000_PRE_2017(BM_to_ns_from_1970_shuffled, tt2000_shuffled_scalar,
+    cdf::chrono::_impl::scalar_to_ns_from_1970)
+CDFPP_BENCH_TT2000_PRE_2017(BM_to_ns_from_1970_shuffled, tt2000_shuffled_vectorized,
+    vectorized_to_ns_from_1970)
+
+#define CDFPP_BENCH_EPOCH16(name, func)                                                           \
+    BENCHMARK_CAPTURE(BM_to_ns_from_1970, name, static_cast<epoch16_to_ns_t>(func),                \
+        cdf::epoch16 { 62167219200.0, 0. }, cdf::epoch16 { 63745052400.0, 0. })                  \
+        ->RangeMultiplier(4)                                                                     \
+        ->Range(10, mega(256))                                                                   \
+        ->Complexity()                                                                           \
+        ->UseRealTime();
+
+CDFPP_BENCH_EPOCH16(epoch16_scalar, cdf::chrono::_impl::scalar_to_ns_from_1970)
+CDFPP_BENCH_EPOCH16(epoch16_vectorized, vectorized_to_ns_from_1970)
+CDFPP_BENCH_EPOCH16(epoch16_entry_point, cdf::to_ns_from_1970)
+
+template <typename time_t, typename func_t>
+static void BM_from_ns_from_1970(benchmark::State& state, func_t func, int64_t start, int64_t end)
+{
+    const auto ns_vect = generate_sorted_time_vectors<int64_t>(start, end, state.range(0));
+    no_init_vector<time_t> output(ns_vect.size());
+    for (auto _ : state)
+    {
+        benchmark::ClobberMemory();
+        func(ns_vect, output.data());
+        benchmark::DoNotOptimize(output);
+    }
+    state.counters["Epochs"] = std::size(ns_vect);
+    state.counters["epochs_per_second"]
+        = benchmark::Counter(std::size(ns_vect), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// 1972 -> 2035, every batch before 2017 walks part of the leap seconds table
+#define CDFPP_BENCH_FROM_NS(name, time_t, func)                                                  \
+    BENCHMARK_CAPTURE(BM_from_ns_from_1970<time_t>, name,                                        \
+        static_cast<void (*)(const std::span<const int64_t>&, time_t* const)>(func),             \
+        63'072'000'000'000'000, 2'081'948'754'000'000'000)                                       \
+        ->RangeMultiplier(4)                                                                     \
+        ->Range(10, mega(256))                                                                   \
+        ->Complexity()                                                                           \
+        ->UseRealTime();
+
+CDFPP_BENCH_FROM_NS(tt2000_scalar, cdf::tt2000_t, cdf::chrono::_impl::scalar_from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(tt2000_vectorized, cdf::tt2000_t, vectorized_from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(tt2000_entry_point, cdf::tt2000_t, cdf::from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(epoch_scalar, cdf::epoch, cdf::chrono::_impl::scalar_from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(epoch_vectorized, cdf::epoch, vectorized_from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(epoch_entry_point, cdf::epoch, cdf::from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(epoch16_scalar, cdf::epoch16, cdf::chrono::_impl::scalar_from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(epoch16_vectorized, cdf::epoch16, vectorized_from_ns_from_1970)
+CDFPP_BENCH_FROM_NS(epoch16_entry_point, cdf::epoch16, cdf::from_ns_from_1970)
+
+template <typename output_t, typename input_t>
+static void BM_to_cdf_time(benchmark::State& state, input_t start, input_t end, bool element_wise)
+{
+    const auto time_vect = generate_sorted_time_vectors<input_t>(start, end, state.range(0));
+    no_init_vector<output_t> output(time_vect.size());
+    for (auto _ : state)
+    {
+        benchmark::ClobberMemory();
+        if (element_wise)
+            std::transform(std::cbegin(time_vect), std::cend(time_vect), std::begin(output),
+                [](const input_t& v) { return cdf::to_cdf_time<output_t>(v); });
+        else
+            cdf::to_cdf_time(std::span<const input_t> { time_vect }, output.data());
+        benchmark::DoNotOptimize(output);
+    }
+    state.counters["Epochs"] = std::size(time_vect);
+    state.counters["epochs_per_second"]
+        = benchmark::Counter(std::size(time_vect), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// 1970 -> 2020 epoch files re-encoded as TT2000 and the other way around
+#define CDFPP_BENCH_TO_CDF_TIME(name, output_t, start, end, element_wise)                        \
+    BENCHMARK_CAPTURE(BM_to_cdf_time<output_t>, name, start, end, element_wise)                  \
+        ->RangeMultiplier(4)                                                                     \
+        ->Range(10, mega(64))                                                                    \
+        ->Complexity()                                                                           \
+        ->UseRealTime();
+
+CDFPP_BENCH_TO_CDF_TIME(epoch_to_tt2000_element_wise, cdf::tt2000_t,
+    cdf::epoch { 62167219200000.0 }, cdf::epoch { 63745052400000.0 }, true)
+CDFPP_BENCH_TO_CDF_TIME(epoch_to_tt2000_bulk, cdf::tt2000_t, cdf::epoch { 62167219200000.0 },
+    cdf::epoch { 63745052400000.0 }, false)
+CDFPP_BENCH_TO_CDF_TIME(tt2000_to_epoch16_element_wise, cdf::epoch16,
+    cdf::tt2000_t { -946727967816000000 }, cdf::tt2000_t { 631108869184000000 }, true)
+CDFPP_BENCH_TO_CDF_TIME(tt2000_to_epoch16_bulk, cdf::epoch16,
+    cdf::tt2000_t { -946727967816000000 }, cdf::tt2000_t { 631108869184000000 }, false)
+
+template <typename time_t>
+static void BM_time_format(benchmark::State& state, time_t start, time_t end, const char* format)
+{
+    const auto time_vect = generate_sorted_time_vectors<time_t>(start, end, state.range(0));
+    const auto plan = cdf::chrono::time_format::compile<time_t>(format);
+    no_init_vector<char> output(std::size(time_vect) * plan.width());
+    for (auto _ : state)
+    {
+        benchmark::ClobberMemory();
+        cdf::chrono::time_format::format(
+            std::span<const time_t> { time_vect }, output.data(), plan);
+        benchmark::DoNotOptimize(output);
+    }
+    state.counters["Epochs"] = std::size(time_vect);
+    state.counters["epochs_per_second"]
+        = benchmark::Counter(std::size(time_vect), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_CAPTURE(BM_time_format, tt2000_iso, cdf::tt2000_t { -946727967816000000 },
+    cdf::tt2000_t { 631108869184000000 }, "%Y-%m-%dT%H:%M:%SZ")
+    ->RangeMultiplier(4)
+    ->Range(10, mega(16))
+    ->Complexity()
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_time_format, epoch_doy, cdf::epoch { 62167219200000.0 },
+    cdf::epoch { 63745052400000.0 }, "%Y-%j %H:%M:%S")
+    ->RangeMultiplier(4)
+    ->Range(10, mega(16))
+    ->Complexity()
+    ->UseRealTime();
+
+template <typename time_t>
+static void BM_parse_iso8601(benchmark::State& state, time_t)
+{
+    const auto time_vect = generate_sorted_time_vectors<cdf::tt2000_t>(
+        cdf::tt2000_t { -946727967816000000 }, cdf::tt2000_t { 631108869184000000 },
+        state.range(0));
+    const auto plan = cdf::chrono::time_format::compile<cdf::tt2000_t>("%Y-%m-%dT%H:%M:%SZ");
+    no_init_vector<char> input(std::size(time_vect) * plan.width());
+    cdf::chrono::time_format::format(
+        std::span<const cdf::tt2000_t> { time_vect }, input.data(), plan);
+    no_init_vector<time_t> output(std::size(time_vect));
+    for (auto _ : state)
+    {
+        benchmark::ClobberMemory();
+        cdf::chrono::time_parse::parse_iso8601(
+            input.data(), std::size(time_vect), plan.width(), output.data());
+        benchmark::DoNotOptimize(output);
+    }
+    state.counters["Epochs"] = std::size(time_vect);
+    state.counters["epochs_per_second"]
+        = benchmark::Counter(std::size(time_vect), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_CAPTURE(BM_parse_iso8601, tt2000, cdf::tt2000_t {})
+    ->RangeMultiplier(4)
+    ->Range(10, mega(16))
+    ->Complexity()
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_parse_iso8601, epoch16, cdf::epoch16 {})
+    ->RangeMultiplier(4)
+    ->Range(10, mega(16))
+    ->Complexity()
+    ->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -0,0 +1,234 @@
+#pragma once
+// Synthetic CDF files for benchmarks: every knob the loader has a separate code path for
+// (values type, codec, majority, encoding, how many VVRs a variable is split in) can be set
+// independently while the rest of the file stays the same.
+#include <cdfpp/cdf-io/endianness.hpp>
+#include <cdfpp/cdf-io/majority-swap.hpp>
+#include <cdfpp/cdf-io/saving/saving.hpp>
+#include <cdfpp/cdf.hpp>
+#include <cdfpp/no_init_vector.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <compare>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cdf::corpus
+{
+
+struct spec_t
+{
+    // data variables, all depending on one extra CDF_TIME_TT2000 "Epoch" variable
+    std::size_t variables = 8;
+    std::size_t records = 10000;
+    std::vector<uint32_t> record_shape = { 3 };
+    // cycled over variables, numeric types only
+    std::vector<CDF_Types> types = { CDF_Types::CDF_DOUBLE };
+    cdf_compression_type compression = cdf_compression_type::no_compression;
+    cdf_compression_type file_compression = cdf_compression_type::no_compression;
+    cdf_majority majority = cdf_majority::row;
+    cdf_encoding encoding = cdf_encoding::IBMPC;
+    // records per VVR/CVVR, 0 keeps the library defaults (see saving/create_records.hpp)
+    std::size_t records_per_fragment = 0;
+    // share of values set to 0, runs of zero bytes are what RLE compresses
+    double zero_fraction = 0.25;
+    uint32_t seed = 42;
+
+    // every field, so that specs can key caches of generated files
+    friend auto operator<=>(const spec_t&, const spec_t&) = default;
+};
+
+[[nodiscard]] inline std::string variable_name(std::size_t index)
+{
+    return fmt::format("var{:04}", index);
+}
+
+namespace _details
+{
+    template <typename T>
+    no_init_vector<T> make_values(
+        std::size_t count, std::size_t components, double zero_fraction, std::mt19937& rng)
+    {
+        // smooth per component signal with some noise: compresses like real data does
+        std::uniform_real_distribution<double> noise(-0.05, 0.05);
+        std::uniform_real_distribution<double> zero(0., 1.);
+        no_init_vector<T> values(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const auto record = static_cast<double>(i / components);
+            const auto component = static_cast<double>(i % components);
+            auto v = std::sin(record * 1e-3 + component) + noise(rng);
+            if (zero(rng) < zero_fraction)
+                v = 0.;
+            if constexpr (std::is_floating_point_v<T>)
+                values[i] = static_cast<T>(v * 100.);
+            else if constexpr (std::is_signed_v<T>)
+                values[i] = static_cast<T>(std::round(v * 100.));
+            else
+                values[i] = static_cast<T>(std::round(v * 50. + 60.));
+        }
+        return values;
+    }
+
+    inline data_t make_data(
+        CDF_Types type, std::size_t count, std::size_t components, const spec_t& spec,
+        std::mt19937& rng)
+    {
+        return cdf_type_dispatch(type,
+            [&]<CDF_Types t>() -> data_t
+            {
+                using value_t = from_cdf_type_t<t>;
+                if constexpr (std::is_arithmetic_v<value_t> and not is_cdf_string_type(t))
+                    return data_t {
+                        make_values<value_t>(count, components, spec.zero_fraction, rng), t };
+                else
+                    throw std::invalid_argument { fmt::format(
+                        "corpus: unsupported variable type {}", cdf_type_str(t)) };
+            });
+    }
+
+    // the file stores values with its majority and encoding, the saver writes them as is
+    inline void to_file_layout(data_t& data, const no_init_vector<uint32_t>& shape,
+        const spec_t& spec)
+    {
+        if (spec.majority == cdf_majority::column)
+        {
+            // swapping with the record dimensions reversed goes from row to column major
+            no_init_vector<uint32_t> reversed { shape[0] };
+            std::copy(std::crbegin(shape), std::crend(shape) - 1, std::back_inserter(reversed));
+            majority::swap(data, reversed);
+        }
+        if (endianness::is_big_endian_encoding(spec.encoding) != host_is_big_endian)
+        {
+            cdf_type_dispatch(data.type(),
+                [&]<CDF_Types t>()
+                {
+                    if constexpr (not is_cdf_string_type(t))
+                    {
+                        // byte swapping is its own inverse
+                        if constexpr (host_is_little_endian)
+                            endianness::decode_v<endianness::big_endian_t>(
+                                data.get<t>().data(), std::size(data.get<t>()));
+                        else
+                            endianness::decode_v<endianness::little_endian_t>(
+                                data.get<t>().data(), std::size(data.get<t>()));
+                    }
+                });
+        }
+    }
+
+    inline void fragment(io::saving_context& svg_ctx, std::size_t records_per_fragment)
+    {
+        for (auto& var_ctx : svg_ctx.body.variables)
+        {
+            const auto records = var_ctx.variable->len();
+            if (records == 0)
+                continue;
+            std::vector<record_range> ranges;
+            for (std::size_t first = 0; first < records; first += records_per_fragment)
+                ranges.push_back({ first, std::min(first + records_per_fragment, records) });
+            io::saving::store_values_records(var_ctx, ranges);
+        }
+    }
+
+    // with file_layout values are stored with the spec majority and encoding, the saver
+    // writes them as is
+    inline CDF build(const spec_t& spec, bool file_layout)
+    {
+        if (std::empty(spec.types))
+            throw std::invalid_argument { "corpus: no variable type given" };
+        std::mt19937 rng { spec.seed };
+        CDF cdf;
+        cdf.compression = spec.file_compression;
+        cdf.attributes.emplace("Generated_by",
+            Attribute { "Generated_by",
+                { data_t {
+                    no_init_vector<char> { 'C', 'D', 'F', 'p', 'p' }, CDF_Types::CDF_CHAR } } });
+
+        no_init_vector<tt2000_t> time(spec.records);
+        for (std::size_t i = 0; i < spec.records; i++)
+            time[i] = tt2000_t { 631108869184000000 + static_cast<int64_t>(i) * 1'000'000'000 };
+        data_t time_data { std::move(time), CDF_Types::CDF_TIME_TT2000 };
+        Variable::shape_t time_shape { static_cast<uint32_t>(spec.records) };
+        if (file_layout)
+            to_file_layout(time_data, time_shape, spec);
+        cdf.variables.emplace(
+            "Epoch", Variable { "Epoch", 0, std::move(time_data), std::move(time_shape) });
+
+        const auto components = std::accumulate(std::cbegin(spec.record_shape),
+            std::cend(spec.record_shape), std::size_t { 1 }, std::multiplies<std::size_t>());
+        for (std::size_t index = 0; index < spec.variables; index++)
+        {
+            const auto name = variable_name(index);
+            Variable::shape_t shape { static_cast<uint32_t>(spec.records) };
+            std::copy(std::cbegin(spec.record_shape), std::cend(spec.record_shape),
+                std::back_inserter(shape));
+            auto data = make_data(spec.types[index % std::size(spec.types)],
+                spec.records * components, components, spec, rng);
+            if (file_layout)
+                to_file_layout(data, shape, spec);
+            auto [it, _] = cdf.variables.emplace(name,
+                Variable { name, index + 1, std::move(data), std::move(shape), cdf_majority::row,
+                    false, spec.compression });
+            it->second.attributes.emplace("DEPEND_0",
+                VariableAttribute { "DEPEND_0",
+                    data_t {
+                        no_init_vector<char> { 'E', 'p', 'o', 'c', 'h' }, CDF_Types::CDF_CHAR } });
+        }
+        return cdf;
+    }
+}
+
+// Row major, native endianness CDF as the library hands it out after loading the file
+// generated from the same spec.
+[[nodiscard]] inline CDF make_cdf(const spec_t& spec)
+{
+    return _details::build(spec, false);
+}
+
+// Bytes of the file generated from spec, its majority, encoding and fragmentation applied.
+[[nodiscard]] inline no_init_vector<char> make_file(const spec_t& spec)
+{
+    using namespace io::saving;
+    const auto cdf = _details::build(spec, true);
+
+    // saving::prepare_records with the file layout knobs the saver has no setting for
+    auto svg_ctx = make_saving_context(cdf);
+    svg_ctx.body.cdr.record.Encoding = spec.encoding;
+    if (spec.majority == cdf_majority::column)
+        svg_ctx.body.cdr.record.Flags &= ~uint32_t { 1 };
+    create_file_attributes_records(cdf, svg_ctx);
+    create_variables_records(cdf, svg_ctx);
+    if (spec.records_per_fragment != 0)
+        _details::fragment(svg_ctx, spec.records_per_fragment);
+    const auto eof = map_records(svg_ctx);
+    link_records(svg_ctx);
+    update_gdr(svg_ctx, eof);
+    apply_compression(svg_ctx);
+
+    no_init_vector<char> bytes;
+    bytes.reserve(file_size(svg_ctx));
+    io::buffers::vector_writer writer { bytes };
+    write_records(svg_ctx, writer);
+    return bytes;
+}
+
+inline bool write_file(const spec_t& spec, const std::string& path)
+{
+    const auto bytes = make_file(spec);
+    std::ofstream os { path, std::ios::binary | std::ios::trunc };
+    os.write(bytes.data(), static_cast<std::streamsize>(std::size(bytes)));
+    return static_cast<bool>(os);
+}
+
+} // namespace cdf::corpus
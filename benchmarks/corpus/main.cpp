@@ -0,0 +1,153 @@
+// Writes a synthetic CDF file (see corpus.hpp), to benchmark or profile other tools on the
+// same files as benchmark-io:
+//   cdfpp-corpus out.cdf --variables 16 --records 100000 --shape 4x4 --types double,int4
+//                        --codec gzip --majority column --encoding network --fragment 1000
+#include "corpus.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+namespace
+{
+
+using namespace cdf;
+
+std::vector<std::string> split(const std::string& value, char separator)
+{
+    std::vector<std::string> items;
+    std::istringstream is { value };
+    for (std::string item; std::getline(is, item, separator);)
+        items.push_back(item);
+    return items;
+}
+
+CDF_Types parse_type(std::string name)
+{
+    std::transform(std::cbegin(name), std::cend(name), std::begin(name),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    if (not name.starts_with("CDF_"))
+        name = "CDF_" + name;
+    for (const auto type : { CDF_Types::CDF_INT1, CDF_Types::CDF_INT2, CDF_Types::CDF_INT4,
+             CDF_Types::CDF_INT8, CDF_Types::CDF_UINT1, CDF_Types::CDF_UINT2,
+             CDF_Types::CDF_UINT4, CDF_Types::CDF_BYTE, CDF_Types::CDF_REAL4,
+             CDF_Types::CDF_REAL8, CDF_Types::CDF_FLOAT, CDF_Types::CDF_DOUBLE })
+    {
+        if (cdf_type_str(type) == name)
+            return type;
+    }
+    throw std::invalid_argument { fmt::format("unknown or unsupported type: {}", name) };
+}
+
+cdf_compression_type parse_codec(const std::string& name)
+{
+    if (name == "none")
+        return cdf_compression_type::no_compression;
+    if (name == "rle")
+        return cdf_compression_type::rle_compression;
+    if (name == "gzip")
+        return cdf_compression_type::gzip_compression;
+#ifdef CDFPP_USE_ZSTD
+    if (name == "zstd")
+        return cdf_compression_type::zstd_compression;
+#endif
+    throw std::invalid_argument { fmt::format("unknown or unsupported codec: {}", name) };
+}
+
+cdf_majority parse_majority(const std::string& name)
+{
+    if (name == "row")
+        return cdf_majority::row;
+    if (name == "column")
+        return cdf_majority::column;
+    throw std::invalid_argument { fmt::format("unknown majority: {}", name) };
+}
+
+cdf_encoding parse_encoding(const std::string& name)
+{
+    if (name == "native")
+        return host_is_little_endian ? cdf_encoding::IBMPC : cdf_encoding::network;
+    if (name == "network")
+        return cdf_encoding::network;
+    if (name == "ibmpc")
+        return cdf_encoding::IBMPC;
+    throw std::invalid_argument { fmt::format("unknown encoding: {}", name) };
+}
+
+void usage()
+{
+    std::cerr << "usage: cdfpp-corpus <output.cdf> [--variables N] [--records N] [--shape AxB]\n"
+                 "       [--types double,float,int4,...] [--codec none|rle|gzip|zstd]\n"
+                 "       [--file-codec none|rle|gzip|zstd] [--majority row|column]\n"
+                 "       [--encoding native|network|ibmpc] [--fragment records_per_vvr]\n"
+                 "       [--zeros fraction] [--seed N]\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 or std::string_view { argv[1] }.starts_with("-"))
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+    const std::string output = argv[1];
+    corpus::spec_t spec;
+    try
+    {
+        for (int i = 2; i < argc; i += 2)
+        {
+            const std::string_view option = argv[i];
+            if (i + 1 >= argc)
+                throw std::invalid_argument { fmt::format("missing value for {}", option) };
+            const std::string value = argv[i + 1];
+            if (option == "--variables")
+                spec.variables = std::stoul(value);
+            else if (option == "--records")
+                spec.records = std::stoul(value);
+            else if (option == "--shape")
+            {
+                spec.record_shape.clear();
+                for (const auto& dim : split(value, 'x'))
+                    spec.record_shape.push_back(static_cast<uint32_t>(std::stoul(dim)));
+            }
+            else if (option == "--types")
+            {
+                spec.types.clear();
+                for (const auto& type : split(value, ','))
+                    spec.types.push_back(parse_type(type));
+            }
+            else if (option == "--codec")
+                spec.compression = parse_codec(value);
+            else if (option == "--file-codec")
+                spec.file_compression = parse_codec(value);
+            else if (option == "--majority")
+                spec.majority = parse_majority(value);
+            else if (option == "--encoding")
+                spec.encoding = parse_encoding(value);
+            else if (option == "--fragment")
+                spec.records_per_fragment = std::stoul(value);
+            else if (option == "--zeros")
+                spec.zero_fraction = std::stod(value);
+            else if (option == "--seed")
+                spec.seed = static_cast<uint32_t>(std::stoul(value));
+            else
+                throw std::invalid_argument { fmt::format("unknown option {}", option) };
+        }
+        if (not corpus::write_file(spec, output))
+        {
+            std::cerr << "failed to write " << output << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        usage();
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
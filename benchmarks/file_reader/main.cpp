@@ -1,4 +1,5 @@
 #include <benchmark/benchmark.h>
+#include <cdfpp/cdf-io/cdf-io.hpp>
 #include <cdfpp/no_init_vector.hpp>
 #include <cstring>
 #include <errno.h>
@@ -237,4 +238,140 @@ BENCHMARK(BM_raw_read<no_init_vector<char>>)
     ->Range(mega(4), mega(64))
     ->Complexity();
 
+auto make_test_cdf(std::size_t size)
+{
+    auto path = std::filesystem::temp_directory_path()
+        / std::filesystem::path { "pycdfpp_benchmark_" + std::to_string(size) + ".cdf" };
+    if (not std::filesystem::exists(path))
+    {
+        cdf::CDF cd;
+        const auto records = static_cast<uint32_t>(size / (3 * sizeof(double)));
+        no_init_vector<double> values(records * 3UL);
+        for (auto i = 0UL; i < std::size(values); i++)
+            values[i] = static_cast<double>(i);
+        cd.variables["var"] = cdf::Variable { "var", 0,
+            cdf::data_t { std::move(values), cdf::CDF_Types::CDF_DOUBLE }, { records, 3 } };
+        cdf::io::save(cd, path.string());
+    }
+    return path;
+}
+
+// evicts the file from the page cache so the next read really hits the storage
+void drop_file_cache(const std::filesystem::path& path)
+{
+    if (auto fd = open(path.c_str(), O_RDONLY); fd != -1)
+    {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+template <cdf::io::file_access access, bool cold_cache>
+static void BM_cdf_load(benchmark::State& state)
+{
+    auto test_file = make_test_cdf(state.range(0));
+    auto size = std::filesystem::file_size(test_file);
+    for (auto _ : state)
+    {
+        if constexpr (cold_cache)
+        {
+            state.PauseTiming();
+            drop_file_cache(test_file);
+            state.ResumeTiming();
+        }
+        auto cd = cdf::io::load(test_file.string(), access, false, false);
+        benchmark::DoNotOptimize(cd);
+    }
+    state.counters["Bytes"] = size;
+    state.counters["Read Speed"] = benchmark::Counter(
+        size, benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::OneK::kIs1024);
+}
+BENCHMARK(BM_cdf_load<cdf::io::file_access::memory_map, true>)
+    ->Name("io::load mmap (cold cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+BENCHMARK(BM_cdf_load<cdf::io::file_access::async_reads, true>)
+    ->Name("io::load async reads (cold cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+BENCHMARK(BM_cdf_load<cdf::io::file_access::memory_map, false>)
+    ->Name("io::load mmap (warm cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+BENCHMARK(BM_cdf_load<cdf::io::file_access::async_reads, false>)
+    ->Name("io::load async reads (warm cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+
+template <bool access_hints>
+static void BM_cdf_cold_load_mmap_hints(benchmark::State& state)
+{
+    auto test_file = make_test_cdf(state.range(0));
+    auto size = std::filesystem::file_size(test_file);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        drop_file_cache(test_file);
+        state.ResumeTiming();
+        auto cd = cdf::io::load(test_file.string(),
+            access_hints ? cdf::io::file_access::memory_map
+                         : cdf::io::file_access::memory_map_without_hints,
+            false, false);
+        benchmark::DoNotOptimize(cd);
+    }
+    state.counters["Bytes"] = size;
+    state.counters["Read Speed"] = benchmark::Counter(
+        size, benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::OneK::kIs1024);
+}
+BENCHMARK(BM_cdf_cold_load_mmap_hints<false>)
+    ->Name("io::load mmap without access hints (cold cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+BENCHMARK(BM_cdf_cold_load_mmap_hints<true>)
+    ->Name("io::load mmap with access hints (cold cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+
+// lazy load then only read the last tenth of the records
+template <bool access_hints>
+static void BM_cdf_cold_partial_read(benchmark::State& state)
+{
+    auto test_file = make_test_cdf(state.range(0));
+    std::size_t bytes = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        drop_file_cache(test_file);
+        state.ResumeTiming();
+        auto cd = cdf::io::load(test_file.string(),
+            access_hints ? cdf::io::file_access::memory_map
+                         : cdf::io::file_access::memory_map_without_hints,
+            false, true);
+        const auto& var = (*cd)["var"];
+        no_init_vector<std::byte> out(var.bytes() / 10 + var.record_bytes());
+        bytes = var.read_into(out, { var.len() - var.len() / 10 }) * var.record_bytes();
+        benchmark::DoNotOptimize(out);
+    }
+    state.counters["Bytes"] = bytes;
+    state.counters["Read Speed"] = benchmark::Counter(
+        bytes, benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::OneK::kIs1024);
+}
+BENCHMARK(BM_cdf_cold_partial_read<false>)
+    ->Name("lazy partial read mmap without access hints (cold cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+BENCHMARK(BM_cdf_cold_partial_read<true>)
+    ->Name("lazy partial read mmap with access hints (cold cache)")
+    ->RangeMultiplier(4)
+    ->Range(mega(4), mega(256))
+    ->Complexity();
+
 BENCHMARK_MAIN();
@@ -0,0 +1,298 @@
+#include "../corpus/corpus.hpp"
+#include <benchmark/benchmark.h>
+#include <cdfpp/cdf-io/cdf-io.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <new>
+
+// End to end load and save benchmarks on files from the synthetic corpus (corpus.hpp).
+// Every benchmark reports the bytes it processes per second and the heap allocations
+// (count and bytes) it makes per iteration. Values buffers (no_init_vector) come straight
+// from malloc/posix_memalign, so allocations are counted there on glibc, only through
+// operator new elsewhere.
+
+namespace
+{
+std::atomic<std::size_t> allocations_count { 0 };
+std::atomic<std::size_t> allocated_bytes { 0 };
+
+void count_allocation(std::size_t size) noexcept
+{
+    allocations_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+}
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t count, std::size_t size);
+    void* __libc_realloc(void* ptr, std::size_t size);
+    void* __libc_memalign(std::size_t alignment, std::size_t size);
+
+    void* malloc(std::size_t size) noexcept
+    {
+        count_allocation(size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) noexcept
+    {
+        count_allocation(count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, std::size_t size) noexcept
+    {
+        count_allocation(size);
+        return __libc_realloc(ptr, size);
+    }
+
+    int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) noexcept
+    {
+        count_allocation(size);
+        *ptr = __libc_memalign(alignment, size);
+        return *ptr != nullptr ? 0 : ENOMEM;
+    }
+}
+#else
+void* operator new(std::size_t size)
+{
+    count_allocation(size);
+    if (void* ptr = std::malloc(size != 0 ? size : 1))
+        return ptr;
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+namespace
+{
+
+using namespace cdf;
+
+struct allocations_counter
+{
+    std::size_t count = allocations_count.load();
+    std::size_t bytes = allocated_bytes.load();
+
+    void report(benchmark::State& state) const
+    {
+        state.counters["allocs"]
+            = benchmark::Counter(static_cast<double>(allocations_count.load() - count),
+                benchmark::Counter::kAvgIterations);
+        state.counters["alloc_bytes"]
+            = benchmark::Counter(static_cast<double>(allocated_bytes.load() - bytes),
+                benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1024);
+    }
+};
+
+void report_throughput(benchmark::State& state, std::size_t bytes)
+{
+    state.counters["bytes_per_second"] = benchmark::Counter(static_cast<double>(bytes),
+        benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::OneK::kIs1024);
+}
+
+// 8 variables of 20k records of 4x4 doubles (~20MB), each benchmark changes one knob
+corpus::spec_t base_spec()
+{
+    corpus::spec_t spec;
+    spec.variables = 8;
+    spec.records = 20000;
+    spec.record_shape = { 4, 4 };
+    return spec;
+}
+
+cdf_compression_type codec(int64_t index)
+{
+    switch (index)
+    {
+        case 1:
+            return cdf_compression_type::rle_compression;
+        case 2:
+            return cdf_compression_type::gzip_compression;
+#ifdef CDFPP_USE_ZSTD
+        case 3:
+            return cdf_compression_type::zstd_compression;
+#endif
+        default:
+            break;
+    }
+    return cdf_compression_type::no_compression;
+}
+
+void codec_args(benchmark::internal::Benchmark* bench)
+{
+#ifdef CDFPP_USE_ZSTD
+    bench->DenseRange(0, 3);
+#else
+    bench->DenseRange(0, 2);
+#endif
+    bench->ArgName("codec");
+}
+
+// Generated once per spec in the temporary directory, removed when the run ends.
+struct corpus_files : std::map<corpus::spec_t, std::string>
+{
+    ~corpus_files()
+    {
+        std::error_code ec;
+        for (const auto& [_, path] : *this)
+            std::filesystem::remove(path, ec);
+    }
+};
+
+const std::string& corpus_file(const corpus::spec_t& spec)
+{
+    static corpus_files files;
+    if (auto it = files.find(spec); it != std::end(files))
+        return it->second;
+    const auto path = std::filesystem::temp_directory_path()
+        / fmt::format("cdfpp_benchmark_{}.cdf", std::size(files));
+    if (not corpus::write_file(spec, path.string()))
+        throw std::runtime_error { fmt::format("failed to write {}", path.string()) };
+    return files.emplace(spec, path.string()).first->second;
+}
+
+std::size_t values_bytes(const CDF& cdf)
+{
+    std::size_t bytes = 0;
+    for (const auto& [_, variable] : cdf.variables)
+        bytes += variable.bytes();
+    return bytes;
+}
+
+// Opening latency: descriptor records only when lazy, every value decoded otherwise.
+void BM_open(benchmark::State& state)
+{
+    const bool lazy = state.range(0) != 0;
+    auto spec = base_spec();
+    spec.variables = static_cast<std::size_t>(state.range(1));
+    const auto& path = corpus_file(spec);
+    const allocations_counter allocations;
+    for (auto _ : state)
+    {
+        auto cdf = io::load(path, true, lazy);
+        if (not lazy)
+            benchmark::DoNotOptimize(cdf->variables.begin()->second.bytes_ptr());
+        benchmark::DoNotOptimize(cdf);
+    }
+    allocations.report(state);
+    report_throughput(state, std::filesystem::file_size(path));
+}
+BENCHMARK(BM_open)
+    ->ArgsProduct({ { 1, 0 }, { 8, 64 } })
+    ->ArgNames({ "lazy", "variables" })
+    ->Unit(benchmark::kMillisecond);
+
+// Decoding one variable of a lazily opened file, throughput in decoded bytes.
+void BM_decode_variable(benchmark::State& state)
+{
+    auto spec = base_spec();
+    spec.compression = codec(state.range(0));
+    auto cdf = io::load(corpus_file(spec), true, true);
+    const auto& lazy_variable = (*cdf)[corpus::variable_name(0)];
+    std::size_t bytes = 0;
+    const allocations_counter allocations;
+    for (auto _ : state)
+    {
+        // copies of a lazy variable share its loader but decode on their own
+        Variable variable = lazy_variable;
+        variable.load_values();
+        bytes = variable.bytes();
+        benchmark::DoNotOptimize(variable.bytes_ptr());
+    }
+    allocations.report(state);
+    report_throughput(state, bytes);
+}
+BENCHMARK(BM_decode_variable)->Apply(codec_args)->Unit(benchmark::kMillisecond);
+
+// Whole file loads through the paths the file layout selects: majority swap, byte swap of
+// big endian encodings, many small VVRs and whole file compression.
+void load_all(benchmark::State& state, const corpus::spec_t& spec)
+{
+    const auto& path = corpus_file(spec);
+    std::size_t bytes = 0;
+    const allocations_counter allocations;
+    for (auto _ : state)
+    {
+        auto cdf = io::load(path, true, false);
+        bytes = values_bytes(*cdf);
+        benchmark::DoNotOptimize(cdf);
+    }
+    allocations.report(state);
+    report_throughput(state, bytes);
+}
+
+void BM_load_majority(benchmark::State& state)
+{
+    auto spec = base_spec();
+    spec.majority = state.range(0) ? cdf_majority::column : cdf_majority::row;
+    load_all(state, spec);
+}
+BENCHMARK(BM_load_majority)->DenseRange(0, 1)->ArgName("column")->Unit(benchmark::kMillisecond);
+
+void BM_load_encoding(benchmark::State& state)
+{
+    auto spec = base_spec();
+    spec.encoding = state.range(0) ? cdf_encoding::network : cdf_encoding::IBMPC;
+    load_all(state, spec);
+}
+BENCHMARK(BM_load_encoding)->DenseRange(0, 1)->ArgName("network")->Unit(benchmark::kMillisecond);
+
+void BM_load_fragmented(benchmark::State& state)
+{
+    auto spec = base_spec();
+    spec.records_per_fragment = static_cast<std::size_t>(state.range(0));
+    load_all(state, spec);
+}
+BENCHMARK(BM_load_fragmented)
+    ->Arg(0)
+    ->Arg(10000)
+    ->Arg(1000)
+    ->Arg(100)
+    ->ArgName("records_per_vvr")
+    ->Unit(benchmark::kMillisecond);
+
+void BM_load_file_compressed(benchmark::State& state)
+{
+    auto spec = base_spec();
+    spec.file_compression = codec(state.range(0));
+    load_all(state, spec);
+}
+BENCHMARK(BM_load_file_compressed)->Apply(codec_args)->Unit(benchmark::kMillisecond);
+
+// Saving into memory, throughput in values bytes.
+void BM_save(benchmark::State& state)
+{
+    auto spec = base_spec();
+    spec.compression = codec(state.range(0));
+    const auto cdf = corpus::make_cdf(spec);
+    const allocations_counter allocations;
+    for (auto _ : state)
+    {
+        auto bytes = io::save(cdf);
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    allocations.report(state);
+    report_throughput(state, values_bytes(cdf));
+}
+BENCHMARK(BM_save)->Apply(codec_args)->Unit(benchmark::kMillisecond);
+
+}
+
+BENCHMARK_MAIN();
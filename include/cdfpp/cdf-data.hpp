@@ -117,11 +117,30 @@ private:
     CDF_Types p_type;
 };
 
+/*
+ * State kept by a caller reading consecutive record ranges of a lazy variable (see
+ * record_chunks): the last CVVR it inflated, so that a block spanning several ranges is only
+ * decompressed once, and how many records following each range to announce to the file
+ * buffer so that their reads start while the caller processes the current ones.
+ */
+struct records_cursor
+{
+    std::size_t readahead = 0;
+    std::size_t block_offset = static_cast<std::size_t>(-1);
+    no_init_vector<char> block;
+};
+
 struct lazy_data
 {
+    // Decodes records [first_record, first_record + records_count) straight into dest
+    // (file majority, native endianness), without materializing the whole variable.
+    // cursor may be null.
+    using records_reader_t = std::function<void(char* dest, std::size_t first_record,
+        std::size_t records_count, records_cursor* cursor)>;
+
     lazy_data() = default;
-    lazy_data(std::function<data_t(void)>&& loader, CDF_Types type)
-            : p_loader { std::move(loader) }, p_type { type }
+    lazy_data(std::function<data_t(void)>&& loader, CDF_Types type, records_reader_t&& reader = {})
+            : p_loader { std::move(loader) }, p_reader { std::move(reader) }, p_type { type }
     {
     }
     lazy_data(const lazy_data&) = default;
@@ -131,10 +150,21 @@ struct lazy_data
 
     [[nodiscard]] inline data_t load() { return p_loader(); }
 
+    [[nodiscard]] inline bool can_read_records() const noexcept
+    {
+        return static_cast<bool>(p_reader);
+    }
+    inline void read_records(char* dest, std::size_t first_record, std::size_t records_count,
+        records_cursor* cursor = nullptr) const
+    {
+        p_reader(dest, first_record, records_count, cursor);
+    }
+
     [[nodiscard]] inline CDF_Types type() const noexcept { return p_type; }
 
 private:
     std::function<data_t(void)> p_loader;
+    records_reader_t p_reader;
     CDF_Types p_type;
 };
 
@@ -0,0 +1,380 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "cdf-enums.hpp"
+#include "cdf-parallel.hpp"
+#include "chrono/cdf-chrono.hpp"
+#include "no_init_vector.hpp"
+#include "variable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+/*
+ * Min/max decimation for plotting: records are split in time buckets (usually one per
+ * pixel column) and each bucket is reduced to the min, max, first and last valid values of
+ * every component, so that a plot of the result looks like a plot of the full resolution data.
+ * Fill values and NaNs are skipped, empty buckets are NaN.
+ * Time axes are expected sorted, as any DEPEND_0 is, bucket bounds are then found with a
+ * binary search and each bucket is a contiguous range of records reduced in a single pass.
+ */
+namespace cdf::decimation
+{
+
+struct minmax_t
+{
+    std::size_t buckets = 0;
+    std::size_t components = 0;
+    // [bucket][component]
+    no_init_vector<double> min;
+    no_init_vector<double> max;
+    no_init_vector<double> first;
+    no_init_vector<double> last;
+};
+
+namespace _details
+{
+    inline constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+    template <typename time_t>
+    constexpr bool time_less(const time_t& left, const time_t& right)
+    {
+        if constexpr (std::is_same_v<time_t, epoch16>)
+            return left.seconds < right.seconds
+                || (left.seconds == right.seconds && left.picoseconds < right.picoseconds);
+        else if constexpr (std::is_same_v<time_t, epoch>)
+            return left.mseconds < right.mseconds;
+        else if constexpr (std::is_same_v<time_t, tt2000_t>)
+            return left.nseconds < right.nseconds;
+        else
+            return left < right;
+    }
+
+    // NaN never compares equal, so a missing fill value is a NaN fill value.
+    struct validity_t
+    {
+        double fill;
+        bool operator()(double value) const { return value == value && value != fill; }
+    };
+
+    // The fill value as stored in a value_t, a double -1e31 FILLVAL must match float -1e31 values.
+    template <typename value_t>
+    double as_fill(double fill)
+    {
+        if constexpr (std::is_integral_v<value_t>)
+        {
+            if (not(fill >= static_cast<double>(std::numeric_limits<value_t>::lowest())
+                    && fill < static_cast<double>(std::numeric_limits<value_t>::max()) + 1.))
+                return nan;
+        }
+        return static_cast<double>(static_cast<value_t>(fill));
+    }
+
+    template <typename value_t>
+    void reduce_one(const value_t* values, std::size_t size, validity_t valid, double* min,
+        double* max, double* first, double* last)
+    {
+        std::size_t head = 0;
+        while (head < size && not valid(static_cast<double>(values[head])))
+            ++head;
+        if (head == size)
+        {
+            *min = *max = *first = *last = nan;
+            return;
+        }
+        std::size_t tail = size - 1;
+        while (not valid(static_cast<double>(values[tail])))
+            --tail;
+        // branchless so that it vectorizes
+        double lo = static_cast<double>(values[head]);
+        double hi = lo;
+        for (std::size_t i = head + 1; i <= tail; ++i)
+        {
+            const auto value = static_cast<double>(values[i]);
+            const bool ok = valid(value);
+            lo = ok && value < lo ? value : lo;
+            hi = ok && value > hi ? value : hi;
+        }
+        *min = lo;
+        *max = hi;
+        const auto last_value = static_cast<double>(values[tail]);
+        *first = static_cast<double>(values[head]);
+        *last = last_value;
+    }
+
+    template <typename value_t>
+    void reduce_many(const value_t* values, std::size_t records, std::size_t components,
+        validity_t valid, double* min, double* max, double* first, double* last)
+    {
+        std::fill_n(min, components, std::numeric_limits<double>::infinity());
+        std::fill_n(max, components, -std::numeric_limits<double>::infinity());
+        std::fill_n(first, components, nan);
+        std::fill_n(last, components, nan);
+        for (std::size_t record = 0; record < records; ++record)
+        {
+            const value_t* row = values + record * components;
+            for (std::size_t component = 0; component < components; ++component)
+            {
+                const auto value = static_cast<double>(row[component]);
+                const bool ok = valid(value);
+                min[component] = ok && value < min[component] ? value : min[component];
+                max[component] = ok && value > max[component] ? value : max[component];
+                first[component]
+                    = ok && first[component] != first[component] ? value : first[component];
+                last[component] = ok ? value : last[component];
+            }
+        }
+        for (std::size_t component = 0; component < components; ++component)
+        {
+            if (first[component] != first[component])
+                min[component] = max[component] = nan;
+        }
+    }
+
+    template <typename value_t>
+    inline constexpr bool is_decimable_v
+        = std::is_arithmetic_v<value_t> && not std::is_same_v<value_t, char>;
+
+    // calls f with the values of a numeric variable, or not_numeric()
+    template <typename function_t, typename fallback_t>
+    auto visit_numeric(const Variable& variable, function_t&& f, fallback_t&& not_numeric)
+    {
+        using enum cdf::CDF_Types;
+        switch (variable.type())
+        {
+            case CDF_INT1:
+            case CDF_BYTE:
+                return f(variable.get<int8_t>());
+            case CDF_UINT1:
+                return f(variable.get<uint8_t>());
+            case CDF_INT2:
+                return f(variable.get<int16_t>());
+            case CDF_UINT2:
+                return f(variable.get<uint16_t>());
+            case CDF_INT4:
+                return f(variable.get<int32_t>());
+            case CDF_UINT4:
+                return f(variable.get<uint32_t>());
+            case CDF_INT8:
+                return f(variable.get<int64_t>());
+            case CDF_FLOAT:
+            case CDF_REAL4:
+                return f(variable.get<float>());
+            case CDF_DOUBLE:
+            case CDF_REAL8:
+                return f(variable.get<double>());
+            default:
+                return not_numeric();
+        }
+    }
+}
+
+/*
+ * Reduces values (records x components, row major) bucket by bucket, bucket i holding the
+ * records whose time t verifies edges[i] <= t < edges[i + 1].
+ */
+template <typename value_t, typename time_t>
+[[nodiscard]] minmax_t minmax(std::span<const value_t> values, std::size_t components,
+    std::span<const time_t> time, std::span<const time_t> edges,
+    std::optional<double> fill = std::nullopt)
+{
+    if (components == 0 || std::size(values) != std::size(time) * components)
+        throw std::invalid_argument(fmt::format(
+            "minmax: {} values can't be split in {} records of {} components", std::size(values),
+            std::size(time), components));
+    minmax_t result;
+    result.buckets = std::size(edges) < 2 ? 0 : std::size(edges) - 1;
+    result.components = components;
+    const auto size = result.buckets * components;
+    result.min.resize(size);
+    result.max.resize(size);
+    result.first.resize(size);
+    result.last.resize(size);
+
+    std::vector<std::size_t> bounds(std::size(edges));
+    std::transform(std::cbegin(edges), std::cend(edges), std::begin(bounds),
+        [&time](const time_t& edge)
+        {
+            return static_cast<std::size_t>(
+                std::lower_bound(std::cbegin(time), std::cend(time), edge,
+                    _details::time_less<time_t>)
+                - std::cbegin(time));
+        });
+
+    const _details::validity_t valid { fill ? _details::as_fill<value_t>(*fill) : _details::nan };
+    // a chunk of buckets is worth a thread once it holds about min_chunk_size() values
+    const auto min_chunk = std::max(std::size_t { 1 },
+        parallel::min_chunk_size() * result.buckets
+            / std::max(std::size(values), std::size_t { 1 }));
+    parallel::parallel_chunks(result.buckets, min_chunk,
+        [&](std::size_t first_bucket, std::size_t count)
+        {
+            for (std::size_t bucket = first_bucket; bucket < first_bucket + count; ++bucket)
+            {
+                const auto first_record = bounds[bucket];
+                const auto records = bounds[bucket + 1] - first_record;
+                const auto offset = bucket * components;
+                const value_t* data = std::data(values) + first_record * components;
+                if (components == 1)
+                    _details::reduce_one(data, records, valid, result.min.data() + offset,
+                        result.max.data() + offset, result.first.data() + offset,
+                        result.last.data() + offset);
+                else
+                    _details::reduce_many(data, records, components, valid,
+                        result.min.data() + offset, result.max.data() + offset,
+                        result.first.data() + offset, result.last.data() + offset);
+            }
+        });
+    return result;
+}
+
+// buckets + 1 evenly spaced edges splitting [start, stop).
+[[nodiscard]] inline std::vector<int64_t> uniform_edges(
+    int64_t start, int64_t stop, std::size_t buckets)
+{
+    if (stop <= start || buckets == 0)
+        throw std::invalid_argument(fmt::format(
+            "minmax: can't split [{}, {}) in {} buckets", start, stop, buckets));
+    std::vector<int64_t> edges(buckets + 1);
+    // unsigned arithmetic, the full int64 range doesn't fit in an int64
+    const auto origin = static_cast<uint64_t>(start);
+    const auto span = static_cast<uint64_t>(stop) - origin;
+    const auto step = span / buckets, remainder = span % buckets;
+    for (std::size_t i = 0; i <= buckets; ++i)
+        edges[i] = static_cast<int64_t>(origin + step * i + remainder * i / buckets);
+    return edges;
+}
+
+// [first, last + 1ns) of a sorted CDF time variable, in ns since 1970 UTC.
+[[nodiscard]] inline std::pair<int64_t, int64_t> time_span(const Variable& time)
+{
+    using enum cdf::CDF_Types;
+    if (time.len() == 0)
+        throw std::invalid_argument(fmt::format("minmax: time axis {} is empty", time.name()));
+    const auto span_of = []<typename time_t>(const no_init_vector<time_t>& values)
+    {
+        const std::array bounds { values.front(), values.back() };
+        std::array<int64_t, 2> ns;
+        chrono::_impl::_to_ns_from_1970(std::span<const time_t> { bounds }, ns.data());
+        return std::pair { ns[0], ns[1] + 1 };
+    };
+    switch (time.type())
+    {
+        case CDF_EPOCH:
+            return span_of(time.get<epoch>());
+        case CDF_EPOCH16:
+            return span_of(time.get<epoch16>());
+        case CDF_TIME_TT2000:
+            return span_of(time.get<tt2000_t>());
+        default:
+            throw std::invalid_argument(fmt::format(
+                "minmax: time axis {} must be a CDF time variable (CDF_EPOCH, CDF_EPOCH16, or "
+                "CDF_TIME_TT2000), got {}",
+                time.name(), cdf_type_str(time.type())));
+    }
+}
+
+/*
+ * Reduces a variable against its time axis (usually its DEPEND_0, a CDF time variable with as
+ * many records) in buckets evenly splitting [start, stop), given in ns since 1970 UTC.
+ * The variable FILLVAL attribute, if any, gives the values to skip.
+ */
+[[nodiscard]] inline minmax_t minmax(const Variable& values, const Variable& time,
+    std::size_t buckets, int64_t start, int64_t stop)
+{
+    using enum cdf::CDF_Types;
+    if (values.len() != time.len())
+        throw std::invalid_argument(
+            fmt::format("minmax: {} has {} records but its time axis {} has {}", values.name(),
+                values.len(), time.name(), time.len()));
+    const auto edges_ns = uniform_edges(start, stop, buckets);
+    const std::size_t records = values.len();
+    const std::size_t components
+        = records == 0 ? 1 : std::max(flat_size(values.shape()) / records, std::size_t { 1 });
+
+    std::optional<double> fill;
+    if (auto it = values.attributes.find("FILLVAL"); it != std::cend(values.attributes))
+    {
+        visit(
+            it->second.value(),
+            [&fill]<typename T>(const no_init_vector<T>& fill_values)
+            {
+                if constexpr (_details::is_decimable_v<T>)
+                {
+                    if (not fill_values.empty())
+                        fill = static_cast<double>(fill_values.front());
+                }
+            },
+            [](const auto&) {});
+    }
+
+    const auto with_time = [&]<typename time_t>(const no_init_vector<time_t>& time_values)
+    {
+        std::vector<time_t> edges(std::size(edges_ns));
+        chrono::_impl::_from_ns_from_1970(std::span<const int64_t> { edges_ns }, edges.data());
+        const auto with_values = [&]<typename value_t>(const no_init_vector<value_t>& data)
+        {
+            return decimation::minmax(
+                std::span<const value_t> { data.data(), records * components },
+                components, std::span<const time_t> { time_values.data(), records },
+                std::span<const time_t> { edges }, fill);
+        };
+        return _details::visit_numeric(values, with_values,
+            [&values]() -> minmax_t
+            {
+                throw std::invalid_argument(fmt::format("minmax: {} has non numeric type {}",
+                    values.name(), cdf_type_str(values.type())));
+            });
+    };
+    switch (time.type())
+    {
+        case CDF_EPOCH:
+            return with_time(time.get<epoch>());
+        case CDF_EPOCH16:
+            return with_time(time.get<epoch16>());
+        case CDF_TIME_TT2000:
+            return with_time(time.get<tt2000_t>());
+        default:
+            throw std::invalid_argument(fmt::format(
+                "minmax: time axis {} must be a CDF time variable (CDF_EPOCH, CDF_EPOCH16, or "
+                "CDF_TIME_TT2000), got {}",
+                time.name(), cdf_type_str(time.type())));
+    }
+}
+
+}
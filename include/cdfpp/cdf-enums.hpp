@@ -24,6 +24,7 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #pragma once
+#include <limits>
 #include <span>
 #include <stdexcept>
 #include <stdint.h>
@@ -62,6 +63,30 @@ enum class cdf_majority
 }
 
 
+// How a variable's records missing from the file (sparse records) read back, VDR SRecords.
+enum class cdf_sparse_records : int32_t
+{
+    no_sparse = 0,
+    pad = 1,
+    previous = 2
+};
+
+[[nodiscard]] inline std::string cdf_sparse_records_str(cdf_sparse_records type) noexcept
+{
+    using enum cdf_sparse_records;
+    switch (type)
+    {
+        case no_sparse:
+            return "None";
+        case pad:
+            return "Pad";
+        case previous:
+            return "Previous";
+    }
+    return "Unknown";
+}
+
+
 enum class cdf_record_type : int32_t
 {
     CDR = 1,
@@ -367,6 +392,28 @@ constexpr CDF_Types to_cdf_type()
 template <CDF_Types type>
 using from_cdf_type_t = decltype(from_cdf_type<type>());
 
+// Value the CDF library reads back from records never written when a variable has no pad
+// value of its own.
+template <CDF_Types type>
+[[nodiscard]] constexpr from_cdf_type_t<type> default_pad_value() noexcept
+{
+    using value_t = from_cdf_type_t<type>;
+    if constexpr (is_cdf_string_type(type))
+        return static_cast<value_t>(' ');
+    else if constexpr (type == CDF_Types::CDF_TIME_TT2000)
+        return tt2000_t { std::numeric_limits<int64_t>::min() + 1 };
+    else if constexpr (type == CDF_Types::CDF_EPOCH)
+        return epoch { 0. };
+    else if constexpr (type == CDF_Types::CDF_EPOCH16)
+        return epoch16 { 0., 0. };
+    else if constexpr (is_cdf_floating_point_type(type))
+        return static_cast<value_t>(-1e30);
+    else if constexpr (std::is_signed_v<value_t>)
+        return std::numeric_limits<value_t>::min() + 1;
+    else
+        return std::numeric_limits<value_t>::max() - 1;
+}
+
 
 [[nodiscard]] inline auto cdf_type_dispatch(CDF_Types cdf_type, auto&& f, auto&&... args)
 {
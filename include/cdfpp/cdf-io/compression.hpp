@@ -25,6 +25,7 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 #include "../cdf-enums.hpp"
+#include "../cdf-trace.hpp"
 #include <cdfpp_config.h>
 #ifdef CDFpp_USE_LIBDEFLATE
 #include "./libdeflate.hpp"
@@ -65,6 +66,8 @@ no_init_vector<char> deflate(const T& input)
 template <typename T>
 no_init_vector<char> deflate(cdf_compression_type type, const T& input)
 {
+    CDFPP_TRACE_SCOPE("codec", "deflate", { "codec", cdf_compression_type_str(type) },
+        { "uncompressed_bytes", std::size(input) });
     if (type == cdf_compression_type::gzip_compression)
         return gzdeflate(input);
     if (type == cdf_compression_type::rle_compression)
@@ -25,6 +25,7 @@
 ----------------------------------------------------------------------------*/
 #pragma once
 #include "../cdf-enums.hpp"
+#include "../cdf-trace.hpp"
 #include <cdfpp_config.h>
 #include <stdexcept>
 #include <vector>
@@ -76,6 +77,8 @@ template <typename T>
 std::size_t inflate(
     cdf_compression_type type, const T& input, char* output, const std::size_t output_size)
 {
+    CDFPP_TRACE_SCOPE("codec", "inflate", { "codec", cdf_compression_type_str(type) },
+        { "compressed_bytes", std::size(input) }, { "uncompressed_bytes", output_size });
     if (type == cdf_compression_type::gzip_compression)
         return gzinflate(input, output, output_size);
     if (type == cdf_compression_type::rle_compression)
@@ -261,14 +261,21 @@ struct cdf_rVDR_t
     cdf_string_field_t<version_t, 256, 64> Name;
 
     table_field<int32_t, 0> DimVarys;
-    table_field<int32_t, 1> PadValues;
+    // one value (NumElems characters for strings) in the file encoding, only when Flags bit 1
+    // is set
+    table_field<char, 1> PadValues;
 
     std::size_t size(const table_field<int32_t, 0>&, int32_t rNumDims = 0) const
     {
         return rNumDims * sizeof(int32_t);
     }
 
-    constexpr std::size_t size(const table_field<int32_t, 1>&) const { return 0; }
+    std::size_t size(const table_field<char, 1>&) const
+    {
+        if (this->Flags & 2)
+            return static_cast<std::size_t>(this->NumElems) * cdf_type_size(this->DataType);
+        return 0;
+    }
     constexpr std::size_t size(const table_field<char, 2>&) const { return 132; }
 };
 
@@ -297,7 +304,8 @@ struct cdf_zVDR_t
     int32_t zNumDims;
     table_field<int32_t, 0> zDimSizes;
     table_field<int32_t, 1> DimVarys;
-    table_field<int32_t, 2> PadValues;
+    // same as rVDR PadValues, index 2 is taken by rfuF
+    table_field<char, 3> PadValues;
 
     std::size_t size(const table_field<int32_t, 0>&) const
     {
@@ -308,7 +316,12 @@ struct cdf_zVDR_t
         return this->zNumDims * sizeof(int32_t);
     }
 
-    constexpr std::size_t size(const table_field<int32_t, 2>&) const { return 0; }
+    std::size_t size(const table_field<char, 3>&) const
+    {
+        if (this->Flags & 2)
+            return static_cast<std::size_t>(this->NumElems) * cdf_type_size(this->DataType);
+        return 0;
+    }
     constexpr std::size_t size(const table_field<char, 2>&) const { return 132; }
 };
 
@@ -163,7 +163,7 @@ inline void _impl_decode_v(value_t* data, std::size_t size)
         CDFPP_ASSERT(data != nullptr);
         if (size > 0)
         {
-            for (auto i = 0UL; i < size; i++)
+            for (std::size_t i = 0; i < size; i++)
             {
                 data[i] = byte_swap(data[i]);
             }
@@ -0,0 +1,308 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "cdfpp/cdf-enums.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define CDFPP_HAS_GETRUSAGE
+#endif
+
+namespace cdf::io
+{
+
+/*
+ * Where load and save time goes. Phases nest: load and save cover the whole call, the others
+ * are parts of it. Phases running on the thread pool (inflate, deflate) are summed over
+ * threads and may exceed the wall time of the call.
+ */
+enum class io_phase : uint8_t
+{
+    load,
+    descriptors, // CDR, GDR, attributes, VDRs, VXRs and CPRs
+    read, // VVR payloads copied out of the file
+    inflate, // CVVRs and whole file compression
+    byte_swap, // values stored with an encoding other than the host one
+    utf8, // ISO 8859-1 to UTF-8 conversion of strings
+    majority_swap, // column major variables
+    save,
+    deflate, // CVVRs and whole file compression
+    write,
+};
+
+inline constexpr std::size_t io_phases_count = static_cast<std::size_t>(io_phase::write) + 1;
+
+[[nodiscard]] constexpr std::string_view io_phase_name(io_phase phase) noexcept
+{
+    switch (phase)
+    {
+        case io_phase::load:
+            return "load";
+        case io_phase::descriptors:
+            return "descriptors";
+        case io_phase::read:
+            return "read";
+        case io_phase::inflate:
+            return "inflate";
+        case io_phase::byte_swap:
+            return "byte_swap";
+        case io_phase::utf8:
+            return "utf8";
+        case io_phase::majority_swap:
+            return "majority_swap";
+        case io_phase::save:
+            return "save";
+        case io_phase::deflate:
+            return "deflate";
+        case io_phase::write:
+            return "write";
+    }
+    return "unknown";
+}
+
+struct codec_stats
+{
+    std::atomic<uint64_t> blocks { 0 };
+    std::atomic<uint64_t> compressed_bytes { 0 };
+    std::atomic<uint64_t> uncompressed_bytes { 0 };
+};
+
+/*
+ * Counters filled by load/save overloads taking an io_stats&, they accumulate over calls
+ * until reset(). Lazily loaded variables keep reporting the values they decode later on
+ * (except column major swaps), the io_stats must then outlive them.
+ */
+struct io_stats
+{
+    // descriptor records parsed (CDR, GDR, ADR, AEDR, VDR)
+    std::atomic<uint64_t> records_parsed { 0 };
+    // VVRs and CVVRs read or written
+    std::atomic<uint64_t> values_records { 0 };
+    // size of the file image the loader parses, the whole mapping for files
+    std::atomic<uint64_t> bytes_mapped { 0 };
+    // values bytes copied or inflated out of the file image
+    std::atomic<uint64_t> bytes_read { 0 };
+    std::atomic<uint64_t> bytes_written { 0 };
+    // process wide, only available where getrusage is
+    std::atomic<uint64_t> minor_page_faults { 0 };
+    std::atomic<uint64_t> major_page_faults { 0 };
+
+    io_stats() = default;
+    io_stats(const io_stats&) = delete;
+    io_stats& operator=(const io_stats&) = delete;
+
+    [[nodiscard]] static constexpr std::size_t codec_index(cdf_compression_type type) noexcept
+    {
+        switch (type)
+        {
+            case cdf_compression_type::rle_compression:
+                return 1;
+            case cdf_compression_type::huff_compression:
+                return 2;
+            case cdf_compression_type::ahuff_compression:
+                return 3;
+            case cdf_compression_type::gzip_compression:
+                return 4;
+#ifdef CDFPP_USE_ZSTD
+            case cdf_compression_type::zstd_compression:
+                return 5;
+#endif
+            default:
+                return 0;
+        }
+    }
+
+    [[nodiscard]] codec_stats& codec(cdf_compression_type type) noexcept
+    {
+        return p_codecs[codec_index(type)];
+    }
+
+    [[nodiscard]] const codec_stats& codec(cdf_compression_type type) const noexcept
+    {
+        return p_codecs[codec_index(type)];
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds time(io_phase phase) const noexcept
+    {
+        return std::chrono::nanoseconds { p_phases_ns[static_cast<std::size_t>(phase)].load(
+            std::memory_order_relaxed) };
+    }
+
+    void add_time(io_phase phase, std::chrono::nanoseconds duration) noexcept
+    {
+        p_phases_ns[static_cast<std::size_t>(phase)].fetch_add(
+            static_cast<uint64_t>(duration.count()), std::memory_order_relaxed);
+    }
+
+    void reset() noexcept
+    {
+        for (auto* counter : { &records_parsed, &values_records, &bytes_mapped, &bytes_read,
+                 &bytes_written, &minor_page_faults, &major_page_faults })
+            counter->store(0, std::memory_order_relaxed);
+        for (auto& codec : p_codecs)
+        {
+            codec.blocks.store(0, std::memory_order_relaxed);
+            codec.compressed_bytes.store(0, std::memory_order_relaxed);
+            codec.uncompressed_bytes.store(0, std::memory_order_relaxed);
+        }
+        for (auto& phase : p_phases_ns)
+            phase.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<codec_stats, 6> p_codecs;
+    std::array<std::atomic<uint64_t>, io_phases_count> p_phases_ns {};
+};
+
+/*
+ * Compile time policies threaded through the parsing and saving functions, the same way
+ * common::iso_8859_1_to_utf8_t is: with no_stats_t every hook is an empty inline function
+ * and timers are empty objects, so the default path doesn't even read the clock.
+ */
+struct no_stats_t
+{
+    static constexpr bool enabled = false;
+
+    struct timer
+    {
+        constexpr ~timer() { }
+        constexpr void stop() noexcept { }
+    };
+
+    [[nodiscard]] constexpr timer time(io_phase, bool = true) const noexcept { return {}; }
+    constexpr void parsed_records(std::size_t) const noexcept { }
+    constexpr void values_record(std::size_t) const noexcept { }
+    constexpr void codec(cdf_compression_type, std::size_t, std::size_t) const noexcept { }
+    constexpr void written(std::size_t) const noexcept { }
+};
+
+struct with_stats_t
+{
+    static constexpr bool enabled = true;
+
+    io_stats* stats;
+
+    // Adds the time elapsed since its creation to phase when stopped or destroyed.
+    class timer
+    {
+        io_stats* p_stats;
+        io_phase p_phase;
+        std::chrono::steady_clock::time_point p_start;
+
+    public:
+        timer(io_stats* stats, io_phase phase)
+                : p_stats { stats }
+                , p_phase { phase }
+                , p_start { stats ? std::chrono::steady_clock::now()
+                                  : std::chrono::steady_clock::time_point {} }
+        {
+        }
+        timer(const timer&) = delete;
+        timer& operator=(const timer&) = delete;
+        ~timer() { stop(); }
+
+        void stop() noexcept
+        {
+            if (p_stats)
+            {
+                p_stats->add_time(p_phase, std::chrono::steady_clock::now() - p_start);
+                p_stats = nullptr;
+            }
+        }
+    };
+
+    // when active is false the timer records nothing
+    [[nodiscard]] timer time(io_phase phase, bool active = true) const noexcept
+    {
+        return timer { active ? stats : nullptr, phase };
+    }
+
+    void parsed_records(std::size_t count) const noexcept
+    {
+        stats->records_parsed.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // a VVR (compression == no_compression) or CVVR of size bytes in the file
+    void values_record(std::size_t size) const noexcept
+    {
+        stats->values_records.fetch_add(1, std::memory_order_relaxed);
+        stats->bytes_read.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void codec(cdf_compression_type type, std::size_t compressed, std::size_t uncompressed) const
+        noexcept
+    {
+        auto& codec = stats->codec(type);
+        codec.blocks.fetch_add(1, std::memory_order_relaxed);
+        codec.compressed_bytes.fetch_add(compressed, std::memory_order_relaxed);
+        codec.uncompressed_bytes.fetch_add(uncompressed, std::memory_order_relaxed);
+    }
+
+    void written(std::size_t size) const noexcept
+    {
+        stats->bytes_written.fetch_add(size, std::memory_order_relaxed);
+    }
+};
+
+namespace _details
+{
+    // Page faults taken by the process between its creation and its destruction.
+    struct page_faults_probe
+    {
+        io_stats& stats;
+#ifdef CDFPP_HAS_GETRUSAGE
+        rusage start {};
+        explicit page_faults_probe(io_stats& stats) : stats { stats }
+        {
+            getrusage(RUSAGE_SELF, &start);
+        }
+        ~page_faults_probe()
+        {
+            rusage end {};
+            if (getrusage(RUSAGE_SELF, &end) == 0)
+            {
+                stats.minor_page_faults.fetch_add(
+                    static_cast<uint64_t>(end.ru_minflt - start.ru_minflt),
+                    std::memory_order_relaxed);
+                stats.major_page_faults.fetch_add(
+                    static_cast<uint64_t>(end.ru_majflt - start.ru_majflt),
+                    std::memory_order_relaxed);
+            }
+        }
+#else
+        explicit page_faults_probe(io_stats& stats) : stats { stats } { }
+#endif
+        page_faults_probe(const page_faults_probe&) = delete;
+        page_faults_probe& operator=(const page_faults_probe&) = delete;
+    };
+}
+
+}
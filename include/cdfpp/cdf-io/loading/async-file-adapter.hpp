@@ -0,0 +1,558 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "./buffers.hpp"
+#include "./paged-reader-adapter.hpp"
+#include "cdfpp/no_init_vector.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#if __has_include(<unistd.h>)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CDFPP_HAS_PREAD
+#endif
+#if __has_include(<linux/io_uring.h>) && __has_include(<sys/syscall.h>)                           \
+    && __has_include(<sys/mman.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define CDFPP_HAS_IO_URING
+#endif
+#endif
+
+namespace cdf::io::buffers
+{
+
+namespace _details
+{
+#ifdef CDFPP_HAS_IO_URING
+    /*
+     * Minimal io_uring driver built on raw syscalls (no liburing dependency), only able to
+     * queue file reads and collect their completions.
+     */
+    struct uring_t
+    {
+        int fd = -1;
+        unsigned entries = 0;
+        void* sq_ring = MAP_FAILED;
+        std::size_t sq_ring_size = 0;
+        void* cq_ring = MAP_FAILED;
+        std::size_t cq_ring_size = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        std::size_t sqes_size = 0;
+        unsigned *sq_head = nullptr, *sq_tail = nullptr, *sq_mask = nullptr, *sq_array = nullptr;
+        unsigned *cq_head = nullptr, *cq_tail = nullptr, *cq_mask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+        explicit uring_t(unsigned queue_depth)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+            if (fd < 0)
+                return;
+            entries = params.sq_entries;
+            sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single_mmap)
+                sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+            sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sq_ring == MAP_FAILED)
+                return;
+            cq_ring = single_mmap ? sq_ring
+                                  : mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE,
+                                        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ring == MAP_FAILED)
+                return;
+            sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+            auto sq = static_cast<char*>(sq_ring);
+            sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            auto cq = static_cast<char*>(cq_ring);
+            cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        ~uring_t()
+        {
+            if (sqes != MAP_FAILED)
+                munmap(sqes, sqes_size);
+            if (cq_ring != MAP_FAILED and cq_ring != sq_ring)
+                munmap(cq_ring, cq_ring_size);
+            if (sq_ring != MAP_FAILED)
+                munmap(sq_ring, sq_ring_size);
+            if (fd >= 0)
+                close(fd);
+        }
+
+        [[nodiscard]] bool is_valid() const
+        {
+            return fd >= 0 and sq_ring != MAP_FAILED and cq_ring != MAP_FAILED
+                and sqes != MAP_FAILED;
+        }
+
+        void push_read(int file, char* dest, unsigned size, std::size_t offset, uint64_t tag)
+        {
+            const unsigned tail = *sq_tail;
+            const unsigned index = tail & *sq_mask;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = file;
+            sqe.addr = reinterpret_cast<uint64_t>(dest);
+            sqe.len = size;
+            sqe.off = offset;
+            sqe.user_data = tag;
+            sq_array[index] = index;
+            std::atomic_ref<unsigned> { *sq_tail }.store(tail + 1, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool submit_and_wait(unsigned to_submit, unsigned min_complete)
+        {
+            while (true)
+            {
+                const auto ret = syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                    IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (ret >= 0)
+                    return true;
+                if (errno != EINTR)
+                    return false;
+            }
+        }
+
+        template <typename function_t>
+        void for_each_completion(function_t&& function)
+        {
+            unsigned head = *cq_head;
+            const unsigned tail
+                = std::atomic_ref<unsigned> { *cq_tail }.load(std::memory_order_acquire);
+            for (; head != tail; head++)
+                function(cqes[head & *cq_mask]);
+            std::atomic_ref<unsigned> { *cq_head }.store(head, std::memory_order_release);
+        }
+
+        // Entries pushed but not consumed by the kernel yet, io_uring_enter may stop early.
+        [[nodiscard]] unsigned unsubmitted() const
+        {
+            const unsigned head
+                = std::atomic_ref<unsigned> { *sq_head }.load(std::memory_order_acquire);
+            return *sq_tail - head;
+        }
+    };
+#endif
+
+#ifdef CDFPP_HAS_PREAD
+    [[nodiscard]] inline bool pread_all(int file, char* dest, std::size_t size, std::size_t offset)
+    {
+        while (size != 0)
+        {
+            const auto ret = ::pread(file, dest, size, static_cast<off_t>(offset));
+            if (ret < 0 and errno == EINTR)
+                continue;
+            if (ret <= 0)
+                return false;
+            dest += ret;
+            offset += static_cast<std::size_t>(ret);
+            size -= static_cast<std::size_t>(ret);
+        }
+        return true;
+    }
+#endif
+}
+
+/*
+ * Reads the file on demand with many reads in flight instead of faulting pages one at a time
+ * like mmap_adapter does, this matters on cold caches and on network file systems (Lustre,
+ * NFS) where page faults serialize I/O.
+ * Descriptor records go through the page cache of paged_reader_adapter. Variable records
+ * extents announced with access_pattern::will_need (see load_var_records) are split in
+ * chunk_size reads queued on io_uring right away and handed out when decoded, so fetching
+ * the next blocks overlaps inflating the current one. At most max_prefetch bytes are held
+ * that way, extents announced but never requested are dropped oldest first to make room.
+ * Past it (or without io_uring) extents are read when requested after a posix_fadvise hint,
+ * reads of a page or more straight from the file with pread so that concurrent CVVR loads
+ * don't queue behind the page cache lock.
+ */
+struct async_file_adapter
+{
+    using implements_view = std::false_type;
+    // preads are thread safe and the io_uring queue is guarded by a mutex
+    using concurrent_reads = std::true_type;
+
+    explicit async_file_adapter(const std::string& path, unsigned queue_depth = 32,
+        std::size_t chunk_size = 1024 * 1024, std::size_t max_prefetch = 256 * 1024 * 1024)
+            : p_chunk_size { std::max<std::size_t>(chunk_size, 4096) }
+            , p_max_prefetch { max_prefetch }
+    {
+        if (not std::filesystem::exists(path))
+            return;
+        if (std::filesystem::is_directory(path))
+            throw std::runtime_error("Cannot load a directory as a CDF file");
+        p_size = std::filesystem::file_size(path);
+        if (p_size == 0)
+            return;
+#ifdef CDFPP_HAS_PREAD
+        p_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (p_fd == -1)
+            return;
+        p_pages.emplace([fd = p_fd](char* dest, std::size_t offset, std::size_t size)
+            { return _details::pread_all(fd, dest, size, offset); },
+            p_size, page_size);
+#ifdef CDFPP_HAS_IO_URING
+        p_ring.emplace(queue_depth);
+        if (not p_ring->is_valid())
+            p_ring.reset();
+#else
+        (void)queue_depth;
+#endif
+#else
+        (void)queue_depth;
+        auto file = std::make_shared<std::ifstream>(path, std::ios::binary);
+        if (not file->is_open())
+            return;
+        p_pages.emplace(
+            [file](char* dest, std::size_t offset, std::size_t size)
+            {
+                file->clear();
+                file->seekg(static_cast<std::streamoff>(offset));
+                return static_cast<bool>(file->read(dest, static_cast<std::streamsize>(size)));
+            },
+            p_size, page_size);
+#endif
+    }
+
+    async_file_adapter(const async_file_adapter&) = delete;
+    async_file_adapter& operator=(const async_file_adapter&) = delete;
+
+    ~async_file_adapter()
+    {
+#ifdef CDFPP_HAS_IO_URING
+        if (p_ring)
+        {
+            // reads in flight still write into their extent, wait for them before freeing
+            std::lock_guard lock { p_mutex };
+            p_queue.clear();
+            while (p_in_flight != 0 and not p_ring_failed)
+                wait_completions();
+            if (p_in_flight != 0)
+                for (auto& extent : p_extents)
+                    (void)extent.release();
+        }
+#endif
+#ifdef CDFPP_HAS_PREAD
+        if (p_fd != -1)
+            ::close(p_fd);
+#endif
+    }
+
+    void read(char* dest, const std::size_t offset, const std::size_t size)
+    {
+        if (auto extent = take_prefetched(offset, size))
+            std::memcpy(dest, extent->data.data() + (offset - extent->offset), size);
+        else if (not read_direct(dest, offset, size))
+            p_pages->read(dest, offset, size);
+    }
+
+    no_init_vector<char> view(const std::size_t offset, const std::size_t size)
+    {
+        if (auto extent = take_prefetched(offset, size))
+        {
+            if (extent->offset == offset and std::size(extent->data) == size)
+                return std::move(extent->data);
+            const auto begin = extent->data.data() + (offset - extent->offset);
+            return no_init_vector<char>(begin, begin + size);
+        }
+        if (size >= page_size and offset <= p_size and size <= p_size - offset)
+        {
+            no_init_vector<char> bytes(size);
+            if (read_direct(bytes.data(), offset, size))
+                return bytes;
+        }
+        return p_pages->view(offset, size);
+    }
+
+    void advise(const std::size_t offset, const std::size_t size, access_pattern pattern) noexcept
+    {
+        if (pattern != access_pattern::will_need or size == 0 or offset > p_size
+            or size > p_size - offset)
+            return;
+        try
+        {
+            if (queue_prefetch(offset, size))
+                return;
+        }
+        catch (...)
+        {
+            // only a hint, the extent will be read when requested
+        }
+#if defined(CDFPP_HAS_PREAD) && defined(POSIX_FADV_WILLNEED)
+        ::posix_fadvise(p_fd, static_cast<off_t>(offset), static_cast<off_t>(size),
+            POSIX_FADV_WILLNEED);
+#endif
+    }
+
+    bool is_valid() const { return p_pages and p_pages->is_valid(); }
+
+private:
+    // page size of p_pages, smaller reads share its pages
+    static constexpr std::size_t page_size = 64 * 1024;
+
+    // Reads a range of at least a page with pread, without holding any lock. Returns false
+    // when the range is left to p_pages (small, out of the file or no pread).
+    bool read_direct(
+        [[maybe_unused]] char* dest, const std::size_t offset, const std::size_t size) const
+    {
+#ifdef CDFPP_HAS_PREAD
+        if (size < page_size or offset > p_size or size > p_size - offset)
+            return false;
+        if (not _details::pread_all(p_fd, dest, size, offset))
+            throw std::runtime_error { fmt::format(
+                "Failed to read {} bytes at offset {}", size, offset) };
+        return true;
+#else
+        (void)offset;
+        (void)size;
+        return false;
+#endif
+    }
+
+    struct extent_t
+    {
+        struct chunk_t
+        {
+            extent_t* extent;
+            char* dest;
+            std::size_t offset;
+            std::size_t size;
+        };
+        std::size_t offset;
+        no_init_vector<char> data;
+        std::vector<chunk_t> chunks;
+        std::size_t remaining;
+        bool failed = false;
+    };
+
+#ifdef CDFPP_HAS_IO_URING
+    using chunk_t = extent_t::chunk_t;
+
+    bool queue_prefetch(const std::size_t offset, const std::size_t size)
+    {
+        if (not p_ring)
+            return false;
+        std::lock_guard lock { p_mutex };
+        // record_chunks announces the next chunk extents before they get requested
+        if (find_extent(offset, size) != std::end(p_extents))
+            return true;
+        if (p_ring_failed or size > p_max_prefetch)
+            return false;
+        if (size > p_max_prefetch - std::min(p_max_prefetch, p_prefetched))
+        {
+            // moves queued reads along without waiting, then makes room if it can
+            reap_completions();
+            if (not submit(0))
+            {
+                p_ring_failed = true;
+                return false;
+            }
+            drop_completed(size);
+        }
+        if (size > p_max_prefetch - std::min(p_max_prefetch, p_prefetched))
+            return false;
+        auto extent = std::make_unique<extent_t>();
+        extent->offset = offset;
+        extent->data.resize(size);
+        for (std::size_t done = 0; done < size; done += p_chunk_size)
+            extent->chunks.push_back({ extent.get(), extent->data.data() + done, offset + done,
+                std::min(p_chunk_size, size - done) });
+        extent->remaining = std::size(extent->chunks);
+        for (auto& chunk : extent->chunks)
+            p_queue.push_back(&chunk);
+        p_prefetched += size;
+        p_extents.push_back(std::move(extent));
+        if (not submit(0))
+            p_ring_failed = true;
+        return true;
+    }
+
+    // Pushes queued chunks while the ring has room and enters the kernel, waiting for
+    // min_complete completions. Must be called with p_mutex held.
+    [[nodiscard]] bool submit(unsigned min_complete)
+    {
+        while (not std::empty(p_queue) and p_in_flight < p_ring->entries)
+        {
+            auto chunk = p_queue.front();
+            p_queue.pop_front();
+            p_ring->push_read(p_fd, chunk->dest, static_cast<unsigned>(chunk->size),
+                chunk->offset, reinterpret_cast<uint64_t>(chunk));
+            p_in_flight++;
+        }
+        const auto to_submit = p_ring->unsubmitted();
+        if (to_submit == 0 and min_complete == 0)
+            return true;
+        return p_ring->submit_and_wait(to_submit, min_complete);
+    }
+
+    // Must be called with p_mutex held.
+    std::vector<std::unique_ptr<extent_t>>::iterator find_extent(
+        const std::size_t offset, const std::size_t size)
+    {
+        return std::find_if(std::begin(p_extents), std::end(p_extents),
+            [offset, size](const auto& extent)
+            {
+                return offset >= extent->offset
+                    and offset + size <= extent->offset + std::size(extent->data);
+            });
+    }
+
+    // Drops completed extents, oldest first, until size more bytes fit in the prefetch
+    // budget. Must be called with p_mutex held.
+    void drop_completed(const std::size_t size)
+    {
+        for (auto it = std::begin(p_extents); it != std::end(p_extents)
+             and size > p_max_prefetch - std::min(p_max_prefetch, p_prefetched);)
+        {
+            if ((*it)->remaining != 0)
+            {
+                ++it;
+                continue;
+            }
+            p_prefetched -= std::size((*it)->data);
+            it = p_extents.erase(it);
+        }
+    }
+
+    // Must be called with p_mutex held.
+    void wait_completions()
+    {
+        if (not submit(1))
+        {
+            p_ring_failed = true;
+            return;
+        }
+        reap_completions();
+    }
+
+    // Must be called with p_mutex held, short reads are queued again for their remainder.
+    void reap_completions()
+    {
+        p_ring->for_each_completion(
+            [this](const io_uring_cqe& cqe)
+            {
+                p_in_flight--;
+                auto chunk = reinterpret_cast<chunk_t*>(cqe.user_data);
+                if (cqe.res > 0 and static_cast<std::size_t>(cqe.res) < chunk->size)
+                {
+                    chunk->dest += cqe.res;
+                    chunk->offset += static_cast<std::size_t>(cqe.res);
+                    chunk->size -= static_cast<std::size_t>(cqe.res);
+                    p_queue.push_back(chunk);
+                    return;
+                }
+                if (cqe.res <= 0)
+                    chunk->extent->failed = true;
+                chunk->extent->remaining--;
+            });
+    }
+#else
+    bool queue_prefetch(const std::size_t, const std::size_t) { return false; }
+#endif
+
+    // Hands out the prefetched extent holding [offset, offset + size) once all its reads
+    // completed, or nothing if there is none so the caller reads the range itself.
+    std::unique_ptr<extent_t> take_prefetched(
+        [[maybe_unused]] const std::size_t offset, [[maybe_unused]] const std::size_t size)
+    {
+#ifdef CDFPP_HAS_IO_URING
+        if (not p_ring)
+            return nullptr;
+        std::lock_guard lock { p_mutex };
+        auto it = find_extent(offset, size);
+        if (it == std::end(p_extents))
+            return nullptr;
+        while ((*it)->remaining != 0 and not p_ring_failed)
+            wait_completions();
+        // when the ring broke down its reads may still land, keep the buffer until the end
+        if ((*it)->remaining != 0)
+            return nullptr;
+        auto extent = std::move(*it);
+        p_extents.erase(it);
+        p_prefetched -= std::size(extent->data);
+        if (extent->failed)
+            return nullptr;
+        return extent;
+#else
+        return nullptr;
+#endif
+    }
+
+    std::size_t p_size = 0;
+    std::size_t p_chunk_size;
+    std::size_t p_max_prefetch;
+    std::optional<paged_reader_adapter> p_pages;
+#ifdef CDFPP_HAS_PREAD
+    int p_fd = -1;
+#endif
+#ifdef CDFPP_HAS_IO_URING
+    std::optional<_details::uring_t> p_ring;
+    std::mutex p_mutex;
+    std::vector<std::unique_ptr<extent_t>> p_extents;
+    std::deque<chunk_t*> p_queue;
+    unsigned p_in_flight = 0;
+    std::size_t p_prefetched = 0;
+    bool p_ring_failed = false;
+#endif
+};
+
+inline auto make_shared_async_file_adapter(const std::string& path, unsigned queue_depth = 32)
+{
+    return shared_buffer_t(std::make_shared<async_file_adapter>(path, queue_depth));
+}
+
+}
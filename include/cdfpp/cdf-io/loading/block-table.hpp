@@ -0,0 +1,178 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "../desc-records.hpp"
+#include "../endianness.hpp"
+#include "./buffers.hpp"
+#include "./records-loading.hpp"
+#include "cdfpp/cdf-enums.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace cdf::io::variable
+{
+
+/*
+ * One leaf VVR/CVVR of a variable, flattened out of the VXR tree.
+ * `offset` and `compressed_size` describe the payload only (record header skipped):
+ * for a VVR, `compressed_size` is simply the number of raw bytes stored in the file.
+ */
+struct var_block_t
+{
+    uint32_t first_record;
+    uint32_t last_record;
+    std::size_t offset;
+    cdf_record_type kind;
+    std::size_t compressed_size;
+
+    [[nodiscard]] inline std::size_t records_count() const noexcept
+    {
+        return static_cast<std::size_t>(last_record) - first_record + 1UL;
+    }
+    [[nodiscard]] inline bool is_compressed() const noexcept
+    {
+        return kind == cdf_record_type::CVVR;
+    }
+};
+
+using var_block_table_t = std::vector<var_block_t>;
+
+namespace _details
+{
+    // VXR and CVVR records without their variable length tables, loading them this way
+    // avoids allocating First/Last/Offset vectors and copying compressed payloads.
+    template <typename version_t>
+    struct cdf_VXR_head_t
+    {
+        cdf_DR_header<version_t, cdf_record_type::VXR> header;
+        cdf_offset_field_t<version_t> VXRnext;
+        uint32_t Nentries;
+        uint32_t NusedEntries;
+    };
+
+    template <typename version_t>
+    struct cdf_CVVR_head_t
+    {
+        cdf_DR_header<version_t, cdf_record_type::CVVR> header;
+        unused_field<uint32_t> rfuA;
+        cdf_offset_field_t<version_t> cSize;
+    };
+
+    template <typename version_t, typename stream_t>
+    void flatten_vxr(
+        stream_t& stream, std::size_t vxr_offset, var_block_table_t& table, std::size_t depth)
+    {
+        using offset_t = cdf_offset_field_t<version_t>;
+        // a legit VXR tree is at most a few levels deep, this only guards against loops
+        if (depth > 64)
+            throw std::runtime_error { "Error loading variable data: VXR tree is too deep" };
+        while (vxr_offset != 0)
+        {
+            cdf_VXR_head_t<version_t> vxr;
+            const auto entries_offset = load_record(vxr, stream, vxr_offset);
+            if (vxr.header.record_type != cdf_record_type::VXR)
+                throw std::runtime_error { "Failed to read vxr" };
+            const std::size_t n = vxr.Nentries;
+            auto entries_view = buffers::view(
+                stream, entries_offset, n * (2 * sizeof(uint32_t) + sizeof(offset_t)));
+            const char* entries = buffers::get_data_ptr(entries_view);
+            for (std::size_t i = 0; i < vxr.NusedEntries; i++)
+            {
+                const auto first = endianness::decode<endianness::big_endian_t, uint32_t>(
+                    entries + i * sizeof(uint32_t));
+                const auto last = endianness::decode<endianness::big_endian_t, uint32_t>(
+                    entries + (n + i) * sizeof(uint32_t));
+                const std::size_t offset = endianness::decode<endianness::big_endian_t, offset_t>(
+                    entries + 2 * n * sizeof(uint32_t) + i * sizeof(offset_t));
+                cdf_DR_header<version_t, cdf_record_type::UIR> header;
+                const auto payload_offset = load_record(header, stream, offset);
+                switch (header.record_type)
+                {
+                    case cdf_record_type::VVR:
+                        table.push_back({ first, last, payload_offset, cdf_record_type::VVR,
+                            static_cast<std::size_t>(header.record_size)
+                                - (payload_offset - offset) });
+                        break;
+                    case cdf_record_type::CVVR:
+                    {
+                        cdf_CVVR_head_t<version_t> cvvr;
+                        const auto data_offset = load_record(cvvr, stream, offset);
+                        table.push_back({ first, last, data_offset, cdf_record_type::CVVR,
+                            static_cast<std::size_t>(cvvr.cSize) });
+                    }
+                    break;
+                    case cdf_record_type::VXR:
+                        flatten_vxr<version_t>(stream, offset, table, depth + 1);
+                        break;
+                    default:
+                        throw std::runtime_error {
+                            "Error loading variable data expecting VVR, CVVR or VXR"
+                        };
+                }
+            }
+            vxr_offset = static_cast<std::size_t>(vxr.VXRnext);
+        }
+    }
+}
+
+/*
+ * Walks a variable's VXR tree once and returns its leaf blocks sorted by first record.
+ * Only index records and block headers are read, never variable data, so this is cheap
+ * enough to run at open time even in lazy mode; loading, contiguity checks and partial
+ * reads all work from this table afterward.
+ */
+template <typename version_t, typename stream_t>
+[[nodiscard]] var_block_table_t make_block_table(stream_t& stream, std::size_t vxr_head)
+{
+    var_block_table_t table;
+    _details::flatten_vxr<version_t>(stream, vxr_head, table, 0);
+    if (not std::is_sorted(std::cbegin(table), std::cend(table),
+            [](const var_block_t& a, const var_block_t& b)
+            { return a.first_record < b.first_record; }))
+    {
+        std::stable_sort(std::begin(table), std::end(table),
+            [](const var_block_t& a, const var_block_t& b)
+            { return a.first_record < b.first_record; });
+    }
+    return table;
+}
+
+// Blocks holding at least one record of [first_record, last_record], in O(log(blocks)).
+[[nodiscard]] inline std::span<const var_block_t> blocks_in_range(
+    const var_block_table_t& table, uint32_t first_record, uint32_t last_record)
+{
+    auto begin = std::partition_point(std::cbegin(table), std::cend(table),
+        [first_record](const var_block_t& b) { return b.last_record < first_record; });
+    auto end = std::partition_point(begin, std::cend(table),
+        [last_record](const var_block_t& b) { return b.first_record <= last_record; });
+    return { begin, end };
+}
+
+}
@@ -75,6 +75,53 @@ constexpr auto get_data_ptr(buffer_t& buffer) -> decltype(buffer.view(0UL))
     return buffer.view(0UL);
 }
 
+// Returns something get_data_ptr can be applied to, giving at least size contiguous bytes
+// starting at offset. Buffers holding the whole file give a plain pointer into it, buffers
+// only readable piecewise (see paged_reader_adapter) give an owning copy of the range.
+template <typename buffer_t>
+constexpr auto view(buffer_t& buffer, std::size_t offset, std::size_t size)
+{
+    if constexpr (requires { buffer.view(offset, size); })
+        return buffer.view(offset, size);
+    else if constexpr (requires { get_data_ptr(buffer); })
+        return get_data_ptr(buffer) + offset;
+    else
+        return view(buffer.buffer, offset, size);
+}
+
+// Hints about how a buffer region is about to be accessed, buffers that can't make use of
+// them (in memory arrays for instance) just ignore them.
+enum class access_pattern
+{
+    normal,
+    random,
+    sequential,
+    will_need
+};
+
+template <typename buffer_t>
+inline void advise(
+    buffer_t& buffer, std::size_t offset, std::size_t size, access_pattern pattern) noexcept
+{
+    if constexpr (requires { buffer.advise(offset, size, pattern); })
+        buffer.advise(offset, size, pattern);
+}
+
+// Buffers handing out views (in memory, mapped) can be read from several threads at once,
+// those reading through a function (paged_reader_adapter) stay on the calling thread since
+// that function may be bound to it (a JS callback in the WASM build). A buffer can state
+// otherwise with a concurrent_reads member type (see async_file_adapter).
+template <typename buffer_t>
+inline constexpr bool concurrent_reads_v = []()
+{
+    if constexpr (requires { typename buffer_t::concurrent_reads; })
+        return buffer_t::concurrent_reads::value;
+    else if constexpr (requires { typename buffer_t::implements_view; })
+        return buffer_t::implements_view::value;
+    else
+        return false;
+}();
+
 struct array_view
 {
     using value_type = char;
@@ -236,13 +283,20 @@ struct mmap_adapter
 #endif
     char* mapped_file = nullptr;
     std::size_t f_size = 0UL;
+    bool use_hints = true;
     using implements_view = std::true_type;
 #ifdef USE_MapViewOfFile
     HANDLE hMapFile = NULL;
     HANDLE hFile = NULL;
 #endif
 
-    mmap_adapter(const std::string& path)
+    // Descriptor records are scattered all over the file, so the whole mapping starts with a
+    // random access hint (no useless readahead) and loaders flag the VVR/CVVR extents they
+    // are about to read as sequential. Files smaller than populate_below are prefaulted
+    // with MAP_POPULATE since they end up read almost entirely anyway.
+    mmap_adapter(const std::string& path, bool access_hints = true,
+        std::size_t populate_below = 1024 * 1024)
+            : use_hints { access_hints }
     {
 
         if (std::filesystem::exists(path))
@@ -257,14 +311,23 @@ struct mmap_adapter
                 {
 
                     {
-                        mapped_file = static_cast<char*>(mmap(
-                            nullptr, this->f_size, PROT_READ, MAP_FILE | MAP_PRIVATE, fd, 0UL));
+                        int flags = MAP_FILE | MAP_PRIVATE;
+#ifdef MAP_POPULATE
+                        if (this->f_size < populate_below)
+                            flags |= MAP_POPULATE;
+#endif
+                        mapped_file = static_cast<char*>(
+                            mmap(nullptr, this->f_size, PROT_READ, flags, fd, 0UL));
                         if (mapped_file == MAP_FAILED)
                         {
                             mapped_file = nullptr;
                             close(fd);
                             fd = -1;
                         }
+                        else if (use_hints and this->f_size >= populate_below)
+                        {
+                            madvise(mapped_file, this->f_size, MADV_RANDOM);
+                        }
                     }
                 }
 #endif
@@ -321,6 +384,36 @@ struct mmap_adapter
 
     auto view(const std::size_t offset) const { return mapped_file + offset; }
 
+    void advise(const std::size_t offset, const std::size_t size, access_pattern pattern) const
+    {
+#ifdef USE_MMAP
+        if (not use_hints or mapped_file == nullptr or size == 0 or offset >= f_size)
+            return;
+        static const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const auto begin = offset - (offset % page_size);
+        const auto end = std::min(offset + size, f_size);
+        const int advice = [pattern]()
+        {
+            switch (pattern)
+            {
+                case access_pattern::random:
+                    return MADV_RANDOM;
+                case access_pattern::sequential:
+                    return MADV_SEQUENTIAL;
+                case access_pattern::will_need:
+                    return MADV_WILLNEED;
+                default:
+                    return MADV_NORMAL;
+            }
+        }();
+        madvise(mapped_file + begin, end - begin, advice);
+#else
+        (void)offset;
+        (void)size;
+        (void)pattern;
+#endif
+    }
+
     bool is_valid() const
     {
 #ifdef USE_MMAP
@@ -338,6 +431,7 @@ struct shared_buffer_t
 {
     shared_buffer_t() = delete;
     using implements_view = typename buffer_t::implements_view;
+    using concurrent_reads = std::bool_constant<concurrent_reads_v<buffer_t>>;
 
     shared_buffer_t(std::shared_ptr<buffer_t>&& buffer) : p_buffer { std::move(buffer) } { }
 
@@ -379,11 +473,24 @@ struct shared_buffer_t
         return p_buffer->template view<size>(offset);
     }
 
-    auto view(const std::size_t offset) const -> decltype(std::declval<buffer_t>().view(offset))
+    template <typename T = buffer_t>
+    auto view(const std::size_t offset) const -> decltype(std::declval<T>().view(offset))
     {
         return p_buffer->view(offset);
     }
 
+    template <typename T = buffer_t>
+    auto view(const std::size_t offset, const std::size_t size) const
+        -> decltype(std::declval<T&>().view(offset, size))
+    {
+        return p_buffer->view(offset, size);
+    }
+
+    inline void advise(std::size_t offset, std::size_t size, access_pattern pattern) const noexcept
+    {
+        buffers::advise(*p_buffer, offset, size, pattern);
+    }
+
     inline bool is_valid() const { return p_buffer->is_valid(); }
 
 private:
@@ -407,9 +514,9 @@ inline auto make_shared_array_adapter(const char* const data, std::size_t size)
     return shared_buffer_t(std::make_shared<array_adapter<const char* const>>(data, size));
 }
 
-inline auto make_shared_file_adapter(const std::string& path)
+inline auto make_shared_file_adapter(const std::string& path, bool access_hints = true)
 {
-    return shared_buffer_t(std::make_shared<mmap_adapter>(path));
+    return shared_buffer_t(std::make_shared<mmap_adapter>(path, access_hints));
 }
 
 }
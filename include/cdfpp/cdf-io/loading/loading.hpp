@@ -28,18 +28,29 @@
 #include "../decompression.hpp"
 #include "../desc-records.hpp"
 #include "../endianness.hpp"
+#include "../io-stats.hpp"
+#include "./async-file-adapter.hpp"
 #include "./attribute.hpp"
 #include "./buffers.hpp"
+#include "./paged-reader-adapter.hpp"
 #include "./records-loading.hpp"
 #include "./variable.hpp"
 #include "cdfpp/cdf-enums.hpp"
 #include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+#include "cdfpp/cdf-trace.hpp"
 #include <algorithm>
+#include <atomic>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <optional>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace cdf::io
 {
@@ -56,12 +67,16 @@ namespace
     }
 
 
-    template <typename version_t, typename buffer_t>
-    auto make_parsing_context(version_t, buffer_t&& buff, cdf_compression_type compression_type)
+    template <typename version_t, typename buffer_t, typename stats_t = no_stats_t>
+    auto make_parsing_context(version_t, buffer_t&& buff, cdf_compression_type compression_type,
+        stats_t stats = {})
     {
-        parsing_context_t<buffer_t, version_t> ctx { std::move(buff), compression_type };
+        parsing_context_t<buffer_t, version_t, stats_t> ctx { std::move(buff), compression_type,
+            stats };
+        const auto timer = stats.time(io_phase::descriptors);
         load_record(ctx.cdr, ctx.buffer, 8);
         load_record(ctx.gdr, ctx.buffer, ctx.cdr.GDRoffset);
+        stats.parsed_records(2);
         ctx.majority = common::majority(ctx.cdr);
         return ctx;
     }
@@ -88,18 +103,24 @@ namespace
         repr.distribution_version = parsing_context.distribution_version();
         repr.compression_type = parsing_context.compression_type;
         repr.lazy = lazy_load;
-        if (!attribute::load_all<typename parsing_context_t::version_tag, iso_8859_1_to_utf8>(
-                parsing_context, repr))
-            return std::nullopt;
+        {
+            CDFPP_TRACE_SCOPE("load", "attributes");
+            const auto timer = parsing_context.stats.time(io_phase::descriptors);
+            if (!attribute::load_all<typename parsing_context_t::version_tag,
+                    iso_8859_1_to_utf8>(parsing_context, repr))
+                return std::nullopt;
+        }
+        CDFPP_TRACE_SCOPE("load", "variables", { "lazy", lazy_load });
         if (!variable::load_all<typename parsing_context_t::version_tag, iso_8859_1_to_utf8>(
                 parsing_context, repr, lazy_load))
             return std::nullopt;
         return from_repr(std::move(repr));
     }
 
-    template <typename cdf_version_tag_t, typename iso_8859_1_to_utf8, typename buffer_t>
-    [[nodiscard]] std::optional<CDF> parse_cdf(
-        buffer_t&& buffer, iso_8859_1_to_utf8, bool is_compressed = false, bool lazy_load = false)
+    template <typename cdf_version_tag_t, typename iso_8859_1_to_utf8, typename buffer_t,
+        typename stats_t = no_stats_t>
+    [[nodiscard]] std::optional<CDF> parse_cdf(buffer_t&& buffer, iso_8859_1_to_utf8,
+        bool is_compressed = false, bool lazy_load = false, stats_t stats = {})
     {
         if (is_compressed)
         {
@@ -109,10 +130,17 @@ namespace
                 load_record(CPR, buffer, CCR.CPRoffset);
                 no_init_vector<char> data(8UL + CCR.uSize);
                 buffer.read(data.data(), 0, 8);
-                decompression::inflate(
-                    CPR.cType, CCR.data.values, data.data() + 8UL, std::size(data) - 8UL);
+                {
+                    CDFPP_TRACE_SCOPE("load", "uncompress file",
+                        { "compressed_bytes", std::size(CCR.data.values) },
+                        { "uncompressed_bytes", CCR.uSize });
+                    const auto timer = stats.time(io_phase::inflate);
+                    decompression::inflate(
+                        CPR.cType, CCR.data.values, data.data() + 8UL, std::size(data) - 8UL);
+                }
+                stats.codec(CPR.cType, std::size(CCR.data.values), CCR.uSize);
                 auto parsing_ctx = make_parsing_context(cdf_version_tag_t {},
-                    buffers::make_shared_array_adapter(std::move(data)), CPR.cType);
+                    buffers::make_shared_array_adapter(std::move(data)), CPR.cType, stats);
                 return impl_parse_cdf<common::with_iso_8859_1_to_utf8<iso_8859_1_to_utf8>>(
                     parsing_ctx, lazy_load);
             }
@@ -120,21 +148,21 @@ namespace
         }
         else // Compression was introduced in CDF V2.6
         {
-            auto parsing_ctx = make_parsing_context(
-                cdf_version_tag_t {}, std::move(buffer), cdf_compression_type::no_compression);
+            auto parsing_ctx = make_parsing_context(cdf_version_tag_t {}, std::move(buffer),
+                cdf_compression_type::no_compression, stats);
             if constexpr (!is_v3_v<cdf_version_tag_t>)
             {
                 if (parsing_ctx.cdr.Release >= 5)
                 {
                     auto new_ctx = make_parsing_context(v2_5_or_more_tag {},
-                        std::move(parsing_ctx.buffer), cdf_compression_type::no_compression);
+                        std::move(parsing_ctx.buffer), cdf_compression_type::no_compression, stats);
                     return impl_parse_cdf<common::with_iso_8859_1_to_utf8<iso_8859_1_to_utf8>>(
                         new_ctx, lazy_load);
                 }
                 else
                 {
                     auto new_ctx = make_parsing_context(v2_4_or_less_tag {},
-                        std::move(parsing_ctx.buffer), cdf_compression_type::no_compression);
+                        std::move(parsing_ctx.buffer), cdf_compression_type::no_compression, stats);
                     return impl_parse_cdf<common::with_iso_8859_1_to_utf8<iso_8859_1_to_utf8>>(
                         new_ctx, lazy_load);
                 }
@@ -147,35 +175,53 @@ namespace
         }
     }
 
-    template <typename buffer_t, typename iso_8859_1_to_utf8>
+    template <typename buffer_t, typename iso_8859_1_to_utf8, typename stats_t = no_stats_t>
     [[nodiscard]] auto _impl_load(buffer_t&& buffer, iso_8859_1_to_utf8 iso_8859_1_to_utf8_tag,
-        bool lazy_load = false) -> decltype(buffer.read(std::declval<char*>(), 0UL, 0UL),
-                                    std::optional<CDF> {})
+        bool lazy_load = false, stats_t stats = {})
+        -> decltype(buffer.read(std::declval<char*>(), 0UL, 0UL), std::optional<CDF> {})
     {
+        CDFPP_TRACE_SCOPE("load", "parse", { "lazy", lazy_load });
         auto magic = get_magic(buffer);
         if (common::is_cdf(magic))
         {
             if (common::is_v3x(magic))
             {
                 return parse_cdf<v3x_tag>(std::move(buffer), iso_8859_1_to_utf8_tag,
-                    common::is_compressed(magic), lazy_load);
+                    common::is_compressed(magic), lazy_load, stats);
             }
             else
             {
                 return parse_cdf<v2x_tag>(std::move(buffer), iso_8859_1_to_utf8_tag,
-                    common::is_compressed(magic), lazy_load);
+                    common::is_compressed(magic), lazy_load, stats);
             }
         }
         return std::nullopt;
     }
 
-    template <typename buffer_t>
-    [[nodiscard]] auto impl_load(buffer_t&& buffer, bool iso_8859_1_to_utf8, bool lazy_load = false)
+    template <typename buffer_t, typename stats_t = no_stats_t>
+    [[nodiscard]] auto impl_load(
+        buffer_t&& buffer, bool iso_8859_1_to_utf8, bool lazy_load = false, stats_t stats = {})
     {
         if (iso_8859_1_to_utf8)
-            return _impl_load(std::move(buffer), common::iso_8859_1_to_utf8_t {}, lazy_load);
+            return _impl_load(std::move(buffer), common::iso_8859_1_to_utf8_t {}, lazy_load, stats);
         else
-            return _impl_load(std::move(buffer), common::no_iso_8859_1_to_utf8_t {}, lazy_load);
+            return _impl_load(
+                std::move(buffer), common::no_iso_8859_1_to_utf8_t {}, lazy_load, stats);
+    }
+
+    // Runs function(i) for i in [0, count) with at most threads_count of them in flight on
+    // the library thread pool, the first exception thrown by a task is rethrown.
+    template <typename function_t>
+    void parallel_for(std::size_t count, std::size_t threads_count, const function_t& function)
+    {
+        threads_count = std::min(std::max(threads_count, std::size_t { 1 }), count);
+        std::atomic<std::size_t> next { 0 };
+        cdf::parallel::parallel_for(threads_count,
+            [&](std::size_t)
+            {
+                for (auto i = next++; i < count; i = next++)
+                    function(i);
+            });
     }
 } // namespace
 
@@ -183,6 +229,7 @@ namespace
 [[nodiscard]] std::optional<CDF> load(
     const std::string& path, bool iso_8859_1_to_utf8 = true, bool lazy_load = true)
 {
+    CDFPP_TRACE_SCOPE("load", "load file", { "path", path });
     auto buffer = buffers::make_shared_file_adapter(path);
     if (buffer.is_valid())
     {
@@ -191,6 +238,63 @@ namespace
     return std::nullopt;
 }
 
+/*
+ * How load(path, ...) gets file bytes: memory_map maps the file and lets the OS fault pages in
+ * on access, async_reads reads descriptor records and then variable records extents on demand
+ * with many reads in flight which is much faster on cold caches and network file systems.
+ * memory_map_without_hints maps the file without the madvise hints of memory_map (see
+ * buffers::mmap_adapter), mostly to measure what they bring.
+ */
+enum class file_access
+{
+    memory_map,
+    memory_map_without_hints,
+    async_reads
+};
+
+[[nodiscard]] std::optional<CDF> load(const std::string& path, file_access access,
+    bool iso_8859_1_to_utf8 = true, bool lazy_load = true)
+{
+    if (access == file_access::memory_map)
+        return load(path, iso_8859_1_to_utf8, lazy_load);
+    if (access == file_access::memory_map_without_hints)
+    {
+        CDFPP_TRACE_SCOPE(
+            "load", "load file", { "path", path }, { "access", "memory_map_without_hints" });
+        auto buffer = buffers::make_shared_file_adapter(path, false);
+        if (buffer.is_valid())
+            return impl_load(std::move(buffer), iso_8859_1_to_utf8, lazy_load);
+        return std::nullopt;
+    }
+    CDFPP_TRACE_SCOPE("load", "load file", { "path", path }, { "access", "async_reads" });
+    auto buffer = buffers::make_shared_async_file_adapter(path);
+    if (buffer.is_valid())
+    {
+        return impl_load(std::move(buffer), iso_8859_1_to_utf8, lazy_load);
+    }
+    return std::nullopt;
+}
+
+/*
+ * Same as load(path, iso_8859_1_to_utf8, lazy_load), also accumulating into stats where the
+ * time went (see io_stats). With lazy_load values decoded later on are accounted for too, so
+ * stats must outlive the returned CDF.
+ */
+[[nodiscard]] std::optional<CDF> load(const std::string& path, io_stats& stats,
+    bool iso_8859_1_to_utf8 = true, bool lazy_load = true)
+{
+    CDFPP_TRACE_SCOPE("load", "load file", { "path", path });
+    const _details::page_faults_probe page_faults { stats };
+    const auto timer = with_stats_t { &stats }.time(io_phase::load);
+    auto buffer = buffers::make_shared_file_adapter(path);
+    if (buffer.is_valid())
+    {
+        stats.bytes_mapped.fetch_add(std::filesystem::file_size(path), std::memory_order_relaxed);
+        return impl_load(std::move(buffer), iso_8859_1_to_utf8, lazy_load, with_stats_t { &stats });
+    }
+    return std::nullopt;
+}
+
 [[nodiscard]] std::optional<CDF> load(
     const std::vector<char>& data, bool iso_8859_1_to_utf8 = true, bool lazy_load = false)
 {
@@ -222,4 +326,170 @@ namespace
     }
     return std::nullopt;
 }
+
+[[nodiscard]] std::optional<CDF> load(const char* data, std::size_t size, io_stats& stats,
+    bool iso_8859_1_to_utf8 = true, bool lazy_load = false)
+{
+    const _details::page_faults_probe page_faults { stats };
+    const auto timer = with_stats_t { &stats }.time(io_phase::load);
+    if (size != 0 && data != nullptr)
+    {
+        stats.bytes_mapped.fetch_add(size, std::memory_order_relaxed);
+        return impl_load(buffers::make_shared_array_adapter(data, size), iso_8859_1_to_utf8,
+            lazy_load, with_stats_t { &stats });
+    }
+    return std::nullopt;
+}
+
+/*
+ * Loads a file only reachable by ranges through read_function (see
+ * buffers::paged_reader_adapter), which must fill dest with size bytes read at offset and
+ * return false on failure. With lazy_load only descriptor records are read here, variable
+ * values are fetched on first access, so a file much larger than memory can be browsed.
+ */
+[[nodiscard]] std::optional<CDF> load(buffers::paged_reader_adapter::read_function_t read_function,
+    std::size_t size, bool iso_8859_1_to_utf8 = true, bool lazy_load = true)
+{
+    auto buffer = buffers::make_shared_paged_reader_adapter(std::move(read_function), size);
+    if (buffer.is_valid())
+    {
+        return impl_load(std::move(buffer), iso_8859_1_to_utf8, lazy_load);
+    }
+    return std::nullopt;
+}
+
+/*
+ * Loads the same variables from many files holding consecutive chunks of one product
+ * (daily files for instance) and concatenates them along records.
+ * Files are opened in parallel, then each variable gets a single buffer sized for the sum of
+ * all files records and every file decodes its records straight into its own slice of it.
+ * Global and variable attributes, as well as non record varying variables, come from the
+ * first file. Values are returned in row major order whatever the files majority.
+ * A sparse records variable keeps its mode (which must be the same in every file) and the
+ * present records of all files, each file fills its own missing records so with
+ * cdf_sparse_records::previous those leading a file hold pad values rather than the last
+ * record of the previous file. More than 2^32 - 1 records in total for one variable is
+ * rejected with std::invalid_argument, as is any type or shape mismatch.
+ * An empty variables list selects every variable of the first file. At most threads files
+ * are processed at once on the library thread pool, threads == 0 uses the whole pool (see
+ * cdf::parallel::set_num_threads).
+ */
+[[nodiscard]] std::optional<CDF> load_many(const std::vector<std::string>& paths,
+    const std::vector<std::string>& variables = {}, std::size_t threads = 0,
+    bool iso_8859_1_to_utf8 = true)
+{
+    if (std::size(paths) == 0)
+        return std::nullopt;
+    if (threads == 0)
+        threads = cdf::parallel::num_threads();
+    CDFPP_TRACE_SCOPE("load", "load_many", { "files", std::size(paths) });
+
+    std::vector<std::optional<CDF>> files(std::size(paths));
+    parallel_for(std::size(paths), threads,
+        [&](std::size_t i) { files[i] = load(paths[i], iso_8859_1_to_utf8, true); });
+    if (std::any_of(std::cbegin(files), std::cend(files),
+            [](const auto& f) { return not f.has_value(); }))
+        return std::nullopt;
+
+    const CDF& first = *files.front();
+    std::vector<std::string> names = variables;
+    if (std::size(names) == 0)
+    {
+        for (const auto& [name, _] : first.variables)
+            names.push_back(name);
+    }
+
+    CDF result;
+    result.distribution_version = first.distribution_version;
+    result.compression = first.compression;
+    result.attributes = first.attributes;
+
+    for (const auto& name : names)
+    {
+        const auto& reference = first[name];
+        std::size_t records = 0;
+        std::vector<record_range> present;
+        bool has_missing_records = false;
+        for (std::size_t i = 0; i < std::size(files); i++)
+        {
+            if (reference.is_nrv() and i != 0)
+                break;
+            const auto& var = (*files[i])[name];
+            if (var.type() != reference.type()
+                or not std::equal(std::cbegin(var.shape()) + 1, std::cend(var.shape()),
+                    std::cbegin(reference.shape()) + 1, std::cend(reference.shape())))
+                throw std::invalid_argument { fmt::format(
+                    "load_many: variable {} from {} doesn't match its type or shape in {}", name,
+                    paths[i], paths[0]) };
+            if (var.sparse_records() != reference.sparse_records())
+                throw std::invalid_argument { fmt::format(
+                    "load_many: variable {} from {} has {} sparse records, {} in {}", name,
+                    paths[i], cdf_sparse_records_str(var.sparse_records()),
+                    cdf_sparse_records_str(reference.sparse_records()), paths[0]) };
+            // present records of every file shifted to where the file lands, ranges touching
+            // across files are merged
+            const auto file_present = var.present_records();
+            for (const auto& range : file_present)
+            {
+                if (not std::empty(present) and present.back().stop == records + range.start)
+                    present.back().stop = records + range.stop;
+                else
+                    present.push_back({ records + range.start, records + range.stop });
+            }
+            has_missing_records |= var.len() != 0
+                and (std::size(file_present) != 1 or file_present.front().start != 0
+                    or file_present.front().stop != var.len());
+            records += var.len();
+        }
+        if (records > std::numeric_limits<uint32_t>::max())
+            throw std::invalid_argument { fmt::format(
+                "load_many: variable {} would have {} records, more than a CDF variable can hold",
+                name, records) };
+        auto shape = reference.shape();
+        shape[0] = static_cast<uint32_t>(records);
+        data_t data = new_data_container(
+            flat_size(shape) * cdf_type_size(reference.type()), reference.type());
+        result.variables[name] = Variable { name, reference.number(), std::move(data),
+            std::move(shape), cdf_majority::row, reference.is_nrv(), reference.compression_type(),
+            reference.is_zvariable() };
+        result.variables[name].attributes = reference.attributes;
+        result.variables[name].set_sparse_records(reference.sparse_records(),
+            has_missing_records ? std::optional { std::move(present) } : std::nullopt);
+    }
+
+    // all destination variables exist from here, references to them stay valid
+    struct slice_t
+    {
+        const Variable* source;
+        Variable* destination;
+        std::size_t first_record;
+    };
+    std::vector<std::vector<slice_t>> slices(std::size(files));
+    for (const auto& name : names)
+    {
+        auto& destination = result[name];
+        std::size_t first_record = 0;
+        for (std::size_t i = 0; i < std::size(files); i++)
+        {
+            if (destination.is_nrv() and i != 0)
+                break;
+            const auto& source = (*files[i])[name];
+            slices[i].push_back({ &source, &destination, first_record });
+            first_record += source.len();
+        }
+    }
+
+    parallel_for(std::size(files), threads,
+        [&](std::size_t i)
+        {
+            CDFPP_TRACE_SCOPE("load", "load_many concatenate", { "path", paths[i] });
+            for (const auto& slice : slices[i])
+            {
+                slice.source->read_records(slice.destination->bytes_ptr()
+                        + slice.first_record * slice.destination->record_bytes(),
+                    0, slice.source->len());
+            }
+        });
+    return result;
+}
 }
@@ -0,0 +1,153 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "./buffers.hpp"
+#include "cdfpp/no_init_vector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace cdf::io::buffers
+{
+
+/*
+ * Reads the file piecewise through a user provided function instead of holding it in memory,
+ * for sources only reachable by ranges (a browser File/Blob from WASM, an HTTP range server...)
+ * and files too large to be copied. Descriptor records are small and scattered but tend to
+ * share pages, so reads smaller than a page go through a small LRU page cache while larger
+ * ones (variable data) are fetched straight into their destination.
+ * The read function must fill dest with size bytes starting at offset and return false on
+ * failure, it may be called from several threads but never concurrently.
+ */
+struct paged_reader_adapter
+{
+    using implements_view = std::false_type;
+    using read_function_t
+        = std::function<bool(char* dest, std::size_t offset, std::size_t size)>;
+
+    paged_reader_adapter(read_function_t read_function, std::size_t size,
+        std::size_t page_size = 64 * 1024, std::size_t max_pages = 64)
+            : p_read { std::move(read_function) }
+            , p_size { size }
+            , p_page_size { std::max<std::size_t>(page_size, 16) }
+            , p_max_pages { std::max<std::size_t>(max_pages, 1) }
+    {
+    }
+
+    void read(char* dest, const std::size_t offset, const std::size_t size)
+    {
+        if (offset > p_size or size > p_size - offset)
+            throw std::out_of_range { fmt::format(
+                "Cannot read {} bytes at offset {} from a {} bytes file", size, offset, p_size) };
+        std::lock_guard lock { p_mutex };
+        if (size >= p_page_size)
+            return fetch(dest, offset, size);
+        for (std::size_t done = 0; done < size;)
+        {
+            const auto page_index = (offset + done) / p_page_size;
+            const auto page_offset = (offset + done) % p_page_size;
+            const auto count = std::min(size - done, p_page_size - page_offset);
+            std::memcpy(dest + done, page(page_index).data() + page_offset, count);
+            done += count;
+        }
+    }
+
+    // Ranges running past the end of the file (the last fixed size string field of a record
+    // written by a sloppy writer for instance) are zero padded.
+    no_init_vector<char> view(const std::size_t offset, const std::size_t size)
+    {
+        no_init_vector<char> bytes(size);
+        const auto available = offset < p_size ? std::min(size, p_size - offset) : 0UL;
+        read(bytes.data(), std::min(offset, p_size), available);
+        std::fill(bytes.data() + available, bytes.data() + size, '\0');
+        return bytes;
+    }
+
+    bool is_valid() const { return p_size != 0 and static_cast<bool>(p_read); }
+
+private:
+    struct page_t
+    {
+        std::size_t index;
+        std::size_t last_use;
+        no_init_vector<char> data;
+    };
+
+    void fetch(char* dest, const std::size_t offset, const std::size_t size)
+    {
+        if (size != 0 and not p_read(dest, offset, size))
+            throw std::runtime_error { fmt::format(
+                "Failed to read {} bytes at offset {}", size, offset) };
+    }
+
+    const no_init_vector<char>& page(const std::size_t index)
+    {
+        p_clock++;
+        auto it = std::find_if(std::begin(p_pages), std::end(p_pages),
+            [index](const page_t& p) { return p.index == index; });
+        if (it != std::end(p_pages))
+        {
+            it->last_use = p_clock;
+            return it->data;
+        }
+        const auto offset = index * p_page_size;
+        no_init_vector<char> data(std::min(p_page_size, p_size - offset));
+        fetch(data.data(), offset, std::size(data));
+        if (std::size(p_pages) < p_max_pages)
+            it = p_pages.insert(std::end(p_pages), page_t { index, p_clock, std::move(data) });
+        else
+        {
+            it = std::min_element(std::begin(p_pages), std::end(p_pages),
+                [](const page_t& a, const page_t& b) { return a.last_use < b.last_use; });
+            *it = page_t { index, p_clock, std::move(data) };
+        }
+        return it->data;
+    }
+
+    read_function_t p_read;
+    std::size_t p_size;
+    std::size_t p_page_size;
+    std::size_t p_max_pages;
+    std::vector<page_t> p_pages;
+    std::size_t p_clock = 0;
+    std::mutex p_mutex;
+};
+
+inline auto make_shared_paged_reader_adapter(paged_reader_adapter::read_function_t read_function,
+    std::size_t size, std::size_t page_size = 64 * 1024, std::size_t max_pages = 64)
+{
+    return shared_buffer_t(std::make_shared<paged_reader_adapter>(
+        std::move(read_function), size, page_size, max_pages));
+}
+
+}
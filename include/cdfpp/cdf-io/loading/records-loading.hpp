@@ -27,6 +27,7 @@
 
 #include "../desc-records.hpp"
 #include "../endianness.hpp"
+#include "../io-stats.hpp"
 #include "../reflection.hpp"
 #include "../special-fields.hpp"
 #include "./buffers.hpp"
@@ -37,7 +38,7 @@
 namespace cdf::io
 {
 
-template <typename buffer_t, typename version_t>
+template <typename buffer_t, typename version_t, typename stats_t = no_stats_t>
 struct parsing_context_t
 {
     inline static constexpr bool v3 = is_v3_v<version_t>;
@@ -47,9 +48,16 @@ struct parsing_context_t
     cdf_GDR_t<version_t> gdr;
     cdf_majority majority;
     cdf_compression_type compression_type;
-
-    parsing_context_t(buffer_t&& buff, cdf_compression_type compression_type)
-            : buffer { std::move(buff) }, cdr {}, gdr {}, compression_type { compression_type }
+    // see io-stats.hpp, no_stats_t takes no room
+    [[no_unique_address]] stats_t stats;
+
+    parsing_context_t(
+        buffer_t&& buff, cdf_compression_type compression_type, stats_t stats = {})
+            : buffer { std::move(buff) }
+            , cdr {}
+            , gdr {}
+            , compression_type { compression_type }
+            , stats { stats }
     {
     }
     inline cdf_encoding encoding() { return cdr.Encoding; }
@@ -67,13 +75,15 @@ inline std::size_t load_field(
 {
     if constexpr (is_string_field_v<T>)
     {
+        auto bytes = buffers::view(parsing_context, offset, T::max_len);
+        const char* str = buffers::get_data_ptr(bytes);
         std::size_t size = 0;
         for (; size < T::max_len; size++)
         {
-            if (buffers::get_data_ptr(parsing_context)[offset + size] == '\0')
+            if (str[size] == '\0')
                 break;
         }
-        field.value = std::string { buffers::get_data_ptr(parsing_context) + offset, size };
+        field.value = std::string { str, size };
         return offset + T::max_len;
     }
     else
@@ -84,8 +94,8 @@ inline std::size_t load_field(
             field.values.resize(bytes / sizeof(typename T::value_type));
             if (bytes > 0)
             {
-                std::memcpy(
-                    field.values.data(), buffers::get_data_ptr(parsing_context) + offset, bytes);
+                auto source = buffers::view(parsing_context, offset, bytes);
+                std::memcpy(field.values.data(), buffers::get_data_ptr(source), bytes);
                 cdf::endianness::decode_v<endianness::big_endian_t>(
                     field.values.data(), bytes / sizeof(typename T::value_type));
             }
@@ -93,8 +103,9 @@ inline std::size_t load_field(
         }
         else
         {
+            auto source = buffers::view(parsing_context, offset, sizeof(T));
             field = cdf::endianness::decode<endianness::big_endian_t, T>(
-                buffers::get_data_ptr(parsing_context) + offset);
+                buffers::get_data_ptr(source));
             return offset + sizeof(T);
         }
     }
@@ -133,7 +144,8 @@ inline std::size_t load_field(const cdf_rVDR_t<version_t>& r, parsing_context_t&
     field.values.resize(bytes / sizeof(typename T::value_type));
     if (bytes > 0)
     {
-        std::memcpy(field.values.data(), buffers::get_data_ptr(parsing_context) + offset, bytes);
+        auto source = buffers::view(parsing_context, offset, bytes);
+        std::memcpy(field.values.data(), buffers::get_data_ptr(source), bytes);
         cdf::endianness::decode_v<endianness::big_endian_t>(
             field.values.data(), bytes / sizeof(typename T::value_type));
     }
@@ -266,6 +278,8 @@ struct blk_iterator
     std::size_t wrapper_load(std::size_t offset, std::index_sequence<Is...>)
     {
         block.first = offset;
+        if constexpr (requires { parsing_context.stats; })
+            parsing_context.stats.parsed_records(1);
         return load_record(block.second, parsing_context, offset, std::get<Is>(load_opt_args)...);
     }
 
@@ -0,0 +1,172 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "../endianness.hpp"
+#include "./block-table.hpp"
+#include "cdfpp/cdf-enums.hpp"
+#include "cdfpp/no_init_vector.hpp"
+#include "cdfpp/variable.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace cdf::io::variable
+{
+
+/*
+ * Records of a sparse variable that no VVR/CVVR holds read back as one record of pad
+ * values, or as a copy of the last present record before them in previous mode.
+ * `pad_record` is kept in the file encoding so that missing records are filled before
+ * decoding, exactly like records read from the file.
+ */
+struct var_padding_t
+{
+    cdf_sparse_records mode = cdf_sparse_records::no_sparse;
+    no_init_vector<char> pad_record;
+};
+
+template <typename cdf_vdr_t>
+[[nodiscard]] cdf_sparse_records sparse_records_mode(const cdf_vdr_t& vdr) noexcept
+{
+    switch (vdr.SRecords)
+    {
+        case static_cast<int32_t>(cdf_sparse_records::pad):
+            return cdf_sparse_records::pad;
+        case static_cast<int32_t>(cdf_sparse_records::previous):
+            return cdf_sparse_records::previous;
+        default:
+            break;
+    }
+    return cdf_sparse_records::no_sparse;
+}
+
+// The VDR pad value when the variable has one, the CDF default one for its type otherwise,
+// repeated over a whole record.
+template <typename cdf_vdr_t>
+[[nodiscard]] var_padding_t make_padding(
+    const cdf_vdr_t& vdr, std::size_t record_size, cdf_encoding encoding)
+{
+    var_padding_t padding { sparse_records_mode(vdr), no_init_vector<char>(record_size) };
+    no_init_vector<char> value = vdr.PadValues.values;
+    if (std::empty(value) and vdr.DataType != CDF_Types::CDF_NONE)
+    {
+        cdf_type_dispatch(vdr.DataType,
+            [&]<CDF_Types t>()
+            {
+                auto pad = default_pad_value<t>();
+                // byte swapping is its own inverse, decoding to the file encoding encodes
+                if constexpr (not is_cdf_string_type(t))
+                {
+                    if (endianness::is_big_endian_encoding(encoding))
+                        endianness::decode_v<endianness::big_endian_t>(&pad, 1);
+                    else
+                        endianness::decode_v<endianness::little_endian_t>(&pad, 1);
+                }
+                value.resize(sizeof(pad));
+                std::memcpy(value.data(), &pad, sizeof(pad));
+            });
+    }
+    if (std::empty(value))
+        std::fill(std::begin(padding.pad_record), std::end(padding.pad_record), '\0');
+    else
+        for (std::size_t i = 0; i < record_size; i++)
+            padding.pad_record[i] = value[i % std::size(value)];
+    return padding;
+}
+
+// Records of [0, record_count) held by a block as merged ranges, nullopt when none is missing.
+[[nodiscard]] inline std::optional<std::vector<record_range>> present_records(
+    const var_block_table_t& table, std::size_t record_count)
+{
+    std::vector<record_range> ranges;
+    for (const auto& block : table)
+    {
+        const std::size_t start = block.first_record;
+        const std::size_t stop = std::min(block.last_record + std::size_t { 1 }, record_count);
+        if (start >= stop)
+            continue;
+        if (not std::empty(ranges) and start <= ranges.back().stop)
+            ranges.back().stop = std::max(ranges.back().stop, stop);
+        else
+            ranges.push_back({ start, stop });
+    }
+    if (record_count == 0
+        or (std::size(ranges) == 1 and ranges.front().start == 0
+            and ranges.front().stop == record_count))
+        return std::nullopt;
+    return ranges;
+}
+
+// Last record before `record` held by a block, previous mode repeats it over the gap.
+[[nodiscard]] inline std::optional<std::size_t> last_present_record(
+    const var_block_table_t& table, std::size_t record)
+{
+    auto it = std::partition_point(std::cbegin(table), std::cend(table),
+        [record](const var_block_t& b) { return b.first_record < record; });
+    if (it == std::cbegin(table))
+        return std::nullopt;
+    return std::min<std::size_t>(std::prev(it)->last_record, record - 1);
+}
+
+/*
+ * Fills the records of [first_record, last_record] that none of `range` (the blocks
+ * overlapping it, as given by blocks_in_range) holds. dest starts at first_record and
+ * already holds the present ones. In previous mode a gap at the very start of the range
+ * repeats previous_record, the last present record before the range, when there is one.
+ */
+inline void fill_missing_records(const var_padding_t& padding, std::span<const var_block_t> range,
+    std::size_t record_size, char* dest, std::size_t first_record, std::size_t last_record,
+    const char* previous_record = nullptr)
+{
+    const auto fill = [&](std::size_t from, std::size_t to)
+    {
+        char* out = dest + (from - first_record) * record_size;
+        const char* value = padding.pad_record.data();
+        if (padding.mode == cdf_sparse_records::previous)
+        {
+            if (from > first_record)
+                value = out - record_size;
+            else if (previous_record != nullptr)
+                value = previous_record;
+        }
+        for (; from < to; from++, out += record_size)
+            std::memcpy(out, value, record_size);
+    };
+    std::size_t next = first_record;
+    for (const auto& block : range)
+    {
+        if (block.first_record > next)
+            fill(next, block.first_record);
+        next = std::max(next, block.last_record + std::size_t { 1 });
+    }
+    if (next <= last_record)
+        fill(next, last_record + 1);
+}
+
+}
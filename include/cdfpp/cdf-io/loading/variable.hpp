@@ -27,13 +27,29 @@
 #include "../common.hpp"
 #include "../decompression.hpp"
 #include "../desc-records.hpp"
+#include "../io-stats.hpp"
+#include "./block-table.hpp"
+#include "./buffers.hpp"
 #include "./records-loading.hpp"
+#include "./sparse-records.hpp"
 #include "cdfpp/cdf-data.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+#include "cdfpp/cdf-trace.hpp"
 #include "cdfpp/no_init_vector.hpp"
 #include "cdfpp/variable.hpp"
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
 
 namespace cdf::io::variable
 {
@@ -100,198 +116,356 @@ namespace
     }
 
 
-    template <typename cdf_version_tag_t, typename buffer_t>
-    inline void load_vvr_data(buffer_t& stream, std::size_t offset, std::size_t size,
-        const cdf_VVR_t<cdf_version_tag_t>& vvr, char* const data)
-    {
-        stream.read(
-            data, offset + sizeof(vvr.header.record_size) + sizeof(vvr.header.record_type), size);
-    }
-
-    template <typename cdf_version_tag_t, typename buffer_t>
-    inline void load_vvr_data(buffer_t& stream, std::size_t offset,
-        const cdf_VVR_t<cdf_version_tag_t>& vvr, const std::size_t vvr_records_count,
-        const std::size_t record_size, std::size_t& pos, char* data, std::size_t data_len)
+    // Flags the file extents about to be read so the kernel can start fetching them all
+    // before decoding begins (a no-op for in-memory buffers).
+    template <typename stream_t>
+    inline void prefetch_extent(stream_t& stream, std::size_t offset, std::size_t size)
     {
-        std::size_t vvr_data_size
-            = std::min(static_cast<std::size_t>(vvr_records_count * record_size),
-                static_cast<std::size_t>(data_len - pos));
-        load_vvr_data<cdf_version_tag_t>(stream, offset, vvr_data_size, vvr, data + pos);
-        pos += vvr_data_size;
+        buffers::advise(stream, offset, size, buffers::access_pattern::sequential);
+        buffers::advise(stream, offset, size, buffers::access_pattern::will_need);
     }
 
-
-    template <typename cdf_version_tag_t, typename buffer_t>
-    inline void load_cvvr_data(const cdf_CVVR_t<cdf_version_tag_t>& cvvr, std::size_t& pos,
-        const cdf_compression_type compression_type, char* data, std::size_t data_len)
+    // Announces the extents holding records [first_record, last_record] of range to the
+    // stream, except the block cursor already holds decompressed.
+    template <typename stream_t>
+    inline void prefetch_records(stream_t& stream, std::span<const var_block_t> range,
+        const std::size_t record_size, const std::size_t first_record,
+        const std::size_t last_record, const records_cursor* cursor)
     {
-        pos += decompression::inflate(
-            compression_type, cvvr.data.values, data + pos, data_len - pos);
+        for (const auto& block : range)
+        {
+            if (block.is_compressed())
+            {
+                if (cursor == nullptr or cursor->block_offset != block.offset)
+                    prefetch_extent(stream, block.offset, block.compressed_size);
+            }
+            else
+            {
+                const std::size_t from = std::max<std::size_t>(block.first_record, first_record);
+                const std::size_t to = std::min<std::size_t>(block.last_record, last_record);
+                prefetch_extent(stream, block.offset + (from - block.first_record) * record_size,
+                    (to - from + 1) * record_size);
+            }
+        }
     }
 
-    template <typename cdf_version_tag_t, typename stream_t>
-    void load_var_data(stream_t& stream, char* data, std::size_t data_len, std::size_t& pos,
-        const cdf_VXR_t<cdf_version_tag_t>& vxr, std::size_t record_size,
-        const cdf_compression_type compression_type)
+    // Decodes records [first_record, first_record + records_count) into dest, only touching
+    // the blocks overlapping that range. A CVVR partially covered by the range goes through
+    // a scratch buffer since a compressed stream can't be entered midway, with a cursor the
+    // one running past the range is kept there for the next call. Records no block holds
+    // are filled from padding, which is null when the variable has none missing.
+    // variable_name only labels trace events (see cdf-trace.hpp).
+    template <typename stream_t, typename stats_t = no_stats_t>
+    void load_var_records(stream_t& stream, const var_block_table_t& blocks,
+        const std::size_t record_size, const cdf_compression_type compression_type,
+        const var_padding_t* padding, char* dest, const std::size_t first_record,
+        const std::size_t records_count, [[maybe_unused]] std::string_view variable_name = {},
+        stats_t stats = {}, records_cursor* cursor = nullptr)
     {
-        for (auto i = 0UL; i < vxr.NusedEntries; i++)
+        if (records_count == 0)
+            return;
+        const std::size_t last_record = first_record + records_count - 1;
+        const auto range = blocks_in_range(
+            blocks, static_cast<uint32_t>(first_record), static_cast<uint32_t>(last_record));
+        prefetch_records(stream, range, record_size, first_record, last_record, cursor);
+        // block_cursor is only given for the blocks run outside of the thread pool
+        const auto load_block = [&](const var_block_t& block, records_cursor* block_cursor)
         {
-            int record_count = vxr.Last.values[i] - vxr.First.values[i] + 1;
-
-            if (cdf_mutable_variable_record_t<cdf_version_tag_t> cvvr_or_vvr {};
-                load_mut_record(cvvr_or_vvr, stream, vxr.Offset.values[i]))
+            const std::size_t from = std::max<std::size_t>(block.first_record, first_record);
+            const std::size_t to = std::min<std::size_t>(block.last_record, last_record);
+            const std::size_t skip = (from - block.first_record) * record_size;
+            const std::size_t len = (to - from + 1) * record_size;
+            char* out = dest + (from - first_record) * record_size;
+            CDFPP_TRACE_SCOPE("load", block.is_compressed() ? "CVVR" : "VVR",
+                { "variable", variable_name }, { "offset", block.offset },
+                { "bytes", block.compressed_size }, { "first_record", from },
+                { "last_record", to });
+            if (block.is_compressed()
+                and (block_cursor != nullptr and block_cursor->block_offset == block.offset))
             {
-                using vvr_t = typename decltype(cvvr_or_vvr)::vvr_t;
-                using vxr_t = typename decltype(cvvr_or_vvr)::vxr_t;
-                using cvvr_t = typename decltype(cvvr_or_vvr)::cvvr_t;
-
-                cvvr_or_vvr.visit(
-                    [&stream, &data, data_len, &pos, record_count, record_size,
-                        offset = vxr.Offset.values[i]](const vvr_t& vvr) -> void
-                    {
-                        load_vvr_data<cdf_version_tag_t, stream_t>(
-                            stream, offset, vvr, record_count, record_size, pos, data, data_len);
-                    },
-                    [&stream, &data, data_len, &pos, record_size, compression_type](
-                        vxr_t vxr) -> void
-                    {
-                        load_var_data<cdf_version_tag_t, stream_t>(
-                            stream, data, data_len, pos, vxr, record_size, compression_type);
-                        while (vxr.VXRnext)
-                        {
-                            load_record(vxr, stream, vxr.VXRnext);
-                            load_var_data<cdf_version_tag_t, stream_t>(
-                                stream, data, data_len, pos, vxr, record_size, compression_type);
-                        }
-                    },
-                    [&stream, &data, data_len, &pos, record_count, record_size, compression_type](
-                        const cvvr_t& cvvr) -> void {
-                        load_cvvr_data<cdf_version_tag_t, stream_t>(
-                            cvvr, pos, compression_type, data, data_len);
-                    },
-                    [](const std::monostate&) -> void {
-                        throw std::runtime_error {
-                            "Error loading variable data expecting VVR, CVVR or VXR"
-                        };
-                    });
+                std::memcpy(out, block_cursor->block.data() + skip, len);
             }
+            else if (block.is_compressed())
+            {
+                const auto timer = stats.time(io_phase::inflate);
+                auto compressed = buffers::view(stream, block.offset, block.compressed_size);
+                const std::span<const char> payload(
+                    buffers::get_data_ptr(compressed), block.compressed_size);
+                // codecs stop at the end of output (libdeflate doesn't even fill it), so a
+                // block is always inflated whole and anything short of it is an error
+                const auto inflate = [&](char* output, std::size_t size)
+                {
+                    if (decompression::inflate(compression_type, payload, output, size) != size)
+                        throw std::runtime_error { fmt::format(
+                            "Error loading variable data: the CVVR at offset {} doesn't "
+                            "inflate to {} bytes",
+                            block.offset, size) };
+                };
+                const std::size_t inflated = block.records_count() * record_size;
+                if (skip == 0 and to == block.last_record)
+                {
+                    inflate(out, len);
+                }
+                else if (block_cursor != nullptr and block.last_record > last_record)
+                {
+                    block_cursor->block_offset = static_cast<std::size_t>(-1);
+                    block_cursor->block.resize(inflated);
+                    inflate(block_cursor->block.data(), inflated);
+                    block_cursor->block_offset = block.offset;
+                    std::memcpy(out, block_cursor->block.data() + skip, len);
+                }
+                else
+                {
+                    no_init_vector<char> scratch(inflated);
+                    inflate(scratch.data(), inflated);
+                    std::memcpy(out, scratch.data() + skip, len);
+                }
+                stats.values_record(block.compressed_size);
+                stats.codec(compression_type, block.compressed_size, inflated);
+            }
+            else if (skip < block.compressed_size)
+            {
+                const auto timer = stats.time(io_phase::read);
+                const auto size = std::min(len, block.compressed_size - skip);
+                stream.read(out, block.offset + skip, size);
+                stats.values_record(size);
+            }
+        };
+        const auto fill_missing = [&]()
+        {
+            if (padding == nullptr)
+                return;
+            CDFPP_TRACE_SCOPE("load", "pad records", { "variable", variable_name },
+                { "first_record", first_record }, { "last_record", last_record });
+            no_init_vector<char> previous;
+            if (padding->mode == cdf_sparse_records::previous and first_record > 0
+                and (std::empty(range) or range.front().first_record > first_record))
+            {
+                if (const auto record = last_present_record(blocks, first_record))
+                {
+                    previous.resize(record_size);
+                    load_var_records(stream, blocks, record_size, compression_type, padding,
+                        previous.data(), *record, 1, variable_name, stats);
+                }
+            }
+            fill_missing_records(*padding, range, record_size, dest, first_record, last_record,
+                std::empty(previous) ? nullptr : previous.data());
+        };
+        // The block the cursor holds can only be the first one and the one replacing it the
+        // last one, both are sliced off and run here so that pooled tasks never touch the
+        // cursor.
+        auto pending = range;
+        if (cursor != nullptr and not std::empty(pending)
+            and pending.front().offset == cursor->block_offset)
+        {
+            load_block(pending.front(), cursor);
+            pending = pending.subspan(1);
+        }
+        std::optional<var_block_t> refills_cursor;
+        if (cursor != nullptr and not std::empty(pending) and pending.back().is_compressed()
+            and pending.back().last_record > last_record)
+        {
+            refills_cursor = pending.back();
+            pending = pending.first(std::size(pending) - 1);
         }
+        // CVVRs inflate independently into disjoint slices of dest, so once there is enough
+        // of them they are spread over the library thread pool (small ones don't even
+        // instantiate it).
+        bool pooled = false;
+        if constexpr (buffers::concurrent_reads_v<stream_t>)
+        {
+            const auto compressed_bytes
+                = std::accumulate(std::cbegin(pending), std::cend(pending), std::size_t { 0 },
+                    [](std::size_t total, const var_block_t& block)
+                    { return total + (block.is_compressed() ? block.compressed_size : 0); });
+            if (std::size(pending) > 1 and compressed_bytes >= parallel::min_chunk_size())
+            {
+                parallel::parallel_for(std::size(pending),
+                    [&](std::size_t index) { load_block(pending[index], nullptr); });
+                pooled = true;
+            }
+        }
+        if (not pooled)
+        {
+            for (const auto& block : pending)
+                load_block(block, nullptr);
+        }
+        if (refills_cursor)
+            load_block(*refills_cursor, cursor);
+        fill_missing();
     }
 
-    template <typename VDR_t, typename stream_t>
-    data_t load_var_data(stream_t& stream, const VDR_t& vdr, const std::size_t record_size,
-        const uint32_t record_count, const cdf_compression_type compression_type)
+    template <typename stream_t, typename stats_t = no_stats_t>
+    data_t load_var_data(stream_t& stream, const var_block_table_t& blocks, CDF_Types type,
+        const std::size_t record_size, const uint32_t record_count,
+        const cdf_compression_type compression_type, const var_padding_t* padding,
+        std::string_view variable_name = {}, stats_t stats = {})
     {
         data_t data = new_data_container(
-            static_cast<std::size_t>(record_count) * static_cast<std::size_t>(record_size),
-            vdr.DataType);
-        std::size_t pos { 0UL };
-        cdf_VXR_t<typename VDR_t::cdf_version_t> vxr;
+            static_cast<std::size_t>(record_count) * static_cast<std::size_t>(record_size), type);
+        load_var_records(stream, blocks, record_size, compression_type, padding,
+            data.bytes_ptr(), 0, record_count, variable_name, stats);
+        return data;
+    }
 
-        if (vdr.VXRhead != 0 && load_record(vxr, stream, vdr.VXRhead))
-        {
-            load_var_data(stream, data.bytes_ptr(), static_cast<std::size_t>(record_count) * record_size, pos, vxr,
-                record_size, compression_type);
-            if (vxr.VXRnext)
+    inline void decode_records(
+        char* data, std::size_t bytes, CDF_Types type, cdf_encoding encoding)
+    {
+        if (type == CDF_Types::CDF_NONE or bytes == 0)
+            return;
+        cdf_type_dispatch(type,
+            [&]<CDF_Types t>()
             {
-                do
+                if constexpr (not is_cdf_string_type(t))
                 {
-                    if (load_record(vxr, stream, vxr.VXRnext))
-                    {
-                        load_var_data(stream, data.bytes_ptr(), static_cast<std::size_t>(record_count) * record_size, pos,
-                            vxr, record_size, compression_type);
-                    }
+                    using value_t = from_cdf_type_t<t>;
+                    auto values = reinterpret_cast<value_t*>(data);
+                    if (endianness::is_big_endian_encoding(encoding))
+                        endianness::decode_v<endianness::big_endian_t>(
+                            values, bytes / sizeof(value_t));
                     else
-                    {
-                        throw std::runtime_error { "Failed to read vxr" };
-                    }
-                } while (vxr.VXRnext != 0);
-            }
-        }
-        return data;
+                        endianness::decode_v<endianness::little_endian_t>(
+                            values, bytes / sizeof(value_t));
+                }
+            });
     }
 
-
-    template <typename cdf_version_tag_t, typename stream_t>
-    void count_blocks_in_vxr(stream_t& stream, const cdf_VXR_t<cdf_version_tag_t>& vxr,
-        std::size_t& count, std::size_t limit)
+    // Variable name kept by the deferred loaders below only to label trace events, it holds
+    // nothing without CDFpp_WITH_TRACING.
+    struct trace_label_t
     {
-        for (auto i = 0UL; i < vxr.NusedEntries && count < limit; i++)
+        explicit trace_label_t([[maybe_unused]] std::string_view name)
+#ifdef CDFpp_WITH_TRACING
+                : p_name { name }
+#endif
         {
-            if (cdf_mutable_variable_record_t<cdf_version_tag_t> rec {};
-                load_mut_record(rec, stream, vxr.Offset.values[i]))
-            {
-                using vvr_t = typename decltype(rec)::vvr_t;
-                using vxr_t = typename decltype(rec)::vxr_t;
-                using cvvr_t = typename decltype(rec)::cvvr_t;
-                rec.visit([&count](const vvr_t&) -> void { ++count; },
-                    [&stream, &count, limit](vxr_t sub) -> void
-                    {
-                        count_blocks_in_vxr<cdf_version_tag_t>(stream, sub, count, limit);
-                        while (sub.VXRnext && count < limit)
-                        {
-                            load_record(sub, stream, sub.VXRnext);
-                            count_blocks_in_vxr<cdf_version_tag_t>(stream, sub, count, limit);
-                        }
-                    },
-                    [&count](const cvvr_t&) -> void { ++count; },
-                    [](const std::monostate&) -> void {});
-            }
         }
-    }
 
-    // Counts the leaf VVR/CVVR blocks reachable from a variable's VXR head, stopping
-    // early once `limit` is reached (callers only need contiguous ⟺ count <= 1). Reads
-    // index records only — no variable data — so it is cheap and works in lazy mode.
-    template <typename cdf_version_tag_t, typename stream_t>
-    std::size_t count_var_blocks(stream_t stream, std::size_t vxr_head, std::size_t limit = 2)
+        [[nodiscard]] std::string_view view() const noexcept
+        {
+#ifdef CDFpp_WITH_TRACING
+            return p_name;
+#else
+            return {};
+#endif
+        }
+
+#ifdef CDFpp_WITH_TRACING
+    private:
+        std::string p_name;
+#endif
+    };
+
+    // Values decoded later on by lazily loaded variables are accounted for in the stats
+    // they were opened with (see io_stats).
+    template <typename stream_t, typename stats_t = no_stats_t>
+    struct defered_records_reader
     {
-        std::size_t count = 0UL;
-        if (vxr_head != 0)
+        defered_records_reader(stream_t stream, cdf_encoding encoding,
+            std::shared_ptr<const var_block_table_t> blocks,
+            std::shared_ptr<const var_padding_t> padding, CDF_Types type,
+            std::size_t record_size, cdf_compression_type compression, std::string_view name,
+            stats_t stats = {})
+                : p_stream { stream }
+                , p_encoding { encoding }
+                , p_blocks { std::move(blocks) }
+                , p_padding { std::move(padding) }
+                , p_type { type }
+                , p_record_size { record_size }
+                , p_compression { compression }
+                , p_name { name }
+                , p_stats { stats }
         {
-            cdf_VXR_t<cdf_version_tag_t> vxr;
-            if (load_record(vxr, stream, vxr_head))
+        }
+
+        inline void operator()(char* dest, std::size_t first_record, std::size_t records_count,
+            records_cursor* cursor)
+        {
+            CDFPP_TRACE_SCOPE("load", "read records", { "variable", this->p_name.view() },
+                { "first_record", first_record }, { "records", records_count });
+            load_var_records(this->p_stream, *this->p_blocks, this->p_record_size,
+                this->p_compression, this->p_padding.get(), dest, first_record, records_count,
+                this->p_name.view(), this->p_stats, cursor);
             {
-                count_blocks_in_vxr<cdf_version_tag_t>(stream, vxr, count, limit);
-                while (vxr.VXRnext && count < limit)
-                {
-                    load_record(vxr, stream, vxr.VXRnext);
-                    count_blocks_in_vxr<cdf_version_tag_t>(stream, vxr, count, limit);
-                }
+                const auto timer = this->p_stats.time(io_phase::byte_swap,
+                    endianness::is_big_endian_encoding(this->p_encoding) != host_is_big_endian);
+                decode_records(
+                    dest, records_count * this->p_record_size, this->p_type, this->p_encoding);
+            }
+            if (cursor != nullptr and cursor->readahead != 0)
+            {
+                const auto first = first_record + records_count;
+                const auto last = std::min<std::size_t>(
+                    first + cursor->readahead - 1, std::numeric_limits<uint32_t>::max());
+                if (first <= last)
+                    prefetch_records(this->p_stream,
+                        blocks_in_range(*this->p_blocks, static_cast<uint32_t>(first),
+                            static_cast<uint32_t>(last)),
+                        this->p_record_size, first, last, cursor);
             }
         }
-        return count;
-    }
 
-    template <bool iso_8859_1_to_utf8, typename stream_t, typename VDR_t>
+    private:
+        stream_t p_stream;
+        cdf_encoding p_encoding;
+        std::shared_ptr<const var_block_table_t> p_blocks;
+        std::shared_ptr<const var_padding_t> p_padding;
+        CDF_Types p_type;
+        std::size_t p_record_size;
+        cdf_compression_type p_compression;
+        [[no_unique_address]] trace_label_t p_name;
+        [[no_unique_address]] stats_t p_stats;
+    };
+
+    template <bool iso_8859_1_to_utf8, typename stream_t, typename stats_t = no_stats_t>
     struct defered_variable_loader
     {
-        defered_variable_loader(stream_t stream, cdf_encoding encoding, VDR_t vdr,
-            uint32_t record_count, std::size_t record_size, cdf_compression_type compression)
+        defered_variable_loader(stream_t stream, cdf_encoding encoding,
+            std::shared_ptr<const var_block_table_t> blocks,
+            std::shared_ptr<const var_padding_t> padding, CDF_Types type, uint32_t record_count,
+            std::size_t record_size, cdf_compression_type compression, std::string_view name,
+            stats_t stats = {})
                 : p_stream { stream }
                 , p_encoding { encoding }
-                , p_vdr { vdr }
+                , p_blocks { std::move(blocks) }
+                , p_padding { std::move(padding) }
+                , p_type { type }
                 , p_record_count { record_count }
                 , p_record_size { record_size }
                 , p_compression { compression }
+                , p_name { name }
+                , p_stats { stats }
         {
         }
 
         inline data_t operator()()
         {
-            return load_values<iso_8859_1_to_utf8>(
-                load_var_data(this->p_stream, this->p_vdr, this->p_record_size,
-                    this->p_record_count, p_compression),
-                this->p_encoding);
+            CDFPP_TRACE_SCOPE("load", "variable", { "name", this->p_name.view() },
+                { "lazy", true }, { "records", this->p_record_count });
+            auto data = load_var_data(this->p_stream, *this->p_blocks, this->p_type,
+                this->p_record_size, this->p_record_count, p_compression, this->p_padding.get(),
+                this->p_name.view(), this->p_stats);
+            CDFPP_TRACE_SCOPE("load", "decode", { "variable", this->p_name.view() });
+            const bool is_string
+                = this->p_type == CDF_Types::CDF_CHAR or this->p_type == CDF_Types::CDF_UCHAR;
+            const bool swaps_bytes
+                = endianness::is_big_endian_encoding(this->p_encoding) != host_is_big_endian;
+            const auto timer = is_string ? this->p_stats.time(io_phase::utf8, iso_8859_1_to_utf8)
+                                         : this->p_stats.time(io_phase::byte_swap, swaps_bytes);
+            return load_values<iso_8859_1_to_utf8>(std::move(data), this->p_encoding);
         }
 
     private:
         stream_t p_stream;
         cdf_encoding p_encoding;
-        VDR_t p_vdr;
+        std::shared_ptr<const var_block_table_t> p_blocks;
+        std::shared_ptr<const var_padding_t> p_padding;
+        CDF_Types p_type;
         uint32_t p_record_count;
         std::size_t p_record_size;
         cdf_compression_type p_compression;
+        [[no_unique_address]] trace_label_t p_name;
+        [[no_unique_address]] stats_t p_stats;
     };
 
     template <cdf_r_z type, typename cdf_version_tag_t, bool iso_8859_1_to_utf8, typename context_t>
@@ -302,6 +476,9 @@ namespace
             {
                 const auto& [offset, vdr] = blk;
                 {
+                    CDFPP_TRACE_SCOPE("load", "variable", { "name", vdr.Name.value },
+                        { "vdr_offset", offset }, { "lazy", lazy_load });
+                    auto timer = context.stats.time(io_phase::descriptors);
                     auto shape = get_variable_dimensions<type>(vdr, context);
                     const std::size_t record_size = var_record_size(shape, vdr.DataType);
                     const auto is_nrv = common::is_nrv(vdr);
@@ -332,30 +509,64 @@ namespace
                     shape.insert(std::cbegin(shape), record_count);
                     /*}*/
                     constexpr bool is_zvariable = (type == cdf_r_z::z);
-                    auto block_counter
-                        = [buffer = context.buffer,
-                              vxr_head = static_cast<std::size_t>(vdr.VXRhead)]() -> std::size_t
-                    { return count_var_blocks<cdf_version_tag_t>(buffer, vxr_head); };
+                    auto blocks = std::make_shared<const var_block_table_t>(
+                        make_block_table<cdf_version_tag_t>(
+                            context.buffer, static_cast<std::size_t>(vdr.VXRhead)));
+                    auto block_counter = [blocks]() -> std::size_t { return std::size(*blocks); };
+                    // sparse variables, the pad record is only built when some are missing
+                    const auto sparse_records = sparse_records_mode(vdr);
+                    auto present = present_records(*blocks, record_count);
+                    std::shared_ptr<const var_padding_t> padding;
+                    if (present.has_value())
+                        padding = std::make_shared<const var_padding_t>(
+                            make_padding(vdr, record_size, context.encoding()));
+                    timer.stop();
                     if (lazy_load)
                     {
+                        // strings may grow when converted to UTF-8, those are only loaded whole
+                        lazy_data::records_reader_t reader;
+                        if (not iso_8859_1_to_utf8 or (vdr.DataType != CDF_Types::CDF_CHAR
+                                                        and vdr.DataType != CDF_Types::CDF_UCHAR))
+                            reader = defered_records_reader<decltype(context.buffer),
+                                decltype(context.stats)> { context.buffer, context.encoding(),
+                                blocks, padding, vdr.DataType, record_size, compression_type,
+                                vdr.Name.value, context.stats };
                         common::add_lazy_variable(cdf, vdr.Name.value, vdr.Num,
                             lazy_data { defered_variable_loader<iso_8859_1_to_utf8,
-                                            decltype(context.buffer), decltype(vdr)> {
-                                            context.buffer, context.encoding(), vdr, record_count,
-                                            record_size, compression_type },
-                                vdr.DataType },
+                                            decltype(context.buffer), decltype(context.stats)> {
+                                            context.buffer, context.encoding(), blocks, padding,
+                                            vdr.DataType, record_count, record_size,
+                                            compression_type, vdr.Name.value, context.stats },
+                                vdr.DataType, std::move(reader) },
                             std::move(shape), is_nrv, compression_type, is_zvariable,
-                            std::move(block_counter));
+                            std::move(block_counter), sparse_records, std::move(present));
                     }
                     else
                     {
-                        common::add_variable(cdf, vdr.Name.value, vdr.Num,
-                            load_values<iso_8859_1_to_utf8>(
-                                load_var_data(context.buffer, vdr, record_size, record_count,
-                                    compression_type),
-                                context.encoding()),
+                        auto data = load_var_data(context.buffer, *blocks, vdr.DataType,
+                            record_size, record_count, compression_type, padding.get(),
+                            vdr.Name.value, context.stats);
+                        {
+                            CDFPP_TRACE_SCOPE("load", "decode", { "variable", vdr.Name.value });
+                            const bool is_string = vdr.DataType == CDF_Types::CDF_CHAR
+                                or vdr.DataType == CDF_Types::CDF_UCHAR;
+                            const bool swaps_bytes
+                                = endianness::is_big_endian_encoding(context.encoding())
+                                != host_is_big_endian;
+                            const auto decode_timer = is_string
+                                ? context.stats.time(io_phase::utf8, iso_8859_1_to_utf8)
+                                : context.stats.time(io_phase::byte_swap, swaps_bytes);
+                            data = load_values<iso_8859_1_to_utf8>(
+                                std::move(data), context.encoding());
+                        }
+                        // column major values are swapped to row major by Variable
+                        CDFPP_TRACE_SCOPE("load", "add variable", { "name", vdr.Name.value },
+                            { "column_major", cdf.majority == cdf_majority::column });
+                        const auto swap_timer = context.stats.time(
+                            io_phase::majority_swap, cdf.majority == cdf_majority::column);
+                        common::add_variable(cdf, vdr.Name.value, vdr.Num, std::move(data),
                             std::move(shape), is_nrv, compression_type, is_zvariable,
-                            std::move(block_counter));
+                            std::move(block_counter), sparse_records, std::move(present));
                     }
                 }
             });
@@ -118,10 +118,10 @@ namespace _private
     auto generate_access_pattern(const std::vector<std::size_t>& record_shape)
     {
         const auto record_size = std::accumulate(std::cbegin(record_shape), std::cend(record_shape),
-            1UL, std::multiplies<std::size_t>());
+            std::size_t { 1 }, std::multiplies<std::size_t>());
         std::vector<index_swap_pair> access_patern(record_size);
         std::vector<std::size_t> nd_index(std::size(record_shape));
-        for (auto index = 0UL; index < record_size; index++)
+        for (std::size_t index = 0; index < record_size; index++)
         {
             auto reversed_flat_index = inverted_flat_index(nd_index, record_shape);
             access_patern[index] = { index, reversed_flat_index };
@@ -151,8 +151,8 @@ void swap(data_t& data, const shape_t& shape)
         const auto elements_per_record = std::size(access_patern);
         const auto bytes_per_record = elements_per_record
             * (is_string ? shape.back() : sizeof(typename data_t::value_type));
-        auto offset = 0UL;
-        for (auto record = 0UL; record < records_count; record++)
+        std::size_t offset = 0;
+        for (std::size_t record = 0; record < records_count; record++)
         {
             for (const auto& swap_pair : access_patern)
             {
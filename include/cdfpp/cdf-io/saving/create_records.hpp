@@ -27,9 +27,12 @@
 
 #include "../compression.hpp"
 #include "../desc-records.hpp"
+#include "../io-stats.hpp"
 #include "./records-saving.hpp"
 #include "cdfpp/cdf-enums.hpp"
 #include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+#include "cdfpp/cdf-trace.hpp"
 #include "cdfpp/no_init_vector.hpp"
 #include <algorithm>
 #include <fstream>
@@ -207,8 +210,25 @@ namespace saving
         }
     }
 
-    inline void create_variables_records(const CDF& cdf, saving_context& svg_ctx)
+    // Uncompressed VVRs are limited to 1GB (an arbitrary decision), compressed ones to a few
+    // MB so that both saving and loading can deflate/inflate them in parallel.
+    inline constexpr std::size_t max_vvr_bytes = 1 << 30;
+    inline constexpr std::size_t max_cvvr_bytes = 4 << 20;
+
+    struct pending_cvvr
+    {
+        std::size_t variable;
+        std::size_t index;
+        std::size_t records;
+        std::size_t record_size;
+        std::size_t first_record;
+    };
+
+    template <typename stats_t = no_stats_t>
+    void create_variables_records(
+        const CDF& cdf, saving_context& svg_ctx, stats_t stats = {})
     {
+        std::vector<pending_cvvr> pending;
         for (const auto& [name, variable] : cdf.variables)
         {
             int32_t index = std::size(svg_ctx.body.variables);
@@ -257,16 +277,28 @@ namespace saving
                           flat_size(std::cbegin(variable.shape()) + 1, std::cend(variable.shape())))
                     * cdf_type_size(variable.type());
                 {
+                    const bool compressed
+                        = variable.compression_type() != cdf_compression_type::no_compression;
+                    const auto max_records = std::max(std::size_t { 1 },
+                        (compressed ? max_cvvr_bytes : max_vvr_bytes) / var_record_size);
                     auto records = variable.len();
                     auto first_record = 0;
                     while (records > 0)
                     {
-                        // this is an arbitrary decision to limit VVRs to 1GB
                         auto records_in_vvr
-                            = std::min(static_cast<std::size_t>((1 << 30) / var_record_size),
-                                static_cast<std::size_t>(records));
-                        var_ctx.values_records.emplace_back(make_values_record(
-                            variable, records_in_vvr, var_record_size, first_record));
+                            = std::min(max_records, static_cast<std::size_t>(records));
+                        if (compressed)
+                        {
+                            // deflated once every variable is laid out, see below
+                            pending.push_back({ std::size(svg_ctx.body.variables) - 1,
+                                std::size(var_ctx.values_records), records_in_vvr,
+                                var_record_size, static_cast<std::size_t>(first_record) });
+                            var_ctx.values_records.emplace_back(
+                                record_wrapper<cdf_CVVR_t<v3x_tag>> {});
+                        }
+                        else
+                            var_ctx.values_records.emplace_back(make_values_record(
+                                variable, records_in_vvr, var_record_size, first_record));
                         vxr.record.First.values.push_back(first_record);
                         vxr.record.Last.values.push_back(first_record + records_in_vvr - 1);
                         first_record += records_in_vvr;
@@ -280,6 +312,67 @@ namespace saving
             }
             create_variable_attributes_records(var_ctx, svg_ctx);
         }
+        // CVVRs deflate independently, enough of them are spread over the library thread pool
+        const auto deflate = [&pending, &svg_ctx, stats](std::size_t index)
+        {
+            const auto timer = stats.time(io_phase::deflate);
+            const auto& cvvr = pending[index];
+            auto& var_ctx = svg_ctx.body.variables[cvvr.variable];
+            CDFPP_TRACE_SCOPE("save", "CVVR", { "variable", var_ctx.variable->name() },
+                { "first_record", cvvr.first_record }, { "records", cvvr.records });
+            auto& record = var_ctx.values_records[cvvr.index];
+            record = make_values_record(
+                *var_ctx.variable, cvvr.records, cvvr.record_size, cvvr.first_record);
+            if constexpr (stats_t::enabled)
+            {
+                const auto compressed_size
+                    = std::get<record_wrapper<cdf_CVVR_t<v3x_tag>>>(record).record.cSize;
+                stats.values_record(compressed_size);
+                stats.codec(
+                    var_ctx.compression, compressed_size, cvvr.records * cvvr.record_size);
+            }
+        };
+        const auto pending_bytes = std::accumulate(std::cbegin(pending), std::cend(pending),
+            std::size_t { 0 }, [](std::size_t total, const auto& item)
+            { return total + item.records * item.record_size; });
+        if (std::size(pending) > 1 and pending_bytes >= parallel::min_chunk_size())
+            parallel::parallel_for(std::size(pending), deflate);
+        else
+            for (std::size_t index = 0; index < std::size(pending); index++)
+                deflate(index);
+    }
+
+    // Stores the records of a variable as one VVR/CVVR per range instead of the default split
+    // made by create_variables_records. The variable values hold the records of the ranges one
+    // range after the other, ranges leaving records out make a sparse records variable whose
+    // VDR the caller completes (MaxRec, SRecords, pad value).
+    inline void store_values_records(
+        variable_ctx& var_ctx, const std::vector<record_range>& ranges)
+    {
+        const auto& variable = *var_ctx.variable;
+        if (std::empty(var_ctx.vxrs))
+            return;
+        const auto record_size = std::max(std::size_t { 1 },
+                                     flat_size(std::cbegin(variable.shape()) + 1,
+                                         std::cend(variable.shape())))
+            * cdf_type_size(variable.type());
+        auto& vxr = var_ctx.vxrs.front();
+        var_ctx.values_records.clear();
+        vxr.record.First.values.clear();
+        vxr.record.Last.values.clear();
+        std::size_t packed = 0;
+        for (const auto& [start, stop] : ranges)
+        {
+            var_ctx.values_records.push_back(
+                make_values_record(variable, stop - start, record_size, packed));
+            vxr.record.First.values.push_back(static_cast<uint32_t>(start));
+            vxr.record.Last.values.push_back(static_cast<uint32_t>(stop - 1));
+            packed += stop - start;
+        }
+        vxr.record.Offset.values.resize(std::size(vxr.record.First.values));
+        vxr.record.Nentries = std::size(vxr.record.First.values);
+        vxr.record.NusedEntries = std::size(vxr.record.First.values);
+        update_size(vxr);
     }
 
 
@@ -28,6 +28,7 @@
 #include "../common.hpp"
 #include "../compression.hpp"
 #include "../desc-records.hpp"
+#include "../io-stats.hpp"
 #include "./buffers.hpp"
 #include "./create_records.hpp"
 #include "./layout_records.hpp"
@@ -35,10 +36,12 @@
 #include "./records-saving.hpp"
 #include "cdfpp/cdf-enums.hpp"
 #include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-trace.hpp"
 #include "cdfpp/chrono/cdf-leap-seconds.h"
 #include "cdfpp/no_init_vector.hpp"
 #include "cdfpp_config.h"
 #include <algorithm>
+#include <concepts>
 #include <fstream>
 #include <iostream>
 #include <numeric>
@@ -52,7 +55,8 @@ namespace saving
 {
     [[nodiscard]] inline std::size_t estimate_size(const CDF& cdf)
     {
-        auto var_size = std::accumulate(std::cbegin(cdf.variables), std::cend(cdf.variables), 0UL,
+        auto var_size = std::accumulate(std::cbegin(cdf.variables), std::cend(cdf.variables),
+            std::size_t { 0 },
             [](std::size_t sz, const auto& node) { return sz + node.mapped().bytes(); });
         return var_size + (1 << 16);
     }
@@ -229,7 +233,8 @@ Greenbelt, Maryland 20771 USA
         svg_ctx.body.gdr.record.eof = eof;
     }
 
-    inline void apply_compression(saving_context& svg_ctx)
+    template <typename stats_t = no_stats_t>
+    void apply_compression(saving_context& svg_ctx, stats_t stats = {})
     {
         if (svg_ctx.ccr and svg_ctx.cpr)
         {
@@ -237,8 +242,15 @@ Greenbelt, Maryland 20771 USA
             buffers::vector_writer writer { svg_ctx.ccr->record.data.values };
             write_body(svg_ctx.body, writer, 8);
             svg_ctx.ccr->record.uSize = std::size(writer.data);
-            svg_ctx.ccr->record.data.values
-                = compression::deflate(svg_ctx.compression, writer.data);
+            {
+                CDFPP_TRACE_SCOPE("save", "compress file", { "uncompressed_bytes",
+                    svg_ctx.ccr->record.uSize });
+                const auto timer = stats.time(io_phase::deflate);
+                svg_ctx.ccr->record.data.values
+                    = compression::deflate(svg_ctx.compression, writer.data);
+            }
+            stats.codec(svg_ctx.compression, std::size(svg_ctx.ccr->record.data.values),
+                svg_ctx.ccr->record.uSize);
             update_size(svg_ctx.ccr.value());
             svg_ctx.cpr->offset = svg_ctx.ccr->offset + svg_ctx.ccr->size;
             svg_ctx.ccr->record.CPRoffset = svg_ctx.cpr->offset;
@@ -246,17 +258,38 @@ Greenbelt, Maryland 20771 USA
     }
 
 
-    template <typename T>
-    [[nodiscard]] bool impl_save(const CDF& cdf, T& writer)
+    // Builds and lays out every record, only writing them remains.
+    template <typename stats_t = no_stats_t>
+    [[nodiscard]] saving_context prepare_records(const CDF& cdf, stats_t stats = {})
     {
+        CDFPP_TRACE_SCOPE("save", "prepare records", { "variables", std::size(cdf.variables) });
         saving_context svg_ctx = make_saving_context(cdf);
         create_file_attributes_records(cdf, svg_ctx);
-        create_variables_records(cdf, svg_ctx);
+        create_variables_records(cdf, svg_ctx, stats);
         auto eof = map_records(svg_ctx);
         link_records(svg_ctx);
         update_gdr(svg_ctx, eof);
-        apply_compression(svg_ctx);
+        apply_compression(svg_ctx, stats);
+        return svg_ctx;
+    }
+
+    // Number of bytes write_records will produce for a prepared context.
+    [[nodiscard]] inline std::size_t file_size(const saving_context& svg_ctx)
+    {
+        if (svg_ctx.compression == cdf_compression_type::no_compression)
+            return svg_ctx.body.gdr.record.eof;
+        return svg_ctx.cpr->offset + svg_ctx.cpr->size;
+    }
+
+    template <typename T, typename stats_t = no_stats_t>
+    [[nodiscard]] bool impl_save(const CDF& cdf, T& writer, stats_t stats = {})
+    {
+        CDFPP_TRACE_SCOPE("save", "save");
+        saving_context svg_ctx = prepare_records(cdf, stats);
+        CDFPP_TRACE_SCOPE("save", "write records", { "bytes", file_size(svg_ctx) });
+        const auto timer = stats.time(io_phase::write);
         write_records(svg_ctx, writer);
+        stats.written(writer.offset());
         return true;
     }
 
@@ -269,6 +302,24 @@ Greenbelt, Maryland 20771 USA
     return saving::impl_save(cdf, writer);
 }
 
+/*
+ * Saves into a destination that can't grow, allocated once the file size is known:
+ * make_writer(size) returns a writer (write/fill/offset, see buffers::vector_writer) taking
+ * exactly size bytes. The WASM build uses it to write straight into a JS Uint8Array.
+ */
+template <typename writer_factory_t>
+    requires std::invocable<writer_factory_t&, std::size_t>
+[[nodiscard]] inline bool save(const CDF& cdf, writer_factory_t&& make_writer)
+{
+    CDFPP_TRACE_SCOPE("save", "save");
+    auto svg_ctx = saving::prepare_records(cdf);
+    const auto size = saving::file_size(svg_ctx);
+    CDFPP_TRACE_SCOPE("save", "write records", { "bytes", size });
+    auto writer = make_writer(size);
+    saving::write_records(svg_ctx, writer);
+    return writer.offset() == size;
+}
+
 [[nodiscard]] inline no_init_vector<char> save(const CDF& cdf)
 {
     no_init_vector<char> data;
@@ -279,4 +330,23 @@ Greenbelt, Maryland 20771 USA
     return {};
 }
 
+// Same as save(cdf, path) and save(cdf), also accumulating into stats (see io_stats).
+[[nodiscard]] inline bool save(const CDF& cdf, const std::string& path, io_stats& stats)
+{
+    const auto timer = with_stats_t { &stats }.time(io_phase::save);
+    buffers::file_writer writer { path };
+    return saving::impl_save(cdf, writer, with_stats_t { &stats });
+}
+
+[[nodiscard]] inline no_init_vector<char> save(const CDF& cdf, io_stats& stats)
+{
+    const auto timer = with_stats_t { &stats }.time(io_phase::save);
+    no_init_vector<char> data;
+    data.reserve(saving::estimate_size(cdf));
+    buffers::vector_writer writer { data };
+    if (saving::impl_save(cdf, writer, with_stats_t { &stats }))
+        return data;
+    return {};
+}
+
 }
@@ -0,0 +1,476 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define CDFPP_HAS_GETPID
+#endif
+
+/*
+ * One process wide pool of worker threads shared by every parallel part of the library
+ * (time conversions, multi-file loading, chunk prefetching, ...).
+ *
+ * Work is submitted as batches of independent tasks [0, count). Idle workers take tasks from
+ * any pending batch while the submitting thread always processes tasks of its own batch until
+ * none is left, so:
+ *  - a batch completes even when every worker is busy (or there is none at all, or the pool
+ *    was lost across a fork()),
+ *  - nested calls (a task that itself runs a parallel_for, or many Python threads converting
+ *    at once) never deadlock and never spawn more threads than the pool holds.
+ *
+ * Defaults come from CDFPP_NUM_THREADS and CDFPP_MIN_CHUNK_SIZE when set, they can then be
+ * changed at runtime with set_num_threads/set_min_chunk_size.
+ */
+namespace cdf::parallel
+{
+
+namespace _details
+{
+    inline std::size_t env_or(const char* name, std::size_t fallback)
+    {
+        if (const char* value = std::getenv(name); value != nullptr)
+        {
+            try
+            {
+                return static_cast<std::size_t>(std::stoull(value));
+            }
+            catch (const std::exception&)
+            {
+            }
+        }
+        return fallback;
+    }
+
+    /* the takeaway is that threading is worth it on platforms with many cores where we infer
+     * big memory bandwidth because of many memory channels.
+     * On a typical 4 core laptop with 8 threads, threading is not worth it because we already
+     * top reach ~70% of memory bandwidth with a single thread.
+     */
+    inline std::size_t default_threads_count()
+    {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+        // no threads at all in this build, std::thread would throw
+        return 1;
+#elif defined(__EMSCRIPTEN_PTHREADS__) && defined(CDFPP_PTHREAD_POOL_SIZE)
+        // In a browser the work is CPU bound (wasm inflate/conversions) rather than memory
+        // bound, use every core up to the web workers emscripten spawns upfront: creating
+        // more later would only start once the main thread yields to the event loop.
+        return std::clamp<std::size_t>(
+            std::thread::hardware_concurrency(), 1U, CDFPP_PTHREAD_POOL_SIZE + 1);
+#else
+        const auto from_env = env_or("CDFPP_NUM_THREADS", 0);
+        if (from_env != 0)
+            return from_env;
+        return std::thread::hardware_concurrency() >= 32 ? 8U : 2U;
+#endif
+    }
+
+    inline long current_pid()
+    {
+#ifdef CDFPP_HAS_GETPID
+        return static_cast<long>(::getpid());
+#else
+        return 0;
+#endif
+    }
+
+    inline std::atomic<std::size_t>& min_chunk_size_setting()
+    {
+        static std::atomic<std::size_t> value { std::max(
+            env_or("CDFPP_MIN_CHUNK_SIZE", 1 * 1024 * 1024), std::size_t { 1 }) };
+        return value;
+    }
+
+    struct batch_t
+    {
+        batch_t(std::size_t count, std::function<void(std::size_t)>&& function)
+                : count { count }, function { std::move(function) }
+        {
+        }
+
+        // Runs one task of the batch, returns false once every task has been handed out.
+        bool run_one()
+        {
+            const auto index = next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= count)
+                return false;
+            if (not failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    function(index);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock { mutex };
+                    if (not error)
+                        error = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == count)
+            {
+                std::lock_guard lock { mutex };
+                finished.notify_all();
+            }
+            return true;
+        }
+
+        [[nodiscard]] bool exhausted() const noexcept
+        {
+            return next.load(std::memory_order_relaxed) >= count;
+        }
+
+        void wait()
+        {
+            std::unique_lock lock { mutex };
+            finished.wait(lock, [this]() { return done.load(std::memory_order_acquire) == count; });
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        const std::size_t count;
+        std::function<void(std::size_t)> function;
+        std::atomic<std::size_t> next { 0 };
+        std::atomic<std::size_t> done { 0 };
+        std::atomic<bool> failed { false };
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+}
+
+/*
+ * Result of thread_pool::submit. Waiting on a task that no worker has picked yet runs it on
+ * the waiting thread, so waiting from inside the pool can't starve it. Like futures returned
+ * by std::async, destroying or overwriting a pending task waits for it.
+ */
+template <typename T>
+class task
+{
+public:
+    task() = default;
+    task(std::shared_ptr<_details::batch_t> batch, std::future<T>&& future)
+            : p_batch { std::move(batch) }, p_future { std::move(future) }
+    {
+    }
+    task(task&&) noexcept = default;
+    task& operator=(task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (valid())
+                wait();
+            p_batch = std::move(other.p_batch);
+            p_future = std::move(other.p_future);
+        }
+        return *this;
+    }
+    ~task()
+    {
+        if (valid())
+            wait();
+    }
+
+    [[nodiscard]] bool valid() const noexcept { return p_future.valid(); }
+
+    void wait()
+    {
+        help();
+        p_future.wait();
+    }
+
+    T get()
+    {
+        help();
+        return p_future.get();
+    }
+
+private:
+    void help()
+    {
+        if (p_batch)
+        {
+            p_batch->run_one();
+            p_batch.reset();
+        }
+    }
+
+    std::shared_ptr<_details::batch_t> p_batch;
+    std::future<T> p_future;
+};
+
+class thread_pool
+{
+    struct worker_t
+    {
+        std::thread thread;
+        std::shared_ptr<bool> stop;
+    };
+
+public:
+    // threads is the total parallelism, the calling thread included
+    explicit thread_pool(std::size_t threads) { resize(threads); }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool() { resize(1); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return workers() + 1; }
+
+    // Must not be called from a task running on this pool. Concurrent calls are fine, each
+    // one only joins the workers it stopped itself.
+    void resize(std::size_t threads)
+    {
+        const auto target = std::max(threads, std::size_t { 1 }) - 1;
+        std::vector<std::thread> retired;
+        {
+            std::lock_guard lock { p_mutex };
+            forget_threads_after_fork();
+            p_target_workers.store(target, std::memory_order_relaxed);
+            while (std::size(p_workers) < target)
+            {
+                auto stop = std::make_shared<bool>(false);
+                p_workers.push_back(
+                    { std::thread { [this, stop]() { worker_loop(stop); } }, stop });
+            }
+            while (std::size(p_workers) > target)
+            {
+                *p_workers.back().stop = true;
+                retired.push_back(std::move(p_workers.back().thread));
+                p_workers.pop_back();
+            }
+        }
+        p_wake.notify_all();
+        for (auto& worker : retired)
+            worker.join();
+    }
+
+    // Runs function(i) for i in [0, count) and returns once all of them are done, the first
+    // exception thrown by a task is rethrown here (remaining tasks are skipped).
+    template <typename function_t>
+    void parallel_for(std::size_t count, function_t&& function)
+    {
+        if (count == 0)
+            return;
+        if (count == 1 or workers() == 0)
+        {
+            for (std::size_t i = 0; i < count; i++)
+                function(i);
+            return;
+        }
+        auto batch = std::make_shared<_details::batch_t>(
+            count, std::function<void(std::size_t)> { std::forward<function_t>(function) });
+        {
+            std::lock_guard lock { p_mutex };
+            p_batches.push_back(batch);
+        }
+        if (count == 2)
+            p_wake.notify_one();
+        else
+            p_wake.notify_all();
+        while (batch->run_one())
+            ;
+        retire(batch);
+        batch->wait();
+    }
+
+    // Runs function asynchronously on a worker, see task. With no worker at all the
+    // function runs before submit returns.
+    template <typename function_t>
+    [[nodiscard]] auto submit(function_t&& function)
+        -> task<std::invoke_result_t<std::decay_t<function_t>>>
+    {
+        using result_t = std::invoke_result_t<std::decay_t<function_t>>;
+        auto job = std::make_shared<std::packaged_task<result_t()>>(
+            std::forward<function_t>(function));
+        auto result = job->get_future();
+        if (workers() == 0)
+        {
+            (*job)();
+            return { nullptr, std::move(result) };
+        }
+        auto batch = std::make_shared<_details::batch_t>(
+            1, std::function<void(std::size_t)> { [job](std::size_t) { (*job)(); } });
+        {
+            std::lock_guard lock { p_mutex };
+            p_batches.push_back(batch);
+        }
+        p_wake.notify_one();
+        return { std::move(batch), std::move(result) };
+    }
+
+private:
+    // workers don't survive a fork(), a child process runs everything on its calling threads
+    [[nodiscard]] std::size_t workers() const noexcept
+    {
+        if (p_owner_pid != _details::current_pid())
+            return 0;
+        return p_target_workers.load(std::memory_order_relaxed);
+    }
+
+    void forget_threads_after_fork()
+    {
+        if (p_owner_pid != _details::current_pid())
+        {
+            // these handles refer to the parent threads, there is nothing to join here
+            for (auto& worker : p_workers)
+                worker.thread.detach();
+            p_workers.clear();
+            p_batches.clear();
+            p_owner_pid = _details::current_pid();
+        }
+    }
+
+    void retire(const std::shared_ptr<_details::batch_t>& batch)
+    {
+        std::lock_guard lock { p_mutex };
+        if (auto it = std::find(std::begin(p_batches), std::end(p_batches), batch);
+            it != std::end(p_batches))
+            p_batches.erase(it);
+    }
+
+    // stop is only written by resize under p_mutex, a stopped worker is never restarted
+    void worker_loop(std::shared_ptr<const bool> stop)
+    {
+        std::unique_lock lock { p_mutex };
+        while (true)
+        {
+            p_wake.wait(lock, [this, &stop]() { return *stop or not p_batches.empty(); });
+            if (*stop)
+                return;
+            auto batch = p_batches.front();
+            if (batch->exhausted())
+            {
+                p_batches.pop_front();
+                continue;
+            }
+            lock.unlock();
+            while (batch->run_one())
+                ;
+            lock.lock();
+            if (auto it = std::find(std::begin(p_batches), std::end(p_batches), batch);
+                it != std::end(p_batches))
+                p_batches.erase(it);
+        }
+    }
+
+    std::mutex p_mutex;
+    std::condition_variable p_wake;
+    std::deque<std::shared_ptr<_details::batch_t>> p_batches;
+    std::vector<worker_t> p_workers;
+    std::atomic<std::size_t> p_target_workers { 0 };
+    long p_owner_pid = _details::current_pid();
+};
+
+[[nodiscard]] inline thread_pool& pool()
+{
+    static thread_pool instance { _details::default_threads_count() };
+    return instance;
+}
+
+// Total number of threads (calling thread included) parallel operations may use.
+[[nodiscard]] inline std::size_t num_threads()
+{
+    return pool().size();
+}
+
+// 0 restores the default (CDFPP_NUM_THREADS or a guess from the hardware), 1 disables
+// threading. Must not be called from a task running on the pool.
+inline void set_num_threads(std::size_t threads)
+{
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    threads = 1; // see _details::default_threads_count
+#endif
+    pool().resize(threads == 0 ? _details::default_threads_count() : threads);
+}
+
+// Smallest number of elements worth handing to a separate thread in bulk operations.
+[[nodiscard]] inline std::size_t min_chunk_size()
+{
+    return _details::min_chunk_size_setting().load(std::memory_order_relaxed);
+}
+
+inline void set_min_chunk_size(std::size_t elements)
+{
+    _details::min_chunk_size_setting().store(
+        std::max(elements, std::size_t { 1 }), std::memory_order_relaxed);
+}
+
+template <typename function_t>
+void parallel_for(std::size_t count, function_t&& function)
+{
+    pool().parallel_for(count, std::forward<function_t>(function));
+}
+
+/*
+ * Splits [0, count) in at most num_threads() ranges of at least min_chunk elements and runs
+ * function(first, size) on each of them, small inputs simply run on the calling thread.
+ */
+template <typename function_t>
+void parallel_chunks(std::size_t count, std::size_t min_chunk, function_t&& function)
+{
+    // small inputs don't even instantiate the pool
+    const auto max_chunks = count / std::max(min_chunk, std::size_t { 1 });
+    const auto chunks = max_chunks <= 1 ? max_chunks : std::min(num_threads(), max_chunks);
+    if (chunks <= 1)
+    {
+        if (count != 0)
+            function(std::size_t { 0 }, count);
+        return;
+    }
+    const auto chunk_size = (count + chunks - 1) / chunks;
+    parallel_for(chunks,
+        [&function, count, chunk_size](std::size_t chunk)
+        {
+            const auto first = chunk * chunk_size;
+            if (first < count)
+                function(first, std::min(chunk_size, count - first));
+        });
+}
+
+template <typename function_t>
+[[nodiscard]] auto submit(function_t&& function)
+{
+    return pool().submit(std::forward<function_t>(function));
+}
+
+} // namespace cdf::parallel
@@ -0,0 +1,561 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "cdf-decimation.hpp"
+#include "cdf-enums.hpp"
+#include "cdf-parallel.hpp"
+#include "chrono/cdf-chrono.hpp"
+#include "no_init_vector.hpp"
+#include "variable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+/*
+ * Spectrogram rasterization for plotting: a 2-D variable (records x bins) is resampled on a
+ * width x height pixel grid, time along x and bins along y, and colour mapped to RGBA in one
+ * pass, so that a plot only has to blit the image instead of drawing one rectangle per cell.
+ * A pixel gets the max of the cells whose center falls in it, or when none does (zoomed in,
+ * data gaps) the cell covering the pixel center. Cells span the midpoints between centers
+ * (in log space on a log axis) and the outer ones extend by half a step, as in spectrogram.js.
+ * Fill values, NaNs, values out of [VALIDMIN, VALIDMAX] and, on a log colour scale,
+ * non-positive values are skipped; pixels without data are transparent.
+ */
+namespace cdf::spectrogram
+{
+
+enum class scale_t
+{
+    linear,
+    log
+};
+
+struct settings_t
+{
+    std::size_t width = 0;
+    std::size_t height = 0;
+    // time range [start, stop) in ns since 1970 UTC, the outer time cells edges by default
+    std::optional<int64_t> start = std::nullopt;
+    std::optional<int64_t> stop = std::nullopt;
+    // bins axis range, bottom to top, the outer bin cells edges by default
+    std::optional<double> y_min = std::nullopt;
+    std::optional<double> y_max = std::nullopt;
+    scale_t y_scale = scale_t::linear;
+    // colour range, the range of the drawn pixels by default
+    std::optional<double> z_min = std::nullopt;
+    std::optional<double> z_max = std::nullopt;
+    scale_t z_scale = scale_t::log;
+};
+
+// values to skip besides NaNs
+struct mask_t
+{
+    std::optional<double> fill = std::nullopt;
+    std::optional<double> valid_min = std::nullopt;
+    std::optional<double> valid_max = std::nullopt;
+};
+
+struct image_t
+{
+    std::size_t width = 0;
+    std::size_t height = 0;
+    // the ranges actually drawn, z range is NaN when no pixel has data
+    int64_t start = 0;
+    int64_t stop = 0;
+    double y_min = 0.;
+    double y_max = 0.;
+    scale_t y_scale = scale_t::linear;
+    double z_min = decimation::_details::nan;
+    double z_max = decimation::_details::nan;
+    scale_t z_scale = scale_t::log;
+    // [row][column][r, g, b, a], top row first
+    no_init_vector<uint8_t> rgba;
+};
+
+namespace _details
+{
+    using decimation::_details::nan;
+
+    inline constexpr std::array<std::array<uint8_t, 3>, 10> viridis_anchors { {
+        { 68, 1, 84 },
+        { 72, 40, 120 },
+        { 62, 74, 137 },
+        { 49, 104, 142 },
+        { 38, 130, 142 },
+        { 31, 158, 137 },
+        { 53, 183, 121 },
+        { 110, 206, 88 },
+        { 181, 222, 43 },
+        { 253, 231, 37 },
+    } };
+
+    // 256 levels, piecewise linear between the anchors exactly like viridis() in spectrogram.js
+    inline const std::array<std::array<uint8_t, 4>, 256>& viridis()
+    {
+        static const auto lut = []()
+        {
+            std::array<std::array<uint8_t, 4>, 256> colors;
+            const auto last = std::size(viridis_anchors) - 1;
+            for (std::size_t level = 0; level < std::size(colors); ++level)
+            {
+                const double x = static_cast<double>(level) / 255. * static_cast<double>(last);
+                const auto i = static_cast<std::size_t>(std::floor(x));
+                const double f = x - static_cast<double>(i);
+                const auto& a = viridis_anchors[i];
+                const auto& b = viridis_anchors[std::min(i + 1, last)];
+                for (std::size_t channel = 0; channel < 3; ++channel)
+                    colors[level][channel] = static_cast<uint8_t>(std::floor(
+                        a[channel] + (b[channel] - a[channel]) * f + 0.5));
+                colors[level][3] = 255;
+            }
+            return colors;
+        }();
+        return lut;
+    }
+
+    struct validity_t
+    {
+        double fill;
+        double low;
+        double high;
+        bool operator()(double value) const
+        {
+            return value >= low && value <= high && value != fill;
+        }
+    };
+
+    // NaNs and infinities fail the bounds checks
+    template <typename value_t>
+    validity_t make_validity(const mask_t& mask, scale_t z_scale)
+    {
+        constexpr double largest = std::numeric_limits<double>::max();
+        double low = std::max(mask.valid_min.value_or(-largest), -largest);
+        const double high = std::min(mask.valid_max.value_or(largest), largest);
+        if (z_scale == scale_t::log)
+            low = std::max(low, std::numeric_limits<double>::denorm_min());
+        return { mask.fill ? decimation::_details::as_fill<value_t>(*mask.fill) : nan, low,
+            high };
+    }
+
+    // [first, last) range of cells for each of the pixels splitting the axis at pixel_edges
+    // (increasing): the cells whose center is in the pixel, else the cell covering the pixel
+    // center, else none. Centers are sorted increasing, a lone center spans +-lone_half_width.
+    template <typename T>
+    std::vector<std::pair<std::size_t, std::size_t>> pixel_ranges(
+        std::span<const T> centers, std::span<const T> pixel_edges, T lone_half_width)
+    {
+        const auto n = std::size(centers);
+        const auto half = [](T a, T b) { return a + (b - a) / 2; };
+        // lower edge of cell k, k in [0, n]
+        const auto edge = [&](std::size_t k) -> T
+        {
+            if (n == 1)
+                return k == 0 ? centers[0] - lone_half_width : centers[0] + lone_half_width;
+            if (k == 0)
+                return centers[0] - (centers[1] - centers[0]) / 2;
+            if (k == n)
+                return centers[n - 1] + (centers[n - 1] - centers[n - 2]) / 2;
+            return half(centers[k - 1], centers[k]);
+        };
+        std::vector<std::pair<std::size_t, std::size_t>> ranges(
+            std::size(pixel_edges) < 2 ? 0 : std::size(pixel_edges) - 1);
+        if (n == 0)
+            return ranges;
+        std::vector<std::size_t> bounds(std::size(pixel_edges));
+        std::transform(std::cbegin(pixel_edges), std::cend(pixel_edges), std::begin(bounds),
+            [&centers](T e)
+            {
+                return static_cast<std::size_t>(
+                    std::lower_bound(std::cbegin(centers), std::cend(centers), e)
+                    - std::cbegin(centers));
+            });
+        for (std::size_t pixel = 0; pixel < std::size(ranges); ++pixel)
+        {
+            if (bounds[pixel] < bounds[pixel + 1])
+            {
+                ranges[pixel] = { bounds[pixel], bounds[pixel + 1] };
+                continue;
+            }
+            const T center = half(pixel_edges[pixel], pixel_edges[pixel + 1]);
+            // no center in the pixel: it lies between centers j - 1 and j
+            const auto j = bounds[pixel];
+            std::size_t cell = n;
+            if (j == 0)
+                cell = center >= edge(0) ? 0 : n;
+            else if (j == n)
+                cell = center < edge(n) ? n - 1 : n;
+            else
+                cell = center < edge(j) ? j - 1 : j;
+            ranges[pixel] = cell == n ? std::pair { n, n } : std::pair { cell, cell + 1 };
+        }
+        return ranges;
+    }
+
+    // [low, high) split in pixels + 1 evenly spaced edges
+    inline std::vector<double> uniform_edges(double low, double high, std::size_t pixels)
+    {
+        std::vector<double> edges(pixels + 1);
+        for (std::size_t i = 0; i <= pixels; ++i)
+            edges[i] = low + (high - low) * static_cast<double>(i) / static_cast<double>(pixels);
+        return edges;
+    }
+
+    inline bool strictly_monotonic(std::span<const double> values)
+    {
+        const auto increasing = std::adjacent_find(std::cbegin(values), std::cend(values),
+                                    [](double a, double b) { return not(b > a); })
+            == std::cend(values);
+        const auto decreasing = std::adjacent_find(std::cbegin(values), std::cend(values),
+                                    [](double a, double b) { return not(b < a); })
+            == std::cend(values);
+        return increasing || decreasing;
+    }
+
+    template <typename value_t>
+    inline constexpr bool is_rasterizable_v = decimation::_details::is_decimable_v<value_t>;
+}
+
+/*
+ * Rasterizes values (records x bins, row major) sampled at time (ns since 1970 UTC, sorted)
+ * with bin centers `bins` (strictly monotonic, and positive on a log y axis).
+ */
+template <typename value_t>
+[[nodiscard]] image_t rasterize(std::span<const value_t> values, std::span<const int64_t> time,
+    std::span<const double> bins, const settings_t& settings, const mask_t& mask = {})
+{
+    const auto records = std::size(time);
+    const auto bins_count = std::size(bins);
+    if (bins_count == 0 || std::size(values) != records * bins_count)
+        throw std::invalid_argument(
+            fmt::format("spectrogram: {} values can't be split in {} records of {} bins",
+                std::size(values), records, bins_count));
+    if (settings.width == 0 || settings.height == 0)
+        throw std::invalid_argument(fmt::format(
+            "spectrogram: can't draw a {}x{} image", settings.width, settings.height));
+    if (not _details::strictly_monotonic(bins))
+        throw std::invalid_argument("spectrogram: bin centers must be strictly monotonic");
+
+    image_t image;
+    image.width = settings.width;
+    image.height = settings.height;
+    image.z_scale = settings.z_scale;
+    image.y_scale = settings.y_scale;
+
+    // bins along y, in log space on a log axis and increasing
+    const bool log_y = settings.y_scale == scale_t::log;
+    if (log_y
+        and std::any_of(std::cbegin(bins), std::cend(bins), [](double b) { return not(b > 0.); }))
+        throw std::invalid_argument("spectrogram: a log y axis needs positive bin centers");
+    const bool reversed = bins_count > 1 && bins[1] < bins[0];
+    std::vector<double> y(bins_count);
+    for (std::size_t bin = 0; bin < bins_count; ++bin)
+    {
+        const auto center = bins[reversed ? bins_count - 1 - bin : bin];
+        y[bin] = log_y ? std::log10(center) : center;
+    }
+    const double lone_y = log_y ? std::log10(std::sqrt(2.)) : 0.5;
+    const double y_low = bins_count == 1 ? y[0] - lone_y : y[0] - (y[1] - y[0]) / 2;
+    const double y_high = bins_count == 1 ? y[0] + lone_y
+                                          : y.back() + (y.back() - y[bins_count - 2]) / 2;
+    const auto to_y = [log_y](double v) { return log_y ? std::log10(v) : v; };
+    const double y_bottom = settings.y_min ? to_y(*settings.y_min) : y_low;
+    const double y_top = settings.y_max ? to_y(*settings.y_max) : y_high;
+    if (not(y_top > y_bottom))
+        throw std::invalid_argument(
+            fmt::format("spectrogram: empty y range [{}, {}]", y_bottom, y_top));
+    image.y_min = log_y ? std::pow(10., y_bottom) : y_bottom;
+    image.y_max = log_y ? std::pow(10., y_top) : y_top;
+    auto rows = _details::pixel_ranges(std::span<const double> { y },
+        std::span<const double> { _details::uniform_edges(y_bottom, y_top, settings.height) },
+        lone_y);
+    if (reversed)
+    {
+        for (auto& [first, last] : rows)
+            std::tie(first, last) = std::pair { bins_count - last, bins_count - first };
+    }
+
+    // time along x, a lone record spans one second as in plot.js
+    constexpr int64_t lone_time = 500'000'000;
+    int64_t start = 0, stop = 1;
+    if (records != 0)
+    {
+        start = records == 1 ? time[0] - lone_time : time[0] - (time[1] - time[0]) / 2;
+        stop = records == 1 ? time[0] + lone_time
+                            : time[records - 1] + (time[records - 1] - time[records - 2]) / 2;
+    }
+    image.start = settings.start.value_or(start);
+    image.stop = settings.stop.value_or(std::max(stop, start + 1));
+    if (image.stop <= image.start)
+        throw std::invalid_argument(
+            fmt::format("spectrogram: empty time range [{}, {})", image.start, image.stop));
+    const auto x_edges = decimation::uniform_edges(image.start, image.stop, settings.width);
+    const auto columns
+        = _details::pixel_ranges(time, std::span<const int64_t> { x_edges }, lone_time);
+
+    // pixel levels, [column][row] with row 0 at the bottom, NaN without data
+    const auto width = settings.width, height = settings.height;
+    no_init_vector<double> levels(width * height);
+    const auto valid = _details::make_validity<value_t>(mask, settings.z_scale);
+    const auto min_chunk = std::max(std::size_t { 1 },
+        parallel::min_chunk_size() * width / std::max(std::size(values), std::size_t { 1 }));
+    parallel::parallel_chunks(width, min_chunk,
+        [&](std::size_t first_column, std::size_t count)
+        {
+            std::vector<double> column_max(bins_count);
+            constexpr double lowest = -std::numeric_limits<double>::infinity();
+            for (std::size_t column = first_column; column < first_column + count; ++column)
+            {
+                // max over the column records per bin, branchless so that it vectorizes
+                std::fill(std::begin(column_max), std::end(column_max), lowest);
+                const auto [first_record, last_record] = columns[column];
+                for (std::size_t record = first_record; record < last_record; ++record)
+                {
+                    const value_t* row = std::data(values) + record * bins_count;
+                    for (std::size_t bin = 0; bin < bins_count; ++bin)
+                    {
+                        const auto value = static_cast<double>(row[bin]);
+                        column_max[bin]
+                            = valid(value) && value > column_max[bin] ? value : column_max[bin];
+                    }
+                }
+                double* out = levels.data() + column * height;
+                for (std::size_t pixel_row = 0; pixel_row < height; ++pixel_row)
+                {
+                    const auto [first_bin, last_bin] = rows[pixel_row];
+                    double level = lowest;
+                    for (std::size_t bin = first_bin; bin < last_bin; ++bin)
+                        level = std::max(level, column_max[bin]);
+                    out[pixel_row] = level == lowest ? _details::nan : level;
+                }
+            }
+        });
+
+    double z_min = std::numeric_limits<double>::infinity(), z_max = -z_min;
+    if (not settings.z_min || not settings.z_max)
+    {
+        for (const double level : levels)
+        {
+            z_min = level < z_min ? level : z_min;
+            z_max = level > z_max ? level : z_max;
+        }
+    }
+    image.z_min = settings.z_min.value_or(z_min);
+    image.z_max = settings.z_max.value_or(z_max);
+    if (not(image.z_max >= image.z_min))
+        image.z_min = image.z_max = _details::nan;
+    else if (image.z_scale == scale_t::log && not(image.z_min > 0.))
+        throw std::invalid_argument(fmt::format(
+            "spectrogram: a log colour scale needs a positive range, got [{}, {}]", image.z_min,
+            image.z_max));
+
+    const bool log_z = settings.z_scale == scale_t::log;
+    const double z_low = log_z ? std::log10(image.z_min) : image.z_min;
+    const double z_high = log_z ? std::log10(image.z_max) : image.z_max;
+    // a single level range maps to the middle of the colormap
+    const double z_scale = z_high > z_low ? 255. / (z_high - z_low) : 0.;
+    const double z_offset = z_high > z_low ? 0. : 127.5;
+    const auto& colors = _details::viridis();
+    image.rgba.resize(width * height * 4);
+    const auto min_rows = std::max(std::size_t { 1 }, parallel::min_chunk_size() / width);
+    parallel::parallel_chunks(height, min_rows,
+        [&](std::size_t first_row, std::size_t count)
+        {
+            for (std::size_t row = first_row; row < first_row + count; ++row)
+            {
+                const auto pixel_row = height - 1 - row;
+                uint8_t* out = image.rgba.data() + row * width * 4;
+                for (std::size_t column = 0; column < width; ++column, out += 4)
+                {
+                    const double level = levels[column * height + pixel_row];
+                    const double z = log_z ? std::log10(level) : level;
+                    const double t = (z - z_low) * z_scale + z_offset;
+                    // NaN levels (no data, or no z range) are transparent
+                    if (not(t == t) || not(z_low == z_low))
+                    {
+                        out[0] = out[1] = out[2] = out[3] = 0;
+                        continue;
+                    }
+                    const auto& color
+                        = colors[static_cast<std::size_t>(std::clamp(t, 0., 255.) + 0.5)];
+                    std::copy(std::cbegin(color), std::cend(color), out);
+                }
+            }
+        });
+    return image;
+}
+
+namespace _details
+{
+    inline std::optional<double> first_number(const Variable& variable, const char* attribute)
+    {
+        std::optional<double> result;
+        if (auto it = variable.attributes.find(attribute); it != std::cend(variable.attributes))
+        {
+            visit(
+                it->second.value(),
+                [&result]<typename T>(const no_init_vector<T>& values)
+                {
+                    if constexpr (is_rasterizable_v<T>)
+                    {
+                        if (not values.empty())
+                            result = static_cast<double>(values.front());
+                    }
+                },
+                [](const auto&) {});
+        }
+        return result;
+    }
+
+    inline std::vector<int64_t> time_ns(const Variable& time)
+    {
+        using enum cdf::CDF_Types;
+        std::vector<int64_t> ns(time.len());
+        const auto convert = [&ns]<typename time_t>(const no_init_vector<time_t>& values)
+        {
+            chrono::_impl::_to_ns_from_1970(
+                std::span<const time_t> { values.data(), std::size(ns) }, ns.data());
+        };
+        switch (time.type())
+        {
+            case CDF_EPOCH:
+                convert(time.get<epoch>());
+                break;
+            case CDF_EPOCH16:
+                convert(time.get<epoch16>());
+                break;
+            case CDF_TIME_TT2000:
+                convert(time.get<tt2000_t>());
+                break;
+            default:
+                throw std::invalid_argument(fmt::format(
+                    "spectrogram: time axis {} must be a CDF time variable (CDF_EPOCH, "
+                    "CDF_EPOCH16, or CDF_TIME_TT2000), got {}",
+                    time.name(), cdf_type_str(time.type())));
+        }
+        return ns;
+    }
+
+    // the first record of a numeric bins variable, or the bin indices
+    inline std::vector<double> bin_centers(const Variable* bins, std::size_t bins_count)
+    {
+        std::vector<double> centers(bins_count);
+        const bool found = bins != nullptr
+            && decimation::_details::visit_numeric(
+                *bins,
+                [&]<typename T>(const no_init_vector<T>& values)
+                {
+                    if (std::size(values) < bins_count)
+                        return false;
+                    std::transform(std::cbegin(values),
+                        std::cbegin(values) + static_cast<std::ptrdiff_t>(bins_count),
+                        std::begin(centers), [](T v) { return static_cast<double>(v); });
+                    return true;
+                },
+                []() { return false; });
+        if (not found || not strictly_monotonic(centers))
+        {
+            for (std::size_t bin = 0; bin < bins_count; ++bin)
+                centers[bin] = static_cast<double>(bin);
+        }
+        return centers;
+    }
+}
+
+// ISTP SCALETYP attribute of a variable, fallback when missing or unknown.
+[[nodiscard]] inline scale_t scale_type(const Variable& variable, scale_t fallback)
+{
+    auto it = variable.attributes.find("SCALETYP");
+    if (it == std::cend(variable.attributes) || not is_string(it->second.type()))
+        return fallback;
+    const auto& chars = it->second.get<char>();
+    std::string scale;
+    for (const char c : chars)
+        if (c != ' ' && c != '\0')
+            scale.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    if (scale == "log")
+        return scale_t::log;
+    if (scale == "linear")
+        return scale_t::linear;
+    return fallback;
+}
+
+/*
+ * Rasterizes a 2-D variable against its time axis (usually its DEPEND_0) and optionally its
+ * bins (usually its DEPEND_1, first record if record varying). Without usable bins (missing,
+ * not numeric or not monotonic) rows are the bin indices, and a log y axis needs positive bin
+ * centers, else it falls back to linear (see image_t::y_scale).
+ * FILLVAL, VALIDMIN and VALIDMAX attributes give the values to skip.
+ */
+[[nodiscard]] inline image_t rasterize(
+    const Variable& values, const Variable& time, const Variable* bins, settings_t settings)
+{
+    if (values.len() != time.len())
+        throw std::invalid_argument(
+            fmt::format("spectrogram: {} has {} records but its time axis {} has {}",
+                values.name(), values.len(), time.name(), time.len()));
+    if (std::size(values.shape()) != 2)
+        throw std::invalid_argument(fmt::format(
+            "spectrogram: {} must have one dimension per record, got {}", values.name(),
+            std::size(values.shape()) - 1));
+    const std::size_t records = values.len();
+    const std::size_t bins_count = values.shape()[1];
+    const auto ns = _details::time_ns(time);
+    const auto centers = _details::bin_centers(bins, bins_count);
+    if (settings.y_scale == scale_t::log
+        && std::any_of(std::cbegin(centers), std::cend(centers), [](double c) { return c <= 0.; }))
+        settings.y_scale = scale_t::linear;
+    const mask_t mask { _details::first_number(values, "FILLVAL"),
+        _details::first_number(values, "VALIDMIN"), _details::first_number(values, "VALIDMAX") };
+
+    const auto with_values = [&]<typename value_t>(const no_init_vector<value_t>& data)
+    {
+        return spectrogram::rasterize(
+            std::span<const value_t> { data.data(), records * bins_count },
+            std::span<const int64_t> { ns }, std::span<const double> { centers }, settings, mask);
+    };
+    return decimation::_details::visit_numeric(values, with_values,
+        [&values]() -> image_t
+        {
+            throw std::invalid_argument(fmt::format("spectrogram: {} has non numeric type {}",
+                values.name(), cdf_type_str(values.type())));
+        });
+}
+
+}
@@ -0,0 +1,329 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "cdfpp_config.h"
+#include <string>
+
+/*
+ * Trace of load and save phases as Chrome trace JSON (the Trace Event Format), which
+ * chrome://tracing and https://ui.perfetto.dev open directly. Each phase gives a begin and
+ * an end event with the thread it ran on and details such as the variable name, the byte
+ * range in the file and the codec, so overlap and stragglers of parallel loads show up.
+ *
+ * Hooks are only compiled in with the with_tracing build option (CDFpp_WITH_TRACING), then
+ * recording is switched on at runtime with tracing::start(), or by setting the CDFPP_TRACE
+ * environment variable to a path where the trace is written when the process exits.
+ * Without the build option CDFPP_TRACE_SCOPE expands to nothing and to_json() gives an empty
+ * trace.
+ */
+
+#ifdef CDFpp_WITH_TRACING
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace cdf::tracing
+{
+
+namespace _details
+{
+    inline void append_json_string(std::string& out, std::string_view value)
+    {
+        out.push_back('"');
+        for (const char c : value)
+        {
+            switch (c)
+            {
+                case '"':
+                    out += "\\\"";
+                    break;
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        out += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+                    else
+                        out.push_back(c);
+            }
+        }
+        out.push_back('"');
+    }
+
+    struct event
+    {
+        const char* category;
+        const char* name;
+        char phase; // 'B' or 'E'
+        uint32_t thread;
+        std::chrono::nanoseconds timestamp;
+        std::string args; // JSON object members, only on begin events
+    };
+
+    // Past this many events new ones are dropped, and counted in the trace metadata.
+    inline constexpr std::size_t max_events = 1 << 22;
+
+    class recorder
+    {
+        std::mutex p_mutex;
+        std::vector<event> p_events;
+        std::size_t p_dropped = 0;
+        std::string p_exit_path;
+        const std::chrono::steady_clock::time_point p_origin = std::chrono::steady_clock::now();
+
+    public:
+        std::atomic<bool> enabled { false };
+
+        recorder()
+        {
+            if (const char* path = std::getenv("CDFPP_TRACE"); path != nullptr and *path != '\0')
+            {
+                p_exit_path = path;
+                enabled = true;
+            }
+        }
+
+        ~recorder()
+        {
+            if (not std::empty(p_exit_path))
+            {
+                std::ofstream os { p_exit_path, std::ios::trunc };
+                os << to_json();
+            }
+        }
+
+        [[nodiscard]] std::chrono::nanoseconds now() const
+        {
+            return std::chrono::steady_clock::now() - p_origin;
+        }
+
+        void record(event&& e)
+        {
+            std::lock_guard lock { p_mutex };
+            if (std::size(p_events) < max_events)
+                p_events.push_back(std::move(e));
+            else
+                p_dropped++;
+        }
+
+        void clear()
+        {
+            std::lock_guard lock { p_mutex };
+            p_events.clear();
+            p_dropped = 0;
+        }
+
+        [[nodiscard]] std::string to_json()
+        {
+            std::lock_guard lock { p_mutex };
+            std::string json = R"({"displayTimeUnit":"ns","traceEvents":[)";
+            bool first = true;
+            for (const auto& e : p_events)
+            {
+                if (not first)
+                    json.push_back(',');
+                first = false;
+                // timestamps are in microseconds
+                json += fmt::format(R"({{"ph":"{}","cat":"{}","name":"{}","pid":1,"tid":{},)"
+                                    R"("ts":{}.{:03})",
+                    e.phase, e.category, e.name, e.thread, e.timestamp.count() / 1000,
+                    e.timestamp.count() % 1000);
+                if (not std::empty(e.args))
+                    json += fmt::format(R"(,"args":{{{}}})", e.args);
+                json.push_back('}');
+            }
+            json += fmt::format(R"(],"otherData":{{"dropped_events":{}}}}})", p_dropped);
+            return json;
+        }
+    };
+
+    inline recorder& instance()
+    {
+        static recorder r;
+        return r;
+    }
+
+    // Small per process thread numbers, in the order threads first record something.
+    inline uint32_t thread_number()
+    {
+        static std::atomic<uint32_t> next { 1 };
+        thread_local const uint32_t number = next++;
+        return number;
+    }
+}
+
+[[nodiscard]] inline constexpr bool available() noexcept
+{
+    return true;
+}
+
+[[nodiscard]] inline bool enabled() noexcept
+{
+    return _details::instance().enabled.load(std::memory_order_relaxed);
+}
+
+inline void start()
+{
+    _details::instance().enabled = true;
+}
+
+inline void stop()
+{
+    _details::instance().enabled = false;
+}
+
+// Drops the events recorded so far.
+inline void clear()
+{
+    _details::instance().clear();
+}
+
+// Every event recorded so far as Chrome trace JSON.
+[[nodiscard]] inline std::string to_json()
+{
+    return _details::instance().to_json();
+}
+
+inline bool write(const std::string& path)
+{
+    std::ofstream os { path, std::ios::trunc };
+    os << to_json();
+    return static_cast<bool>(os);
+}
+
+// One detail of a begin event, a string or an integer.
+struct arg
+{
+    std::string member;
+
+    arg(const char* key, std::string_view value)
+    {
+        _details::append_json_string(member, key);
+        member.push_back(':');
+        _details::append_json_string(member, value);
+    }
+
+    arg(const char* key, const std::string& value) : arg(key, std::string_view { value }) { }
+    arg(const char* key, const char* value) : arg(key, std::string_view { value }) { }
+
+    template <typename T>
+        requires std::is_integral_v<T>
+    arg(const char* key, T value)
+    {
+        _details::append_json_string(member, key);
+        member += fmt::format(":{}", value);
+    }
+};
+
+// Records a begin event when built with details, the matching end event when destroyed.
+class scope
+{
+    const char* p_category = nullptr;
+    const char* p_name = nullptr;
+
+public:
+    scope() = default;
+    scope(const char* category, const char* name, std::initializer_list<arg> args)
+            : p_category { category }, p_name { name }
+    {
+        std::string members;
+        for (const auto& a : args)
+        {
+            if (not std::empty(members))
+                members.push_back(',');
+            members += a.member;
+        }
+        auto& recorder = _details::instance();
+        recorder.record({ category, name, 'B', _details::thread_number(), recorder.now(),
+            std::move(members) });
+    }
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+    ~scope()
+    {
+        if (p_name != nullptr)
+        {
+            auto& recorder = _details::instance();
+            recorder.record(
+                { p_category, p_name, 'E', _details::thread_number(), recorder.now(), {} });
+        }
+    }
+};
+
+}
+
+#define CDFPP_TRACE_CONCAT_(a, b) a##b
+#define CDFPP_TRACE_CONCAT(a, b) CDFPP_TRACE_CONCAT_(a, b)
+// CDFPP_TRACE_SCOPE(category, name, { "key", value }...) traces the enclosing scope, details
+// are only evaluated while recording. category and name must be string literals.
+#define CDFPP_TRACE_SCOPE(category, name, ...)                                                    \
+    const auto CDFPP_TRACE_CONCAT(cdfpp_trace_scope_, __LINE__) = ::cdf::tracing::enabled()       \
+        ? ::cdf::tracing::scope { category, name, { __VA_ARGS__ } }                               \
+        : ::cdf::tracing::scope {}
+
+#else
+
+namespace cdf::tracing
+{
+[[nodiscard]] inline constexpr bool available() noexcept
+{
+    return false;
+}
+[[nodiscard]] inline constexpr bool enabled() noexcept
+{
+    return false;
+}
+inline void start() { }
+inline void stop() { }
+inline void clear() { }
+[[nodiscard]] inline std::string to_json()
+{
+    return R"({"displayTimeUnit":"ns","traceEvents":[]})";
+}
+inline bool write(const std::string&)
+{
+    return false;
+}
+}
+
+#define CDFPP_TRACE_SCOPE(category, name, ...)
+
+#endif
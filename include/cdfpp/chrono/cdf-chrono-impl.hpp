@@ -28,7 +28,12 @@
 #include "cdf-chrono-constants.hpp"
 #include "cdf-leap-seconds.h"
 #include "cdfpp/cdf-enums.hpp"
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
 
 namespace cdf::chrono::_impl
 {
@@ -89,6 +94,50 @@ inline int64_t leap_second(const tt2000_t& ep)
     return 0;
 }
 
+/*
+ * leap_seconds_tt2000_reverse with one leading entry catching everything before 1972 (no
+ * leap second) and trailing entries that can't be reached, so that segment p is
+ * [thresholds[p], thresholds[p + 1]) with leap seconds offsets[p] and branchless binary
+ * searches over a power of two sized table never go out of bounds.
+ */
+struct padded_leap_table_t
+{
+    std::array<int64_t, 32> thresholds;
+    std::array<int64_t, 32> offsets;
+};
+
+inline constexpr padded_leap_table_t padded_leap_seconds_tt2000_reverse = []()
+{
+    constexpr auto& table = leap_seconds::leap_seconds_tt2000_reverse;
+    static_assert(std::size(table) + 2 <= 32);
+    padded_leap_table_t padded {};
+    padded.thresholds[0] = std::numeric_limits<int64_t>::min();
+    padded.offsets[0] = 0;
+    for (std::size_t i = 0; i < std::size(table); ++i)
+    {
+        padded.thresholds[i + 1] = table[i].first;
+        padded.offsets[i + 1] = table[i].second;
+    }
+    for (std::size_t i = std::size(table) + 1; i < 32; ++i)
+    {
+        padded.thresholds[i] = std::numeric_limits<int64_t>::max();
+        padded.offsets[i] = table.back().second;
+    }
+    return padded;
+}();
+
+// Index of the padded table segment holding tt2000, starting the search from hint.
+inline std::size_t leap_segment(const int64_t tt2000, std::size_t hint)
+{
+    constexpr auto& thresholds = padded_leap_seconds_tt2000_reverse.thresholds;
+    constexpr std::size_t last = std::size(leap_seconds::leap_seconds_tt2000_reverse);
+    while (hint < last && tt2000 >= thresholds[hint + 1])
+        ++hint;
+    while (hint > 0 && tt2000 < thresholds[hint])
+        --hint;
+    return hint;
+}
+
 inline auto _leap_second(const tt2000_t& ep, std::size_t leap_index_hint)
 {
     if (ep.nseconds >= leap_seconds::leap_seconds_tt2000_reverse[leap_index_hint].first)
@@ -151,6 +200,83 @@ inline void _optimistic_to_ns_from_1970_after_2017(
     }
 }
 
+/* Cheap sortedness guess, looks at a handful of evenly spaced values only. A wrong guess
+ * costs speed, never correctness: segment-wise conversions still check every value against
+ * its segment bounds.
+ */
+inline bool looks_sorted(const std::span<const tt2000_t>& input)
+{
+    constexpr std::size_t probes = 16;
+    if (std::size(input) < 2)
+        return true;
+    const auto last = std::size(input) - 1;
+    auto previous = input.front().nseconds;
+    for (std::size_t p = 1; p <= probes; ++p)
+    {
+        const auto value = input[last * p / probes].nseconds;
+        if (value < previous)
+            return false;
+        previous = value;
+    }
+    return true;
+}
+
+/* Calls segment_function(first, count, segment) for each run of input sharing the leap
+ * seconds offset of padded_leap_seconds_tt2000_reverse segment, assuming input is sorted.
+ * Boundaries are located with binary searches so this costs O(leap seconds * log(n)).
+ */
+inline void for_each_leap_segment(
+    const std::span<const tt2000_t>& input, const auto& segment_function)
+{
+    if (std::size(input) == 0)
+        return;
+    constexpr auto& thresholds = padded_leap_seconds_tt2000_reverse.thresholds;
+    const auto first_segment = leap_segment(input.front().nseconds, 0);
+    const auto last_segment
+        = std::max(first_segment, leap_segment(input.back().nseconds, first_segment));
+    auto begin = std::cbegin(input);
+    for (auto segment = first_segment; segment <= last_segment; ++segment)
+    {
+        const auto end = (segment == last_segment)
+            ? std::cend(input)
+            : std::partition_point(begin, std::cend(input),
+                  [threshold = thresholds[segment + 1]](const tt2000_t& v)
+                  { return v.nseconds < threshold; });
+        if (end != begin)
+        {
+            segment_function(static_cast<std::size_t>(begin - std::cbegin(input)),
+                static_cast<std::size_t>(end - begin), segment);
+        }
+        begin = end;
+    }
+}
+
+// One constant offset per leap second segment, any value outside of its segment bounds
+// (unsorted input) sends the whole segment back to the hint walk.
+inline void _sorted_to_ns_from_1970(
+    const tt2000_t* const input, const std::size_t count, int64_t* const output)
+{
+    constexpr auto& padded = padded_leap_seconds_tt2000_reverse;
+    for_each_leap_segment(std::span<const tt2000_t> { input, count },
+        [input, output](std::size_t first, std::size_t size, std::size_t segment)
+        {
+            const auto offset = constants::tt2000_offset - padded.offsets[segment];
+            const auto lower = padded.thresholds[segment];
+            const auto upper = padded.thresholds[segment + 1];
+            bool in_segment = true;
+            for (std::size_t i = first; i < first + size; ++i)
+            {
+                const auto value = input[i].nseconds;
+                output[i] = value + offset;
+                in_segment &= (value >= lower) & (value < upper);
+            }
+            if (!in_segment)
+            {
+                _impl::_unsorted_to_ns_from_1970(input + first, size, output + first);
+            }
+        });
+}
+
 inline void scalar_to_ns_from_1970(
     const std::span<const tt2000_t>& input, int64_t* const output)
 {
@@ -158,6 +284,10 @@ inline void scalar_to_ns_from_1970(
     {
         return;
     }
+    if (looks_sorted(input))
+    {
+        return _impl::_sorted_to_ns_from_1970(input.data(), input.size(), output);
+    }
     if (input[0].nseconds >= leap_seconds::leap_seconds_tt2000_reverse.back().first)
     {
         return _impl::_optimistic_to_ns_from_1970_after_2017(input.data(), input.size(), output);
@@ -165,12 +295,18 @@ inline void scalar_to_ns_from_1970(
     return _impl::_unsorted_to_ns_from_1970(input.data(), input.size(), output);
 }
 
+/* Whole and fractional parts are converted separately, exactly like to_time_point does,
+ * scaling the full value would round it to the ~256ns resolution of a double around 2^60.
+ */
 inline void scalar_to_ns_from_1970(
     const std::span<const epoch>& input, int64_t* const output)
 {
     for (std::size_t i = 0; i < input.size(); ++i)
     {
-        output[i] = (input[i].mseconds - constants::epoch_offset_miliseconds) * 1'000'000;
+        const auto ms = input[i].mseconds - constants::epoch_offset_miliseconds;
+        const auto whole_ms = std::trunc(ms);
+        output[i] = static_cast<int64_t>(whole_ms) * 1'000'000
+            + static_cast<int64_t>((ms - whole_ms) * 1'000'000.);
     }
 }
 
@@ -181,8 +317,49 @@ inline void scalar_to_ns_from_1970(
     for (std::size_t i = 0; i < input.size(); ++i)
     {
         output[i]
-            = (input[i].seconds - constants::epoch_offset_seconds) * 1'000'000'000
-            + (input[i].picoseconds / 1'000);
+            = static_cast<int64_t>(input[i].seconds - constants::epoch_offset_seconds)
+                * 1'000'000'000
+            + static_cast<int64_t>(input[i].picoseconds / 1'000.);
+    }
+}
+
+/* Reverse conversions, they give exactly what to_tt2000/to_epoch/to_epoch16 give for
+ * system_clock time points built from the same nanoseconds, including their truncation
+ * toward zero for negative values, without the std::chrono round trip.
+ */
+inline void scalar_from_ns_from_1970(const std::span<const int64_t>& input, tt2000_t* const output)
+{
+    if (input.size() == 0)
+    {
+        return;
+    }
+    const auto last_leap_sec = leap_seconds::leap_seconds_tt2000.back().first;
+    const auto offset = leap_seconds::leap_seconds_tt2000.back().second - constants::tt2000_offset;
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        const auto ns = input[i];
+        output[i] = tt2000_t { ns >= last_leap_sec
+                ? ns + offset
+                : ns - constants::tt2000_offset + leap_second(ns) };
+    }
+}
+
+inline void scalar_from_ns_from_1970(const std::span<const int64_t>& input, epoch* const output)
+{
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        output[i] = epoch { static_cast<double>(input[i] / 1'000'000)
+            + constants::epoch_offset_miliseconds };
+    }
+}
+
+inline void scalar_from_ns_from_1970(const std::span<const int64_t>& input, epoch16* const output)
+{
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        const auto s = input[i] / 1'000'000'000;
+        output[i] = epoch16 { static_cast<double>(s) + constants::epoch_offset_seconds,
+            static_cast<double>(input[i] - s * 1'000'000'000) * 1000. };
     }
 }
 
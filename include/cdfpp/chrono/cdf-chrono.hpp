@@ -29,6 +29,8 @@
 #include "cdf-chrono-impl.hpp"
 #include "cdfpp/cdf-debug.hpp"
 #include "cdfpp/cdf-enums.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+#include "cdfpp/cdf-trace.hpp"
 #include "cdfpp/no_init_vector.hpp"
 #include <cdfpp/vectorized/cdf-chrono.hpp>
 
@@ -37,7 +39,6 @@
 #include <chrono>
 #include <cmath>
 #include <span>
-#include <thread>
 
 #ifndef CDFPP_NO_SIMD
 #include "cdfpp/vectorized/cdf-chrono.hpp"
@@ -53,76 +54,60 @@ using namespace cdf::chrono;
 
 namespace chrono::_impl
 {
-    static inline std::size_t ideal_threads_count()
+    // Splits large conversions across the library thread pool, see cdf::parallel.
+    static inline void _parallel_if_needed(
+        const auto& input, auto* const output, const auto& function)
     {
-        static const auto threads_count = std::thread::hardware_concurrency() >= 32 ? 8U : 2U;
-        return threads_count;
+        parallel::parallel_chunks(std::size(input), parallel::min_chunk_size(),
+            [&input, output, &function](std::size_t first, std::size_t count)
+            {
+                CDFPP_TRACE_SCOPE("chrono", "chunk", { "first", first }, { "count", count });
+                function(input.subspan(first, count), output + first);
+            });
     }
 
-    /* the takeaway is that threading is worth it on platforms with many cores where we infer
-     * big memory bandwidht because of many memry channels.
-     * On a typical 4 core laptop with 8 threads, threading is not worth it because we already
-     * top reach ~70% of memory bandwidth with a single thread.
-     */
-    template <std::size_t min_chunk_size = 1 * 1024 * 1024>
-    static inline void _thread_if_needed(
-        const auto& input, auto* const output, const auto& function)
+    // Single threaded kernels, picking the vectorized implementation when worth it.
+    static inline void _to_ns_from_1970(const cdf_time_t_span_t auto& input, int64_t* output)
     {
-        static const auto threads_count = ideal_threads_count();
-        const auto count = std::size(input);
-        if ((count >= (min_chunk_size * threads_count)))
+#ifndef CDFPP_NO_SIMD
+        if (input.size() >= 8)
         {
-            const auto chunk_size = [count]()
-            {
-                auto cs = (count / threads_count);
-                while ((cs * threads_count) < count)
-                {
-                    cs += min_chunk_size;
-                }
-                return cs;
-            }();
-            std::vector<std::thread> threads;
-            threads.reserve(threads_count);
-            std::size_t start = 0;
-            std::size_t sz = chunk_size;
-            for (std::size_t i = 0; i < threads_count; ++i)
-            {
-                threads.emplace_back([input, start, sz, output, &function]()
-                    { function(input.subspan(start, sz), output + start); });
-                start += sz;
-                sz = ((start + chunk_size) > count) ? count - start : chunk_size;
-            }
-            for (auto& t : threads)
-            {
-                t.join();
-            }
+            vectorized_to_ns_from_1970(input, output);
+        }
+        else
+        {
+            _impl::scalar_to_ns_from_1970(input, output);
+        }
+#else
+        _impl::scalar_to_ns_from_1970(input, output);
+#endif
+    }
+
+    static inline void _from_ns_from_1970(
+        const std::span<const int64_t>& input, cdf_time_t auto* output)
+    {
+#ifndef CDFPP_NO_SIMD
+        if (input.size() >= 8)
+        {
+            vectorized_from_ns_from_1970(input, output);
         }
         else
         {
-            function(input, output);
+            _impl::scalar_from_ns_from_1970(input, output);
         }
+#else
+        _impl::scalar_from_ns_from_1970(input, output);
+#endif
     }
 
 }
 
 static inline void to_ns_from_1970(const cdf_time_t_span_t auto& input, int64_t* output)
 {
-    chrono::_impl::_thread_if_needed<1 * 1024 * 1024>(input, output,
+    CDFPP_TRACE_SCOPE("chrono", "to_ns_from_1970", { "count", std::size(input) });
+    chrono::_impl::_parallel_if_needed(input, output,
         [](const cdf_time_t_span_t auto& input, int64_t* output)
-        {
-#ifndef CDFPP_NO_SIMD
-            if (input.size() >= 8)
-            {
-                vectorized_to_ns_from_1970(input, output);
-            }
-            else
-            {
-                _impl::scalar_to_ns_from_1970(input, output);
-            }
-#else
-            _impl::scalar_to_ns_from_1970(input, output);
-#endif
-        });
+        { chrono::_impl::_to_ns_from_1970(input, output); });
 }
 
 epoch to_epoch(const time_point_t auto& tp)
@@ -199,12 +184,40 @@ T to_cdf_time(const cdf_time_t auto& in)
 
 static inline void from_ns_from_1970(const std::span<const int64_t>& input, cdf_time_t auto* output)
 {
-    std::transform(std::cbegin(input), std::cend(input), output,
-        [](const int64_t ns)
-        {
-            return to_cdf_time<std::decay_t<decltype(output[0])>>(
-                std::chrono::system_clock::time_point {} + std::chrono::nanoseconds(ns));
-        });
+    CDFPP_TRACE_SCOPE("chrono", "from_ns_from_1970", { "count", std::size(input) });
+    chrono::_impl::_parallel_if_needed(input, output,
+        [](const std::span<const int64_t>& input, cdf_time_t auto* output)
+        { chrono::_impl::_from_ns_from_1970(input, output); });
+}
+
+/* Bulk conversion between CDF time types, gives exactly what to_cdf_time<T> gives element
+ * wise. Values go through ns since 1970 in small cache resident chunks with the same kernels
+ * as to_ns_from_1970 and from_ns_from_1970, large inputs are split across the thread pool.
+ */
+template <cdf_time_t output_t>
+static inline void to_cdf_time(const cdf_time_t_span_t auto& input, output_t* output)
+{
+    using input_t = std::remove_cv_t<typename std::decay_t<decltype(input)>::element_type>;
+    if constexpr (std::is_same_v<input_t, output_t>)
+    {
+        std::copy(std::cbegin(input), std::cend(input), output);
+    }
+    else
+    {
+        CDFPP_TRACE_SCOPE("chrono", "to_cdf_time", { "count", std::size(input) });
+        chrono::_impl::_parallel_if_needed(input, output,
+            [](const cdf_time_t_span_t auto& input, output_t* output)
+            {
+                std::array<int64_t, 2048> ns;
+                for (std::size_t first = 0; first < std::size(input); first += std::size(ns))
+                {
+                    const auto count = std::min(std::size(ns), std::size(input) - first);
+                    chrono::_impl::_to_ns_from_1970(input.subspan(first, count), ns.data());
+                    chrono::_impl::_from_ns_from_1970(
+                        std::span<const int64_t> { ns.data(), count }, output + first);
+                }
+            });
+    }
 }
 
 inline auto to_time_point(const epoch& ep)
@@ -0,0 +1,487 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "cdf-chrono.hpp"
+#include "cdfpp/cdf-enums.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/core.h>
+
+/*
+ * Fixed width time strings (ISO-8601, CSV columns...) from CDF time values.
+ * A strftime like format is compiled once into a plan (a template string and the offsets of
+ * each field), then values are formatted by blocks: converted to ns since 1970 with the
+ * vectorized kernels, broken down into civil dates with integer only arithmetic, and each
+ * field is written for the whole block at once, eight digits at a time for sub-seconds.
+ * Output strings are not null terminated, string i starts at output + i * plan.width().
+ */
+namespace cdf::chrono::time_format
+{
+
+namespace _details
+{
+    // clang-format off
+    alignas(64) inline constexpr char DIGIT_PAIRS[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+    // clang-format on
+
+    inline void write_2d(char* p, unsigned v)
+    {
+        std::memcpy(p, DIGIT_PAIRS + v * 2, 2);
+    }
+
+    inline void write_3d(char* p, unsigned v)
+    {
+        p[0] = '0' + static_cast<char>(v / 100);
+        write_2d(p + 1, v % 100);
+    }
+
+    inline void write_4d(char* p, unsigned v)
+    {
+        write_2d(p, v / 100);
+        write_2d(p + 2, v % 100);
+    }
+
+    /* v < 10^8, all eight digits are computed in one 64 bits register: the value is split in
+     * two 4 digits lanes, then 2 digits, then 1 digit lanes using multiply and shift divisions
+     * that are exact in those ranges, finally '0' is added to every byte.
+     */
+    inline void write_8d(char* p, uint32_t v)
+    {
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            uint64_t merged = (v / 10000) | (static_cast<uint64_t>(v % 10000) << 32);
+            const uint64_t div100 = ((merged * 10486) >> 20) & 0x0000007F0000007FULL;
+            merged = div100 | ((merged - div100 * 100) << 16);
+            const uint64_t div10 = ((merged * 103) >> 10) & 0x000F000F000F000FULL;
+            merged = div10 | ((merged - div10 * 10) << 8);
+            merged += 0x3030303030303030ULL;
+            std::memcpy(p, &merged, 8);
+        }
+        else
+        {
+            write_4d(p, v / 10000);
+            write_4d(p + 4, v % 10000);
+        }
+    }
+
+    inline void write_nd(char* p, uint64_t v, int n)
+    {
+        for (; n >= 8; n -= 8)
+        {
+            write_8d(p + n - 8, static_cast<uint32_t>(v % 100'000'000));
+            v /= 100'000'000;
+        }
+        for (int i = n - 1; i >= 0; --i)
+        {
+            p[i] = '0' + static_cast<char>(v % 10);
+            v /= 10;
+        }
+    }
+
+    inline constexpr std::array<uint64_t, 13> powers_of_10 = []()
+    {
+        std::array<uint64_t, 13> powers {};
+        uint64_t value = 1;
+        for (auto& p : powers)
+        {
+            p = value;
+            value *= 10;
+        }
+        return powers;
+    }();
+
+    // Broken down times of one block, one array per field so each field loop is branchless.
+    template <std::size_t size>
+    struct civil_times_t
+    {
+        std::array<int64_t, size> ns;
+        std::array<uint16_t, size> year;
+        std::array<uint16_t, size> day_of_year;
+        std::array<uint8_t, size> month;
+        std::array<uint8_t, size> day;
+        std::array<uint8_t, size> hour;
+        std::array<uint8_t, size> minute;
+        std::array<uint8_t, size> second;
+        std::array<uint32_t, size> nanosecond;
+        std::array<uint8_t, size> special;
+    };
+
+    enum class special_value : uint8_t
+    {
+        none = 0,
+        fill,
+        pad
+    };
+
+    // CDF fill and pad values, rendered like cdf-repr.hpp does instead of being converted.
+    inline special_value special_kind(const tt2000_t& v)
+    {
+        constexpr auto min = std::numeric_limits<int64_t>::min();
+        if (v.nseconds == min || v.nseconds == min + 3)
+            return special_value::fill;
+        if (v.nseconds == min + 1)
+            return special_value::pad;
+        return special_value::none;
+    }
+
+    inline special_value special_kind(const epoch& v)
+    {
+        if (v.mseconds == -1e31)
+            return special_value::fill;
+        if (v.mseconds == 0.)
+            return special_value::pad;
+        return special_value::none;
+    }
+
+    inline special_value special_kind(const epoch16& v)
+    {
+        if (v.seconds == -1e31 && v.picoseconds == -1e31)
+            return special_value::fill;
+        if (v.seconds == 0. && v.picoseconds == 0.)
+            return special_value::pad;
+        return special_value::none;
+    }
+
+    /* Days since 1970 to proleptic Gregorian civil date, from Howard Hinnant's
+     * chrono-Compatible Low-Level Date Algorithms, plus the day of the year.
+     */
+    inline void civil_from_days(int64_t z, uint16_t& year, uint8_t& month, uint8_t& day,
+        uint16_t& day_of_year)
+    {
+        z += 719468;
+        const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const auto doe = static_cast<uint32_t>(z - era * 146097);
+        const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100); // from March 1st
+        const uint32_t mp = (5 * doy + 2) / 153;
+        const uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+        const uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+        const int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+        const bool leap = (y % 4 == 0) && ((y % 100 != 0) || (y % 400 == 0));
+        // %Y is always four digits, years outside of [0, 9999] are clamped
+        year = static_cast<uint16_t>(std::clamp<int64_t>(y, 0, 9999));
+        month = static_cast<uint8_t>(m);
+        day = static_cast<uint8_t>(d);
+        day_of_year = static_cast<uint16_t>(m <= 2 ? doy - 306 + 1 : doy + 59 + leap + 1);
+    }
+
+    template <std::size_t size>
+    inline void break_down(civil_times_t<size>& times, std::size_t count)
+    {
+        constexpr int64_t ns_per_day = 86'400'000'000'000;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            int64_t days = times.ns[i] / ns_per_day;
+            int64_t ns_of_day = times.ns[i] % ns_per_day;
+            if (ns_of_day < 0)
+            {
+                days -= 1;
+                ns_of_day += ns_per_day;
+            }
+            civil_from_days(
+                days, times.year[i], times.month[i], times.day[i], times.day_of_year[i]);
+            const auto s = static_cast<uint32_t>(ns_of_day / 1'000'000'000);
+            times.nanosecond[i] = static_cast<uint32_t>(ns_of_day % 1'000'000'000);
+            times.hour[i] = static_cast<uint8_t>(s / 3600);
+            times.minute[i] = static_cast<uint8_t>((s / 60) % 60);
+            times.second[i] = static_cast<uint8_t>(s % 60);
+        }
+    }
+
+    template <std::size_t size>
+    inline void set_special(civil_times_t<size>& times, std::size_t i)
+    {
+        const bool fill = times.special[i] == static_cast<uint8_t>(special_value::fill);
+        times.year[i] = fill ? 9999 : 0;
+        times.month[i] = fill ? 12 : 1;
+        times.day[i] = fill ? 31 : 1;
+        times.day_of_year[i] = fill ? 365 : 1;
+        times.hour[i] = fill ? 23 : 0;
+        times.minute[i] = fill ? 59 : 0;
+        times.second[i] = fill ? 59 : 0;
+        times.nanosecond[i] = fill ? 999'999'999 : 0;
+    }
+
+}
+
+enum class field_kind : uint8_t
+{
+    YEAR,
+    MONTH,
+    DAY,
+    DOY,
+    HOUR,
+    MINUTE,
+    SECOND
+};
+
+struct field
+{
+    uint16_t offset;
+    field_kind kind;
+};
+
+struct plan
+{
+    std::string tmpl;
+    std::vector<field> fields;
+    uint16_t subsec_offset = 0;
+    uint8_t subsec_digits = 0;
+    bool needs_doy = false;
+
+    // Length of every formatted string.
+    [[nodiscard]] inline std::size_t width() const noexcept { return std::size(tmpl); }
+};
+
+// %S sub-seconds digits, matching the resolution of to_time_point for this type.
+template <cdf_time_t time_t>
+constexpr int default_subsec_digits()
+{
+    using tp_t = decltype(cdf::to_time_point(std::declval<time_t>()));
+    using period = typename tp_t::duration::period;
+    if constexpr (std::is_same_v<period, std::pico>)
+        return 12;
+    else if constexpr (std::is_same_v<period, std::nano>)
+        return 9;
+    else if constexpr (std::is_same_v<period, std::micro>)
+        return 6;
+    else if constexpr (std::is_same_v<period, std::milli>)
+        return 3;
+    else
+        return 0;
+}
+
+/*
+ * Supported specifiers: %Y %m %d %j %H %M %S (with sub-seconds, see default_subsec_digits)
+ * and %%, anything else throws std::invalid_argument.
+ */
+template <cdf_time_t time_t>
+[[nodiscard]] plan compile(std::string_view format)
+{
+    plan p;
+    const int subsec_n = default_subsec_digits<time_t>();
+    const auto add_field = [&p](field_kind kind, std::size_t digits)
+    {
+        p.fields.push_back({ static_cast<uint16_t>(p.tmpl.size()), kind });
+        p.tmpl.append(digits, '0');
+    };
+    for (std::size_t i = 0; i < format.size(); ++i)
+    {
+        if (format[i] == '%' && i + 1 < format.size())
+        {
+            ++i;
+            switch (format[i])
+            {
+                case 'Y':
+                    add_field(field_kind::YEAR, 4);
+                    break;
+                case 'm':
+                    add_field(field_kind::MONTH, 2);
+                    break;
+                case 'd':
+                    add_field(field_kind::DAY, 2);
+                    break;
+                case 'j':
+                    add_field(field_kind::DOY, 3);
+                    p.needs_doy = true;
+                    break;
+                case 'H':
+                    add_field(field_kind::HOUR, 2);
+                    break;
+                case 'M':
+                    add_field(field_kind::MINUTE, 2);
+                    break;
+                case 'S':
+                    add_field(field_kind::SECOND, 2);
+                    if (subsec_n > 0)
+                    {
+                        p.tmpl += '.';
+                        p.subsec_offset = static_cast<uint16_t>(p.tmpl.size());
+                        p.subsec_digits = static_cast<uint8_t>(subsec_n);
+                        p.tmpl.append(static_cast<std::size_t>(subsec_n), '0');
+                    }
+                    break;
+                case '%':
+                    p.tmpl += '%';
+                    break;
+                default:
+                    throw std::invalid_argument(
+                        fmt::format("unsupported time format specifier '%{}'", format[i]));
+            }
+        }
+        else
+        {
+            p.tmpl += format[i];
+        }
+    }
+    if (p.tmpl.size() > std::numeric_limits<uint16_t>::max())
+        throw std::invalid_argument("time format is too long");
+    return p;
+}
+
+// Single threaded, see format for large inputs.
+template <cdf_time_t time_t>
+void format_chunk(const std::span<const time_t>& input, char* output, const plan& p)
+{
+    constexpr std::size_t block = 256;
+    using namespace _details;
+    civil_times_t<block> times;
+    const auto width = p.width();
+    for (std::size_t first = 0; first < std::size(input); first += block)
+    {
+        const auto count = std::min(block, std::size(input) - first);
+        const auto values = input.subspan(first, count);
+        auto* out = output + first * width;
+
+        bool has_special = false;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            times.special[i] = static_cast<uint8_t>(special_kind(values[i]));
+            has_special |= times.special[i] != 0;
+        }
+        if (not has_special)
+        {
+            chrono::_impl::_to_ns_from_1970(values, times.ns.data());
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                times.ns[i] = 0;
+                if (times.special[i] == 0)
+                    chrono::_impl::scalar_to_ns_from_1970(values.subspan(i, 1), &times.ns[i]);
+            }
+        }
+        break_down(times, count);
+        if (has_special)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (times.special[i] != 0)
+                    set_special(times, i);
+            }
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+            std::memcpy(out + i * width, p.tmpl.data(), width);
+        for (const auto& f : p.fields)
+        {
+            auto* dest = out + f.offset;
+            switch (f.kind)
+            {
+                case field_kind::YEAR:
+                    for (std::size_t i = 0; i < count; ++i)
+                        write_4d(dest + i * width, times.year[i]);
+                    break;
+                case field_kind::MONTH:
+                    for (std::size_t i = 0; i < count; ++i)
+                        write_2d(dest + i * width, times.month[i]);
+                    break;
+                case field_kind::DAY:
+                    for (std::size_t i = 0; i < count; ++i)
+                        write_2d(dest + i * width, times.day[i]);
+                    break;
+                case field_kind::DOY:
+                    for (std::size_t i = 0; i < count; ++i)
+                        write_3d(dest + i * width, times.day_of_year[i]);
+                    break;
+                case field_kind::HOUR:
+                    for (std::size_t i = 0; i < count; ++i)
+                        write_2d(dest + i * width, times.hour[i]);
+                    break;
+                case field_kind::MINUTE:
+                    for (std::size_t i = 0; i < count; ++i)
+                        write_2d(dest + i * width, times.minute[i]);
+                    break;
+                case field_kind::SECOND:
+                    for (std::size_t i = 0; i < count; ++i)
+                        write_2d(dest + i * width, times.second[i]);
+                    break;
+            }
+        }
+        if (p.subsec_digits > 0)
+        {
+            auto* dest = out + p.subsec_offset;
+            const int digits = p.subsec_digits;
+            if (digits == 9)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    dest[i * width] = '0' + static_cast<char>(times.nanosecond[i] / 100'000'000);
+                    write_8d(dest + i * width + 1, times.nanosecond[i] % 100'000'000);
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const uint64_t subsec = digits < 9
+                        ? times.nanosecond[i] / powers_of_10[9 - digits]
+                        : times.nanosecond[i] * powers_of_10[digits - 9];
+                    write_nd(dest + i * width, subsec, digits);
+                }
+            }
+        }
+    }
+}
+
+// Formats input into output (std::size(input) * p.width() bytes), using the thread pool for
+// large inputs.
+template <cdf_time_t time_t>
+void format(const std::span<const time_t>& input, char* output, const plan& p)
+{
+    static constexpr std::size_t min_chunk = 1024;
+    parallel::parallel_chunks(std::size(input), min_chunk,
+        [&input, output, &p](std::size_t first, std::size_t size)
+        { format_chunk(input.subspan(first, size), output + first * p.width(), p); });
+}
+
+}
@@ -0,0 +1,378 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+
+#include "cdf-chrono-constants.hpp"
+#include "cdf-chrono.hpp"
+#include "cdf-leap-seconds.h"
+#include "cdfpp/cdf-enums.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include <fmt/core.h>
+
+/*
+ * ISO-8601 strings to CDF time types, in bulk.
+ * Accepted syntax is YYYY-MM-DD[(T| )hh:mm[:ss[.f...]]][Z], trailing spaces and '\0'
+ * padding are ignored so that fixed width columns (numpy 'S' arrays, CSV fields) can be
+ * parsed in place. The YYYY-MM-DDThh:mm:ss prefix is validated and decoded with a couple of
+ * 64 bits registers (SWAR), fractions eight digits at a time, anything else goes through a
+ * plain scalar path.
+ * Leap seconds (hh:mm:ss = 23:59:60) are only accepted on the days listed in
+ * cdf-leap-seconds.h, they map to their own TT2000 value and roll over to the next day for
+ * epoch and epoch16 which have no leap seconds. Fractions are truncated to the resolution of
+ * the output type.
+ * Invalid rows throw std::invalid_argument.
+ */
+namespace cdf::chrono::time_parse
+{
+
+namespace _details
+{
+    struct civil_time_t
+    {
+        int32_t year;
+        uint32_t month;
+        uint32_t day;
+        uint32_t hour;
+        uint32_t minute;
+        uint32_t second;
+        uint64_t picoseconds;
+    };
+
+    inline constexpr uint64_t ascii_zeros = 0x3030303030303030ULL;
+
+    // True if every byte of x selected by mask is an ASCII digit.
+    inline bool all_digits(uint64_t x, uint64_t mask)
+    {
+        x = (x & mask) | (ascii_zeros & ~mask);
+        const uint64_t overflow = ((x + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4;
+        return ((x & 0xF0F0F0F0F0F0F0F0ULL) | overflow) == 0x3333333333333333ULL;
+    }
+
+    // Eight ASCII digits (little endian load) to their value.
+    inline uint32_t eight_digits(uint64_t x)
+    {
+        x = ((x & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+        x = ((x & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+        return static_cast<uint32_t>(((x & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+    }
+
+    inline uint64_t load_8(const char* p)
+    {
+        uint64_t x;
+        std::memcpy(&x, p, 8);
+        return x;
+    }
+
+    inline bool is_digit(char c)
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    inline bool digits(const char*& p, const char* end, std::size_t n, uint32_t& value)
+    {
+        if (static_cast<std::size_t>(end - p) < n)
+            return false;
+        value = 0;
+        for (std::size_t i = 0; i < n; ++i, ++p)
+        {
+            if (not is_digit(*p))
+                return false;
+            value = value * 10 + static_cast<uint32_t>(*p - '0');
+        }
+        return true;
+    }
+
+    inline bool expect(const char*& p, const char* end, char c)
+    {
+        if (p == end || *p != c)
+            return false;
+        ++p;
+        return true;
+    }
+
+    // "YYYY-MM-DDThh:mm:ss" (or with a space instead of T) in three registers loads.
+    inline bool parse_head(const char* p, civil_time_t& t)
+    {
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            // "YYYY-MM-" and "DDThh:mm", separators bytes masked out of the digits checks
+            constexpr uint64_t date_digits = 0x00FFFF00FFFFFFFFULL;
+            constexpr uint64_t date_separators = 0x2D00002D00000000ULL;
+            constexpr uint64_t time_digits = 0xFFFF00FFFF00FFFFULL;
+            constexpr uint64_t time_separators = 0x00003A0000000000ULL;
+            const uint64_t date = load_8(p);
+            const uint64_t time = load_8(p + 8);
+            if (not(all_digits(date, date_digits) && all_digits(time, time_digits)
+                    && (date & ~date_digits) == date_separators
+                    && (time & 0x0000FF0000000000ULL) == time_separators
+                    && (p[10] == 'T' || p[10] == ' ')
+                    && p[16] == ':' && is_digit(p[17]) && is_digit(p[18])))
+                return false;
+            // digits are validated, their low nibble is their value
+            const uint64_t d = date & 0x0F0F0F0F0F0F0F0FULL;
+            const uint64_t h = time & 0x0F0F0F0F0F0F0F0FULL;
+            const auto byte
+                = [](uint64_t v, int i) { return static_cast<uint32_t>((v >> (8 * i)) & 0xF); };
+            t.year = static_cast<int32_t>(
+                byte(d, 0) * 1000 + byte(d, 1) * 100 + byte(d, 2) * 10 + byte(d, 3));
+            t.month = byte(d, 5) * 10 + byte(d, 6);
+            t.day = byte(h, 0) * 10 + byte(h, 1);
+            t.hour = byte(h, 3) * 10 + byte(h, 4);
+            t.minute = byte(h, 6) * 10 + byte(h, 7);
+            t.second = static_cast<uint32_t>(p[17] - '0') * 10 + static_cast<uint32_t>(p[18] - '0');
+            return true;
+        }
+        return false;
+    }
+
+    inline bool parse_fraction(const char*& p, const char* end, uint64_t& picoseconds)
+    {
+        uint64_t value = 0;
+        int n = 0;
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            if (end - p >= 8 && all_digits(load_8(p), ~uint64_t { 0 }))
+            {
+                value = eight_digits(load_8(p));
+                n = 8;
+                p += 8;
+            }
+        }
+        for (; p != end && is_digit(*p); ++p, ++n)
+        {
+            if (n < 12)
+                value = value * 10 + static_cast<uint64_t>(*p - '0');
+        }
+        if (n == 0)
+            return false;
+        for (int i = n; i < 12; ++i)
+            value *= 10;
+        picoseconds = value;
+        return true;
+    }
+
+    constexpr uint32_t days_in_month(int32_t y, uint32_t m)
+    {
+        constexpr uint32_t days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        const bool leap = (y % 4 == 0) && ((y % 100 != 0) || (y % 400 == 0));
+        return days[m - 1] + (m == 2 && leap);
+    }
+
+    // Howard Hinnant's days_from_civil, days since 1970-01-01.
+    constexpr int64_t days_from_civil(int32_t y, uint32_t m, uint32_t d)
+    {
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const auto yoe = static_cast<uint32_t>(y - era * 400);
+        const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    // UTC days ending with a leap second, i.e. the day before each leap seconds table entry.
+    inline bool ends_with_leap_second(int64_t days)
+    {
+        constexpr int64_t ns_per_day = 86'400'000'000'000;
+        const auto& table = leap_seconds::leap_seconds_tt2000;
+        // the first entry is the initial 10s TAI-UTC offset, not an inserted second
+        return std::any_of(std::cbegin(table) + 1, std::cend(table),
+            [next_day = (days + 1) * ns_per_day](const auto& entry)
+            { return entry.first == next_day; });
+    }
+
+    inline bool parse(std::string_view s, civil_time_t& t)
+    {
+        while (not s.empty() && (s.back() == '\0' || s.back() == ' '))
+            s.remove_suffix(1);
+        while (not s.empty() && s.front() == ' ')
+            s.remove_prefix(1);
+        const char* p = s.data();
+        const char* end = p + s.size();
+        t = civil_time_t { 0, 0, 0, 0, 0, 0, 0 };
+        if (s.size() >= 19 && parse_head(p, t))
+        {
+            p += 19;
+        }
+        else
+        {
+            uint32_t year;
+            if (not(digits(p, end, 4, year) && expect(p, end, '-') && digits(p, end, 2, t.month)
+                    && expect(p, end, '-') && digits(p, end, 2, t.day)))
+                return false;
+            t.year = static_cast<int32_t>(year);
+            if (p != end && (*p == 'T' || *p == ' '))
+            {
+                ++p;
+                if (not(digits(p, end, 2, t.hour) && expect(p, end, ':')
+                        && digits(p, end, 2, t.minute)))
+                    return false;
+                if (p != end && *p == ':')
+                {
+                    ++p;
+                    if (not digits(p, end, 2, t.second))
+                        return false;
+                }
+            }
+        }
+        if (p != end && *p == '.')
+        {
+            ++p;
+            if (not parse_fraction(p, end, t.picoseconds))
+                return false;
+        }
+        if (p != end && *p == 'Z')
+            ++p;
+        if (p != end)
+            return false;
+        if (t.month < 1 || t.month > 12 || t.day < 1 || t.day > days_in_month(t.year, t.month)
+            || t.hour > 23 || t.minute > 59 || t.second > 60)
+            return false;
+        return t.second < 60
+            || (t.hour == 23 && t.minute == 59
+                && ends_with_leap_second(days_from_civil(t.year, t.month, t.day)));
+    }
+
+    [[noreturn]] inline void throw_invalid(std::size_t row, std::string_view s)
+    {
+        throw std::invalid_argument(
+            fmt::format("invalid ISO-8601 time at row {}: '{}'", row, s.substr(0, s.find('\0'))));
+    }
+
+    inline int64_t seconds_from_0000(const civil_time_t& t)
+    {
+        return (days_from_civil(t.year, t.month, t.day) + 719528) * 86'400
+            + static_cast<int64_t>(t.hour * 3600 + t.minute * 60 + t.second);
+    }
+
+    inline epoch to_epoch(const civil_time_t& t)
+    {
+        return epoch { static_cast<double>(
+            seconds_from_0000(t) * 1'000 + static_cast<int64_t>(t.picoseconds / 1'000'000'000)) };
+    }
+
+    inline epoch16 to_epoch16(const civil_time_t& t)
+    {
+        return epoch16 { static_cast<double>(seconds_from_0000(t)),
+            static_cast<double>(t.picoseconds) };
+    }
+
+    template <cdf_time_t time_t>
+    void parse_rows(const auto& row, std::size_t first, std::size_t count, time_t* output)
+    {
+        constexpr std::size_t block = 256;
+        for (std::size_t block_first = first; block_first < first + count; block_first += block)
+        {
+            const auto n = std::min(block, first + count - block_first);
+            if constexpr (std::is_same_v<time_t, tt2000_t>)
+            {
+                // ns since 1970 with leap seconds folded on ss=59, then the vectorized encoder
+                constexpr int32_t min_year = 1678, max_year = 2261;
+                std::array<int64_t, block> ns;
+                std::array<bool, block> leap;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    civil_time_t t;
+                    const auto s = row(block_first + i);
+                    if (not parse(s, t) || t.year < min_year || t.year > max_year)
+                        throw_invalid(block_first + i, s);
+                    leap[i] = t.second == 60;
+                    ns[i] = (days_from_civil(t.year, t.month, t.day) * 86'400
+                                + static_cast<int64_t>(t.hour * 3600 + t.minute * 60
+                                    + std::min(t.second, 59u)))
+                            * 1'000'000'000
+                        + static_cast<int64_t>(t.picoseconds / 1'000);
+                }
+                auto* out = output + (block_first - first);
+                chrono::_impl::_from_ns_from_1970(std::span<const int64_t> { ns.data(), n }, out);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (leap[i])
+                        out[i].nseconds += 1'000'000'000;
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    civil_time_t t;
+                    const auto s = row(block_first + i);
+                    if (not parse(s, t))
+                        throw_invalid(block_first + i, s);
+                    if constexpr (std::is_same_v<time_t, epoch>)
+                        output[block_first - first + i] = to_epoch(t);
+                    else
+                        output[block_first - first + i] = to_epoch16(t);
+                }
+            }
+        }
+    }
+
+    template <cdf_time_t time_t>
+    void parse_all(const auto& row, std::size_t count, time_t* output)
+    {
+        static constexpr std::size_t min_chunk = 4096;
+        parallel::parallel_chunks(count, min_chunk,
+            [&row, output](std::size_t first, std::size_t size)
+            { parse_rows(row, first, size, output + first); });
+    }
+}
+
+template <cdf_time_t time_t>
+[[nodiscard]] time_t parse_iso8601(std::string_view input)
+{
+    time_t result;
+    _details::parse_rows(
+        [input](std::size_t) { return input; }, std::size_t { 0 }, std::size_t { 1 }, &result);
+    return result;
+}
+
+template <cdf_time_t time_t>
+void parse_iso8601(const std::span<const std::string_view>& input, time_t* output)
+{
+    _details::parse_all(
+        [&input](std::size_t i) { return input[i]; }, std::size(input), output);
+}
+
+// count fixed width rows, row i is [input + i * width, input + (i + 1) * width).
+template <cdf_time_t time_t>
+void parse_iso8601(const char* input, std::size_t count, std::size_t width, time_t* output)
+{
+    _details::parse_all([input, width](std::size_t i)
+        { return std::string_view { input + i * width, width }; }, count, output);
+}
+
+}
@@ -33,11 +33,20 @@
 #include "cdf-repr.hpp"
 #include "no_init_vector.hpp"
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iomanip>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <source_location>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
 #include <fmt/core.h>
@@ -60,8 +69,8 @@ namespace cdf
 {
     if (std::size(shape) > 0)
     {
-        return std::accumulate(
-            std::cbegin(shape), std::cend(shape), 1UL, std::multiplies<std::size_t>());
+        return std::accumulate(std::cbegin(shape), std::cend(shape), std::size_t { 1 },
+            std::multiplies<std::size_t>());
     }
     return 0UL;
 }
@@ -71,11 +80,49 @@ template <typename T>
 {
     if (cbegin != cend)
     {
-        return std::accumulate(cbegin, cend, 1UL, std::multiplies<std::size_t>());
+        return std::accumulate(cbegin, cend, std::size_t { 1 }, std::multiplies<std::size_t>());
     }
     return 0UL;
 }
 
+// Half open [start, stop) range of records, stop is clamped to the variable length.
+struct record_range
+{
+    std::size_t start = 0;
+    std::size_t stop = std::numeric_limits<std::size_t>::max();
+};
+
+class record_chunks;
+struct compact_records;
+
+namespace _details
+{
+    /*
+     * Guards the lazy -> loaded transition of a variable's values. `loaded` is set exactly
+     * when p_data holds decoded values that passed the shape check, so readers that see it
+     * set skip the mutex entirely. Copying or assigning a variable must not share (or copy)
+     * the mutex, the destination gets a fresh one and the flag of the p_data it copied.
+     */
+    struct load_latch
+    {
+        load_latch() = default;
+        load_latch(const load_latch& other) noexcept : loaded { other.is_set() } { }
+        load_latch& operator=(const load_latch& other) noexcept
+        {
+            loaded.store(other.is_set(), std::memory_order_release);
+            return *this;
+        }
+        [[nodiscard]] bool is_set() const noexcept
+        {
+            return loaded.load(std::memory_order_acquire);
+        }
+        void set() noexcept { loaded.store(true, std::memory_order_release); }
+
+        std::mutex mutex;
+        std::atomic<bool> loaded { false };
+    };
+}
+
 /*
  * Before version 1.0 it would make sense to consider exposing a view to data instead of
  * a vector. That would allow zero copy from and to any user defined data structure
@@ -98,6 +145,7 @@ struct Variable
         bool is_zvariable = true)
             : p_name { name }
             , p_number { number }
+            , p_type { data.type() }
             , p_data { std::move(data) }
             , p_shape { std::move(shape) }
             , p_majority { majority }
@@ -114,6 +162,7 @@ struct Variable
             majority::swap(_data(), p_shape);
         }
         check_shape();
+        p_latch.set();
     }
 
     Variable(const std::string& name, std::size_t number, lazy_data&& data, shape_t&& shape,
@@ -122,6 +171,7 @@ struct Variable
         bool is_zvariable = true)
             : p_name { name }
             , p_number { number }
+            , p_type { data.type() }
             , p_data { std::move(data) }
             , p_shape { std::move(shape) }
             , p_majority { majority }
@@ -179,34 +229,47 @@ struct Variable
     void set_data(const Variable& source)
     {
         p_data = source._data();
+        p_type = source.p_type;
         p_shape = source.p_shape;
         p_is_nrv = source.p_is_nrv;
         p_majority = source.p_majority;
         p_compression = source.p_compression;
+        p_sparse_records = source.p_sparse_records;
+        p_present_records = source.p_present_records;
         check_shape();
+        p_latch.set();
     }
 
 
     void set_data(const data_t& data, const shape_t& shape)
     {
         p_data = data;
+        p_type = data.type();
         p_shape = shape;
+        p_present_records.reset();
         check_shape();
+        p_latch.set();
     }
 
 
     void set_data(data_t&& data, shape_t&& shape)
     {
+        p_type = data.type();
         p_data = std::move(data);
         p_shape = std::move(shape);
+        p_present_records.reset();
         check_shape();
+        p_latch.set();
     }
 
     void set_data(std::pair<data_t, shape_t>&& data)
     {
+        p_type = data.first.type();
         p_data = std::move(data.first);
         p_shape = std::move(data.second);
+        p_present_records.reset();
         check_shape();
+        p_latch.set();
     }
 
     [[nodiscard]] std::size_t bytes() const noexcept
@@ -220,23 +283,18 @@ struct Variable
     [[nodiscard]] const char* bytes_ptr() const noexcept { return _data().bytes_ptr(); }
     [[nodiscard]] char* bytes_ptr() noexcept { return _data().bytes_ptr(); }
 
-    [[nodiscard]] CDF_Types type() const
-    {
-        if (std::holds_alternative<var_data_t>(p_data))
-            return std::get<var_data_t>(p_data).type();
-        return std::get<lazy_data>(p_data).type();
-    }
+    [[nodiscard]] CDF_Types type() const noexcept { return p_type; }
 
     [[nodiscard]] bool is_nrv() const noexcept { return p_is_nrv; }
     [[nodiscard]] bool is_zvariable() const noexcept { return p_is_zvariable; }
 
-    // On-demand probe: walks the variable's VXR chain (index records only, no data)
-    // counting leaf VVR/CVVR blocks; the value is true when records are stored in a
-    // single contiguous block. Computed lazily on first call, then cached, and the
-    // retained file buffer handle is released. Variables not loaded from a file (no
-    // probe set) are reported contiguous.
+    // True when records are stored in a single VVR/CVVR block. The block count comes from
+    // the block table built at open time, it is read on first call then cached and the
+    // probe (with its reference on the table) is released. Variables not loaded from a
+    // file (no probe set) are reported contiguous.
     [[nodiscard]] bool is_contiguous() const
     {
+        std::lock_guard lock { p_latch.mutex };
         if (not p_contiguous.has_value())
             p_contiguous = not p_block_counter or p_block_counter() <= 1;
         p_block_counter = nullptr;
@@ -244,22 +302,55 @@ struct Variable
     }
     void set_block_counter(std::function<std::size_t()> counter)
     {
+        std::lock_guard lock { p_latch.mutex };
         p_block_counter = std::move(counter);
     }
 
+    // Sparse records mode from the file, it tells what records missing from the file (see
+    // present_records) hold once loaded: pad values, a copy of the previous present record,
+    // or pad values again for files that don't declare sparseness but still have gaps.
+    [[nodiscard]] cdf_sparse_records sparse_records() const noexcept { return p_sparse_records; }
+
+    // Ranges of records actually stored in the file, in increasing order. Variables without
+    // missing records (and those not loaded from a file) report a single [0, len()) range.
+    [[nodiscard]] std::vector<record_range> present_records() const
+    {
+        if (p_present_records.has_value())
+            return *p_present_records;
+        if (len() == 0)
+            return {};
+        return { record_range { 0, len() } };
+    }
+
+    // present is left unset when every record is stored in the file.
+    void set_sparse_records(cdf_sparse_records mode,
+        std::optional<std::vector<record_range>> present = std::nullopt)
+    {
+        p_sparse_records = mode;
+        p_present_records = std::move(present);
+    }
+
+    // Only the records stored in the file with their record numbers, decoded straight from
+    // the file when values aren't loaded yet so a lazily opened sparse variable is never
+    // expanded to its dense, mostly padding, form. See compact_records.
+    [[nodiscard]] compact_records compact() const;
+
     [[nodiscard]] std::size_t number() const noexcept { return p_number; }
     [[nodiscard]] cdf_majority majority() const noexcept { return p_majority; }
     [[nodiscard]] cdf_compression_type compression_type() const noexcept { return p_compression; }
     void set_compression_type(cdf_compression_type ct) noexcept { p_compression = ct; }
 
-    [[nodiscard]] inline bool values_loaded() const noexcept
-    {
-        return not std::holds_alternative<lazy_data>(p_data);
-    }
+    [[nodiscard]] inline bool values_loaded() const noexcept { return p_latch.is_set(); }
 
+    // Safe to call from several threads at once on the same variable: the first caller
+    // decodes the values while the others wait for it, then everyone sees the loaded data.
+    // Mutating a variable (set_data, assignment, ...) still requires exclusive access.
     inline void load_values() const
     {
-        if (not values_loaded())
+        if (p_latch.is_set())
+            return;
+        std::lock_guard lock { p_latch.mutex };
+        if (std::holds_alternative<lazy_data>(p_data))
         {
             p_data = std::get<lazy_data>(p_data).load();
             auto& data = std::get<data_t>(p_data);
@@ -267,10 +358,84 @@ struct Variable
             {
                 majority::swap(data, p_shape);
             }
-            check_shape();
         }
+        check_shape();
+        p_latch.set();
+    }
+
+
+    [[nodiscard]] std::size_t record_bytes() const noexcept
+    {
+        if (len() == 0)
+            return 0UL;
+        return bytes() / len();
     }
 
+    // Copies records [first_record, first_record + records_count) to dest in row major
+    // order, dest must hold at least records_count * record_bytes() bytes. When the values
+    // aren't loaded yet and the file allows it, records are decoded straight from the file
+    // into dest and the variable itself stays lazy, only a CVVR the range covers partially is
+    // inflated in a scratch buffer first. Callers reading consecutive ranges can pass the same
+    // cursor to each call, that buffer then stays in the cursor (see records_cursor).
+    void read_records(char* dest, std::size_t first_record, std::size_t records_count,
+        records_cursor* cursor = nullptr) const
+    {
+        if (first_record + records_count > len())
+            throw std::out_of_range { exception_message(
+                fmt::format("Variable {}: records [{}, {}) out of range, variable has {} records",
+                    p_name, first_record, first_record + records_count, len())) };
+        if (records_count == 0)
+            return;
+        if (auto reader = _records_reader())
+        {
+            reader->read_records(dest, first_record, records_count, cursor);
+            if (this->majority() == cdf_majority::column and type() != CDF_Types::CDF_NONE)
+            {
+                shape_t chunk_shape = p_shape;
+                chunk_shape[0] = static_cast<uint32_t>(records_count);
+                cdf_type_dispatch(type(),
+                    [&]<CDF_Types t>()
+                    {
+                        using value_t = from_cdf_type_t<t>;
+                        std::span<value_t> values { reinterpret_cast<value_t*>(dest),
+                            records_count * record_bytes() / sizeof(value_t) };
+                        majority::swap<is_cdf_string_type(t)>(values, chunk_shape);
+                    });
+            }
+        }
+        else
+        {
+            std::memcpy(dest, bytes_ptr() + first_record * record_bytes(),
+                records_count * record_bytes());
+        }
+    }
+
+
+    // Decodes the records in range into dest (row major, native endianness) and returns how
+    // many records were written. When the values aren't loaded yet they are not allocated,
+    // only a compressed block (CVVR) the range covers partially is inflated in a scratch
+    // buffer first (see read_records).
+    std::size_t read_into(std::span<std::byte> dest, record_range range = {}) const
+    {
+        const auto stop = std::min(range.stop, len());
+        if (range.start > stop)
+            throw std::out_of_range { exception_message(fmt::format(
+                "Variable {}: record {} out of range, variable has {} records", p_name,
+                range.start, len())) };
+        const auto count = stop - range.start;
+        if (std::size(dest) < count * record_bytes())
+            throw std::invalid_argument { exception_message(fmt::format(
+                "Variable {}: destination is too small, {} records need {} bytes, got {}",
+                p_name, count, count * record_bytes(), std::size(dest))) };
+        read_records(reinterpret_cast<char*>(std::data(dest)), range.start, count);
+        return count;
+    }
+
+
+    // Streams the variable as batches of records_per_chunk decoded records, without ever
+    // loading it whole, see record_chunks.
+    [[nodiscard]] record_chunks chunks(std::size_t records_per_chunk) const;
+
 
     template <typename... Ts>
     friend auto visit(Variable& var, Ts... lambdas);
@@ -303,6 +468,20 @@ struct Variable
 
 
 private:
+    // A copy of the lazy loader when values can still be streamed from the file, taken under
+    // the latch so that it can't race with a concurrent load_values(). Reading records
+    // through it doesn't touch the variable at all.
+    [[nodiscard]] std::optional<lazy_data> _records_reader() const
+    {
+        if (p_latch.is_set())
+            return std::nullopt;
+        std::lock_guard lock { p_latch.mutex };
+        if (std::holds_alternative<lazy_data>(p_data)
+            and std::get<lazy_data>(p_data).can_read_records())
+            return std::get<lazy_data>(p_data);
+        return std::nullopt;
+    }
+
     [[nodiscard]] var_data_t& _data()
     {
         load_values();
@@ -315,13 +494,14 @@ private:
         return std::get<var_data_t>(p_data);
     }
 
+    // p_data must hold decoded values, it is read directly since load_values() calls this
+    // with the latch mutex held
     void check_shape() const
     {
-
-        if (flat_size(p_shape) != _data().size()
-            and not(is_nrv() and _data().size() == 0UL
-                and (_data().type() == CDF_Types::CDF_CHAR
-                    or _data().type() == CDF_Types::CDF_UCHAR)))
+        const auto& data = std::get<var_data_t>(p_data);
+        if (flat_size(p_shape) != data.size()
+            and not(is_nrv() and data.size() == 0UL
+                and (data.type() == CDF_Types::CDF_CHAR or data.type() == CDF_Types::CDF_UCHAR)))
             throw std::invalid_argument { exception_message(fmt::format(R"(
 Variable: given shape and data size doesn't match:
 Variable name: "{}"
@@ -329,19 +509,24 @@ Variable name: "{}"
 Data:
     size: {}
 )",
-                p_name, p_shape, flat_size(p_shape), _data().size())) };
+                p_name, p_shape, flat_size(p_shape), data.size())) };
     }
 
     std::string p_name;
     std::size_t p_number;
+    // kept next to p_data rather than read from it so that type() never takes the latch
+    CDF_Types p_type = CDF_Types::CDF_NONE;
     mutable std::variant<lazy_data, var_data_t> p_data;
     shape_t p_shape;
     cdf_majority p_majority;
     bool p_is_nrv;
     cdf_compression_type p_compression;
     bool p_is_zvariable = true;
+    cdf_sparse_records p_sparse_records = cdf_sparse_records::no_sparse;
+    std::optional<std::vector<record_range>> p_present_records;
     mutable std::function<std::size_t()> p_block_counter;
     mutable std::optional<bool> p_contiguous;
+    mutable _details::load_latch p_latch;
 };
 
 template <typename... Ts>
@@ -350,6 +535,130 @@ auto visit(Variable& var, Ts... lambdas)
     return visit(var.p_data, lambdas...);
 }
 
+// A batch of consecutive records, decoded, byte swapped and in row major order.
+struct record_chunk
+{
+    std::size_t first_record = 0;
+    Variable::shape_t shape; // shape[0] is the number of records in this chunk
+    data_t values;
+};
+
+/*
+ * Single pass range over a variable cut in chunks of records_per_chunk records (the last one
+ * may be shorter). A chunk is decoded when the iterator reaches it while the file reads of the
+ * next one are already started, and a CVVR spanning two chunks is inflated once (see
+ * records_cursor), so at most one chunk plus one decompressed block are alive at once. The
+ * variable must outlive the range and must not be modified while iterating.
+ */
+class record_chunks
+{
+public:
+    struct sentinel
+    {
+    };
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = record_chunk;
+        using difference_type = std::ptrdiff_t;
+
+        iterator(const Variable& var, std::size_t records_per_chunk)
+                : p_var { &var }, p_records_per_chunk { records_per_chunk }
+        {
+            p_cursor.readahead = records_per_chunk;
+            ++(*this);
+        }
+        iterator(iterator&&) = default;
+        iterator& operator=(iterator&&) = default;
+
+        [[nodiscard]] record_chunk& operator*() noexcept { return p_current; }
+        [[nodiscard]] const record_chunk& operator*() const noexcept { return p_current; }
+        [[nodiscard]] const record_chunk* operator->() const noexcept { return &p_current; }
+
+        iterator& operator++()
+        {
+            // the previous chunk goes away first, it may have been moved out anyway
+            p_current = {};
+            if (p_next_record < p_var->len())
+            {
+                const auto count = std::min(p_records_per_chunk, p_var->len() - p_next_record);
+                p_current = record_chunk { p_next_record, p_var->shape(),
+                    new_data_container(count * p_var->record_bytes(), p_var->type()) };
+                p_current.shape[0] = static_cast<uint32_t>(count);
+                p_var->read_records(p_current.values.bytes_ptr(), p_next_record, count, &p_cursor);
+                p_next_record += count;
+            }
+            else
+                p_done = true;
+            return *this;
+        }
+        void operator++(int) { ++(*this); }
+
+        [[nodiscard]] bool operator==(const sentinel&) const noexcept { return p_done; }
+
+    private:
+        const Variable* p_var;
+        std::size_t p_records_per_chunk;
+        std::size_t p_next_record = 0;
+        record_chunk p_current;
+        records_cursor p_cursor;
+        bool p_done = false;
+    };
+
+    record_chunks(const Variable& var, std::size_t records_per_chunk)
+            : p_var { &var }, p_records_per_chunk { records_per_chunk }
+    {
+        if (records_per_chunk == 0)
+            throw std::invalid_argument { "records_per_chunk must be strictly positive" };
+    }
+
+    [[nodiscard]] iterator begin() const { return iterator { *p_var, p_records_per_chunk }; }
+    [[nodiscard]] sentinel end() const noexcept { return {}; }
+
+private:
+    const Variable* p_var;
+    std::size_t p_records_per_chunk;
+};
+
+inline record_chunks Variable::chunks(std::size_t records_per_chunk) const
+{
+    return record_chunks { *this, records_per_chunk };
+}
+
+// Present records of a variable (see Variable::present_records), packed one after the other.
+struct compact_records
+{
+    no_init_vector<uint32_t> record_numbers;
+    Variable::shape_t shape; // shape[0] is std::size(record_numbers)
+    data_t values;
+};
+
+inline compact_records Variable::compact() const
+{
+    const auto ranges = present_records();
+    const auto count = std::accumulate(std::cbegin(ranges), std::cend(ranges), std::size_t { 0 },
+        [](std::size_t total, const record_range& r) { return total + (r.stop - r.start); });
+    compact_records result { no_init_vector<uint32_t>(count), p_shape,
+        new_data_container(count * record_bytes(), type()) };
+    if (not std::empty(result.shape))
+        result.shape[0] = static_cast<uint32_t>(count);
+    std::size_t offset = 0;
+    for (const auto& r : ranges)
+    {
+        if (result.values.type() != CDF_Types::CDF_NONE)
+            read_records(result.values.bytes_ptr() + offset * record_bytes(), r.start,
+                r.stop - r.start);
+        std::iota(std::begin(result.record_numbers) + offset,
+            std::begin(result.record_numbers) + offset + (r.stop - r.start),
+            static_cast<uint32_t>(r.start));
+        offset += r.stop - r.start;
+    }
+    return result;
+}
+
+
 } // namespace cdf
 
 template <class stream_t>
@@ -29,7 +29,9 @@
 #include "cdfpp/chrono/cdf-chrono-constants.hpp"
 #include "cdfpp/chrono/cdf-chrono-impl.hpp"
 #include "cdfpp/chrono/cdf-leap-seconds.h"
+#include <algorithm>
 #include <array>
+#include <utility>
 #include <xsimd/xsimd.hpp>
 
 
@@ -81,6 +83,9 @@ void sfence()
 }
 
 
+// Outputs at least this big (bytes) bypass the cache on the sorted TT2000 path.
+inline constexpr std::size_t _streaming_threshold = 1 << 20;
+
 template <class Arch, typename T>
 static inline std::tuple<std::span<const T>,int64_t*>  _realign(Arch, const std::span<const T>& input,
     int64_t* const output, const auto& scalar_function)
@@ -133,7 +138,7 @@ struct _to_ns_from_1970_epoch16_t
 
         const auto offset = xsimd::broadcast<double, Arch>(constants::epoch_offset_seconds);
         const auto ps_in_ns = xsimd::broadcast<double, Arch>(1'000);
-        const auto ns_in_s = xsimd::broadcast<double, Arch>(1'000'000'000);
+        const auto ns_in_s = xsimd::broadcast<int64_t, Arch>(1'000'000'000);
         std::size_t i = 0;
         for (; i + simd_size <= count; i += simd_size)
         {
@@ -141,7 +146,8 @@ struct _to_ns_from_1970_epoch16_t
                 = batchin_type::gather(reinterpret_cast<const double*>(&input[i]), even_indexes);
             auto picos
                 = batchin_type::gather(reinterpret_cast<const double*>(&input[i]), odd_indexes);
-            xsimd::batch_cast<int64_t>(((seconds - offset) * ns_in_s + (picos / ps_in_ns)))
+            (xsimd::batch_cast<int64_t>(seconds - offset) * ns_in_s
+                + xsimd::batch_cast<int64_t>(picos / ps_in_ns))
                 .store(output + i, output_align_mode {});
         }
         if (i < count)
@@ -159,6 +165,10 @@ template <class Arch>
 void _to_ns_from_1970_epoch16_t::operator()(
     Arch, const std::span<const epoch16>& input, int64_t* const output)
 {
+    // fallback to scalar implementation where it's not worth vectorizing
+    // on x86 double -> int64 conversions are only native with AVX512, sse2
+    // and avx2 emulate them lane by lane, we need at least 512 bits SIMD
+    // registers to make it worth it.
     if constexpr (cdf::helpers::is_any_of_v<Arch, xsimd::unavailable, xsimd::sse2, xsimd::avx2>)
     {
         return _impl::scalar_to_ns_from_1970(input, output);
@@ -198,12 +208,15 @@ struct _to_ns_from_1970_epoch_t
         constexpr std::size_t simd_size = batchout_type::size;
         const auto offset = xsimd::broadcast<double, Arch>(constants::epoch_offset_miliseconds);
         const auto ns_in_ms = xsimd::broadcast<double, Arch>(1'000'000);
+        const auto ns_in_ms_i = xsimd::broadcast<int64_t, Arch>(1'000'000);
         std::size_t i = 0;
         for (; i + simd_size <= count; i += simd_size)
         {
-            auto epoch_batch = batchin_type::load(&input[i].mseconds, input_align_mode {});
-            store<Arch, output_align_mode>(
-                xsimd::batch_cast<int64_t>((epoch_batch - offset) * ns_in_ms), output + i);
+            const auto ms = batchin_type::load(&input[i].mseconds, input_align_mode {}) - offset;
+            const auto whole_ms = xsimd::trunc(ms);
+            store<Arch, output_align_mode>(xsimd::batch_cast<int64_t>(whole_ms) * ns_in_ms_i
+                    + xsimd::batch_cast<int64_t>((ms - whole_ms) * ns_in_ms),
+                output + i);
         }
         if (i < count)
         {
@@ -219,6 +232,10 @@ template <class Arch>
 void _to_ns_from_1970_epoch_t::operator()(
     Arch, const std::span<const epoch>& input, int64_t* const output)
 {
+    // fallback to scalar implementation where it's not worth vectorizing
+    // on x86 double -> int64 conversions are only native with AVX512, sse2
+    // and avx2 emulate them lane by lane, we need at least 512 bits SIMD
+    // registers to make it worth it.
     if constexpr (cdf::helpers::is_any_of_v<Arch, xsimd::unavailable, xsimd::sse2, xsimd::avx2>)
     {
         return _impl::scalar_to_ns_from_1970(input, output);
@@ -279,61 +296,127 @@ struct _to_ns_from_1970_tt2000_t
         }
     }
 
+    /* Any input, any era. Each batch is first checked against the leap second segment of
+     * its first value (found with the scalar hint walk, so sorted data costs two compares per
+     * batch), batches straddling a leap second or holding unsorted values fall back to a
+     * branchless binary search over the padded leap seconds table with gathers.
+     */
     template <class Arch, typename input_align_mode, typename output_align_mode>
     static inline void _unsorted(
         Arch, const std::span<const tt2000_t>& input, int64_t* const output)
     {
         using batch_type = xsimd::batch<int64_t, Arch>;
         constexpr std::size_t simd_size = batch_type::size;
-        std::size_t i = 0;
+        constexpr auto& padded = _impl::padded_leap_seconds_tt2000_reverse;
         const auto count = std::size(input);
-        constexpr auto max_leap_offset = leap_seconds::leap_seconds_tt2000_reverse.back().second;
-        const auto last_leap_sec = xsimd::broadcast<int64_t, Arch>(
-            leap_seconds::leap_seconds_tt2000_reverse.back().first);
-        const auto one_sec = xsimd::broadcast<int64_t, Arch>(1000000000LL);
-
-
+        const auto tt2000_offset = xsimd::broadcast<int64_t, Arch>(constants::tt2000_offset);
+        std::size_t segment = 0;
+        std::size_t i = 0;
         for (; i + simd_size <= count; i += simd_size)
         {
             auto tt2000_batch = batch_type::load(&input[i].nseconds, input_align_mode {});
-            auto offset
-                = xsimd::broadcast<int64_t, Arch>(constants::tt2000_offset - max_leap_offset);
-            int leap_index = std::size(leap_seconds::leap_seconds_tt2000_reverse) - 2;
-            auto needs_correction = (tt2000_batch < last_leap_sec);
-            if (!xsimd::any(needs_correction))
+            segment = _impl::leap_segment(input[i].nseconds, segment);
+            const auto in_segment
+                = (tt2000_batch >= xsimd::broadcast<int64_t, Arch>(padded.thresholds[segment]))
+                & (tt2000_batch < xsimd::broadcast<int64_t, Arch>(padded.thresholds[segment + 1]));
+            if (xsimd::all(in_segment))
             {
-                store<Arch, output_align_mode>(tt2000_batch + offset, &output[i]);
+                store<Arch, output_align_mode>(tt2000_batch + tt2000_offset
+                        - xsimd::broadcast<int64_t, Arch>(padded.offsets[segment]),
+                    &output[i]);
                 continue;
             }
-            while (xsimd::any(needs_correction) && (leap_index != -1))
+            auto index = xsimd::broadcast<int64_t, Arch>(0);
+            for (int64_t step = 16; step != 0; step /= 2)
             {
-                offset = xsimd::select(needs_correction, offset + one_sec, offset);
-                needs_correction
-                    = (tt2000_batch < xsimd::broadcast<int64_t, Arch>(
-                           leap_seconds::leap_seconds_tt2000_reverse[leap_index].first));
-                leap_index--;
+                const auto candidate = index + xsimd::broadcast<int64_t, Arch>(step);
+                index = xsimd::select(
+                    tt2000_batch >= batch_type::gather(padded.thresholds.data(), candidate),
+                    candidate, index);
             }
-            // Values before all table entries still need one final correction
-            offset = xsimd::select(needs_correction, offset + one_sec, offset);
-            store<Arch, output_align_mode>(tt2000_batch + offset, &output[i]);
+            store<Arch, output_align_mode>(
+                tt2000_batch + tt2000_offset - batch_type::gather(padded.offsets.data(), index),
+                &output[i]);
         }
-        // sfence<Arch>();
         if (i < count)
         {
             _impl::scalar_to_ns_from_1970(input.subspan(i), &output[i]);
         }
     }
 
+    /* Sorted input, see _impl::for_each_leap_segment. Inside a segment this is a single
+     * add and store per batch, big outputs use non temporal stores since the result won't
+     * fit in cache anyway. Only the batches straddling a segment boundary go scalar so that
+     * loads and stores stay aligned on the input start.
+     */
+    template <class Arch, typename input_align_mode, typename output_align_mode>
+    static inline void _sorted(
+        Arch, const std::span<const tt2000_t>& input, int64_t* const output)
+    {
+        using batch_type = xsimd::batch<int64_t, Arch>;
+        constexpr std::size_t simd_size = batch_type::size;
+        constexpr auto& padded = _impl::padded_leap_seconds_tt2000_reverse;
+        const bool streaming = std::size(input) * sizeof(int64_t) >= _streaming_threshold;
+        _impl::for_each_leap_segment(input,
+            [&input, output, streaming](std::size_t first, std::size_t size, std::size_t segment)
+            {
+                const auto end = first + size;
+                const auto offset = constants::tt2000_offset - padded.offsets[segment];
+                const auto lower = padded.thresholds[segment];
+                const auto upper = padded.thresholds[segment + 1];
+                const auto offset_batch = xsimd::broadcast<int64_t, Arch>(offset);
+                const auto lower_batch = xsimd::broadcast<int64_t, Arch>(lower);
+                const auto upper_batch = xsimd::broadcast<int64_t, Arch>(upper);
+                auto in_segment_batch = xsimd::batch_bool<int64_t, Arch>(true);
+                bool in_segment = true;
+                std::size_t i = first;
+                const auto scalar_until = [&](std::size_t last)
+                {
+                    for (; i < last; ++i)
+                    {
+                        const auto value = input[i].nseconds;
+                        output[i] = value + offset;
+                        in_segment &= (value >= lower) & (value < upper);
+                    }
+                };
+                scalar_until(std::min(end, (first + simd_size - 1) / simd_size * simd_size));
+                for (; i + simd_size <= end; i += simd_size)
+                {
+                    auto tt2000_batch = batch_type::load(&input[i].nseconds, input_align_mode {});
+                    if (streaming)
+                        stream_store<Arch, output_align_mode>(
+                            tt2000_batch + offset_batch, &output[i]);
+                    else
+                        store<Arch, output_align_mode>(tt2000_batch + offset_batch, &output[i]);
+                    in_segment_batch = in_segment_batch & (tt2000_batch >= lower_batch)
+                        & (tt2000_batch < upper_batch);
+                }
+                scalar_until(end);
+                if (!(in_segment && xsimd::all(in_segment_batch)))
+                {
+                    _unsorted<Arch, xsimd::unaligned_mode, xsimd::unaligned_mode>(
+                        Arch {}, input.subspan(first, size), output + first);
+                }
+            });
+        if (streaming)
+            sfence<Arch>();
+    }
+
     template <class Arch, typename input_align_mode, typename output_align_mode>
     static inline void to_ns_from_1970(
         Arch, const std::span<const tt2000_t>& input, int64_t* const output)
     {
-        /* We asume that the input is almost always sorted and recent (after 2017)
-         * so we first check if the first value is after the last leap second
-         * if yes, we can use a faster algorithm (just a constant offset).
-         * This optimistic still keeps track of the fact that some values may be before
-         * the last leap second, in which case we fallback to the unsorted algorithm.
+        /* We asume that the input is almost always sorted, then each leap second segment
+         * is just a constant offset. Otherwise data is often recent (after 2017) so we
+         * check if the first value is after the last leap second, if yes, we can use a
+         * faster algorithm (just a constant offset).
+         * Both still keep track of the fact that some values may not fit, in which case we
+         * fallback to the unsorted algorithm.
          */
+        if (_impl::looks_sorted(input))
+        {
+            return _sorted<Arch, input_align_mode, output_align_mode>(Arch {}, input, output);
+        }
         if (input[0].nseconds >= leap_seconds::leap_seconds_tt2000_reverse.back().first)
         {
             return _optimistic_after_2017<Arch, input_align_mode, output_align_mode>(
@@ -351,12 +434,7 @@ template <class Arch>
 void _to_ns_from_1970_tt2000_t::operator()(
     Arch, const std::span<const tt2000_t>& input, int64_t* const output)
 {
-    // fallback to scalar implementation where it's not worth vectorizing
-    // in this particular case, we manipulate 64-bit integers and to avoid
-    // branching in the vectorized code, we process more leap seconds than
-    // the scalar code, we need at least 512 bits SIMD registers to make it
-    // worth it.
-    if constexpr (cdf::helpers::is_any_of_v<Arch, xsimd::unavailable, xsimd::sse2>)
+    if constexpr (cdf::helpers::is_any_of_v<Arch, xsimd::unavailable>)
     {
         return _impl::scalar_to_ns_from_1970(input, output);
     }
@@ -395,6 +473,211 @@ void _to_ns_from_1970_tt2000_t::operator()(
     }
 }
 
+/*
+ * Encode direction (ns since 1970 -> CDF time types).
+ * Results are bit identical to the scalar kernels (_impl::scalar_from_ns_from_1970).
+ */
+
+/* Exact truncated (toward zero, like std::chrono::duration_cast) division by a constant.
+ * The quotient is first estimated in double precision, for any int64 input the estimate is
+ * off by at most one, then it is fixed using the integer remainder. Returns {q, r} with
+ * ns == q * divisor + r.
+ */
+template <int64_t divisor, class Arch>
+static inline auto _trunc_div(const xsimd::batch<int64_t, Arch>& ns)
+{
+    using batch_type = xsimd::batch<int64_t, Arch>;
+    const auto d = xsimd::broadcast<int64_t, Arch>(divisor);
+    const auto minus_d = xsimd::broadcast<int64_t, Arch>(-divisor);
+    const auto zero = xsimd::broadcast<int64_t, Arch>(0);
+    const auto one = xsimd::broadcast<int64_t, Arch>(1);
+    batch_type q = xsimd::batch_cast<int64_t>(xsimd::trunc(xsimd::batch_cast<double>(ns)
+        / xsimd::broadcast<double, Arch>(static_cast<double>(divisor))));
+    batch_type r = ns - q * d;
+    const auto negative = ns < zero;
+    const auto overshoot = (negative & (r <= minus_d)) | (~negative & (r < zero));
+    const auto undershoot = (negative & (r > zero)) | (~negative & (r >= d));
+    q = xsimd::select(overshoot, q - one, xsimd::select(undershoot, q + one, q));
+    r = xsimd::select(overshoot, r + d, xsimd::select(undershoot, r - d, r));
+    return std::pair { q, r };
+}
+
+template <class Arch, typename kernel_t, typename output_t>
+static inline void _from_ns_from_1970_dispatch_alignment(
+    Arch, const std::span<const int64_t>& input, output_t* const output)
+{
+    if (xsimd::is_aligned(input.data()) && xsimd::is_aligned(output))
+    {
+        kernel_t::template from_ns_from_1970<Arch, xsimd::aligned_mode, xsimd::aligned_mode>(
+            Arch {}, input, output);
+    }
+    else if (xsimd::is_aligned(input.data()))
+    {
+        kernel_t::template from_ns_from_1970<Arch, xsimd::aligned_mode, xsimd::unaligned_mode>(
+            Arch {}, input, output);
+    }
+    else if (xsimd::is_aligned(output))
+    {
+        kernel_t::template from_ns_from_1970<Arch, xsimd::unaligned_mode, xsimd::aligned_mode>(
+            Arch {}, input, output);
+    }
+    else
+    {
+        kernel_t::template from_ns_from_1970<Arch, xsimd::unaligned_mode,
+            xsimd::unaligned_mode>(Arch {}, input, output);
+    }
+}
+
+struct _from_ns_from_1970_tt2000_t
+{
+    template <class Arch, typename input_align_mode, typename output_align_mode>
+    static inline void from_ns_from_1970(
+        Arch, const std::span<const int64_t>& input, tt2000_t* const output)
+    {
+        using batch_type = xsimd::batch<int64_t, Arch>;
+        constexpr std::size_t simd_size = batch_type::size;
+        constexpr auto& table = leap_seconds::leap_seconds_tt2000;
+        const auto count = std::size(input);
+        const auto last_leap_sec = xsimd::broadcast<int64_t, Arch>(table.back().first);
+        const auto recent_offset = xsimd::broadcast<int64_t, Arch>(
+            table.back().second - constants::tt2000_offset);
+        std::size_t i = 0;
+        for (; i + simd_size <= count; i += simd_size)
+        {
+            auto ns_batch = batch_type::load(input.data() + i, input_align_mode {});
+            auto offset = recent_offset;
+            auto needs_correction = (ns_batch < last_leap_sec);
+            // only walks back the table as far as the oldest value of the batch requires,
+            // recent data never enters this loop
+            for (std::size_t leap = std::size(table) - 1; leap > 0 && xsimd::any(needs_correction);
+                 --leap)
+            {
+                offset = xsimd::select(needs_correction,
+                    xsimd::broadcast<int64_t, Arch>(
+                        table[leap - 1].second - constants::tt2000_offset),
+                    offset);
+                needs_correction
+                    = (ns_batch < xsimd::broadcast<int64_t, Arch>(table[leap - 1].first));
+            }
+            // before the first table entry there is no leap second at all
+            offset = xsimd::select(needs_correction,
+                xsimd::broadcast<int64_t, Arch>(-constants::tt2000_offset), offset);
+            store<Arch, output_align_mode>(ns_batch + offset, &output[i].nseconds);
+        }
+        if (i < count)
+        {
+            _impl::scalar_from_ns_from_1970(input.subspan(i), output + i);
+        }
+    }
+
+    template <class Arch>
+    void operator()(Arch, const std::span<const int64_t>& input, tt2000_t* const output);
+};
+
+template <class Arch>
+void _from_ns_from_1970_tt2000_t::operator()(
+    Arch, const std::span<const int64_t>& input, tt2000_t* const output)
+{
+    // pure 64-bit integer arithmetic, two lanes are not enough to amortize the table walk
+    if constexpr (cdf::helpers::is_any_of_v<Arch, xsimd::unavailable, xsimd::sse2, xsimd::wasm>)
+    {
+        return _impl::scalar_from_ns_from_1970(input, output);
+    }
+    _from_ns_from_1970_dispatch_alignment<Arch, _from_ns_from_1970_tt2000_t>(
+        Arch {}, input, output);
+}
+
+struct _from_ns_from_1970_epoch_t
+{
+    template <class Arch, typename input_align_mode, typename output_align_mode>
+    static inline void from_ns_from_1970(
+        Arch, const std::span<const int64_t>& input, epoch* const output)
+    {
+        using batch_type = xsimd::batch<int64_t, Arch>;
+        constexpr std::size_t simd_size = batch_type::size;
+        const auto count = std::size(input);
+        const auto offset = xsimd::broadcast<double, Arch>(constants::epoch_offset_miliseconds);
+        std::size_t i = 0;
+        for (; i + simd_size <= count; i += simd_size)
+        {
+            auto ns_batch = batch_type::load(input.data() + i, input_align_mode {});
+            const auto ms = _trunc_div<1'000'000>(ns_batch).first;
+            store<Arch, output_align_mode>(
+                xsimd::batch_cast<double>(ms) + offset, &output[i].mseconds);
+        }
+        if (i < count)
+        {
+            _impl::scalar_from_ns_from_1970(input.subspan(i), output + i);
+        }
+    }
+
+    template <class Arch>
+    void operator()(Arch, const std::span<const int64_t>& input, epoch* const output);
+};
+
+template <class Arch>
+void _from_ns_from_1970_epoch_t::operator()(
+    Arch, const std::span<const int64_t>& input, epoch* const output)
+{
+    // int64 <-> double conversions and 64-bit multiplies are only native with AVX512, below
+    // that (WASM SIMD128 included) the exact division in _trunc_div costs more than the
+    // scalar code
+    if constexpr (cdf::helpers::is_any_of_v<Arch, xsimd::unavailable, xsimd::sse2, xsimd::avx2,
+                      xsimd::wasm>)
+    {
+        return _impl::scalar_from_ns_from_1970(input, output);
+    }
+    _from_ns_from_1970_dispatch_alignment<Arch, _from_ns_from_1970_epoch_t>(
+        Arch {}, input, output);
+}
+
+struct _from_ns_from_1970_epoch16_t
+{
+    template <class Arch, typename input_align_mode, typename output_align_mode>
+    static inline void from_ns_from_1970(
+        Arch, const std::span<const int64_t>& input, epoch16* const output)
+    {
+        using batch_type = xsimd::batch<int64_t, Arch>;
+        constexpr std::size_t simd_size = batch_type::size;
+        const auto count = std::size(input);
+        const auto even_indexes = make_even_indexes<Arch>();
+        const auto odd_indexes = make_odd_indexes<Arch>();
+        const auto offset = xsimd::broadcast<double, Arch>(constants::epoch_offset_seconds);
+        const auto ps_in_ns = xsimd::broadcast<double, Arch>(1'000);
+        std::size_t i = 0;
+        for (; i + simd_size <= count; i += simd_size)
+        {
+            auto ns_batch = batch_type::load(input.data() + i, input_align_mode {});
+            const auto [seconds, ns] = _trunc_div<1'000'000'000>(ns_batch);
+            // epoch16 is {seconds, picoseconds} pairs, scatter both halves in place
+            (xsimd::batch_cast<double>(seconds) + offset)
+                .scatter(reinterpret_cast<double*>(&output[i]), even_indexes);
+            (xsimd::batch_cast<double>(ns) * ps_in_ns)
+                .scatter(reinterpret_cast<double*>(&output[i]), odd_indexes);
+        }
+        if (i < count)
+        {
+            _impl::scalar_from_ns_from_1970(input.subspan(i), output + i);
+        }
+    }
+
+    template <class Arch>
+    void operator()(Arch, const std::span<const int64_t>& input, epoch16* const output);
+};
+
+template <class Arch>
+void _from_ns_from_1970_epoch16_t::operator()(
+    Arch, const std::span<const int64_t>& input, epoch16* const output)
+{
+    if constexpr (cdf::helpers::is_any_of_v<Arch, xsimd::unavailable, xsimd::sse2, xsimd::avx2,
+                      xsimd::wasm>)
+    {
+        return _impl::scalar_from_ns_from_1970(input, output);
+    }
+    _from_ns_from_1970_dispatch_alignment<Arch, _from_ns_from_1970_epoch16_t>(
+        Arch {}, input, output);
+}
+
 #ifdef CDFPP_ENABLE_SSE2_ARCH
 extern template void _to_ns_from_1970_tt2000_t::operator()<xsimd::sse2>(
     xsimd::sse2, const std::span<const tt2000_t>& input, int64_t* const output);
@@ -402,6 +685,12 @@ extern template void _to_ns_from_1970_epoch_t::operator()<xsimd::sse2>(
     xsimd::sse2, const std::span<const epoch>& input, int64_t* const output);
 extern template void _to_ns_from_1970_epoch16_t::operator()<xsimd::sse2>(
     xsimd::sse2, const std::span<const epoch16>& input, int64_t* const output);
+extern template void _from_ns_from_1970_tt2000_t::operator()<xsimd::sse2>(
+    xsimd::sse2, const std::span<const int64_t>& input, tt2000_t* const output);
+extern template void _from_ns_from_1970_epoch_t::operator()<xsimd::sse2>(
+    xsimd::sse2, const std::span<const int64_t>& input, epoch* const output);
+extern template void _from_ns_from_1970_epoch16_t::operator()<xsimd::sse2>(
+    xsimd::sse2, const std::span<const int64_t>& input, epoch16* const output);
 #endif
 #ifdef CDFPP_ENABLE_AVX2_ARCH
 extern template void _to_ns_from_1970_tt2000_t::operator()<xsimd::avx2>(
@@ -410,6 +699,12 @@ extern template void _to_ns_from_1970_epoch_t::operator()<xsimd::avx2>(
     xsimd::avx2, const std::span<const epoch>& input, int64_t* const output);
 extern template void _to_ns_from_1970_epoch16_t::operator()<xsimd::avx2>(
     xsimd::avx2, const std::span<const epoch16>& input, int64_t* const output);
+extern template void _from_ns_from_1970_tt2000_t::operator()<xsimd::avx2>(
+    xsimd::avx2, const std::span<const int64_t>& input, tt2000_t* const output);
+extern template void _from_ns_from_1970_epoch_t::operator()<xsimd::avx2>(
+    xsimd::avx2, const std::span<const int64_t>& input, epoch* const output);
+extern template void _from_ns_from_1970_epoch16_t::operator()<xsimd::avx2>(
+    xsimd::avx2, const std::span<const int64_t>& input, epoch16* const output);
 #endif
 #ifdef CDFPP_ENABLE_AVX512BW_ARCH
 extern template void _to_ns_from_1970_tt2000_t::operator()<xsimd::avx512bw>(
@@ -418,5 +713,11 @@ extern template void _to_ns_from_1970_epoch_t::operator()<xsimd::avx512bw>(
     xsimd::avx512bw, const std::span<const epoch>& input, int64_t* const output);
 extern template void _to_ns_from_1970_epoch16_t::operator()<xsimd::avx512bw>(
     xsimd::avx512bw, const std::span<const epoch16>& input, int64_t* const output);
+extern template void _from_ns_from_1970_tt2000_t::operator()<xsimd::avx512bw>(
+    xsimd::avx512bw, const std::span<const int64_t>& input, tt2000_t* const output);
+extern template void _from_ns_from_1970_epoch_t::operator()<xsimd::avx512bw>(
+    xsimd::avx512bw, const std::span<const int64_t>& input, epoch* const output);
+extern template void _from_ns_from_1970_epoch16_t::operator()<xsimd::avx512bw>(
+    xsimd::avx512bw, const std::span<const int64_t>& input, epoch16* const output);
 #endif
 }
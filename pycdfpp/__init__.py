@@ -23,8 +23,9 @@ import re
 
 import numpy as np
 
-from ._pycdfpp import DataType, CompressionType, Majority, Variable, VariableAttribute, Attribute, CDF, tt2000_t, epoch, \
-    epoch16, save
+from ._pycdfpp import DataType, CompressionType, Majority, SparseRecords, Variable, VariableAttribute, Attribute, CDF, tt2000_t, epoch, \
+    epoch16, save, set_num_threads, get_num_threads, set_min_chunk_size, tracing_available, start_tracing, \
+    stop_tracing, clear_trace, trace_json, write_trace
 from . import _pycdfpp
 
 # ByteString is deprecated in Python 3.9+ and removed in Python 3.14
@@ -36,8 +37,9 @@ sys.path.append(__here__)
 if sys.platform == 'win32' and sys.version_info[0] == 3 and sys.version_info[1] >= 8:
     os.add_dll_directory(__here__)
 
-__all__ = ['tt2000_t', 'epoch', 'epoch16', 'load', 'save', 'CDF', 'Variable',
-           'Attribute', 'to_datetime64', 'to_datetime', 'to_time_string', 'DataType', 'CompressionType', 'Majority']
+__all__ = ['tt2000_t', 'epoch', 'epoch16', 'load', 'load_many', 'save', 'CDF', 'Variable',
+           'Attribute', 'to_datetime64', 'to_datetime', 'to_time_string', 'parse_iso8601', 'minmax', 'spectrogram', 'DataType', 'CompressionType', 'Majority', 'SparseRecords',
+           'set_num_threads', 'get_num_threads', 'set_min_chunk_size']
 
 # Build dtype.num → CDF type mapping dynamically to handle platform differences.
 # On Windows, np.int64 is NPY_LONGLONG (num=9) while on Linux it's NPY_LONG (num=7).
@@ -693,13 +695,17 @@ def to_tt2000(values):
 
     Parameters
     ----------
-    values: datetime.datetime or List[datetime.datetime] or numpy.array[numpy.datetime64[ns]]
+    values: datetime.datetime or List[datetime.datetime] or numpy.array[numpy.datetime64[ns]] or Variable or numpy.ndarray[tt2000_t] or numpy.ndarray[epoch] or numpy.ndarray[epoch16]
         input value(s)
 to convert to CDF tt2000
 
     Returns
     -------
-    tt2000_t or List[tt2000_t]
+    tt2000_t or List[tt2000_t] or numpy.ndarray[tt2000_t]
+
+    Note
+    ----
+    Arrays and Variables of CDF time types are converted in bulk with the same vectorized kernels as to_datetime64.
     """
     return _pycdfpp.to_tt2000(values)
 
@@ -710,13 +716,17 @@ def to_epoch(values):
 
     Parameters
     ----------
-    values: datetime.datetime or List[datetime.datetime] or numpy.array[numpy.datetime64[ns]]
+    values: datetime.datetime or List[datetime.datetime] or numpy.array[numpy.datetime64[ns]] or Variable or numpy.ndarray[tt2000_t] or numpy.ndarray[epoch] or numpy.ndarray[epoch16]
         input value(s)
 to convert to CDF epoch
 
     Returns
     -------
-    epoch or List[epoch]
+    epoch or List[epoch] or numpy.ndarray[epoch]
+
+    Note
+    ----
+    Arrays and Variables of CDF time types are converted in bulk with the same vectorized kernels as to_datetime64.
     """
     return _pycdfpp.to_epoch(values)
 
@@ -741,24 +751,138 @@ def to_time_string(values, format: str):
     return _pycdfpp.to_time_string(values, format)
 
 
+def parse_iso8601(values, data_type: DataType = DataType.CDF_TIME_TT2000):
+    """Parse ISO-8601 strings into CDF time values.
+
+    Accepted syntax is ``YYYY-MM-DD[(T| )hh:mm[:ss[.fff...]]][Z]``, leap seconds (``23:59:60``) are
+    accepted on the days they were inserted and fractions are truncated to the resolution of
+    ``data_type``.
+
+    Parameters
+    ----------
+    values : str or List[str] or numpy.ndarray[S] or numpy.ndarray[U]
+        String(s) to parse, fixed-width byte strings arrays (as returned by to_time_string) are
+        parsed in place.
+    data_type : DataType, optional
+        One of CDF_TIME_TT2000, CDF_EPOCH or CDF_EPOCH16.
+        (Default is CDF_TIME_TT2000)
+
+    Returns
+    -------
+    tt2000_t or epoch or epoch16 or numpy.ndarray
+        Array of the requested CDF time type with the same shape as input.
+
+    Raises
+    ------
+    ValueError
+        If any string is not a valid ISO-8601 time or data_type is not a CDF time type.
+    """
+    return _pycdfpp.parse_iso8601(values, data_type)
+
+
+def _ns(value):
+    # datetime64, datetime or None to integer nanoseconds since 1970 for the C++ side
+    return None if value is None else int(np.datetime64(value, 'ns').astype(np.int64))
+
+
+def minmax(values: Variable, time: Variable, buckets: int, start=None, stop=None):
+    """Reduce a variable to per time bucket min, max, first and last values, for plotting.
+
+    [start, stop) is evenly split in `buckets` buckets (typically one per pixel column) and the
+    records of each bucket are reduced in a single threaded pass, so that a plot of the result
+    looks like a plot of the full resolution data. Fill values (FILLVAL attribute) and NaNs are
+    skipped, empty buckets are NaN.
+
+    Parameters
+    ----------
+    values : Variable
+        Numeric variable to reduce.
+    time : Variable
+        Its time axis, usually its DEPEND_0, a sorted CDF time variable with as many records.
+    buckets : int
+        Number of buckets.
+    start, stop : numpy.datetime64 or datetime.datetime, optional
+        Time range to reduce, the whole time axis by default.
+
+    Returns
+    -------
+    dict
+        'edges': numpy.ndarray[datetime64[ns]] of buckets + 1 bucket edges,
+        'min', 'max', 'first', 'last': numpy.ndarray[float64] of shape (buckets,) + record shape.
+    """
+    return _pycdfpp.minmax(values, time, buckets, _ns(start), _ns(stop))
+
+
+def spectrogram(values: Variable, time: Variable, width: int, height: int, bins: Variable = None,
+                start=None, stop=None, y_range=None, y_scale: str = None, z_range=None,
+                z_scale: str = None):
+    """Rasterize a 2-D variable to a viridis RGBA image, for plotting.
+
+    Records are binned along x against their time axis and bins along y against their centers,
+    a pixel shows the max of the cells in it (or the cell covering it when zoomed in) and is colour
+    mapped in the same multi-threaded pass. Fill values (FILLVAL attribute), NaNs and values out of
+    [VALIDMIN, VALIDMAX] are skipped, pixels without data are transparent.
+
+    Parameters
+    ----------
+    values : Variable
+        Numeric variable of shape (records, bins) to draw.
+    time : Variable
+        Its time axis, usually its DEPEND_0, a sorted CDF time variable with as many records.
+    width, height : int
+        Image size in pixels.
+    bins : Variable, optional
+        Its bin centers, usually its DEPEND_1 (first record if record varying), the bin indices
+        when missing, not numeric or not monotonic.
+    start, stop : numpy.datetime64 or datetime.datetime, optional
+        Time range to draw, the outer time cells by default.
+    y_range : (float, float), optional
+        Bins range to draw, bottom to top, the outer bin cells by default.
+    y_scale : str, optional
+        'log' or 'linear', bins SCALETYP attribute by default, else 'linear'. A log scale needs
+        positive bin centers and falls back to linear otherwise.
+    z_range : (float, float), optional
+        Colour range, the range of the drawn pixels by default.
+    z_scale : str, optional
+        'log' or 'linear', values SCALETYP attribute by default, else 'log'.
+
+    Returns
+    -------
+    dict
+        'image': numpy.ndarray[uint8] of shape (height, width, 4), top row first,
+        'start', 'stop': numpy.datetime64[ns] time range drawn,
+        'y_min', 'y_max', 'y_scale', 'z_min', 'z_max', 'z_scale': ranges and scales drawn, the
+        z range is NaN when no pixel has data.
+    """
+    y_min, y_max = y_range if y_range is not None else (None, None)
+    z_min, z_max = z_range if z_range is not None else (None, None)
+    return _pycdfpp.spectrogram(values, time, width, height, bins, _ns(start), _ns(stop), y_min,
+                                y_max, y_scale, z_min, z_max, z_scale)
+
+
 def to_epoch16(values):
     """
     to_epoch16
 
     Parameters
     ----------
-    values: datetime.datetime or List[datetime.datetime] or numpy.array[numpy.datetime64[ns]]
+    values: datetime.datetime or List[datetime.datetime] or numpy.array[numpy.datetime64[ns]] or Variable or numpy.ndarray[tt2000_t] or numpy.ndarray[epoch] or numpy.ndarray[epoch16]
         input value(s)
 to convert to CDF epoch16
 
     Returns
     -------
-    epoch16 or List[epoch16]
+    epoch16 or List[epoch16] or numpy.ndarray[epoch16]
+
+    Note
+    ----
+    Arrays and Variables of CDF time types are converted in bulk with the same vectorized kernels as to_datetime64.
     """
     return _pycdfpp.to_epoch16(values)
 
 
-def load(file_or_buffer: str or ByteString, iso_8859_1_to_utf8: bool = True, lazy_load: bool = True):
+def load(file_or_buffer: str or ByteString, iso_8859_1_to_utf8: bool = True, lazy_load: bool = True,
+         stats: bool = False):
     """
     Load and parse a CDF file.
 
@@ -775,13 +899,28 @@ def load(file_or_buffer: str or ByteString, iso_8859_1_to_utf8: bool = True, laz
         Controls whether variable values are loaded immediately or only when accessed by the user.
         If True, variables' values are loaded on demand. If False, all variable values are loaded during parsing.
         (Default is True)
+    stats : bool, optional
+        Also return where the load time went: a dict with the descriptor records parsed
+        ("records_parsed"), VVR/CVVR read ("values_records"), "bytes_mapped", "bytes_read",
+        page faults taken by the process, compressed and uncompressed bytes per codec ("codecs",
+        keyed by CompressionType) and the time spent in each phase in seconds ("phases": load,
+        descriptors, read, inflate, byte_swap, utf8, majority_swap).
+        Values are then loaded immediately whatever lazy_load, so that the dict covers them.
+        (Default is False)
 
     Returns
     -------
-    CDF or None
+    CDF or None, or (CDF or None, dict) when stats is True
         Returns a CDF object upon successful read.
         If there's an issue with the read, None is returned.
     """
+    if stats:
+        io_stats = _pycdfpp._IOStats()
+        if type(file_or_buffer) is str:
+            cdf = _pycdfpp.load(file_or_buffer, iso_8859_1_to_utf8, False, io_stats)
+        else:
+            cdf = _pycdfpp.load(file_or_buffer, iso_8859_1_to_utf8, io_stats)
+        return cdf, io_stats.to_dict()
     if type(file_or_buffer) is str:
         return _pycdfpp.load(file_or_buffer, iso_8859_1_to_utf8, lazy_load)
     if lazy_load:
@@ -790,6 +929,36 @@ def load(file_or_buffer: str or ByteString, iso_8859_1_to_utf8: bool = True, laz
         return _pycdfpp.load(file_or_buffer, iso_8859_1_to_utf8)
 
 
+def load_many(files: List[str], variables: List[str] = None, threads: int = 0,
+              iso_8859_1_to_utf8: bool = True):
+    """
+    Load the same variables from many CDF files and concatenate them along records.
+
+    Files are opened in parallel and each variable is decoded once, directly into a single buffer
+    holding the records of every file, in the order of `files`. Global attributes, variable
+    attributes and non record varying variables are taken from the first file.
+
+    Parameters
+    ----------
+    files : List[str]
+        Files to load, typically consecutive files of the same product.
+    variables : List[str], optional
+        Names of the variables to load, all the variables of the first file when None or empty.
+    threads : int, optional
+        Number of threads used to open and decode files, 0 means all available cores.
+        (Default is 0)
+    iso_8859_1_to_utf8 : bool, optional
+        Automatically convert Latin-1 characters to their equivalent UTF counterparts when True.
+        (Default is True)
+
+    Returns
+    -------
+    CDF or None
+        A CDF object holding the concatenated variables, None if any file couldn't be read.
+    """
+    return _pycdfpp.load_many(list(files), list(variables or []), threads, iso_8859_1_to_utf8)
+
+
 def _stringify_time_values(values, values_type):
     if values_type in (DataType.CDF_TIME_TT2000, DataType.CDF_EPOCH, DataType.CDF_EPOCH16):
         return list(map(str, values))
@@ -42,6 +42,7 @@ using namespace cdf;
 
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 namespace py = pybind11;
 namespace docstrings
@@ -243,9 +244,54 @@ void def_cdf_wrapper(T& mod)
             py::arg("name"));
 }
 
+inline py::dict to_dict(const io::io_stats& stats)
+{
+    py::dict codecs;
+    for (const auto type : { cdf_compression_type::rle_compression,
+             cdf_compression_type::gzip_compression,
+#ifdef CDFPP_USE_ZSTD
+             cdf_compression_type::zstd_compression
+#endif
+         })
+    {
+        const auto& codec = stats.codec(type);
+        if (codec.blocks != 0)
+        {
+            py::dict counters;
+            counters["blocks"] = codec.blocks.load();
+            counters["compressed_bytes"] = codec.compressed_bytes.load();
+            counters["uncompressed_bytes"] = codec.uncompressed_bytes.load();
+            codecs[py::cast(type)] = counters;
+        }
+    }
+    py::dict phases;
+    for (std::size_t index = 0; index < io::io_phases_count; index++)
+    {
+        const auto phase = static_cast<io::io_phase>(index);
+        if (const auto time = stats.time(phase); time.count() != 0)
+            phases[py::str(std::string { io::io_phase_name(phase) })]
+                = std::chrono::duration<double>(time).count();
+    }
+    py::dict result;
+    result["records_parsed"] = stats.records_parsed.load();
+    result["values_records"] = stats.values_records.load();
+    result["bytes_mapped"] = stats.bytes_mapped.load();
+    result["bytes_read"] = stats.bytes_read.load();
+    result["bytes_written"] = stats.bytes_written.load();
+    result["minor_page_faults"] = stats.minor_page_faults.load();
+    result["major_page_faults"] = stats.major_page_faults.load();
+    result["codecs"] = codecs;
+    result["phases"] = phases;
+    return result;
+}
+
 template <typename T>
 void def_cdf_loading_functions(T& mod)
 {
+    py::class_<io::io_stats>(mod, "_IOStats")
+        .def(py::init<>())
+        .def("to_dict", [](const io::io_stats& stats) { return to_dict(stats); });
+
     mod.def(
         "load",
         [](py::bytes& buffer, bool iso_8859_1_to_utf8)
@@ -280,6 +326,55 @@ void def_cdf_loading_functions(T& mod)
         },
         py::arg("fname"), py::arg("iso_8859_1_to_utf8") = false, py::arg("lazy_load") = true,
         py::return_value_policy::move);
+
+    mod.def(
+        "load",
+        [](py::bytes& buffer, bool iso_8859_1_to_utf8, io::io_stats& stats)
+        {
+            py::buffer_info info(py::buffer(buffer).request());
+            py::gil_scoped_release release;
+            return io::load(static_cast<char*>(info.ptr), static_cast<std::size_t>(info.size),
+                stats, iso_8859_1_to_utf8);
+        },
+        py::arg("buffer"), py::arg("iso_8859_1_to_utf8"), py::arg("stats"),
+        py::return_value_policy::move);
+
+    mod.def(
+        "lazy_load",
+        [](py::buffer& buffer, bool iso_8859_1_to_utf8, io::io_stats& stats)
+        {
+            py::buffer_info info(buffer.request());
+            if (info.ndim != 1)
+                throw std::runtime_error(fmt::format(
+                    "lazy_load requires a 1-D buffer, got ndim={}", info.ndim));
+            py::gil_scoped_release release;
+            return io::load(
+                static_cast<char*>(info.ptr), info.shape[0], stats, iso_8859_1_to_utf8, true);
+        },
+        py::arg("buffer"), py::arg("iso_8859_1_to_utf8"), py::arg("stats"),
+        py::return_value_policy::move, py::keep_alive<0, 1>(), py::keep_alive<0, 3>());
+
+    mod.def(
+        "load",
+        [](const char* fname, bool iso_8859_1_to_utf8, bool lazy_load, io::io_stats& stats)
+        {
+            py::gil_scoped_release release;
+            return io::load(std::string { fname }, stats, iso_8859_1_to_utf8, lazy_load);
+        },
+        py::arg("fname"), py::arg("iso_8859_1_to_utf8"), py::arg("lazy_load"), py::arg("stats"),
+        py::return_value_policy::move, py::keep_alive<0, 4>());
+
+    mod.def(
+        "load_many",
+        [](const std::vector<std::string>& fnames, const std::vector<std::string>& variables,
+            std::size_t threads, bool iso_8859_1_to_utf8)
+        {
+            py::gil_scoped_release release;
+            return io::load_many(fnames, variables, threads, iso_8859_1_to_utf8);
+        },
+        py::arg("fnames"), py::arg("variables") = std::vector<std::string> {},
+        py::arg("threads") = 0, py::arg("iso_8859_1_to_utf8") = false,
+        py::return_value_policy::move);
 }
 
 struct cdf_bytes
@@ -30,8 +30,11 @@
 #include "data_types.hpp"
 
 #include <cdfpp/cdf-data.hpp>
+#include <cdfpp/cdf-parallel.hpp>
 #include <cdfpp/cdf.hpp>
 #include <cdfpp/chrono/cdf-chrono.hpp>
+#include <cdfpp/chrono/cdf-time-format.hpp>
+#include <cdfpp/chrono/cdf-time-parse.hpp>
 #include <cdfpp/no_init_vector.hpp>
 
 using namespace cdf;
@@ -433,11 +436,8 @@ template <typename time_t>
 [[nodiscard]] inline bool _to_cdf_time_t(
     const cdf_time_t_span_t auto& input, cdf_time_t auto* output)
 {
-    for (const auto in: input)
-    {
-        *output= cdf::to_cdf_time<std::decay_t<decltype(output[0])>>(in);
-        ++output;
-    }
+    py::gil_scoped_release release;
+    cdf::to_cdf_time(input, output);
     return true;
 }
 
@@ -464,21 +464,15 @@ template <typename time_t>
     }
     if (input.dtype().is(tt2000_dtype))
     {
-        auto view =  _details::ranges::make_span<const tt2000_t>(input);
-        py::gil_scoped_release release;
-        return _to_cdf_time_t(view, output);
+        return _to_cdf_time_t(_details::ranges::make_span<const tt2000_t>(input), output);
     }
     if (input.dtype().is(epoch_dtype))
     {
-        auto view =  _details::ranges::make_span<const epoch>(input);
-        py::gil_scoped_release release;
-        return _to_cdf_time_t(view, output);
+        return _to_cdf_time_t(_details::ranges::make_span<const epoch>(input), output);
     }
     if (input.dtype().is(epoch16_dtype))
     {
-        auto view =  _details::ranges::make_span<const epoch16>(input);
-        py::gil_scoped_release release;
-        return _to_cdf_time_t(view, output);
+        return _to_cdf_time_t(_details::ranges::make_span<const epoch16>(input), output);
     }
     return false;
 }
@@ -498,234 +492,35 @@ inline py::object to_cdf_time_t(const py::array& input)
         std::string(input.dtype().attr("str").cast<std::string>())));
 }
 
-
-namespace time_fmt
-{
-    // clang-format off
-    alignas(64) constexpr char DIGIT_PAIRS[] =
-        "00010203040506070809"
-        "10111213141516171819"
-        "20212223242526272829"
-        "30313233343536373839"
-        "40414243444546474849"
-        "50515253545556575859"
-        "60616263646566676869"
-        "70717273747576777879"
-        "80818283848586878889"
-        "90919293949596979899";
-    // clang-format on
-
-    inline void write_2d(char* p, unsigned v) { std::memcpy(p, DIGIT_PAIRS + v * 2, 2); }
-
-    inline void write_3d(char* p, unsigned v)
-    {
-        p[0] = '0' + static_cast<char>(v / 100);
-        write_2d(p + 1, v % 100);
-    }
-
-    inline void write_4d(char* p, unsigned v)
-    {
-        write_2d(p, v / 100);
-        write_2d(p + 2, v % 100);
-    }
-
-    inline void write_nd(char* p, uint64_t v, int n)
-    {
-        for (int i = n - 1; i >= 0; --i)
-        {
-            p[i] = '0' + static_cast<char>(v % 10);
-            v /= 10;
-        }
-    }
-
-    enum class field_kind : uint8_t { YEAR, MONTH, DAY, DOY, HOUR, MINUTE, SECOND };
-
-    struct field
-    {
-        uint16_t offset;
-        field_kind kind;
-    };
-
-    struct plan
-    {
-        std::string tmpl;
-        std::vector<field> fields;
-        uint16_t subsec_offset = 0;
-        uint8_t subsec_digits = 0;
-        bool needs_doy = false;
-    };
-
-    template <typename time_t>
-    constexpr int default_subsec_digits()
-    {
-        using tp_t = decltype(cdf::to_time_point(std::declval<time_t>()));
-        using period = typename tp_t::duration::period;
-        if constexpr (std::is_same_v<period, std::pico>)
-            return 12;
-        else if constexpr (std::is_same_v<period, std::nano>)
-            return 9;
-        else if constexpr (std::is_same_v<period, std::micro>)
-            return 6;
-        else if constexpr (std::is_same_v<period, std::milli>)
-            return 3;
-        else
-            return 0;
-    }
-
-    template <typename time_t>
-    plan compile(const std::string& fmt)
-    {
-        plan p;
-        const int subsec_n = default_subsec_digits<time_t>();
-        for (std::size_t i = 0; i < fmt.size(); ++i)
-        {
-            if (fmt[i] == '%' && i + 1 < fmt.size())
-            {
-                ++i;
-                switch (fmt[i])
-                {
-                    case 'Y':
-                        p.fields.push_back(
-                            { static_cast<uint16_t>(p.tmpl.size()), field_kind::YEAR });
-                        p.tmpl.append("0000");
-                        break;
-                    case 'm':
-                        p.fields.push_back(
-                            { static_cast<uint16_t>(p.tmpl.size()), field_kind::MONTH });
-                        p.tmpl.append("00");
-                        break;
-                    case 'd':
-                        p.fields.push_back(
-                            { static_cast<uint16_t>(p.tmpl.size()), field_kind::DAY });
-                        p.tmpl.append("00");
-                        break;
-                    case 'j':
-                        p.fields.push_back(
-                            { static_cast<uint16_t>(p.tmpl.size()), field_kind::DOY });
-                        p.needs_doy = true;
-                        p.tmpl.append("000");
-                        break;
-                    case 'H':
-                        p.fields.push_back(
-                            { static_cast<uint16_t>(p.tmpl.size()), field_kind::HOUR });
-                        p.tmpl.append("00");
-                        break;
-                    case 'M':
-                        p.fields.push_back(
-                            { static_cast<uint16_t>(p.tmpl.size()), field_kind::MINUTE });
-                        p.tmpl.append("00");
-                        break;
-                    case 'S':
-                        p.fields.push_back(
-                            { static_cast<uint16_t>(p.tmpl.size()), field_kind::SECOND });
-                        p.tmpl.append("00");
-                        if (subsec_n > 0)
-                        {
-                            p.tmpl += '.';
-                            p.subsec_offset = static_cast<uint16_t>(p.tmpl.size());
-                            p.subsec_digits = static_cast<uint8_t>(subsec_n);
-                            p.tmpl.append(static_cast<std::size_t>(subsec_n), '0');
-                        }
-                        break;
-                    case '%':
-                        p.tmpl += '%';
-                        break;
-                    default:
-                        throw std::invalid_argument(fmt::format(
-                            "to_time_string: unsupported format specifier '%{}'", fmt[i]));
-                }
-            }
-            else
-            {
-                p.tmpl += fmt[i];
-            }
-        }
-        return p;
-    }
-
-    template <typename time_t>
-    void format_chunk(const time_t* input, std::size_t count, char* output, const plan& p)
-    {
-        using namespace std::chrono;
-        const auto str_len = p.tmpl.size();
-        const auto* tmpl_data = p.tmpl.data();
-        const auto* fields_data = p.fields.data();
-        const auto nfields = p.fields.size();
-
-        for (std::size_t i = 0; i < count; ++i)
-        {
-            auto* out = output + i * str_len;
-            std::memcpy(out, tmpl_data, str_len);
-
-            auto tp = cdf::to_time_point(input[i]);
-            auto dp = floor<days>(tp);
-            year_month_day ymd { dp };
-            hh_mm_ss time { tp - dp };
-
-            const auto y = static_cast<unsigned>(static_cast<int>(ymd.year()));
-            const auto mo = static_cast<unsigned>(ymd.month());
-            const auto d = static_cast<unsigned>(ymd.day());
-            const auto h = static_cast<unsigned>(time.hours().count());
-            const auto mi = static_cast<unsigned>(time.minutes().count());
-            const auto s = static_cast<unsigned>(time.seconds().count());
-
-            for (std::size_t f = 0; f < nfields; ++f)
-            {
-                auto* dest = out + fields_data[f].offset;
-                switch (fields_data[f].kind)
-                {
-                    case field_kind::YEAR: write_4d(dest, y); break;
-                    case field_kind::MONTH: write_2d(dest, mo); break;
-                    case field_kind::DAY: write_2d(dest, d); break;
-                    case field_kind::HOUR: write_2d(dest, h); break;
-                    case field_kind::MINUTE: write_2d(dest, mi); break;
-                    case field_kind::SECOND: write_2d(dest, s); break;
-                    case field_kind::DOY:
-                        write_3d(dest, static_cast<unsigned>(
-                            (dp - sys_days { ymd.year() / January / day { 1 } }).count() + 1));
-                        break;
-                }
-            }
-            if (p.subsec_digits > 0)
-            {
-                write_nd(out + p.subsec_offset,
-                    static_cast<uint64_t>(time.subseconds().count()), p.subsec_digits);
-            }
-        }
-    }
-} // namespace time_fmt
-
 template <typename time_t>
-void format_time_to_bytes(
-    const time_t* input, std::size_t count, char* output, const time_fmt::plan& plan)
+inline py::object to_cdf_time_t(const Variable& input)
 {
-    static constexpr std::size_t min_chunk = 1024;
-    static const auto threads_count
-        = static_cast<std::size_t>(std::max(1U, std::thread::hardware_concurrency()));
-    if (count >= min_chunk * threads_count)
-    {
-        const auto chunk_size = (count + threads_count - 1) / threads_count;
-        std::vector<std::thread> threads;
-        threads.reserve(threads_count);
-        std::size_t start = 0;
-        for (std::size_t i = 0; i < threads_count && start < count; ++i)
-        {
-            const auto sz = std::min(chunk_size, count - start);
-            threads.emplace_back(time_fmt::format_chunk<time_t>, input + start, sz,
-                output + start * plan.tmpl.size(), std::cref(plan));
-            start += sz;
-        }
-        for (auto& t : threads)
-        {
-            t.join();
-        }
-    }
-    else
+    using enum cdf::CDF_Types;
+    auto result = _details::fast_allocate_array<time_t>(input.shape());
+    auto out_ptr = static_cast<time_t*>(result.request(true).ptr);
+    const auto size = static_cast<std::size_t>(result.size());
+    switch (input.type())
     {
-        time_fmt::format_chunk(input, count, output, plan);
+        case CDF_EPOCH:
+            (void)_to_cdf_time_t(std::span { input.get<CDF_EPOCH>().data(), size }, out_ptr);
+            break;
+        case CDF_EPOCH16:
+            (void)_to_cdf_time_t(std::span { input.get<CDF_EPOCH16>().data(), size }, out_ptr);
+            break;
+        case CDF_TIME_TT2000:
+            (void)_to_cdf_time_t(
+                std::span { input.get<CDF_TIME_TT2000>().data(), size }, out_ptr);
+            break;
+        default:
+            throw std::invalid_argument(fmt::format(
+                "Cannot convert variable with type {} to CDF time type, expecting CDF_EPOCH, "
+                "CDF_EPOCH16, or CDF_TIME_TT2000",
+                cdf_type_str(input.type())));
     }
+    return result;
 }
 
+
 template <typename time_t>
 [[nodiscard]] py::array to_time_string_span(const std::span<const time_t> input,
     const std::vector<ssize_t>& shape, const std::string& format)
@@ -734,12 +529,12 @@ template <typename time_t>
     {
         return py::array(py::dtype("S1"), std::vector<ssize_t> { 0 });
     }
-    auto plan = time_fmt::compile<time_t>(format);
-    auto result = py::array(py::dtype(fmt::format("S{}", plan.tmpl.size())), shape);
+    auto plan = cdf::chrono::time_format::compile<time_t>(format);
+    auto result = py::array(py::dtype(fmt::format("S{}", plan.width())), shape);
     auto* buf = static_cast<char*>(result.mutable_data());
     {
         py::gil_scoped_release release;
-        format_time_to_bytes(input.data(), input.size(), buf, plan);
+        cdf::chrono::time_format::format(input, buf, plan);
     }
     return result;
 }
@@ -779,6 +574,122 @@ template <typename time_t>
     }
 }
 
+[[noreturn]] inline void throw_not_a_time_type(CDF_Types data_type)
+{
+    throw std::invalid_argument(fmt::format(
+        "parse_iso8601 requires a CDF time type (CDF_EPOCH, CDF_EPOCH16, or CDF_TIME_TT2000), "
+        "got {}",
+        cdf_type_str(data_type)));
+}
+
+template <typename time_t>
+[[nodiscard]] py::array parse_iso8601_rows(
+    const char* data, std::size_t count, std::size_t width, const std::vector<ssize_t>& shape)
+{
+    auto result = py::array_t<time_t>(shape);
+    auto* out = static_cast<time_t*>(result.mutable_data());
+    {
+        py::gil_scoped_release release;
+        cdf::chrono::time_parse::parse_iso8601(data, count, width, out);
+    }
+    return result;
+}
+
+[[nodiscard]] py::array parse_iso8601_rows(const char* data, std::size_t count, std::size_t width,
+    const std::vector<ssize_t>& shape, CDF_Types data_type)
+{
+    using enum cdf::CDF_Types;
+    switch (data_type)
+    {
+        case CDF_EPOCH:
+            return parse_iso8601_rows<epoch>(data, count, width, shape);
+        case CDF_EPOCH16:
+            return parse_iso8601_rows<epoch16>(data, count, width, shape);
+        case CDF_TIME_TT2000:
+            return parse_iso8601_rows<tt2000_t>(data, count, width, shape);
+        default:
+            throw_not_a_time_type(data_type);
+    }
+}
+
+// numpy 'S' arrays are parsed in place, 'U' arrays are narrowed to ASCII first (anything else
+// can't be a valid time and ends up as an invalid row).
+[[nodiscard]] py::array parse_iso8601(const py::array& values, CDF_Types data_type)
+{
+    const auto kind = values.dtype().kind();
+    if (kind != 'S' && kind != 'U')
+        throw std::invalid_argument(
+            fmt::format("parse_iso8601 expects an array of strings, got '{}'",
+                values.dtype().attr("str").cast<std::string>()));
+    auto rows = py::array::ensure(values, py::array::c_style);
+    std::vector<ssize_t> shape(rows.shape(), rows.shape() + rows.ndim());
+    const auto count = static_cast<std::size_t>(rows.size());
+    if (kind == 'S')
+        return parse_iso8601_rows(static_cast<const char*>(rows.data()), count,
+            static_cast<std::size_t>(rows.itemsize()), shape, data_type);
+    const auto width = static_cast<std::size_t>(rows.itemsize()) / sizeof(char32_t);
+    std::string narrowed(count * width, '\0');
+    const auto* ucs4 = static_cast<const char32_t*>(rows.data());
+    std::transform(ucs4, ucs4 + count * width, std::begin(narrowed),
+        [](char32_t c) { return c < 128 ? static_cast<char>(c) : '?'; });
+    return parse_iso8601_rows(narrowed.data(), count, width, shape, data_type);
+}
+
+template <typename time_t>
+[[nodiscard]] py::array parse_iso8601_rows(const std::vector<std::string_view>& rows)
+{
+    auto result = py::array_t<time_t>(static_cast<ssize_t>(std::size(rows)));
+    auto* out = static_cast<time_t*>(result.mutable_data());
+    {
+        py::gil_scoped_release release;
+        cdf::chrono::time_parse::parse_iso8601(std::span { rows }, out);
+    }
+    return result;
+}
+
+[[nodiscard]] py::array parse_iso8601(const py::sequence& values, CDF_Types data_type)
+{
+    std::vector<std::string_view> rows;
+    rows.reserve(std::size(values));
+    for (const auto& value : values)
+    {
+        Py_ssize_t size = 0;
+        const char* data = PyUnicode_AsUTF8AndSize(value.ptr(), &size);
+        if (data == nullptr)
+            throw py::error_already_set();
+        rows.emplace_back(data, static_cast<std::size_t>(size));
+    }
+    using enum cdf::CDF_Types;
+    switch (data_type)
+    {
+        case CDF_EPOCH:
+            return parse_iso8601_rows<epoch>(rows);
+        case CDF_EPOCH16:
+            return parse_iso8601_rows<epoch16>(rows);
+        case CDF_TIME_TT2000:
+            return parse_iso8601_rows<tt2000_t>(rows);
+        default:
+            throw_not_a_time_type(data_type);
+    }
+}
+
+[[nodiscard]] py::object parse_iso8601(const std::string& value, CDF_Types data_type)
+{
+    namespace tp = cdf::chrono::time_parse;
+    using enum cdf::CDF_Types;
+    switch (data_type)
+    {
+        case CDF_EPOCH:
+            return py::cast(tp::parse_iso8601<epoch>(value));
+        case CDF_EPOCH16:
+            return py::cast(tp::parse_iso8601<epoch16>(value));
+        case CDF_TIME_TT2000:
+            return py::cast(tp::parse_iso8601<tt2000_t>(value));
+        default:
+            throw_not_a_time_type(data_type);
+    }
+}
+
 void def_time_types_wrapper(auto& mod)
 {
     py::class_<tt2000_t>(mod, "tt2000_t")
@@ -890,6 +801,19 @@ auto def_time_conversion_functions(auto& mod)
         def_to_time_string_functions(mod);
     }
 
+    // from strings
+    {
+        mod.def("parse_iso8601",
+            static_cast<py::object (*)(const std::string&, CDF_Types)>(parse_iso8601),
+            py::arg { "value" }, py::arg { "data_type" });
+        mod.def("parse_iso8601",
+            static_cast<py::array (*)(const py::array&, CDF_Types)>(parse_iso8601),
+            py::arg { "values" }.noconvert(), py::arg { "data_type" });
+        mod.def("parse_iso8601",
+            static_cast<py::array (*)(const py::sequence&, CDF_Types)>(parse_iso8601),
+            py::arg { "values" }, py::arg { "data_type" });
+    }
+
     // backward
     {
         mod.def("to_tt2000", static_cast<py::list (*)(const py::tuple&)>(to_tt2000),
@@ -900,6 +824,9 @@ auto def_time_conversion_functions(auto& mod)
         mod.def("to_tt2000",
             [](decltype(std::chrono::system_clock::now()) tp) { return cdf::to_tt2000(tp); });
 
+        mod.def("to_tt2000",
+            [](const Variable& input) -> py::object { return to_cdf_time_t<tt2000_t>(input); },
+            py::arg { "variable" });
         mod.def("to_tt2000",
             [](const py::array& input) -> py::object { return to_cdf_time_t<tt2000_t>(input); });
 
@@ -908,6 +835,9 @@ auto def_time_conversion_functions(auto& mod)
         mod.def("to_epoch",
             [](const no_init_vector<decltype(std::chrono::system_clock::now())>& tps)
             { return to_epoch(tps); });
+        mod.def("to_epoch",
+            [](const Variable& input) -> py::object { return to_cdf_time_t<epoch>(input); },
+            py::arg { "variable" });
         mod.def("to_epoch",
             [](const py::array& input) -> py::object { return to_cdf_time_t<epoch>(input); });
 
@@ -916,6 +846,9 @@ auto def_time_conversion_functions(auto& mod)
         mod.def("to_epoch16",
             [](const no_init_vector<decltype(std::chrono::system_clock::now())>& tps)
             { return to_epoch16(tps); });
+        mod.def("to_epoch16",
+            [](const Variable& input) -> py::object { return to_cdf_time_t<epoch16>(input); },
+            py::arg { "variable" });
         mod.def("to_epoch16",
             [](const py::array& input) -> py::object { return to_cdf_time_t<epoch16>(input); });
     }
@@ -760,6 +760,12 @@ template <bool encode_strings>
 [[nodiscard]] py::object make_values_view(py::object& obj)
 {
     Variable& variable = obj.cast<Variable&>();
+    {
+        // lazy variables are decoded here, other threads may run meanwhile (or may be
+        // decoding the same variable, load_values makes them wait for a single load)
+        py::gil_scoped_release release;
+        variable.load_values();
+    }
     return cdf_type_dispatch(
         variable.type(), [&variable]<CDF_Types T>(py::object& o) -> py::object {
             if constexpr (T == CDF_Types::CDF_CHAR || T == CDF_Types::CDF_UCHAR)
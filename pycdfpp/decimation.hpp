@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "collections.hpp"
+
+#include <cdfpp/cdf-decimation.hpp>
+#include <cdfpp/variable.hpp>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace _details
+{
+[[nodiscard]] inline py::array to_array(
+    const no_init_vector<double>& values, const std::vector<ssize_t>& shape)
+{
+    auto result = fast_allocate_array<double>(shape);
+    std::copy(std::cbegin(values), std::cend(values), static_cast<double*>(result.mutable_data()));
+    return result;
+}
+}
+
+[[nodiscard]] inline py::dict minmax(const Variable& values, const Variable& time,
+    std::size_t buckets, std::optional<int64_t> start, std::optional<int64_t> stop)
+{
+    cdf::decimation::minmax_t result;
+    std::vector<int64_t> edges;
+    {
+        py::gil_scoped_release release;
+        if (not start || not stop)
+        {
+            const auto [first, last] = cdf::decimation::time_span(time);
+            start = start.value_or(first);
+            stop = stop.value_or(last);
+        }
+        result = cdf::decimation::minmax(values, time, buckets, *start, *stop);
+        edges = cdf::decimation::uniform_edges(*start, *stop, buckets);
+    }
+    // one row per bucket, then the shape of a record
+    auto shape = _details::shape_ssize_t(values);
+    if (std::empty(shape))
+        shape.push_back(0);
+    shape[0] = static_cast<ssize_t>(buckets);
+    py::dict output;
+    output["edges"] = py::array_t<int64_t>(static_cast<ssize_t>(std::size(edges)), edges.data())
+                          .attr("view")("datetime64[ns]");
+    output["min"] = _details::to_array(result.min, shape);
+    output["max"] = _details::to_array(result.max, shape);
+    output["first"] = _details::to_array(result.first, shape);
+    output["last"] = _details::to_array(result.last, shape);
+    return output;
+}
+
+void def_decimation_functions(auto& mod)
+{
+    mod.def("minmax", &minmax, py::arg { "values" }, py::arg { "time" }, py::arg { "buckets" },
+        py::arg { "start" } = std::nullopt, py::arg { "stop" } = std::nullopt);
+}
@@ -54,6 +54,13 @@ void def_enums_wrappers(T& mod)
         .export_values()
         .finalize();
 
+    py::native_enum<cdf_sparse_records>(mod, "SparseRecords", "enum.Enum")
+        .value("no_sparse", cdf_sparse_records::no_sparse)
+        .value("pad", cdf_sparse_records::pad)
+        .value("previous", cdf_sparse_records::previous)
+        .export_values()
+        .finalize();
+
     py::native_enum<CDF_Types>(mod, "DataType", "enum.Enum")
         .value("CDF_BYTE", CDF_Types::CDF_BYTE)
         .value("CDF_CHAR", CDF_Types::CDF_CHAR)
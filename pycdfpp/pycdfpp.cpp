@@ -25,7 +25,9 @@
 ----------------------------------------------------------------------------*/
 #include <cdfpp/attribute.hpp>
 #include <cdfpp/cdf-map.hpp>
+#include <cdfpp/cdf-parallel.hpp>
 #include <cdfpp/cdf-repr.hpp>
+#include <cdfpp/cdf-trace.hpp>
 #include <cdfpp/no_init_vector.hpp>
 #include <cdfpp/variable.hpp>
 #include <cdfpp_config.h>
@@ -33,8 +35,10 @@
 #include "attribute.hpp"
 #include "cdf.hpp"
 #include "chrono.hpp"
+#include "decimation.hpp"
 #include "enums.hpp"
 #include "repr.hpp"
+#include "spectrogram.hpp"
 #include "variable.hpp"
 
 using namespace cdf;
@@ -117,10 +121,51 @@ PYBIND11_MODULE(_pycdfpp, m, py::mod_gil_not_used())
     def_attribute_wrapper(m);
     def_variable_wrapper(m);
     def_time_conversion_functions(m);
+    def_decimation_functions(m);
+    def_spectrogram_functions(m);
     def_cdf_wrapper(m);
 
     def_cdf_loading_functions(m);
     def_cdf_saving_functions(m);
+    m.def(
+        "set_num_threads",
+        [](std::size_t threads)
+        {
+            py::gil_scoped_release release;
+            cdf::parallel::set_num_threads(threads);
+        },
+        py::arg("threads"),
+        "Sets how many threads (calling thread included) CDFpp may use for bulk operations, "
+        "0 restores the default (CDFPP_NUM_THREADS environment variable or a guess from the "
+        "hardware), 1 disables threading.");
+    m.def("get_num_threads", &cdf::parallel::num_threads,
+        "Returns how many threads (calling thread included) CDFpp may use for bulk operations.");
+    m.def("set_min_chunk_size", &cdf::parallel::set_min_chunk_size, py::arg("elements"),
+        "Sets the smallest number of elements worth handing to another thread in bulk "
+        "operations such as time conversions (default 1Mi or CDFPP_MIN_CHUNK_SIZE).");
+    m.def("tracing_available", &cdf::tracing::available,
+        "Whether CDFpp was built with the with_tracing option, see start_tracing.");
+    m.def("start_tracing", &cdf::tracing::start,
+        "Starts recording load, save and time conversion phases for a Chrome/Perfetto trace "
+        "(also started by setting the CDFPP_TRACE environment variable to an output path).");
+    m.def("stop_tracing", &cdf::tracing::stop, "Stops recording, recorded events are kept.");
+    m.def("clear_trace", &cdf::tracing::clear, "Drops the recorded events.");
+    m.def(
+        "trace_json",
+        []()
+        {
+            py::gil_scoped_release release;
+            return cdf::tracing::to_json();
+        },
+        "Returns the recorded events as Chrome trace JSON, which ui.perfetto.dev opens.");
+    m.def(
+        "write_trace",
+        [](const std::string& path)
+        {
+            py::gil_scoped_release release;
+            return cdf::tracing::write(path);
+        },
+        py::arg("path"), "Writes the recorded events as Chrome trace JSON to path.");
     m.def("_buffer_info",
         [](py::buffer& buff) -> std::string
         {
@@ -0,0 +1,118 @@
+/*------------------------------------------------------------------------------
+-- The MIT License (MIT)
+--
+-- Copyright © 2024, Laboratory of Plasma Physics- CNRS
+--
+-- Permission is hereby granted, free of charge, to any person obtaining a copy
+-- of this software and associated documentation files (the “Software”), to deal
+-- in the Software without restriction, including without limitation the rights
+-- to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+-- of the Software, and to permit persons to whom the Software is furnished to do
+-- so, subject to the following conditions:
+--
+-- The above copyright notice and this permission notice shall be included in all
+-- copies or substantial portions of the Software.
+--
+-- THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+-- INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+-- PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+-- HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+-- OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+-- SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-------------------------------------------------------------------------------*/
+/*-- Author : Alexis Jeandet
+-- Mail : alexis.jeandet@member.fsf.org
+----------------------------------------------------------------------------*/
+#pragma once
+#include "collections.hpp"
+
+#include <cdfpp/cdf-spectrogram.hpp>
+#include <cdfpp/variable.hpp>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/core.h>
+
+namespace py = pybind11;
+
+namespace _details
+{
+[[nodiscard]] inline cdf::spectrogram::scale_t to_scale(
+    const std::optional<std::string>& scale, cdf::spectrogram::scale_t fallback)
+{
+    if (not scale)
+        return fallback;
+    if (*scale == "log")
+        return cdf::spectrogram::scale_t::log;
+    if (*scale == "linear")
+        return cdf::spectrogram::scale_t::linear;
+    throw std::invalid_argument(
+        fmt::format("spectrogram: scale must be 'log' or 'linear', got '{}'", *scale));
+}
+
+[[nodiscard]] inline const char* scale_name(cdf::spectrogram::scale_t scale)
+{
+    return scale == cdf::spectrogram::scale_t::log ? "log" : "linear";
+}
+}
+
+[[nodiscard]] inline py::dict spectrogram(const Variable& values, const Variable& time,
+    std::size_t width, std::size_t height, const Variable* bins, std::optional<int64_t> start,
+    std::optional<int64_t> stop, std::optional<double> y_min, std::optional<double> y_max,
+    std::optional<std::string> y_scale, std::optional<double> z_min,
+    std::optional<double> z_max, std::optional<std::string> z_scale)
+{
+    using cdf::spectrogram::scale_t;
+    const cdf::spectrogram::settings_t settings { .width = width,
+        .height = height,
+        .start = start,
+        .stop = stop,
+        .y_min = y_min,
+        .y_max = y_max,
+        .y_scale = _details::to_scale(y_scale,
+            bins ? cdf::spectrogram::scale_type(*bins, scale_t::linear) : scale_t::linear),
+        .z_min = z_min,
+        .z_max = z_max,
+        .z_scale
+        = _details::to_scale(z_scale, cdf::spectrogram::scale_type(values, scale_t::log)) };
+    cdf::spectrogram::image_t image;
+    {
+        py::gil_scoped_release release;
+        image = cdf::spectrogram::rasterize(values, time, bins, settings);
+    }
+    auto rgba = fast_allocate_array<uint8_t>(std::vector<ssize_t> {
+        static_cast<ssize_t>(image.height), static_cast<ssize_t>(image.width), 4 });
+    std::copy(std::cbegin(image.rgba), std::cend(image.rgba),
+        static_cast<uint8_t*>(rgba.mutable_data()));
+    const std::array<int64_t, 2> range { image.start, image.stop };
+    auto time_range = py::array_t<int64_t>(2, range.data()).attr("view")("datetime64[ns]");
+    py::dict output;
+    output["image"] = rgba;
+    output["start"] = time_range[py::int_(0)];
+    output["stop"] = time_range[py::int_(1)];
+    output["y_min"] = image.y_min;
+    output["y_max"] = image.y_max;
+    output["y_scale"] = _details::scale_name(image.y_scale);
+    output["z_min"] = image.z_min;
+    output["z_max"] = image.z_max;
+    output["z_scale"] = _details::scale_name(image.z_scale);
+    return output;
+}
+
+void def_spectrogram_functions(auto& mod)
+{
+    mod.def("spectrogram", &spectrogram, py::arg { "values" }, py::arg { "time" },
+        py::arg { "width" }, py::arg { "height" }, py::arg { "bins" } = nullptr,
+        py::arg { "start" } = std::nullopt, py::arg { "stop" } = std::nullopt,
+        py::arg { "y_min" } = std::nullopt, py::arg { "y_max" } = std::nullopt,
+        py::arg { "y_scale" } = std::nullopt, py::arg { "z_min" } = std::nullopt,
+        py::arg { "z_max" } = std::nullopt, py::arg { "z_scale" } = std::nullopt);
+}
@@ -38,6 +38,12 @@
 #include <cdfpp/chrono/cdf-chrono.hpp>
 #include <cdfpp/no_init_vector.hpp>
 #include <cdfpp_config.h>
+
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+
 using namespace cdf;
 
 #include <pybind11/chrono.h>
@@ -73,6 +79,8 @@ values_loaded: bool
     True if values are availbale in memory, this is usefull with lazy loading to know if values are already loaded.
 compression: CompressionType
     variable compression type (supported values are no_compression, rle_compression, gzip_compression)
+sparse_records: SparseRecords
+    what records missing from the file hold once loaded (pad values or the previous record)
 values: numpy.array
     returns variable values as a numpy.array of the corresponding dtype and shape, note that no copies are involved, the returned array is just a view on variable data.
 values_encoded: numpy.array
@@ -86,6 +94,16 @@ set_compression_type
     Sets the variable compression type
 set_values
     Sets the variable values
+read_into
+    Decodes a range of records straight into a caller provided buffer
+chunks
+    Iterates over the variable values by batches of records
+present_records
+    Ranges of records actually stored in the file
+compact
+    Only the records stored in the file with their record numbers
+load_values
+    Loads lazy values now, thread safe and releases the GIL while decoding
 
 )";
 
@@ -571,9 +589,64 @@ inline void set_values(
 }
 
 
+struct py_record_chunks
+{
+    record_chunks range;
+    std::optional<record_chunks::iterator> it;
+};
+
+template <CDF_Types T>
+[[nodiscard]] py::object chunk_to_array(record_chunk&& chunk)
+{
+    auto values = std::make_unique<data_t>(std::move(chunk.values));
+    auto ptr = values->bytes_ptr();
+    py::capsule owner(values.get(), [](void* p) { delete static_cast<data_t*>(p); });
+    values.release();
+    if constexpr (T == CDF_Types::CDF_CHAR || T == CDF_Types::CDF_UCHAR)
+    {
+        std::vector<ssize_t> shape(std::cbegin(chunk.shape), std::cend(chunk.shape) - 1);
+        return py::array(py::dtype(fmt::format("S{}", chunk.shape.back())), shape, ptr, owner);
+    }
+    else
+    {
+        std::vector<ssize_t> shape(std::cbegin(chunk.shape), std::cend(chunk.shape));
+        return py::array_t<from_cdf_type_t<T>>(
+            shape, reinterpret_cast<from_cdf_type_t<T>*>(ptr), owner);
+    }
+}
+
+template <typename T>
+void def_record_chunks_wrapper(T& mod)
+{
+    py::class_<py_record_chunks>(mod, "_RecordChunks")
+        .def("__iter__", [](py::object& self) { return self; })
+        .def("__next__",
+            [](py_record_chunks& self) -> py::object
+            {
+                {
+                    py::gil_scoped_release release;
+                    if (not self.it)
+                        self.it.emplace(self.range.begin());
+                    else
+                        ++(*self.it);
+                }
+                if (*self.it == record_chunks::sentinel {})
+                    throw py::stop_iteration();
+                auto& chunk = **self.it;
+                if (chunk.values.type() == CDF_Types::CDF_NONE)
+                    return py::none();
+                return cdf_type_dispatch(chunk.values.type(),
+                    []<CDF_Types type>(record_chunk&& c) -> py::object
+                    { return chunk_to_array<type>(std::move(c)); },
+                    std::move(chunk));
+            });
+}
+
+
 template <typename T>
 void def_variable_wrapper(T& mod)
 {
+    def_record_chunks_wrapper(mod);
     py::class_<Variable>(mod, "Variable", py::buffer_protocol(), docstrings::_Variable)
         .def("__repr__", __repr__<Variable>)
         .def(py::self == py::self)
@@ -600,7 +673,93 @@ void def_variable_wrapper(T& mod)
             "Whether the variable's records are stored as a single contiguous block in the "
             "file (True) or fragmented across several VVR/CVVR blocks (False). Walks the "
             "variable's index records on first call, then caches the result.")
+        .def_property_readonly("sparse_records", &Variable::sparse_records)
+        .def(
+            "present_records",
+            [](const Variable& var)
+            {
+                py::list ranges;
+                for (const auto& r : var.present_records())
+                    ranges.append(py::make_tuple(r.start, r.stop));
+                return ranges;
+            },
+            "Returns the [start, stop) ranges of records actually stored in the file. Records "
+            "of a sparse variable outside of them read back as pad values or as a copy of the "
+            "previous present record, see sparse_records.")
+        .def(
+            "compact",
+            [](const Variable& var) -> py::tuple
+            {
+                auto compact = [&var]()
+                {
+                    py::gil_scoped_release release;
+                    return var.compact();
+                }();
+                py::array_t<uint32_t> record_numbers(std::size(compact.record_numbers),
+                    compact.record_numbers.data());
+                if (compact.values.type() == CDF_Types::CDF_NONE)
+                    return py::make_tuple(record_numbers, py::none());
+                return py::make_tuple(record_numbers,
+                    cdf_type_dispatch(compact.values.type(),
+                        []<CDF_Types type>(record_chunk&& c) -> py::object
+                        { return chunk_to_array<type>(std::move(c)); },
+                        record_chunk { 0, std::move(compact.shape), std::move(compact.values) }));
+            },
+            "Returns (record_numbers, values) with only the records stored in the file, "
+            "instead of a dense array mostly made of padding for sparse variables. Lazily "
+            "loaded variables are read straight from the file without being loaded whole.")
         .def_property_readonly("values_loaded", &Variable::values_loaded)
+        .def(
+            "load_values",
+            [](const Variable& var)
+            {
+                py::gil_scoped_release release;
+                var.load_values();
+            },
+            "Loads and decodes the variable values now instead of on first access. Safe to call "
+            "concurrently from several threads, the GIL is released while decoding.")
+        .def(
+            "read_into",
+            [](const Variable& var, py::buffer& out, std::size_t start,
+                std::optional<std::size_t> stop)
+            {
+                py::buffer_info info = out.request(true);
+                if (info.readonly)
+                    throw std::invalid_argument { "read_into requires a writable buffer" };
+                auto expected_stride = info.itemsize;
+                for (auto dim = info.ndim; dim > 0; dim--)
+                {
+                    if (info.shape[dim - 1] > 1 and info.strides[dim - 1] != expected_stride)
+                        throw std::invalid_argument {
+                            "read_into requires a C contiguous buffer"
+                        };
+                    expected_stride *= info.shape[dim - 1];
+                }
+                if (var.type() != CDF_Types::CDF_CHAR and var.type() != CDF_Types::CDF_UCHAR
+                    and static_cast<std::size_t>(info.itemsize) != cdf_type_size(var.type()))
+                    throw std::invalid_argument { fmt::format(
+                        "read_into: buffer item size is {} bytes, {} values are {} bytes",
+                        info.itemsize, cdf_type_str(var.type()), cdf_type_size(var.type())) };
+                // info holds the buffer export, out can't be resized while we write to it
+                py::gil_scoped_release release;
+                return var.read_into(
+                    std::span<std::byte>(static_cast<std::byte*>(info.ptr),
+                        static_cast<std::size_t>(info.size * info.itemsize)),
+                    record_range { start, stop.value_or(std::numeric_limits<std::size_t>::max()) });
+            },
+            py::arg("out"), py::arg("start") = 0, py::arg("stop") = std::nullopt,
+            "Decodes records [start, stop) into out, a writable C contiguous buffer (a numpy "
+            "array for instance), without loading the whole variable. Returns the number of "
+            "records written.")
+        .def(
+            "chunks",
+            [](const Variable& var, std::size_t records_per_chunk) {
+                return py_record_chunks { var.chunks(records_per_chunk), std::nullopt };
+            },
+            py::arg("records_per_chunk"), py::keep_alive<0, 1>(),
+            "Returns an iterator over the variable values as numpy arrays of at most "
+            "records_per_chunk records, decoded on demand without loading the whole variable. "
+            "The file reads of the next chunk start while the current one is processed.")
         .def_property("compression", &Variable::compression_type, &Variable::set_compression_type)
         .def_buffer([](Variable& var) -> py::buffer_info { return make_buffer(var); })
         .def_property_readonly("values", make_values_view<false>, py::keep_alive<0, 1>())
@@ -0,0 +1,40 @@
+#include <cdfpp/vectorized/cdf-chrono-impl.hpp>
+
+// Only built into the -msimd128 WASM module: SIMD128 support is decided when the module is
+// picked (see wacdfpp/wasm.js), so there is a single architecture and nothing to dispatch.
+
+void vectorized_to_ns_from_1970(
+    const std::span<const cdf::tt2000_t>& input, int64_t* const output)
+{
+    cdf::chrono::vectorized::_to_ns_from_1970_tt2000_t {}(xsimd::wasm {}, input, output);
+}
+
+void vectorized_to_ns_from_1970(
+    const std::span<const cdf::epoch>& input, int64_t* const output)
+{
+    cdf::chrono::vectorized::_to_ns_from_1970_epoch_t {}(xsimd::wasm {}, input, output);
+}
+
+void vectorized_to_ns_from_1970(
+    const std::span<const cdf::epoch16>& input, int64_t* const output)
+{
+    cdf::chrono::vectorized::_to_ns_from_1970_epoch16_t {}(xsimd::wasm {}, input, output);
+}
+
+void vectorized_from_ns_from_1970(
+    const std::span<const int64_t>& input, cdf::tt2000_t* const output)
+{
+    cdf::chrono::vectorized::_from_ns_from_1970_tt2000_t {}(xsimd::wasm {}, input, output);
+}
+
+void vectorized_from_ns_from_1970(
+    const std::span<const int64_t>& input, cdf::epoch* const output)
+{
+    cdf::chrono::vectorized::_from_ns_from_1970_epoch_t {}(xsimd::wasm {}, input, output);
+}
+
+void vectorized_from_ns_from_1970(
+    const std::span<const int64_t>& input, cdf::epoch16* const output)
+{
+    cdf::chrono::vectorized::_from_ns_from_1970_epoch16_t {}(xsimd::wasm {}, input, output);
+}
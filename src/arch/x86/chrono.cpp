@@ -8,6 +8,13 @@ auto _disp_to_ns_from_1970_tt2000
 auto _disp_to_ns_from_1970_epoch = xsimd::dispatch<CDFPP_XSIMD_ARCH_LIST>(_to_ns_from_1970_epoch_t {});
 auto _disp_to_ns_from_1970_epoch16 = xsimd::dispatch<CDFPP_XSIMD_ARCH_LIST>(_to_ns_from_1970_epoch16_t {});
 
+auto _disp_from_ns_from_1970_tt2000
+    = xsimd::dispatch<CDFPP_XSIMD_ARCH_LIST>(_from_ns_from_1970_tt2000_t {});
+auto _disp_from_ns_from_1970_epoch
+    = xsimd::dispatch<CDFPP_XSIMD_ARCH_LIST>(_from_ns_from_1970_epoch_t {});
+auto _disp_from_ns_from_1970_epoch16
+    = xsimd::dispatch<CDFPP_XSIMD_ARCH_LIST>(_from_ns_from_1970_epoch16_t {});
+
 } // namespace cdf::chrono::vectorized
 
 void vectorized_to_ns_from_1970(
@@ -27,3 +34,21 @@ void vectorized_to_ns_from_1970(
 {
     cdf::chrono::vectorized::_disp_to_ns_from_1970_epoch16(input, output);
 }
+
+void vectorized_from_ns_from_1970(
+    const std::span<const int64_t>& input, cdf::tt2000_t* const output)
+{
+    cdf::chrono::vectorized::_disp_from_ns_from_1970_tt2000(input, output);
+}
+
+void vectorized_from_ns_from_1970(
+    const std::span<const int64_t>& input, cdf::epoch* const output)
+{
+    cdf::chrono::vectorized::_disp_from_ns_from_1970_epoch(input, output);
+}
+
+void vectorized_from_ns_from_1970(
+    const std::span<const int64_t>& input, cdf::epoch16* const output)
+{
+    cdf::chrono::vectorized::_disp_from_ns_from_1970_epoch16(input, output);
+}
@@ -1,11 +1,17 @@
+#include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <span>
+#include <vector>
 
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 
 #include "cdfpp/chrono/cdf-chrono.hpp"
+#include "cdfpp/chrono/cdf-time-format.hpp"
+#include "cdfpp/chrono/cdf-time-parse.hpp"
+#include <fmt/core.h>
 #include "test_values.hpp"
 
 
@@ -137,6 +143,102 @@ TEST_CASE("To ns from 1970", "")
             }
         }
     }
+    SECTION("Vectorized unsorted and pre-1972 batches match scalar")
+    {
+        // whole batches before 1972, batches straddling leap seconds and shuffled values
+        std::vector<cdf::tt2000_t> inputs;
+        for (int64_t i = 0; i < 256; ++i)
+            inputs.push_back(cdf::tt2000_t { -1'200'000'000'000'000'000LL + i * 1'000'000'000LL });
+        for (const auto& [leap, _] : leap_seconds_tt2000_reverse)
+            for (int64_t delta = -8; delta < 8; ++delta)
+                inputs.push_back(cdf::tt2000_t { leap + delta * 125'000'000LL });
+        for (int64_t i = 0; i < 1001; ++i)
+            inputs.push_back(
+                cdf::tt2000_t { ((i * 7919) % 1001 - 600) * 1'900'000'123'456LL });
+        std::vector<int64_t> expected(std::size(inputs));
+        for (std::size_t i = 0; i < std::size(inputs); ++i)
+            cdf::_impl::scalar_to_ns_from_1970({ &inputs[i], 1 }, &expected[i]);
+        for (std::size_t offset = 0; offset < 8; ++offset)
+        {
+            std::vector<int64_t> outputs(std::size(inputs) - offset);
+            cdf::to_ns_from_1970(std::span<const cdf::tt2000_t> { inputs }.subspan(offset),
+                outputs.data());
+            REQUIRE(std::equal(std::cbegin(outputs), std::cend(outputs),
+                std::cbegin(expected) + static_cast<std::ptrdiff_t>(offset)));
+        }
+    }
+    SECTION("Sorted inputs are converted segment by segment")
+    {
+        // 1965 -> 2025 with every leap second boundary surrounded by dense values
+        std::vector<cdf::tt2000_t> inputs;
+        for (int64_t i = 0; i < 1000; ++i)
+            inputs.push_back(
+                cdf::tt2000_t { -1'100'000'000'000'000'000LL + i * 1'900'000'123'456'789LL });
+        for (const auto& [leap, _] : leap_seconds_tt2000_reverse)
+            for (int64_t delta = -40; delta < 40; ++delta)
+                inputs.push_back(cdf::tt2000_t { leap + delta * 25'000'000LL });
+        std::sort(std::begin(inputs), std::end(inputs),
+            [](const auto& a, const auto& b) { return a.nseconds < b.nseconds; });
+        std::vector<int64_t> expected(std::size(inputs));
+        for (std::size_t i = 0; i < std::size(inputs); ++i)
+            cdf::_impl::scalar_to_ns_from_1970({ &inputs[i], 1 }, &expected[i]);
+
+        REQUIRE(cdf::_impl::looks_sorted(inputs));
+        std::size_t covered = 0, previous_segment = 0;
+        cdf::_impl::for_each_leap_segment(std::span<const cdf::tt2000_t> { inputs },
+            [&](std::size_t first, std::size_t size, std::size_t segment)
+            {
+                REQUIRE(first == covered);
+                REQUIRE((covered == 0 || segment > previous_segment));
+                covered += size;
+                previous_segment = segment;
+            });
+        REQUIRE(covered == std::size(inputs));
+        REQUIRE(previous_segment == std::size(leap_seconds_tt2000_reverse));
+
+        for (std::size_t offset = 0; offset < 8; ++offset)
+        {
+            const auto input = std::span<const cdf::tt2000_t> { inputs }.subspan(offset);
+            std::vector<int64_t> scalar_outputs(std::size(input)), outputs(std::size(input));
+            cdf::_impl::scalar_to_ns_from_1970(input, scalar_outputs.data());
+            cdf::to_ns_from_1970(input, outputs.data());
+            REQUIRE(std::equal(std::cbegin(scalar_outputs), std::cend(scalar_outputs),
+                std::cbegin(expected) + static_cast<std::ptrdiff_t>(offset)));
+            REQUIRE(outputs == scalar_outputs);
+        }
+
+        // looks sorted but isn't, misplaced values must still get their own leap seconds
+        std::swap(inputs[10], inputs[std::size(inputs) - 10]);
+        std::swap(expected[10], expected[std::size(expected) - 10]);
+        std::swap(inputs[1500], inputs[1501]);
+        std::swap(expected[1500], expected[1501]);
+        REQUIRE(cdf::_impl::looks_sorted(inputs));
+        std::vector<int64_t> outputs(std::size(inputs));
+        cdf::_impl::scalar_to_ns_from_1970(inputs, outputs.data());
+        REQUIRE(outputs == expected);
+        cdf::to_ns_from_1970(std::span<const cdf::tt2000_t> { inputs }, outputs.data());
+        REQUIRE(outputs == expected);
+    }
+    SECTION("Vectorized epoch and epoch16 match scalar")
+    {
+        std::vector<cdf::epoch> epochs;
+        std::vector<cdf::epoch16> epochs16;
+        for (int64_t i = 0; i < 1003; ++i)
+        {
+            const auto step = static_cast<double>(i * 2'718'281);
+            epochs.push_back(cdf::epoch { 62'000'000'000'000.0 + step });
+            epochs16.push_back(
+                cdf::epoch16 { 62'000'000'000.0 + step, static_cast<double>(i * 997'000) });
+        }
+        std::vector<int64_t> expected(std::size(epochs)), outputs(std::size(epochs));
+        cdf::_impl::scalar_to_ns_from_1970(std::span<const cdf::epoch> { epochs }, expected.data());
+        cdf::to_ns_from_1970(std::span<const cdf::epoch> { epochs }, outputs.data());
+        REQUIRE(outputs == expected);
+        cdf::_impl::scalar_to_ns_from_1970(
+            std::span<const cdf::epoch16> { epochs16 }, expected.data());
+        cdf::to_ns_from_1970(std::span<const cdf::epoch16> { epochs16 }, outputs.data());
+        REQUIRE(outputs == expected);
+    }
     SECTION("Vectorized pre-1960 exact")
     {
         for (const auto& item : test_values)
@@ -153,6 +255,129 @@ TEST_CASE("To ns from 1970", "")
     }
 }
 
+TEST_CASE("From ns from 1970", "")
+{
+    using namespace cdf;
+    using namespace std::chrono;
+    std::vector<int64_t> input;
+    // around every leap second boundary, where kernels switch offsets
+    for (const auto& [leap, _] : cdf::chrono::leap_seconds::leap_seconds_tt2000)
+    {
+        for (const int64_t delta : { -1'000'000'001LL, -1LL, 0LL, 1LL, 999'999'999LL })
+            input.push_back(leap + delta);
+    }
+    // negative values check truncation toward zero, like duration_cast
+    for (const int64_t v : { -1LL, -999'999LL, -1'000'000LL, -1'000'001LL, -999'999'999LL,
+             -1'000'000'000LL, -1'000'000'001LL, -631152000123456789LL, 0LL, 1LL, 999'999LL,
+             1'000'000LL, 1'700'000'000'123'456'789LL, 4'102'444'800'000'000'001LL })
+        input.push_back(v);
+    // a sorted recent run and an unsorted one, long enough to go through the vector loops
+    for (int64_t i = 0; i < 1000; ++i)
+        input.push_back(1'600'000'000'000'000'000LL + i * 1'234'567'891LL);
+    for (int64_t i = 0; i < 1001; ++i)
+        input.push_back(((i * 7919) % 1001 - 500) * 3'600'000'123'456LL);
+
+    const auto reference = [&input]<typename T>(T)
+    {
+        std::vector<T> expected;
+        for (const auto ns : input)
+            expected.push_back(to_cdf_time<T>(system_clock::time_point {} + nanoseconds(ns)));
+        return expected;
+    };
+    SECTION("tt2000")
+    {
+        std::vector<tt2000_t> output(std::size(input));
+        from_ns_from_1970(input, output.data());
+        REQUIRE(output == reference(tt2000_t {}));
+    }
+    SECTION("epoch")
+    {
+        std::vector<epoch> output(std::size(input));
+        from_ns_from_1970(input, output.data());
+        REQUIRE(output == reference(epoch {}));
+    }
+    SECTION("epoch16")
+    {
+        std::vector<epoch16> output(std::size(input));
+        from_ns_from_1970(input, output.data());
+        REQUIRE(output == reference(epoch16 {}));
+    }
+    SECTION("unaligned tails")
+    {
+        for (std::size_t offset = 1; offset < 8; ++offset)
+        {
+            std::span<const int64_t> view { input.data() + offset, std::size(input) - offset };
+            std::vector<tt2000_t> output(std::size(view) + 1);
+            from_ns_from_1970(view, output.data() + 1);
+            const auto expected = reference(tt2000_t {});
+            REQUIRE(std::equal(std::cbegin(output) + 1, std::cend(output),
+                std::cbegin(expected) + static_cast<std::ptrdiff_t>(offset)));
+        }
+    }
+}
+
+
+TEST_CASE("Bulk conversions between CDF time types", "")
+{
+    using namespace cdf;
+    // 1950 -> 2040 with sub-millisecond fractions, longer than one conversion chunk
+    std::vector<cdf::tt2000_t> tt2000s;
+    std::vector<cdf::epoch> epochs;
+    std::vector<cdf::epoch16> epochs16;
+    for (int64_t i = 0; i < 5003; ++i)
+    {
+        const auto step = (i * 7919) % 5003 - 2501;
+        tt2000s.push_back(cdf::tt2000_t { step * 567'890'123'456'789LL });
+        epochs.push_back(cdf::epoch { 63'400'000'000'000.0 + step * 567'890'123.456789 });
+        epochs16.push_back(cdf::epoch16 {
+            63'400'000'000.0 + static_cast<double>(step * 567'890), (step + 2501) * 199'880'123. });
+    }
+    for (const auto& [leap, _] : chrono::leap_seconds::leap_seconds_tt2000_reverse)
+        tt2000s.push_back(cdf::tt2000_t { leap - 1 });
+
+    const auto check_to_ns = [](const auto& input)
+    {
+        std::vector<int64_t> outputs(std::size(input));
+        to_ns_from_1970(std::span { input }, outputs.data());
+        for (std::size_t i = 0; i < std::size(input); ++i)
+            REQUIRE(outputs[i] == to_time_point(input[i]).time_since_epoch().count());
+    };
+    const auto check_conversion = []<typename output_t>(const auto& input, output_t)
+    {
+        std::vector<output_t> outputs(std::size(input));
+        for (std::size_t offset = 0; offset < 3; ++offset)
+        {
+            const auto view = std::span { input }.subspan(offset);
+            to_cdf_time(view, outputs.data());
+            for (std::size_t i = 0; i < std::size(view); ++i)
+                REQUIRE(outputs[i] == to_cdf_time<output_t>(view[i]));
+        }
+    };
+    SECTION("to_ns_from_1970 matches to_time_point")
+    {
+        check_to_ns(tt2000s);
+        check_to_ns(epochs);
+        check_to_ns(epochs16);
+    }
+    SECTION("from tt2000")
+    {
+        check_conversion(tt2000s, cdf::tt2000_t {});
+        check_conversion(tt2000s, cdf::epoch {});
+        check_conversion(tt2000s, cdf::epoch16 {});
+    }
+    SECTION("from epoch")
+    {
+        check_conversion(epochs, cdf::tt2000_t {});
+        check_conversion(epochs, cdf::epoch {});
+        check_conversion(epochs, cdf::epoch16 {});
+    }
+    SECTION("from epoch16")
+    {
+        check_conversion(epochs16, cdf::tt2000_t {});
+        check_conversion(epochs16, cdf::epoch {});
+        check_conversion(epochs16, cdf::epoch16 {});
+    }
+}
 
 TEST_CASE("cdf epoch to timepoint", "")
 {
@@ -239,3 +464,175 @@ TEST_CASE("timepoint to cdf tt2000", "")
         }
     }
 }
+
+TEST_CASE("Time string formatting", "")
+{
+    using namespace cdf;
+    namespace tf = cdf::chrono::time_format;
+    // 1800 -> 2200 including leap days, month ends and pre-1970 sub-seconds
+    std::vector<cdf::epoch16> epochs16;
+    std::vector<cdf::tt2000_t> tt2000s;
+    for (int64_t i = 0; i < 3001; ++i)
+    {
+        const auto step = (i * 7919) % 3001 - 1500;
+        epochs16.push_back(cdf::epoch16 { 62'167'219'200.0 + static_cast<double>(step * 4'205'011),
+            static_cast<double>((step + 1500) * 333'000'111'000) });
+        tt2000s.push_back(cdf::tt2000_t { step * 4'205'011'123'456'789LL / 10 });
+    }
+    for (int64_t day = -1; day < 2; ++day)
+        epochs16.push_back(cdf::epoch16 { 63'082'281'600.0 + day * 86'400., 0. });
+
+    // one value at a time through std::chrono calendar types
+    const auto reference = [](const auto& tp, std::string_view format)
+    {
+        using namespace std::chrono;
+        const auto dp = floor<days>(tp);
+        const year_month_day ymd { dp };
+        const hh_mm_ss time { tp - dp };
+        std::string result;
+        for (std::size_t i = 0; i < std::size(format); ++i)
+        {
+            if (format[i] != '%')
+            {
+                result += format[i];
+                continue;
+            }
+            switch (format[++i])
+            {
+                case 'Y':
+                    result += fmt::format("{:04}", static_cast<int>(ymd.year()));
+                    break;
+                case 'm':
+                    result += fmt::format("{:02}", static_cast<unsigned>(ymd.month()));
+                    break;
+                case 'd':
+                    result += fmt::format("{:02}", static_cast<unsigned>(ymd.day()));
+                    break;
+                case 'j':
+                    result += fmt::format(
+                        "{:03}", (dp - sys_days { ymd.year() / January / 1 }).count() + 1);
+                    break;
+                case 'H':
+                    result += fmt::format("{:02}", time.hours().count());
+                    break;
+                case 'M':
+                    result += fmt::format("{:02}", time.minutes().count());
+                    break;
+                case 'S':
+                    result += fmt::format(
+                        "{:02}.{:09}", time.seconds().count(), time.subseconds().count());
+                    break;
+                default:
+                    result += format[i];
+            }
+        }
+        return result;
+    };
+    const auto check = [&reference](const auto& values, std::string_view format)
+    {
+        using time_t = typename std::decay_t<decltype(values)>::value_type;
+        const auto plan = tf::compile<time_t>(format);
+        std::string output(std::size(values) * plan.width(), '\0');
+        tf::format(std::span<const time_t> { values }, output.data(), plan);
+        for (std::size_t i = 0; i < std::size(values); ++i)
+        {
+            REQUIRE(output.substr(i * plan.width(), plan.width())
+                == reference(to_time_point(values[i]), format));
+        }
+    };
+    SECTION("matches std::chrono")
+    {
+        check(epochs16, "%Y-%m-%dT%H:%M:%S");
+        check(epochs16, "%Y-%jT%H:%M:%SZ %%");
+        check(tt2000s, "%d/%m/%Y %H%M%S");
+        check(tt2000s, "%Y%j");
+    }
+    SECTION("CDF fill and pad values")
+    {
+        const auto plan = tf::compile<cdf::tt2000_t>("%Y-%m-%dT%H:%M:%S");
+        const std::vector<cdf::tt2000_t> values { cdf::tt2000_t { 0 },
+            cdf::tt2000_t { std::numeric_limits<int64_t>::min() },
+            cdf::tt2000_t { std::numeric_limits<int64_t>::min() + 1 } };
+        std::string output(std::size(values) * plan.width(), '\0');
+        tf::format(std::span<const cdf::tt2000_t> { values }, output.data(), plan);
+        REQUIRE(output
+            == "2000-01-01T11:58:55.816000000"
+               "9999-12-31T23:59:59.999999999"
+               "0000-01-01T00:00:00.000000000");
+    }
+    SECTION("unsupported specifier")
+    {
+        REQUIRE_THROWS_AS(tf::compile<cdf::epoch>("%Y %q"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("ISO-8601 time parsing", "")
+{
+    using namespace cdf;
+    namespace tp = cdf::chrono::time_parse;
+    SECTION("round trips through the formatter")
+    {
+        std::vector<cdf::tt2000_t> tt2000s;
+        for (int64_t i = 0; i < 10001; ++i)
+            tt2000s.push_back(cdf::tt2000_t { ((i * 7919) % 10001 - 5000) * 123'456'789'123'457LL });
+        const auto plan = cdf::chrono::time_format::compile<cdf::tt2000_t>("%Y-%m-%dT%H:%M:%S");
+        std::string strings(std::size(tt2000s) * plan.width(), '\0');
+        cdf::chrono::time_format::format(
+            std::span<const cdf::tt2000_t> { tt2000s }, strings.data(), plan);
+
+        std::vector<cdf::tt2000_t> parsed(std::size(tt2000s));
+        tp::parse_iso8601(strings.data(), std::size(tt2000s), plan.width(), parsed.data());
+        REQUIRE(parsed == tt2000s);
+
+        std::vector<cdf::epoch16> epochs16(std::size(tt2000s));
+        std::vector<cdf::epoch16> expected(std::size(tt2000s));
+        tp::parse_iso8601(strings.data(), std::size(tt2000s), plan.width(), epochs16.data());
+        cdf::to_cdf_time(std::span<const cdf::tt2000_t> { tt2000s }, expected.data());
+        REQUIRE(epochs16 == expected);
+    }
+    SECTION("accepted syntaxes")
+    {
+        const auto expected = cdf::epoch16 { 63'145'440'000.0 + 3'723., 4'500'000'000. };
+        for (const auto s : { "2000-12-31T01:02:03.0045", "2000-12-31 01:02:03.004500000000Z",
+                 "  2000-12-31T01:02:03.00450000000099", "2000-12-31T01:02:03.0045Z\0\0\0" })
+        {
+            REQUIRE(tp::parse_iso8601<cdf::epoch16>(s) == expected);
+        }
+        REQUIRE(tp::parse_iso8601<cdf::epoch>("2000-12-31T01:02:03.0045")
+            == cdf::epoch { (63'145'440'000.0 + 3'723.) * 1000. + 4. });
+        REQUIRE(tp::parse_iso8601<cdf::epoch16>("2000-12-31")
+            == cdf::epoch16 { 63'145'440'000.0, 0. });
+        REQUIRE(tp::parse_iso8601<cdf::epoch16>("2000-12-31T01:02")
+            == cdf::epoch16 { 63'145'440'000.0 + 3'720., 0. });
+    }
+    SECTION("leap seconds")
+    {
+        const auto before = tp::parse_iso8601<cdf::tt2000_t>("2016-12-31T23:59:59.5");
+        const auto leap = tp::parse_iso8601<cdf::tt2000_t>("2016-12-31T23:59:60.5");
+        const auto after = tp::parse_iso8601<cdf::tt2000_t>("2017-01-01T00:00:00.5");
+        REQUIRE(leap.nseconds - before.nseconds == 1'000'000'000);
+        REQUIRE(after.nseconds - leap.nseconds == 1'000'000'000);
+        REQUIRE(after == to_tt2000(std::chrono::sys_days { std::chrono::year { 2017 } / 1 / 1 }
+            + std::chrono::milliseconds { 500 }));
+        REQUIRE(tp::parse_iso8601<cdf::epoch16>("2016-12-31T23:59:60")
+            == tp::parse_iso8601<cdf::epoch16>("2017-01-01"));
+        REQUIRE_THROWS_AS(
+            tp::parse_iso8601<cdf::tt2000_t>("2016-12-30T23:59:60"), std::invalid_argument);
+        REQUIRE_THROWS_AS(
+            tp::parse_iso8601<cdf::tt2000_t>("2016-12-31T23:58:60"), std::invalid_argument);
+    }
+    SECTION("invalid rows")
+    {
+        for (const auto s : { "", "2000-13-01", "2001-02-29", "2000-01-01T24:00:00",
+                 "2000-01-01T12:60", "2000-01-01T12:00:00.", "2000-01-01T12:00:00.5ZZ",
+                 "2000-01-01T12-00-00", "2000/01/01", "20x0-01-01T00:00:00" })
+        {
+            REQUIRE_THROWS_AS(tp::parse_iso8601<cdf::epoch16>(s), std::invalid_argument);
+        }
+        REQUIRE_THROWS_AS(tp::parse_iso8601<cdf::tt2000_t>("1600-01-01"), std::invalid_argument);
+        const std::vector<std::string_view> rows { "2000-01-01", "2000-01-01T00:00:00", "nope" };
+        std::vector<cdf::tt2000_t> output(std::size(rows));
+        REQUIRE_THROWS_WITH(tp::parse_iso8601(std::span { rows }, output.data()),
+            "invalid ISO-8601 time at row 2: 'nope'");
+    }
+}
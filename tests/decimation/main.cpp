@@ -0,0 +1,185 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "cdfpp/cdf-decimation.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+#include "cdfpp/variable.hpp"
+
+#include "../synthetic_series.hpp"
+
+using namespace cdf;
+
+namespace
+{
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+// one record at a time, straight from the definition
+decimation::minmax_t reference(const std::vector<double>& values, std::size_t components,
+    const std::vector<tt2000_t>& time, const std::vector<tt2000_t>& edges, double fill)
+{
+    decimation::minmax_t result;
+    result.buckets = std::size(edges) - 1;
+    result.components = components;
+    const auto size = result.buckets * components;
+    result.min.resize(size, nan);
+    result.max.resize(size, nan);
+    result.first.resize(size, nan);
+    result.last.resize(size, nan);
+    for (std::size_t record = 0; record < std::size(time); ++record)
+    {
+        for (std::size_t bucket = 0; bucket < result.buckets; ++bucket)
+        {
+            if (time[record].nseconds < edges[bucket].nseconds
+                || time[record].nseconds >= edges[bucket + 1].nseconds)
+                continue;
+            for (std::size_t component = 0; component < components; ++component)
+            {
+                const auto value = values[record * components + component];
+                const auto index = bucket * components + component;
+                if (std::isnan(value) || value == fill)
+                    continue;
+                if (std::isnan(result.first[index]))
+                {
+                    result.first[index] = result.min[index] = result.max[index] = value;
+                }
+                result.min[index] = std::min(result.min[index], value);
+                result.max[index] = std::max(result.max[index], value);
+                result.last[index] = value;
+            }
+        }
+    }
+    return result;
+}
+
+bool same(const no_init_vector<double>& left, const no_init_vector<double>& right)
+{
+    return std::equal(std::cbegin(left), std::cend(left), std::cbegin(right), std::cend(right),
+        [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); });
+}
+
+bool same(const decimation::minmax_t& left, const decimation::minmax_t& right)
+{
+    return left.buckets == right.buckets && left.components == right.components
+        && same(left.min, right.min) && same(left.max, right.max)
+        && same(left.first, right.first) && same(left.last, right.last);
+}
+
+struct dataset
+{
+    std::vector<double> values;
+    std::vector<tt2000_t> time;
+    std::vector<tt2000_t> edges;
+};
+
+dataset make_dataset(std::size_t records, std::size_t components, std::size_t buckets)
+{
+    auto series = synthetic::make_series<tt2000_t>(records, components, 0, 10'000'000'000,
+        [](std::size_t i) { return std::sin(static_cast<double>(i) * 0.01) * 100.; });
+    dataset d { std::move(series.values), std::move(series.time), {} };
+    const auto step = d.time.back().nseconds / static_cast<int64_t>(buckets);
+    for (std::size_t bucket = 0; bucket <= buckets; ++bucket)
+        d.edges.push_back(tt2000_t { -1'000'000 + static_cast<int64_t>(bucket) * step });
+    return d;
+}
+}
+
+TEST_CASE("Min/max decimation", "")
+{
+    SECTION("matches a record by record reduction")
+    {
+        for (const std::size_t components : { 1, 3 })
+        {
+            const auto d = make_dataset(100'003, components, 997);
+            const auto result = decimation::minmax(std::span<const double> { d.values },
+                components, std::span<const tt2000_t> { d.time },
+                std::span<const tt2000_t> { d.edges }, synthetic::fill);
+            REQUIRE(same(
+                result, reference(d.values, components, d.time, d.edges, synthetic::fill)));
+            // the data gap leaves empty buckets
+            REQUIRE(std::any_of(std::cbegin(result.min), std::cend(result.min),
+                [](double v) { return std::isnan(v); }));
+        }
+    }
+    SECTION("doesn't depend on threading")
+    {
+        const auto d = make_dataset(200'000, 3, 1000);
+        const auto run = [&d]()
+        {
+            return decimation::minmax(std::span<const double> { d.values }, 3,
+                std::span<const tt2000_t> { d.time }, std::span<const tt2000_t> { d.edges });
+        };
+        parallel::set_num_threads(1);
+        const auto single = run();
+        parallel::set_num_threads(4);
+        parallel::set_min_chunk_size(1000);
+        const auto threaded = run();
+        parallel::set_num_threads(0);
+        parallel::set_min_chunk_size(1024 * 1024);
+        REQUIRE(same(single, threaded));
+    }
+    SECTION("uniform edges")
+    {
+        REQUIRE(decimation::uniform_edges(0, 10, 3) == std::vector<int64_t> { 0, 3, 6, 10 });
+        const auto edges = decimation::uniform_edges(
+            std::numeric_limits<int64_t>::min() + 1, std::numeric_limits<int64_t>::max(), 7);
+        REQUIRE(edges.front() == std::numeric_limits<int64_t>::min() + 1);
+        REQUIRE(edges.back() == std::numeric_limits<int64_t>::max());
+        REQUIRE(std::is_sorted(std::cbegin(edges), std::cend(edges)));
+        REQUIRE_THROWS_AS(decimation::uniform_edges(10, 10, 3), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Min/max decimation of variables", "")
+{
+    // 1000 records, one per second from 2000-01-01T12:00:00 (TT2000 starts 64.184s before)
+    no_init_vector<tt2000_t> time(1000);
+    no_init_vector<float> values(2000);
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        time[i] = tt2000_t { static_cast<int64_t>(i) * 1'000'000'000 + 64'184'000'000 };
+        values[2 * i] = static_cast<float>(i);
+        values[2 * i + 1] = i % 10 == 0 ? -1e31f : -static_cast<float>(i);
+    }
+    Variable epoch_var { "Epoch", 0, data_t { std::move(time), CDF_Types::CDF_TIME_TT2000 },
+        { 1000 } };
+    Variable var { "B", 1, data_t { std::move(values), CDF_Types::CDF_FLOAT }, { 1000, 2 } };
+    // not exactly -1e31f, the fill value has to be compared as a float
+    var.attributes.emplace("FILLVAL",
+        VariableAttribute { "FILLVAL",
+            data_t { no_init_vector<double> { -1e31 }, CDF_Types::CDF_DOUBLE } });
+
+    constexpr int64_t noon = 946'728'000'000'000'000;
+    const auto result
+        = decimation::minmax(var, epoch_var, 10, noon, noon + 1000 * 1'000'000'000LL);
+    REQUIRE(result.buckets == 10);
+    REQUIRE(result.components == 2);
+    for (std::size_t bucket = 0; bucket < 10; ++bucket)
+    {
+        const auto first = static_cast<double>(bucket * 100);
+        REQUIRE(result.first[bucket * 2] == first);
+        REQUIRE(result.last[bucket * 2] == first + 99);
+        REQUIRE(result.min[bucket * 2] == first);
+        REQUIRE(result.max[bucket * 2] == first + 99);
+        // record bucket * 100 is a fill value
+        REQUIRE(result.first[bucket * 2 + 1] == -(first + 1));
+        REQUIRE(result.max[bucket * 2 + 1] == -(first + 1));
+        REQUIRE(result.min[bucket * 2 + 1] == -(first + 99));
+    }
+
+    REQUIRE(decimation::time_span(epoch_var)
+        == std::pair<int64_t, int64_t> { noon, noon + 999 * 1'000'000'000LL + 1 });
+    REQUIRE_THROWS_AS(decimation::time_span(var), std::invalid_argument);
+
+    REQUIRE_THROWS_AS(decimation::minmax(var, var, 10, noon, noon + 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        decimation::minmax(epoch_var, epoch_var, 10, noon, noon + 1), std::invalid_argument);
+    Variable short_var { "short", 2,
+        data_t { no_init_vector<double>(10), CDF_Types::CDF_DOUBLE }, { 10 } };
+    REQUIRE_THROWS_AS(
+        decimation::minmax(short_var, epoch_var, 10, noon, noon + 1), std::invalid_argument);
+}
@@ -0,0 +1,161 @@
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-io/cdf-io.hpp"
+
+#include "../test_fixtures.hpp"
+
+using namespace cdf;
+
+namespace
+{
+uint64_t compressed_blocks(const io::io_stats& stats)
+{
+    return stats.codec(cdf_compression_type::rle_compression).blocks
+        + stats.codec(cdf_compression_type::gzip_compression).blocks;
+}
+
+bool inflated_more_than_read(const io::io_stats& stats, cdf_compression_type type)
+{
+    const auto& codec = stats.codec(type);
+    return codec.blocks == 0 or codec.uncompressed_bytes > codec.compressed_bytes;
+}
+}
+
+SCENARIO("Loading with stats gives the same CDF and accounts for it", "[CDF]")
+{
+    for (const auto& name : layout_fixtures)
+    {
+        GIVEN(std::string { "a full load of " } + name)
+        {
+            const auto path = fixture(name);
+            io::io_stats stats;
+            auto cdf = io::load(path, stats, true, false);
+            REQUIRE(cdf != std::nullopt);
+            THEN("the CDF is the one loaded without stats")
+            {
+                REQUIRE(*cdf == *io::load(path, true, false));
+            }
+            THEN("descriptor records, mapped and read bytes are counted")
+            {
+                REQUIRE(stats.records_parsed >= 2 + std::size(cdf->variables));
+                REQUIRE(stats.bytes_mapped == std::filesystem::file_size(path));
+                REQUIRE(stats.values_records > 0);
+                REQUIRE(stats.bytes_read > 0);
+                REQUIRE(stats.time(io::io_phase::load).count() > 0);
+                REQUIRE(stats.time(io::io_phase::descriptors) <= stats.time(io::io_phase::load));
+                REQUIRE(stats.time(io::io_phase::save).count() == 0);
+            }
+            THEN("codecs inflate to more bytes than they read")
+            {
+                REQUIRE(
+                    inflated_more_than_read(stats, cdf_compression_type::gzip_compression));
+                REQUIRE(inflated_more_than_read(stats, cdf_compression_type::rle_compression));
+            }
+        }
+    }
+    GIVEN("a file with compressed variables")
+    {
+        io::io_stats stats;
+        REQUIRE(io::load(fixture("a_cdf_with_compressed_vars.cdf"), stats, true, false));
+        THEN("each CVVR is counted once")
+        {
+            REQUIRE(compressed_blocks(stats) > 0);
+            REQUIRE(compressed_blocks(stats) <= stats.values_records);
+        }
+    }
+    GIVEN("a lazy load")
+    {
+        io::io_stats stats;
+        auto cdf = io::load(fixture("a_cdf.cdf"), stats, true, true);
+        REQUIRE(cdf != std::nullopt);
+        THEN("only descriptor records are read")
+        {
+            REQUIRE(stats.records_parsed > 0);
+            REQUIRE(stats.values_records == 0);
+            REQUIRE(stats.bytes_read == 0);
+        }
+        WHEN("values are decoded later on")
+        {
+            for (const auto& [name, var] : cdf->variables)
+                var.load_values();
+            THEN("they are counted as they would be by a full load")
+            {
+                io::io_stats full;
+                REQUIRE(io::load(fixture("a_cdf.cdf"), full, true, false));
+                REQUIRE(stats.values_records == full.values_records);
+                REQUIRE(stats.bytes_read == full.bytes_read);
+            }
+        }
+        WHEN("records are read without loading values")
+        {
+            const auto& var = (*cdf)["var"];
+            std::vector<char> records(var.record_bytes());
+            var.read_records(records.data(), 0, 1);
+            THEN("they are counted too")
+            {
+                REQUIRE(stats.values_records > 0);
+                REQUIRE(stats.bytes_read > 0);
+            }
+        }
+    }
+    GIVEN("an in memory file and stats accumulated over two loads")
+    {
+        const auto bytes = io::save(*io::load(fixture("a_cdf.cdf"), true, false));
+        io::io_stats stats;
+        REQUIRE(io::load(bytes.data(), std::size(bytes), stats));
+        const uint64_t records = stats.records_parsed;
+        REQUIRE(io::load(bytes.data(), std::size(bytes), stats));
+        THEN("counters add up until reset")
+        {
+            REQUIRE(stats.records_parsed == 2 * records);
+            REQUIRE(stats.bytes_mapped == 2 * std::size(bytes));
+            stats.reset();
+            REQUIRE(stats.records_parsed == 0);
+            REQUIRE(stats.bytes_mapped == 0);
+            REQUIRE(stats.time(io::io_phase::load).count() == 0);
+        }
+    }
+}
+
+SCENARIO("Saving with stats", "[CDF]")
+{
+    GIVEN("a CDF with compressed variables")
+    {
+        auto cdf = io::load(fixture("a_cdf_with_compressed_vars.cdf"), true, false);
+        REQUIRE(cdf != std::nullopt);
+        io::io_stats stats;
+        const auto bytes = io::save(*cdf, stats);
+        THEN("the file is the one saved without stats")
+        {
+            REQUIRE(bytes == io::save(*cdf));
+        }
+        THEN("written bytes and deflated CVVRs are counted")
+        {
+            REQUIRE(stats.bytes_written == std::size(bytes));
+            REQUIRE(compressed_blocks(stats) > 0);
+            REQUIRE(stats.time(io::io_phase::save).count() > 0);
+            REQUIRE(stats.time(io::io_phase::write) <= stats.time(io::io_phase::save));
+        }
+    }
+    GIVEN("a compressed CDF")
+    {
+        auto cdf = io::load(fixture("a_compressed_cdf.cdf"), true, false);
+        REQUIRE(cdf != std::nullopt);
+        io::io_stats stats;
+        const auto bytes = io::save(*cdf, stats);
+        THEN("the whole file goes through its codec once")
+        {
+            const auto& codec = stats.codec(cdf->compression);
+            REQUIRE(codec.blocks >= 1);
+            REQUIRE(codec.compressed_bytes < std::size(bytes));
+            REQUIRE(codec.uncompressed_bytes > codec.compressed_bytes);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-io/cdf-io.hpp"
+
+#include "../sparse_file.hpp"
+#include "../test_fixtures.hpp"
+
+using namespace cdf;
+
+namespace
+{
+// every variable of `many` must be `copies` times the same variable loaded from `path`
+bool is_concatenation_of(const CDF& many, const std::string& path, std::size_t copies)
+{
+    auto ref = io::load(path, true, false);
+    REQUIRE(ref != std::nullopt);
+    for (const auto& [name, ref_var] : ref->variables)
+    {
+        const auto& var = many[name];
+        if (var.type() != ref_var.type())
+            return false;
+        const std::size_t expected_copies = ref_var.is_nrv() ? 1 : copies;
+        if (var.len() != ref_var.len() * expected_copies
+            or var.bytes() != ref_var.bytes() * expected_copies)
+            return false;
+        for (std::size_t i = 0; i < expected_copies; i++)
+        {
+            if (std::memcmp(var.bytes_ptr() + i * ref_var.bytes(), ref_var.bytes_ptr(),
+                    ref_var.bytes())
+                != 0)
+                return false;
+        }
+    }
+    return true;
+}
+
+std::string write_sparse_file(const std::string& name, cdf_sparse_records mode)
+{
+    const auto path = (std::filesystem::temp_directory_path() / name).string();
+    const auto bytes = tests::make_sparse_file(mode);
+    std::ofstream { path, std::ios::binary }.write(bytes.data(), std::size(bytes));
+    return path;
+}
+}
+
+SCENARIO("Loading many files concatenates their variables along records", "[CDF]")
+{
+    for (const auto& name : layout_fixtures)
+    {
+        GIVEN(std::string { "three copies of " } + name)
+        {
+            const auto path = fixture(name);
+            auto many = io::load_many({ path, path, path }, {}, 2);
+            REQUIRE(many != std::nullopt);
+            THEN("each variable holds the records of every file in order")
+            {
+                REQUIRE(is_concatenation_of(*many, path, 3));
+            }
+        }
+    }
+    GIVEN("a subset of variables")
+    {
+        const auto path = fixture("fragmented.cdf");
+        auto many = io::load_many({ path, path }, { "split_zvar" });
+        REQUIRE(many != std::nullopt);
+        THEN("only those variables are loaded")
+        {
+            REQUIRE(std::size(many->variables) == 1);
+            const auto values = (*many)["split_zvar"].get<int32_t>();
+            REQUIRE(std::size(values) == 20);
+            for (int32_t i = 0; i < 20; i++)
+                REQUIRE(values[i] == i % 10);
+        }
+    }
+    GIVEN("a missing file")
+    {
+        THEN("nothing is returned")
+        {
+            REQUIRE(io::load_many({ fixture("a_cdf.cdf"), fixture("not_here.cdf") })
+                == std::nullopt);
+        }
+    }
+    GIVEN("a variable missing from one of the files")
+    {
+        THEN("load_many throws")
+        {
+            REQUIRE_THROWS_AS(io::load_many({ fixture("contiguous.cdf"), fixture("a_cdf.cdf") },
+                                  { "whole_zvar" }),
+                std::out_of_range);
+        }
+    }
+}
+
+SCENARIO("Loading many files keeps sparse records", "[CDF]")
+{
+    GIVEN("two files with the same sparse records variable")
+    {
+        const auto path = write_sparse_file("cdfpp_load_many_sparse.cdf", cdf_sparse_records::pad);
+        auto many = io::load_many({ path, path });
+        REQUIRE(many != std::nullopt);
+        const auto& var = (*many)["sparse"];
+        THEN("present records of both files are merged and shifted")
+        {
+            REQUIRE(var.len() == 2 * tests::records_count);
+            REQUIRE(var.sparse_records() == cdf_sparse_records::pad);
+            const std::vector<record_range> expected {
+                { 0, 3 }, { 5, 7 }, { 9, 13 }, { 15, 17 }, { 19, 20 } };
+            const auto present = var.present_records();
+            REQUIRE(std::size(present) == std::size(expected));
+            for (std::size_t i = 0; i < std::size(expected); i++)
+            {
+                REQUIRE(present[i].start == expected[i].start);
+                REQUIRE(present[i].stop == expected[i].stop);
+            }
+        }
+        THEN("each file slice holds that file values")
+        {
+            REQUIRE(is_concatenation_of(*many, path, 2));
+        }
+    }
+    GIVEN("files with different sparse records modes")
+    {
+        const auto pad = write_sparse_file("cdfpp_load_many_pad.cdf", cdf_sparse_records::pad);
+        const auto previous
+            = write_sparse_file("cdfpp_load_many_previous.cdf", cdf_sparse_records::previous);
+        THEN("load_many throws")
+        {
+            REQUIRE_THROWS_AS(io::load_many({ pad, previous }, { "sparse" }),
+                std::invalid_argument);
+        }
+    }
+}
@@ -91,6 +91,17 @@ class PycdfChrono(unittest.TestCase):
             np.random.shuffle(ref)
             self.assertTrue(np.all(ref == pycdfpp.to_datetime64(pycdfpp.to_tt2000(ref))))
 
+    def test_dt64_tt2000_sorted_across_leap_seconds(self):
+        # sorted inputs are converted one leap second segment at a time
+        leaps = np.array(['1972-07-01', '1981-07-01', '1999-01-01', '2017-01-01'], dtype='datetime64[ns]')
+        around = (leaps[:, None] + np.arange(-1000, 1000).astype('timedelta64[ms]')).ravel()
+        ref = np.sort(np.concatenate((make_datetime64_n_values(100000, start=0.5e17), around)))
+        self.assertTrue(np.all(ref == pycdfpp.to_datetime64(pycdfpp.to_tt2000(ref))))
+        # almost sorted, a few misplaced values must still get their own leap seconds
+        ref[[10, -10]] = ref[[-10, 10]]
+        ref[[5000, 5001]] = ref[[5001, 5000]]
+        self.assertTrue(np.all(ref == pycdfpp.to_datetime64(pycdfpp.to_tt2000(ref))))
+
     def test_todt64_empty_list(self):
         result = pycdfpp.to_datetime64([])
         self.assertEqual(len(result), 0)
@@ -230,11 +241,103 @@ class PycdfToTimeString(unittest.TestCase):
         self.assertIn(b'123456789', result[0])
 
 
+class PycdfParseIso8601(unittest.TestCase):
+    def test_round_trip_through_time_string(self):
+        times = make_datetime64_n_values(10007, start=-1e18, stop=2e18)
+        tt = pycdfpp.to_tt2000(times)
+        strings = pycdfpp.to_time_string(tt, '%Y-%m-%dT%H:%M:%S')
+        self.assertTrue(np.all(pycdfpp.parse_iso8601(strings) == tt))
+        self.assertTrue(np.all(pycdfpp.parse_iso8601(strings.astype('U')) == tt))
+        self.assertTrue(np.all(pycdfpp.parse_iso8601([s.decode() for s in strings]) == tt))
+
+    def test_data_types(self):
+        strings = np.array(['2020-01-01T00:00:00.001', '2020-06-15 12:30:45Z'])
+        times = np.array(['2020-01-01T00:00:00.001', '2020-06-15T12:30:45'], dtype='datetime64[ns]')
+        for data_type, converter in ((pycdfpp.DataType.CDF_TIME_TT2000, pycdfpp.to_tt2000),
+                                     (pycdfpp.DataType.CDF_EPOCH, pycdfpp.to_epoch),
+                                     (pycdfpp.DataType.CDF_EPOCH16, pycdfpp.to_epoch16)):
+            self.assertTrue(np.all(pycdfpp.parse_iso8601(strings, data_type) == converter(times)))
+        with self.assertRaises(ValueError):
+            pycdfpp.parse_iso8601(strings, pycdfpp.DataType.CDF_DOUBLE)
+
+    def test_scalar_and_leap_second(self):
+        before = pycdfpp.parse_iso8601('2016-12-31T23:59:59')
+        leap = pycdfpp.parse_iso8601('2016-12-31T23:59:60')
+        self.assertEqual(leap.nseconds - before.nseconds, 1000000000)
+
+    def test_preserves_shape(self):
+        strings = np.full((3, 4), b'2020-01-01T00:00:00')
+        self.assertEqual(pycdfpp.parse_iso8601(strings).shape, (3, 4))
+
+    def test_invalid_strings(self):
+        with self.assertRaises(ValueError):
+            pycdfpp.parse_iso8601(['2020-01-01', '2020-02-30'])
+        with self.assertRaises(ValueError):
+            pycdfpp.parse_iso8601(np.array([1, 2]))
+
+
 class PycdfChronoErrors(unittest.TestCase):
     def test_invalid_input(self):
         with self.assertRaises(ValueError):
             pycdfpp.to_datetime64(["not a datetime"])
 
 
+class PycdfTimeTypesConversions(unittest.TestCase):
+    def setUp(self):
+        # millisecond resolution so that every CDF time type holds these values exactly
+        self.ref = make_datetime64_n_values(10007, start=-1e18, stop=2e18).astype("datetime64[ms]").astype(
+            "datetime64[ns]")
+        self.converters = (pycdfpp.to_tt2000, pycdfpp.to_epoch, pycdfpp.to_epoch16)
+
+    def test_arrays(self):
+        for source in self.converters:
+            values = source(self.ref)
+            for destination in self.converters:
+                self.assertTrue(np.all(destination(values) == destination(self.ref)))
+
+    def test_variables(self):
+        cdf = pycdfpp.CDF()
+        for name, data_type in (("tt2000", pycdfpp.DataType.CDF_TIME_TT2000),
+                                ("epoch", pycdfpp.DataType.CDF_EPOCH),
+                                ("epoch16", pycdfpp.DataType.CDF_EPOCH16)):
+            cdf.add_variable(name).set_values(self.ref, data_type)
+            for destination in self.converters:
+                result = destination(cdf[name])
+                self.assertEqual(result.shape, self.ref.shape)
+                self.assertTrue(np.all(result == destination(self.ref)))
+
+    def test_non_time_variable(self):
+        cdf = pycdfpp.CDF()
+        cdf.add_variable("data", values=np.arange(10, dtype=np.float64))
+        for destination in self.converters:
+            with self.assertRaises(ValueError):
+                destination(cdf["data"])
+
+
+class PycdfThreading(unittest.TestCase):
+    def tearDown(self):
+        pycdfpp.set_num_threads(0)
+        pycdfpp.set_min_chunk_size(1024 * 1024)
+
+    def test_num_threads_can_be_changed(self):
+        pycdfpp.set_num_threads(3)
+        self.assertEqual(pycdfpp.get_num_threads(), 3)
+        pycdfpp.set_num_threads(1)
+        self.assertEqual(pycdfpp.get_num_threads(), 1)
+
+    def test_conversions_dont_depend_on_thread_count(self):
+        values = np.arange(np.datetime64('1990-01-01'), np.datetime64('2030-01-01'),
+                           np.timedelta64(7919, 's')).astype('datetime64[ns]')
+        pycdfpp.set_min_chunk_size(1000)
+        results = []
+        for threads in (1, 4):
+            pycdfpp.set_num_threads(threads)
+            tt = pycdfpp.to_tt2000(values)
+            results.append((tt, pycdfpp.to_datetime64(tt)))
+        self.assertTrue(np.array_equal(results[0][0], results[1][0]))
+        self.assertTrue(np.array_equal(results[0][1], values))
+        self.assertTrue(np.array_equal(results[1][1], values))
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import os
+import numpy as np
+import unittest
+import pycdfpp
+
+os.environ['TZ'] = 'UTC'
+
+
+def make_cdf(records: int = 100_000):
+    time = np.datetime64('2020-01-01', 'ns') + np.arange(records) * np.timedelta64(10, 'ms')
+    values = np.sin(np.arange(records * 3, dtype=np.float32).reshape(records, 3) * 0.001)
+    values[::97] = -1e31
+    values[1::101] = np.nan
+    cdf = pycdfpp.CDF()
+    cdf.add_variable('Epoch', values=time, data_type=pycdfpp.DataType.CDF_TIME_TT2000)
+    cdf.add_variable('B', values=values, attributes={'FILLVAL': [np.float32(-1e31)], 'DEPEND_0': 'Epoch'})
+    return cdf, time, values
+
+
+class PycdfMinMax(unittest.TestCase):
+    def test_matches_numpy(self):
+        cdf, time, values = make_cdf()
+        result = pycdfpp.minmax(cdf['B'], cdf['Epoch'], 100)
+        self.assertEqual(result['min'].shape, (100, 3))
+        self.assertEqual(result['edges'].dtype, np.dtype('datetime64[ns]'))
+        self.assertEqual(result['edges'][0], time[0])
+        masked = np.where(values == np.float32(-1e31), np.nan, values).astype(np.float64)
+        for bucket in range(100):
+            selected = (time >= result['edges'][bucket]) & (time < result['edges'][bucket + 1])
+            chunk = masked[selected]
+            self.assertTrue(np.array_equal(result['min'][bucket], np.nanmin(chunk, axis=0)))
+            self.assertTrue(np.array_equal(result['max'][bucket], np.nanmax(chunk, axis=0)))
+            for component in range(3):
+                valid = chunk[:, component][~np.isnan(chunk[:, component])]
+                self.assertEqual(result['first'][bucket, component], valid[0])
+                self.assertEqual(result['last'][bucket, component], valid[-1])
+
+    def test_time_range(self):
+        cdf, time, _ = make_cdf()
+        start, stop = np.datetime64('2019-12-31T23:59:00'), np.datetime64('2020-01-01T00:00:10')
+        result = pycdfpp.minmax(cdf['B'], cdf['Epoch'], 70, start=start, stop=stop)
+        self.assertEqual(result['edges'][0], start)
+        self.assertEqual(result['edges'][-1], stop)
+        # nothing before 2020
+        self.assertTrue(np.all(np.isnan(result['min'][:60])))
+        self.assertFalse(np.any(np.isnan(result['min'][60:])))
+
+    def test_invalid_inputs(self):
+        cdf, _, _ = make_cdf()
+        with self.assertRaises(ValueError):
+            pycdfpp.minmax(cdf['B'], cdf['B'], 10)
+        with self.assertRaises(ValueError):
+            pycdfpp.minmax(cdf['Epoch'], cdf['Epoch'], 10)
+
+
+if __name__ == '__main__':
+    unittest.main()
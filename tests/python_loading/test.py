@@ -215,6 +215,66 @@ class PycdfLazyLoadingTest(unittest.TestCase):
             self.assertTrue(all([d is not None for d in data]))
 
 
+class PycdfLoadManyTest(unittest.TestCase):
+    def test_concatenates_variables_along_records(self):
+        fname = f'{os.path.dirname(os.path.abspath(__file__))}/../resources/a_cdf.cdf'
+        ref = pycdfpp.load(fname, lazy_load=False)
+        many = pycdfpp.load_many([fname, fname], threads=2)
+        self.assertIsNotNone(many)
+        for name, var in ref.items():
+            if var.is_nrv:
+                self.assertTrue(np.array_equal(many[name].values, var.values))
+            else:
+                self.assertTrue(np.array_equal(many[name].values,
+                                               np.concatenate([var.values, var.values])))
+
+    def test_only_loads_requested_variables(self):
+        fname = f'{os.path.dirname(os.path.abspath(__file__))}/../resources/a_cdf.cdf'
+        many = pycdfpp.load_many([fname, fname], ['var'])
+        self.assertEqual(list(many.keys()), ['var'])
+
+class PycdfLoadStatsTest(unittest.TestCase):
+    def test_returns_the_cdf_and_its_stats(self):
+        fname = f'{os.path.dirname(os.path.abspath(__file__))}/../resources/a_cdf_with_compressed_vars.cdf'
+        ref = pycdfpp.load(fname, lazy_load=False)
+        cdf, stats = pycdfpp.load(fname, lazy_load=False, stats=True)
+        self.assertEqual(cdf, ref)
+        self.assertGreater(stats['records_parsed'], 0)
+        self.assertEqual(stats['bytes_mapped'], os.path.getsize(fname))
+        self.assertGreater(stats['bytes_read'], 0)
+        self.assertGreater(stats['phases']['load'], 0.)
+        self.assertTrue(all(codec['uncompressed_bytes'] > codec['compressed_bytes']
+                            for codec in stats['codecs'].values()))
+
+    def test_in_memory_load_with_stats_counts_values(self):
+        fname = f'{os.path.dirname(os.path.abspath(__file__))}/../resources/a_cdf.cdf'
+        cdf, stats = pycdfpp.load(load_bytes(fname), stats=True)
+        self.assertIsNotNone(cdf)
+        self.assertGreater(stats['values_records'], 0)
+        self.assertIsNotNone(cdf['var'].values)
+
+
+class PycdfConcurrentLazyLoadingTest(unittest.TestCase):
+    def test_threads_share_a_single_lazy_load(self):
+        from concurrent.futures import ThreadPoolExecutor
+        fname = f'{os.path.dirname(os.path.abspath(__file__))}/../resources/a_compressed_cdf.cdf'
+        ref = pycdfpp.load(fname, lazy_load=False)
+        cdf = pycdfpp.load(fname, lazy_load=True)
+        names = [name for name, var in ref.items() if var.type not in (
+            pycdfpp.DataType.CDF_CHAR, pycdfpp.DataType.CDF_UCHAR)]
+        with ThreadPoolExecutor(max_workers=8) as pool:
+            results = list(pool.map(lambda name: cdf[name].values, names * 8))
+        for name, values in zip(names * 8, results):
+            self.assertTrue(cdf[name].values_loaded)
+            self.assertTrue(np.array_equal(values, ref[name].values, equal_nan=True))
+
+    def test_explicit_load_values(self):
+        fname = f'{os.path.dirname(os.path.abspath(__file__))}/../resources/a_cdf.cdf'
+        cdf = pycdfpp.load(fname, lazy_load=True)
+        self.assertFalse(cdf['var'].values_loaded)
+        cdf['var'].load_values()
+        self.assertTrue(cdf['var'].values_loaded)
+
 class PycdfDatetimeReprTest(unittest.TestCase):
     def test_can_repr_the_exact_expected_value_no_matter_what_TZ(self):
         backup_TZ = os.environ.get("TZ", None)
@@ -0,0 +1,87 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+import os
+import numpy as np
+import unittest
+import pycdfpp
+
+os.environ['TZ'] = 'UTC'
+
+
+def make_cdf(records: int = 10_000, bins: int = 32):
+    time = np.datetime64('2020-01-01', 'ns') + np.arange(records) * np.timedelta64(1, 's')
+    values = np.exp(np.sin(np.arange(records * bins, dtype=np.float32).reshape(records, bins) * 0.01) * 5)
+    values[::7, 0] = -1e31
+    values[1::11, 1] = np.nan
+    energies = (10. * 1.3 ** np.arange(bins)).astype(np.float32)
+    cdf = pycdfpp.CDF()
+    cdf.add_variable('Epoch', values=time, data_type=pycdfpp.DataType.CDF_TIME_TT2000)
+    cdf.add_variable('Energy', values=energies, attributes={'SCALETYP': 'log'})
+    cdf.add_variable('flux', values=values,
+                     attributes={'FILLVAL': [np.float32(-1e31)], 'DEPEND_0': 'Epoch',
+                                 'DEPEND_1': 'Energy', 'SCALETYP': 'log'})
+    return cdf, time, values
+
+
+class PycdfSpectrogram(unittest.TestCase):
+    def tearDown(self):
+        pycdfpp.set_num_threads(0)
+        pycdfpp.set_min_chunk_size(1024 * 1024)
+
+    def test_one_pixel_per_cell(self):
+        cdf, time, values = make_cdf()
+        result = pycdfpp.spectrogram(cdf['flux'], cdf['Epoch'], 10_000, 32, bins=cdf['Energy'])
+        image = result['image']
+        self.assertEqual(image.shape, (32, 10_000, 4))
+        self.assertEqual(image.dtype, np.uint8)
+        self.assertEqual(result['y_scale'], 'log')
+        self.assertEqual(result['z_scale'], 'log')
+        self.assertEqual(result['start'], time[0] - np.timedelta64(500, 'ms'))
+        self.assertEqual(result['stop'], time[-1] + np.timedelta64(500, 'ms'))
+        valid = values[(values != np.float32(-1e31)) & ~np.isnan(values)]
+        self.assertEqual(result['z_min'], valid.min())
+        self.assertEqual(result['z_max'], valid.max())
+        # bottom row is the first bin, every 7th record a fill value
+        alpha = image[::-1, :, 3]
+        self.assertTrue(np.all(alpha[0, ::7] == 0))
+        self.assertTrue(np.all(alpha[1, 1::11] == 0))
+        self.assertEqual(np.count_nonzero(alpha == 0), len(range(0, 10_000, 7)) + len(range(1, 10_000, 11)))
+
+    def test_ranges_and_scales(self):
+        cdf, time, _ = make_cdf()
+        result = pycdfpp.spectrogram(cdf['flux'], cdf['Epoch'], 200, 100, bins=cdf['Energy'],
+                                     start=time[100], stop=time[200], y_range=(20., 200.),
+                                     y_scale='linear', z_range=(1., 100.), z_scale='linear')
+        self.assertEqual(result['start'], time[100])
+        self.assertEqual(result['stop'], time[200])
+        self.assertEqual((result['y_min'], result['y_max']), (20., 200.))
+        self.assertEqual((result['y_scale'], result['z_scale']), ('linear', 'linear'))
+        self.assertEqual((result['z_min'], result['z_max']), (1., 100.))
+        # without bins rows are the bin indices
+        by_index = pycdfpp.spectrogram(cdf['flux'], cdf['Epoch'], 50, 32)
+        self.assertEqual((by_index['y_min'], by_index['y_max']), (-0.5, 31.5))
+        self.assertEqual(by_index['y_scale'], 'linear')
+
+    def test_doesnt_depend_on_threading(self):
+        cdf, _, _ = make_cdf(100_000)
+        pycdfpp.set_num_threads(1)
+        single = pycdfpp.spectrogram(cdf['flux'], cdf['Epoch'], 777, 123, bins=cdf['Energy'])
+        pycdfpp.set_num_threads(4)
+        pycdfpp.set_min_chunk_size(1000)
+        threaded = pycdfpp.spectrogram(cdf['flux'], cdf['Epoch'], 777, 123, bins=cdf['Energy'])
+        self.assertTrue(np.array_equal(single['image'], threaded['image']))
+
+    def test_invalid_inputs(self):
+        cdf, _, _ = make_cdf()
+        with self.assertRaises(ValueError):
+            pycdfpp.spectrogram(cdf['flux'], cdf['flux'], 10, 10)
+        with self.assertRaises(ValueError):
+            pycdfpp.spectrogram(cdf['Epoch'], cdf['Epoch'], 10, 10)
+        with self.assertRaises(ValueError):
+            pycdfpp.spectrogram(cdf['flux'], cdf['Epoch'], 0, 10)
+        with self.assertRaises(ValueError):
+            pycdfpp.spectrogram(cdf['flux'], cdf['Epoch'], 10, 10, z_scale='cubic')
+
+
+if __name__ == '__main__':
+    unittest.main()
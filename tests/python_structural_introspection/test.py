@@ -2,6 +2,7 @@
 # -*- coding: utf-8 -*-
 import os
 import unittest
+import numpy as np
 import pycdfpp
 
 RESOURCES = f'{os.path.dirname(os.path.abspath(__file__))}/../resources'
@@ -35,5 +36,24 @@ class StructuralIntrospection(unittest.TestCase):
             self.assertFalse(cdf['split_zvar'].is_contiguous())
 
 
+    def test_read_into_decodes_records_across_blocks(self):
+        cdf = load('fragmented.cdf')
+        out = np.zeros(6, dtype=np.int32)
+        self.assertEqual(cdf['split_zvar'].read_into(out, 2, 8), 6)
+        self.assertTrue(np.array_equal(out, np.arange(2, 8, dtype=np.int32)))
+        self.assertFalse(cdf['split_zvar'].values_loaded)
+
+    def test_read_into_rejects_a_too_small_buffer(self):
+        cdf = load('fragmented.cdf')
+        with self.assertRaises(ValueError):
+            cdf['split_zvar'].read_into(np.zeros(2, dtype=np.int32))
+
+    def test_chunks_stream_every_record_in_order(self):
+        cdf = load('fragmented.cdf')
+        chunks = list(cdf['split_zvar'].chunks(3))
+        self.assertEqual([len(c) for c in chunks], [3, 3, 3, 1])
+        self.assertTrue(np.array_equal(np.concatenate(chunks), np.arange(10, dtype=np.int32)))
+        self.assertFalse(cdf['split_zvar'].values_loaded)
+
 if __name__ == '__main__':
     unittest.main()
@@ -1,5 +1,8 @@
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -343,6 +346,67 @@ SCENARIO("Loading cdf files", "[CDF]")
                 CHECK_VARIABLES(cd);
             }
         }
+        WHEN("file is read with asynchronous reads instead of being mapped")
+        {
+            for (const auto& name : { "a_cdf.cdf", "a_compressed_cdf.cdf",
+                     "a_cdf_with_compressed_vars.cdf", "a_col_major_cdf.cdf" })
+            {
+                auto path = std::string(DATA_PATH) + "/" + name;
+                REQUIRE(file_exists(path));
+                auto cd_opt = cdf::io::load(path, cdf::io::file_access::async_reads);
+                REQUIRE(cd_opt != std::nullopt);
+                auto cd = *cd_opt;
+                THEN("It gives the same result as a memory mapped load")
+                {
+                    REQUIRE(cd == *cdf::io::load(path));
+                    CHECK_VARIABLES(cd);
+                }
+            }
+            for (const auto lazy : { false, true })
+            {
+                auto path = std::string(DATA_PATH) + "/ia_k0_epi_19970102_v01.cdf";
+                auto cd_opt = cdf::io::load(path, cdf::io::file_access::async_reads, true, lazy);
+                REQUIRE(cd_opt != std::nullopt);
+                REQUIRE(*cd_opt == *cdf::io::load(path, true, false));
+            }
+            REQUIRE(cdf::io::load(std::string(DATA_PATH) + "/not_here.cdf",
+                        cdf::io::file_access::async_reads)
+                == std::nullopt);
+        }
+        WHEN("file is read piecewise through a read function")
+        {
+            for (const auto& name : { "a_cdf.cdf", "a_compressed_cdf.cdf",
+                     "a_cdf_with_compressed_vars.cdf", "a_col_major_cdf.cdf",
+                     "ia_k0_epi_19970102_v01.cdf" })
+            {
+                auto path = std::string(DATA_PATH) + "/" + name;
+                REQUIRE(file_exists(path));
+                std::ifstream file { path, std::ios::binary };
+                std::vector<char> content { std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>() };
+                std::size_t calls = 0;
+                auto cd_opt = cdf::io::load(
+                    [&](char* dest, std::size_t offset, std::size_t size)
+                    {
+                        calls++;
+                        std::memcpy(dest, content.data() + offset, size);
+                        return true;
+                    },
+                    std::size(content));
+                REQUIRE(cd_opt != std::nullopt);
+                auto cd = *cd_opt;
+                THEN("It gives the same result as a memory mapped load")
+                {
+                    REQUIRE(calls != 0);
+                    REQUIRE(cd == *cdf::io::load(path));
+                }
+            }
+            THEN("Read failures are reported")
+            {
+                REQUIRE_THROWS(cdf::io::load(
+                    [](char*, std::size_t, std::size_t) { return false; }, 1024));
+            }
+        }
         WHEN("In memory data as std::vector is a cdf file")
         {
             auto path = std::string(DATA_PATH) + "/a_cdf.cdf";
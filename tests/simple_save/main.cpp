@@ -90,3 +90,61 @@ SCENARIO("Saving a cdf file", "[CDF]")
         REQUIRE(cdf_obj->variables.count("var1"));
     }
 }
+
+// writes into a buffer sized once, like the WASM build does with a JS Uint8Array
+struct fixed_size_writer
+{
+    std::vector<char>& data;
+    std::size_t global_offset = 0;
+
+    std::size_t write(const char* const data_ptr, std::size_t count)
+    {
+        REQUIRE(global_offset + count <= std::size(data));
+        std::copy(data_ptr, data_ptr + count, std::begin(data) + global_offset);
+        return global_offset += count;
+    }
+
+    std::size_t fill(const char v, std::size_t count)
+    {
+        REQUIRE(global_offset + count <= std::size(data));
+        std::fill_n(std::begin(data) + global_offset, count, v);
+        return global_offset += count;
+    }
+
+    [[nodiscard]] std::size_t offset() const noexcept { return global_offset; }
+};
+
+SCENARIO("Saving a cdf file into a buffer allocated up front", "[CDF]")
+{
+    auto compression = GENERATE(
+        cdf_compression_type::no_compression, cdf_compression_type::gzip_compression);
+    CDF cdf_obj;
+    cdf_obj.compression = compression;
+    cdf_obj.attributes.emplace("some global attr",
+        cdf::Attribute { "some global attr",
+            { data_t { no_init_vector<double> { 1., 2., 3. }, CDF_Types::CDF_DOUBLE } } });
+    cdf_obj.variables.emplace("var1",
+        Variable { "var1", 0, data_t { cos_gen<double> { 0.1 }(1000), CDF_Types::CDF_DOUBLE },
+            { 1000 } });
+    cdf_obj.variables.emplace("var2",
+        Variable { "var2", 1, data_t { ones<float> {}(300), CDF_Types::CDF_FLOAT }, { 100, 3 } });
+    cdf_obj.variables["var2"].set_compression_type(cdf_compression_type::gzip_compression);
+
+    const auto reference = cdf::io::save(cdf_obj);
+    std::vector<char> data;
+    const bool saved = cdf::io::save(cdf_obj,
+        [&data](std::size_t size)
+        {
+            data.resize(size);
+            return fixed_size_writer { data };
+        });
+    THEN("it is exactly the file saved into a growing vector")
+    {
+        REQUIRE(saved);
+        REQUIRE(std::size(data) == std::size(reference));
+        REQUIRE(std::equal(std::cbegin(data), std::cend(data), std::cbegin(reference)));
+        auto reloaded = cdf::io::load(data);
+        REQUIRE(reloaded.has_value());
+        REQUIRE(*reloaded == cdf_obj);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+// Builds in memory a file with a sparse records variable, the kind the saver doesn't write
+// by itself.
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-io/endianness.hpp"
+#include "cdfpp/cdf-io/saving/saving.hpp"
+
+namespace cdf::tests
+{
+// records stored in the file, 3-4 and 7-8 are missing
+inline const std::vector<record_range> present_blocks { { 0, 3 }, { 5, 7 }, { 9, 10 } };
+inline constexpr std::size_t records_count = 10;
+
+inline double value(std::size_t record, std::size_t component)
+{
+    return static_cast<double>(record) + 0.5 * static_cast<double>(component);
+}
+
+/*
+ * A "sparse" variable of records_count records of 2 doubles where only present_blocks
+ * made it to the file, as if written by the CDF library with sparse records enabled.
+ * When pad_value is given it is stored in the VDR. The saver writes the values of a
+ * variable one block after the other, so the variable it is given only holds the present
+ * records, they are stored as one VVR per block and MaxRec is patched afterward.
+ */
+inline no_init_vector<char> make_sparse_file(cdf_sparse_records mode,
+    cdf_compression_type compression = cdf_compression_type::no_compression,
+    cdf_encoding encoding = host_is_little_endian ? cdf_encoding::IBMPC : cdf_encoding::network,
+    std::optional<double> pad_value = std::nullopt)
+{
+    using namespace io;
+    using namespace io::saving;
+    no_init_vector<double> values;
+    for (const auto& [first, stop] : present_blocks)
+        for (std::size_t record = first; record < stop; record++)
+            values.insert(std::end(values), { value(record, 0), value(record, 1) });
+    const auto present_count = static_cast<uint32_t>(std::size(values) / 2);
+    // byte swapping is its own inverse
+    const auto to_file_encoding = [encoding](double* data, std::size_t count)
+    {
+        if (endianness::is_big_endian_encoding(encoding))
+            endianness::decode_v<endianness::big_endian_t>(data, count);
+        else
+            endianness::decode_v<endianness::little_endian_t>(data, count);
+    };
+    to_file_encoding(values.data(), std::size(values));
+    CDF cdf;
+    cdf.variables.emplace("sparse",
+        Variable { "sparse", 0, data_t { std::move(values), CDF_Types::CDF_DOUBLE },
+            { present_count, 2 }, cdf_majority::row, false,
+            compression });
+    cdf.variables.emplace("dense",
+        Variable { "dense", 1, data_t { no_init_vector<int32_t> { 1, 2, 3 }, CDF_Types::CDF_INT4 },
+            { 3 } });
+
+    auto svg_ctx = make_saving_context(cdf);
+    svg_ctx.body.cdr.record.Encoding = encoding;
+    create_file_attributes_records(cdf, svg_ctx);
+    create_variables_records(cdf, svg_ctx);
+    for (auto& var_ctx : svg_ctx.body.variables)
+    {
+        if (var_ctx.variable->name() != "sparse")
+            continue;
+        store_values_records(var_ctx, present_blocks);
+        auto& vdr = var_ctx.vdr.record;
+        vdr.MaxRec = static_cast<int32_t>(records_count - 1);
+        vdr.SRecords = static_cast<int32_t>(mode);
+        if (pad_value)
+        {
+            auto pad = *pad_value;
+            to_file_encoding(&pad, 1);
+            vdr.Flags |= 2;
+            vdr.NumElems = 1;
+            vdr.PadValues.values.resize(sizeof(pad));
+            std::memcpy(vdr.PadValues.values.data(), &pad, sizeof(pad));
+        }
+        update_size(var_ctx.vdr);
+    }
+    const auto eof = map_records(svg_ctx);
+    link_records(svg_ctx);
+    update_gdr(svg_ctx, eof);
+    apply_compression(svg_ctx);
+    no_init_vector<char> bytes;
+    io::buffers::vector_writer writer { bytes };
+    write_records(svg_ctx, writer);
+    return bytes;
+}
+
+} // namespace cdf::tests
@@ -0,0 +1,170 @@
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-io/cdf-io.hpp"
+
+#include "../sparse_file.hpp"
+
+using namespace cdf;
+using namespace cdf::tests;
+
+namespace
+{
+bool is_present(std::size_t record)
+{
+    for (const auto& [first, stop] : present_blocks)
+        if (record >= first and record < stop)
+            return true;
+    return false;
+}
+
+// what record should read back as, -1 stands for the pad value
+std::size_t expected_source(std::size_t record, cdf_sparse_records mode)
+{
+    if (is_present(record))
+        return record;
+    if (mode == cdf_sparse_records::previous)
+    {
+        while (record > 0 and not is_present(record - 1))
+            record--;
+        if (record > 0)
+            return record - 1;
+    }
+    return static_cast<std::size_t>(-1);
+}
+
+bool records_match(const double* values, std::size_t first_record, std::size_t count,
+    cdf_sparse_records mode, double pad)
+{
+    for (std::size_t record = first_record; record < first_record + count; record++)
+    {
+        const auto source = expected_source(record, mode);
+        for (std::size_t component = 0; component < 2; component++)
+        {
+            const auto expected
+                = source == static_cast<std::size_t>(-1) ? pad : value(source, component);
+            if (values[(record - first_record) * 2 + component] != expected)
+                return false;
+        }
+    }
+    return true;
+}
+}
+
+SCENARIO("Sparse records read back as pad values or previous records", "[CDF]")
+{
+    constexpr auto default_pad = default_pad_value<CDF_Types::CDF_DOUBLE>();
+    for (const auto mode : { cdf_sparse_records::no_sparse, cdf_sparse_records::pad,
+             cdf_sparse_records::previous })
+    {
+        for (const auto compression :
+            { cdf_compression_type::no_compression, cdf_compression_type::gzip_compression })
+        {
+            for (const auto lazy : { false, true })
+            {
+                GIVEN(fmt::format("a {} sparse variable, compression: {}, lazy: {}",
+                    cdf_sparse_records_str(mode), cdf_compression_type_str(compression), lazy))
+                {
+                    const auto bytes = make_sparse_file(mode, compression);
+                    auto cdf = io::load(bytes.data(), std::size(bytes), true, lazy);
+                    REQUIRE(cdf != std::nullopt);
+                    const auto& var = (*cdf)["sparse"];
+                    THEN("the sparse records mode and present records come from the file")
+                    {
+                        REQUIRE(var.sparse_records() == mode);
+                        REQUIRE(var.len() == records_count);
+                        const auto present = var.present_records();
+                        REQUIRE(std::size(present) == std::size(present_blocks));
+                        for (std::size_t i = 0; i < std::size(present); i++)
+                        {
+                            REQUIRE(present[i].start == present_blocks[i].start);
+                            REQUIRE(present[i].stop == present_blocks[i].stop);
+                        }
+                    }
+                    THEN("missing records of partial reads are filled too")
+                    {
+                        for (const auto& [first, count] : std::vector<std::pair<std::size_t,
+                                 std::size_t>> { { 3, 2 }, { 4, 3 }, { 7, 1 }, { 8, 2 } })
+                        {
+                            no_init_vector<double> out(count * 2);
+                            var.read_records(reinterpret_cast<char*>(out.data()), first, count);
+                            REQUIRE(records_match(out.data(), first, count, mode, default_pad));
+                        }
+                    }
+                    THEN("the dense values hold pad values or previous records in the gaps")
+                    {
+                        REQUIRE(records_match(var.get<double>().data(), 0, records_count, mode,
+                            default_pad));
+                    }
+                    THEN("the compact form only holds present records")
+                    {
+                        const auto compact = var.compact();
+                        REQUIRE(compact.record_numbers
+                            == no_init_vector<uint32_t> { 0, 1, 2, 5, 6, 9 });
+                        REQUIRE(compact.shape == Variable::shape_t { 6, 2 });
+                        const auto& values = compact.values.get<double>();
+                        REQUIRE(std::size(values) == 12);
+                        for (std::size_t i = 0; i < std::size(compact.record_numbers); i++)
+                        {
+                            REQUIRE(values[i * 2] == value(compact.record_numbers[i], 0));
+                            REQUIRE(values[i * 2 + 1] == value(compact.record_numbers[i], 1));
+                        }
+                        if (lazy)
+                            REQUIRE_FALSE(var.values_loaded());
+                    }
+                    THEN("variables without missing records are unaffected")
+                    {
+                        const auto& dense = (*cdf)["dense"];
+                        REQUIRE(dense.sparse_records() == cdf_sparse_records::no_sparse);
+                        REQUIRE(std::size(dense.present_records()) == 1);
+                        REQUIRE(dense.present_records().front().stop == 3);
+                        REQUIRE(dense.compact().record_numbers == no_init_vector<uint32_t> { 0, 1,
+                            2 });
+                        REQUIRE(dense.get<int32_t>() == no_init_vector<int32_t> { 1, 2, 3 });
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Sparse records use the variable pad value when it has one", "[CDF]")
+{
+    for (const auto encoding : { cdf_encoding::IBMPC, cdf_encoding::network })
+    {
+        GIVEN(fmt::format("a pad sparse variable encoded as {}", static_cast<int>(encoding)))
+        {
+            WHEN("the VDR has no pad value")
+            {
+                const auto bytes = make_sparse_file(
+                    cdf_sparse_records::pad, cdf_compression_type::no_compression, encoding);
+                auto cdf = io::load(bytes.data(), std::size(bytes), true, false);
+                REQUIRE(cdf != std::nullopt);
+                THEN("missing records hold the CDF default pad value")
+                {
+                    REQUIRE(records_match((*cdf)["sparse"].get<double>().data(), 0,
+                        records_count, cdf_sparse_records::pad, -1e30));
+                }
+            }
+            WHEN("the VDR has a pad value")
+            {
+                const auto bytes = make_sparse_file(cdf_sparse_records::pad,
+                    cdf_compression_type::no_compression, encoding, -999.);
+                auto cdf = io::load(bytes.data(), std::size(bytes), true, false);
+                REQUIRE(cdf != std::nullopt);
+                THEN("missing records hold it")
+                {
+                    REQUIRE(records_match((*cdf)["sparse"].get<double>().data(), 0,
+                        records_count, cdf_sparse_records::pad, -999.));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,304 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "cdfpp/cdf-parallel.hpp"
+#include "cdfpp/cdf-spectrogram.hpp"
+#include "cdfpp/variable.hpp"
+
+#include "../synthetic_series.hpp"
+
+using namespace cdf;
+
+namespace
+{
+struct dataset
+{
+    std::vector<double> values;
+    std::vector<int64_t> time;
+    std::vector<double> bins;
+};
+
+// the decimation series with zeros and only positive values otherwise
+dataset make_dataset(std::size_t records, std::size_t bins)
+{
+    auto series = synthetic::make_series<int64_t>(records, bins, 1'000'000'000'000, 200'000'000,
+        [](std::size_t i)
+        { return i % 103 == 0 ? 0. : std::exp(std::sin(static_cast<double>(i) * 0.013) * 5.); });
+    dataset d { std::move(series.values), std::move(series.time), {} };
+    for (std::size_t bin = 0; bin < bins; ++bin)
+        d.bins.push_back(10. * std::pow(1.3, static_cast<double>(bin)));
+    return d;
+}
+
+// cell k spans [edges[k], edges[k + 1]), midpoints between centers, outer cells extended
+template <typename T>
+std::vector<T> cell_edges(const std::vector<T>& centers)
+{
+    const auto n = std::size(centers);
+    std::vector<T> edges(n + 1);
+    for (std::size_t i = 1; i < n; ++i)
+        edges[i] = centers[i - 1] + (centers[i] - centers[i - 1]) / 2;
+    edges[0] = centers[0] - (centers[1] - centers[0]) / 2;
+    edges[n] = centers[n - 1] + (centers[n - 1] - centers[n - 2]) / 2;
+    return edges;
+}
+
+// the cells drawn in pixel [low, high), straight from the definition
+template <typename T>
+std::vector<std::size_t> cells_of(const std::vector<T>& centers, T low, T high)
+{
+    std::vector<std::size_t> cells;
+    for (std::size_t i = 0; i < std::size(centers); ++i)
+        if (centers[i] >= low && centers[i] < high)
+            cells.push_back(i);
+    if (cells.empty())
+    {
+        const auto edges = cell_edges(centers);
+        const T center = low + (high - low) / 2;
+        for (std::size_t i = 0; i < std::size(centers); ++i)
+            if (center >= edges[i] && center < edges[i + 1])
+                cells.push_back(i);
+    }
+    return cells;
+}
+
+// pixel by pixel on a log y and log z scale, colours from the viridis anchors
+std::vector<uint8_t> reference(const dataset& d, std::size_t width, std::size_t height,
+    int64_t start, int64_t stop, double y_min, double y_max, double z_min, double z_max)
+{
+    const std::array<std::array<double, 3>, 10> anchors { { { 68, 1, 84 }, { 72, 40, 120 },
+        { 62, 74, 137 }, { 49, 104, 142 }, { 38, 130, 142 }, { 31, 158, 137 },
+        { 53, 183, 121 }, { 110, 206, 88 }, { 181, 222, 43 }, { 253, 231, 37 } } };
+    std::vector<double> log_bins;
+    for (const auto b : d.bins)
+        log_bins.push_back(std::log10(b));
+    const auto x_edges = decimation::uniform_edges(start, stop, width);
+    const auto bins = std::size(d.bins);
+    std::vector<uint8_t> rgba(width * height * 4, 0);
+    for (std::size_t row = 0; row < height; ++row)
+    {
+        const auto y_row = height - 1 - row;
+        const double y_low = std::log10(y_min)
+            + (std::log10(y_max) - std::log10(y_min)) * static_cast<double>(y_row)
+                / static_cast<double>(height);
+        const double y_high = std::log10(y_min)
+            + (std::log10(y_max) - std::log10(y_min)) * static_cast<double>(y_row + 1)
+                / static_cast<double>(height);
+        const auto row_bins = cells_of(log_bins, y_low, y_high);
+        for (std::size_t column = 0; column < width; ++column)
+        {
+            double level = -std::numeric_limits<double>::infinity();
+            for (const auto record : cells_of(d.time, x_edges[column], x_edges[column + 1]))
+                for (const auto bin : row_bins)
+                {
+                    const auto v = d.values[record * bins + bin];
+                    if (std::isfinite(v) && v > 0. && v != synthetic::fill)
+                        level = std::max(level, v);
+                }
+            if (std::isinf(level))
+                continue;
+            const double t = std::clamp((std::log10(level) - std::log10(z_min))
+                    / (std::log10(z_max) - std::log10(z_min)),
+                0., 1.);
+            const double x = std::round(t * 255.) / 255. * 9.;
+            const auto i = static_cast<std::size_t>(x);
+            const double f = x - static_cast<double>(i);
+            uint8_t* out = rgba.data() + (row * width + column) * 4;
+            for (std::size_t c = 0; c < 3; ++c)
+                out[c] = static_cast<uint8_t>(std::floor(anchors[i][c]
+                    + (anchors[std::min(i + 1, std::size_t { 9 })][c] - anchors[i][c]) * f + 0.5));
+            out[3] = 255;
+        }
+    }
+    return rgba;
+}
+
+spectrogram::image_t draw(const dataset& d, const spectrogram::settings_t& settings)
+{
+    return spectrogram::rasterize(std::span<const double> { d.values },
+        std::span<const int64_t> { d.time }, std::span<const double> { d.bins }, settings,
+        { .fill = synthetic::fill });
+}
+
+std::size_t differences(const no_init_vector<uint8_t>& left, const std::vector<uint8_t>& right)
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < std::size(right); i += 4)
+        count += not std::equal(std::cbegin(right) + i, std::cbegin(right) + i + 4,
+            std::cbegin(left) + i);
+    return count;
+}
+}
+
+TEST_CASE("Spectrogram rasterization", "")
+{
+    SECTION("matches a pixel by pixel rasterization")
+    {
+        // zoomed out, zoomed in on both axes and in between
+        for (const auto& [records, width, height] :
+            std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> {
+                { 20'000, 300, 16 }, { 50, 640, 200 }, { 3000, 1000, 40 } })
+        {
+            const auto d = make_dataset(records, 32);
+            const spectrogram::settings_t settings { .width = width,
+                .height = height,
+                .y_scale = spectrogram::scale_t::log,
+                .z_scale = spectrogram::scale_t::log };
+            const auto image = draw(d, settings);
+            REQUIRE(image.width == width);
+            REQUIRE(image.height == height);
+            REQUIRE(std::size(image.rgba) == width * height * 4);
+            REQUIRE(image.z_min > 0.);
+            REQUIRE(image.z_max > image.z_min);
+            const auto expected = reference(d, width, height, image.start, image.stop,
+                image.y_min, image.y_max, image.z_min, image.z_max);
+            // floating point rounding on the exact colour levels boundaries aside
+            REQUIRE(differences(image.rgba, expected) <= width * height / 1000);
+            // the data gap is transparent when zoomed in
+            if (width > records)
+                REQUIRE(std::count(std::cbegin(image.rgba) + 3, std::cend(image.rgba), 0) > 0);
+        }
+    }
+    SECTION("draws the max of the cells in a pixel")
+    {
+        dataset d { { 1., 2., 5., 3., 4., 1. }, { 0, 1, 2 }, { 1., 2. } };
+        const auto image = draw(d,
+            { .width = 1,
+                .height = 1,
+                .z_min = 0.,
+                .z_max = 5.,
+                .z_scale = spectrogram::scale_t::linear });
+        REQUIRE(image.rgba[0] == 253);
+        REQUIRE(image.rgba[3] == 255);
+        d.values[2] = std::numeric_limits<double>::quiet_NaN();
+        const auto without_max = draw(d,
+            { .width = 1,
+                .height = 1,
+                .z_min = 0.,
+                .z_max = 5.,
+                .z_scale = spectrogram::scale_t::linear });
+        REQUIRE(without_max.rgba != image.rgba);
+    }
+    SECTION("skips fill and out of range values")
+    {
+        // one pixel per cell, bins top row first in the image
+        dataset d { { -1e31, 2., 50., 3. }, { 0, 1'000'000'000 }, { 1., 2. } };
+        const auto image = spectrogram::rasterize(std::span<const double> { d.values },
+            std::span<const int64_t> { d.time }, std::span<const double> { d.bins },
+            { .width = 2, .height = 2, .z_scale = spectrogram::scale_t::linear },
+            { .fill = -1e31, .valid_max = 10. });
+        REQUIRE(image.z_min == 2.);
+        REQUIRE(image.z_max == 3.);
+        REQUIRE(image.rgba[2 * 4 + 3] == 0); // bottom left, fill value
+        REQUIRE(image.rgba[3 * 4 + 3] == 0); // bottom right, above VALIDMAX
+        REQUIRE(image.rgba[0 * 4 + 3] == 255);
+        REQUIRE(image.rgba[1 * 4 + 3] == 255);
+        REQUIRE(image.rgba[0] == 68); // 2, bottom of the colour scale
+        REQUIRE(image.rgba[1 * 4] == 253); // 3, top of the colour scale
+    }
+    SECTION("decreasing bins draw the same image")
+    {
+        const auto d = make_dataset(500, 16);
+        auto flipped = d;
+        std::reverse(std::begin(flipped.bins), std::end(flipped.bins));
+        for (std::size_t record = 0; record < 500; ++record)
+            std::reverse(std::begin(flipped.values) + static_cast<std::ptrdiff_t>(record * 16),
+                std::begin(flipped.values) + static_cast<std::ptrdiff_t>(record * 16 + 16));
+        const spectrogram::settings_t settings { .width = 120,
+            .height = 70,
+            .y_scale = spectrogram::scale_t::log };
+        REQUIRE(draw(d, settings).rgba == draw(flipped, settings).rgba);
+    }
+    SECTION("doesn't depend on threading")
+    {
+        const auto d = make_dataset(100'000, 64);
+        const spectrogram::settings_t settings { .width = 777, .height = 123 };
+        parallel::set_num_threads(1);
+        const auto single = draw(d, settings);
+        parallel::set_num_threads(4);
+        parallel::set_min_chunk_size(1000);
+        const auto threaded = draw(d, settings);
+        parallel::set_num_threads(0);
+        parallel::set_min_chunk_size(1024 * 1024);
+        REQUIRE(single.rgba == threaded.rgba);
+    }
+    SECTION("rejects unusable inputs")
+    {
+        const auto d = make_dataset(10, 4);
+        REQUIRE_THROWS_AS(draw(d, { .width = 0, .height = 10 }), std::invalid_argument);
+        REQUIRE_THROWS_AS(draw(d, { .width = 10, .height = 10, .start = 10, .stop = 10 }),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(draw(d, { .width = 10, .height = 10, .z_min = -1., .z_max = 1. }),
+            std::invalid_argument);
+        auto unsorted = d;
+        std::swap(unsorted.bins[1], unsorted.bins[2]);
+        REQUIRE_THROWS_AS(draw(unsorted, { .width = 10, .height = 10 }), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Spectrogram rasterization of variables", "")
+{
+    // 100 records, one per second from 2000-01-01T12:00:00 (TT2000 starts 64.184s before)
+    no_init_vector<tt2000_t> time(100);
+    no_init_vector<float> values(300);
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        time[i] = tt2000_t { static_cast<int64_t>(i) * 1'000'000'000 + 64'184'000'000 };
+        values[3 * i] = i % 2 == 0 ? -1e31f : 1.f;
+        values[3 * i + 1] = 10.f;
+        values[3 * i + 2] = 100.f;
+    }
+    Variable epoch_var { "Epoch", 0, data_t { std::move(time), CDF_Types::CDF_TIME_TT2000 },
+        { 100 } };
+    Variable energy { "Energy", 1, data_t { no_init_vector<float> { 100.f, 200.f, 400.f },
+                                       CDF_Types::CDF_FLOAT },
+        { 1, 3 } };
+    Variable var { "flux", 2, data_t { std::move(values), CDF_Types::CDF_FLOAT }, { 100, 3 } };
+    var.attributes.emplace("FILLVAL",
+        VariableAttribute { "FILLVAL",
+            data_t { no_init_vector<double> { -1e31 }, CDF_Types::CDF_DOUBLE } });
+
+    energy.attributes.emplace("SCALETYP",
+        VariableAttribute { "SCALETYP",
+            data_t { no_init_vector<char> { 'l', 'o', 'g', ' ' }, CDF_Types::CDF_CHAR } });
+    REQUIRE(spectrogram::scale_type(energy, spectrogram::scale_t::linear)
+        == spectrogram::scale_t::log);
+    REQUIRE(spectrogram::scale_type(var, spectrogram::scale_t::linear)
+        == spectrogram::scale_t::linear);
+
+    constexpr int64_t noon = 946'728'000'000'000'000;
+    const auto image = spectrogram::rasterize(var, epoch_var, &energy,
+        { .width = 100, .height = 3, .y_scale = spectrogram::scale_t::log });
+    REQUIRE(image.start == noon - 500'000'000);
+    REQUIRE(image.stop == noon + 99'500'000'000);
+    REQUIRE(image.y_scale == spectrogram::scale_t::log);
+    REQUIRE(std::abs(image.y_min - 100. / std::sqrt(2.)) < 1e-9);
+    REQUIRE(std::abs(image.y_max - 400. * std::sqrt(2.)) < 1e-9);
+    REQUIRE(image.z_min == 1.);
+    REQUIRE(image.z_max == 100.);
+    for (std::size_t column = 0; column < 100; ++column)
+    {
+        // bottom row: every other record is a fill value
+        REQUIRE(image.rgba[(2 * 100 + column) * 4 + 3] == (column % 2 == 0 ? 0 : 255));
+        REQUIRE(image.rgba[(0 * 100 + column) * 4] == 253);
+    }
+
+    // without bins rows are the bin indices, a log y axis falls back to linear
+    const auto by_index = spectrogram::rasterize(var, epoch_var, nullptr,
+        { .width = 10, .height = 3, .y_scale = spectrogram::scale_t::log });
+    REQUIRE(by_index.y_scale == spectrogram::scale_t::linear);
+    REQUIRE(by_index.y_min == -0.5);
+    REQUIRE(by_index.y_max == 2.5);
+
+    REQUIRE_THROWS_AS(
+        spectrogram::rasterize(epoch_var, epoch_var, nullptr, { .width = 10, .height = 3 }),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        spectrogram::rasterize(var, var, nullptr, { .width = 10, .height = 3 }),
+        std::invalid_argument);
+}
@@ -1,5 +1,9 @@
+#include <cstring>
 #include <optional>
+#include <span>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
@@ -97,3 +101,210 @@ SCENARIO("Variable.is_contiguous() detects fragmented variable record blocks", "
         }
     }
 }
+
+SCENARIO("Variables split across several blocks are reassembled by record index", "[introspection]")
+{
+    GIVEN("the fragmented file")
+    {
+        for (bool lazy : { true, false })
+        {
+            auto cd = load_fixture("fragmented.cdf", lazy);
+            THEN("every record of the split variable lands at its own index")
+            {
+                const auto values = cd["split_zvar"].get<int32_t>();
+                REQUIRE(std::size(values) == 10);
+                for (int32_t i = 0; i < 10; i++)
+                    REQUIRE(values[i] == i);
+            }
+        }
+    }
+    GIVEN("a flattened block table")
+    {
+        const io::variable::var_block_table_t table {
+            { 0, 4, 0, cdf_record_type::VVR, 20 },
+            { 5, 9, 100, cdf_record_type::VVR, 20 },
+            { 10, 19, 200, cdf_record_type::CVVR, 8 },
+        };
+        THEN("blocks_in_range only returns the blocks overlapping the requested records")
+        {
+            REQUIRE(std::size(io::variable::blocks_in_range(table, 0, 19)) == 3);
+            REQUIRE(std::size(io::variable::blocks_in_range(table, 4, 5)) == 2);
+            REQUIRE(io::variable::blocks_in_range(table, 6, 7).front().offset == 100);
+            REQUIRE(io::variable::blocks_in_range(table, 12, 30).front().is_compressed());
+            REQUIRE(std::size(io::variable::blocks_in_range(table, 20, 30)) == 0);
+        }
+    }
+}
+
+SCENARIO("Variable.read_into() decodes records into caller provided memory", "[introspection]")
+{
+    GIVEN("a lazily loaded variable split across two blocks")
+    {
+        auto cd = load_fixture("fragmented.cdf", true);
+        const auto& var = cd["split_zvar"];
+        WHEN("reading a range spanning both blocks")
+        {
+            std::vector<int32_t> out(6);
+            const auto count = var.read_into(std::as_writable_bytes(std::span { out }), { 2, 8 });
+            THEN("only the requested records are written and the variable stays lazy")
+            {
+                REQUIRE(count == 6);
+                for (int32_t i = 0; i < 6; i++)
+                    REQUIRE(out[i] == i + 2);
+                REQUIRE_FALSE(var.values_loaded());
+            }
+        }
+        WHEN("the destination is too small")
+        {
+            std::vector<int32_t> out(2);
+            THEN("read_into throws")
+            {
+                REQUIRE_THROWS_AS(
+                    var.read_into(std::as_writable_bytes(std::span { out })), std::invalid_argument);
+            }
+        }
+    }
+    GIVEN("compressed and column major variables")
+    {
+        for (const auto& name : { "a_cdf_with_compressed_vars.cdf", "a_col_major_cdf.cdf" })
+        {
+            auto lazy = load_fixture(name, true);
+            auto eager = load_fixture(name, false);
+            THEN("read_into gives the same bytes as a full load")
+            {
+                for (const auto& [var_name, var] : eager.variables)
+                {
+                    std::vector<std::byte> out(var.bytes());
+                    REQUIRE(lazy[var_name].read_into(out) == var.len());
+                    REQUIRE(std::memcmp(out.data(), var.bytes_ptr(), var.bytes()) == 0);
+                }
+            }
+        }
+    }
+    GIVEN("variables compressed in multi-record CVVRs")
+    {
+        auto lazy = load_fixture("a_cdf_with_compressed_vars.cdf", true);
+        auto eager = load_fixture("a_cdf_with_compressed_vars.cdf", false);
+        THEN("ranges starting and ending inside a CVVR give the same bytes as a full load")
+        {
+            for (const auto& [var_name, var] : eager.variables)
+            {
+                if (var.compression_type() == cdf_compression_type::no_compression
+                    or var.len() < 3)
+                    continue;
+                const auto first = var.len() / 3, stop = 2 * var.len() / 3 + 1;
+                const auto bytes = (stop - first) * var.record_bytes();
+                std::vector<std::byte> out(bytes);
+                REQUIRE(lazy[var_name].read_into(out, { first, stop }) == stop - first);
+                REQUIRE(std::memcmp(out.data(), var.bytes_ptr() + first * var.record_bytes(),
+                            bytes)
+                    == 0);
+                REQUIRE_FALSE(lazy[var_name].values_loaded());
+            }
+        }
+    }
+}
+
+SCENARIO("Variable.chunks() streams records in batches", "[introspection]")
+{
+    GIVEN("a lazily loaded variable split across two blocks")
+    {
+        auto cd = load_fixture("fragmented.cdf", true);
+        const auto& var = cd["split_zvar"];
+        WHEN("iterating over chunks of 3 records")
+        {
+            std::vector<int32_t> values;
+            std::vector<std::size_t> sizes;
+            for (const auto& chunk : var.chunks(3))
+            {
+                REQUIRE(chunk.first_record == std::size(values));
+                sizes.push_back(chunk.shape[0]);
+                const auto& chunk_values = chunk.values.get<int32_t>();
+                values.insert(std::end(values), std::cbegin(chunk_values), std::cend(chunk_values));
+            }
+            THEN("every record is seen once, in order, and the variable stays lazy")
+            {
+                REQUIRE(sizes == std::vector<std::size_t> { 3, 3, 3, 1 });
+                REQUIRE(std::size(values) == 10);
+                for (int32_t i = 0; i < 10; i++)
+                    REQUIRE(values[i] == i);
+                REQUIRE_FALSE(var.values_loaded());
+            }
+        }
+        THEN("a null chunk size is rejected")
+        {
+            REQUIRE_THROWS_AS(var.chunks(0), std::invalid_argument);
+        }
+    }
+    GIVEN("a column major file")
+    {
+        auto lazy = load_fixture("a_col_major_cdf.cdf", true);
+        auto eager = load_fixture("a_col_major_cdf.cdf", false);
+        THEN("chunks hold the same row major bytes as a full load")
+        {
+            for (const auto& [name, var] : eager.variables)
+            {
+                std::vector<char> bytes;
+                for (const auto& chunk : lazy[name].chunks(7))
+                    bytes.insert(std::end(bytes), chunk.values.bytes_ptr(),
+                        chunk.values.bytes_ptr() + chunk.values.bytes());
+                REQUIRE(std::size(bytes) == var.bytes());
+                REQUIRE(std::memcmp(bytes.data(), var.bytes_ptr(), var.bytes()) == 0);
+            }
+        }
+    }
+    GIVEN("a file with compressed variables")
+    {
+        auto lazy = load_fixture("a_cdf_with_compressed_vars.cdf", true);
+        auto eager = load_fixture("a_cdf_with_compressed_vars.cdf", false);
+        THEN("chunks cutting through compressed blocks match a full load")
+        {
+            for (const auto& [name, var] : eager.variables)
+            {
+                std::vector<char> bytes;
+                for (const auto& chunk : lazy[name].chunks(5))
+                    bytes.insert(std::end(bytes), chunk.values.bytes_ptr(),
+                        chunk.values.bytes_ptr() + chunk.values.bytes());
+                REQUIRE(std::size(bytes) == var.bytes());
+                REQUIRE(std::memcmp(bytes.data(), var.bytes_ptr(), var.bytes()) == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Lazy values can be materialized concurrently", "[introspection]")
+{
+    GIVEN("a lazily loaded compressed file")
+    {
+        auto lazy = load_fixture("a_cdf_with_compressed_vars.cdf", true);
+        auto eager = load_fixture("a_cdf_with_compressed_vars.cdf", false);
+        WHEN("several threads access the values of every variable at once")
+        {
+            std::vector<std::vector<const char*>> seen(8);
+            std::vector<std::thread> workers;
+            for (auto& ptrs : seen)
+                workers.emplace_back(
+                    [&lazy, &ptrs]()
+                    {
+                        for (const auto& [name, var] : lazy.variables)
+                        {
+                            var.load_values();
+                            ptrs.push_back(var.bytes_ptr());
+                        }
+                    });
+            for (auto& worker : workers)
+                worker.join();
+            THEN("values are decoded once and match a full load")
+            {
+                for (const auto& ptrs : seen)
+                    REQUIRE(ptrs == seen.front());
+                for (const auto& [name, var] : eager.variables)
+                {
+                    REQUIRE(lazy[name].values_loaded());
+                    REQUIRE(lazy[name].bytes() == var.bytes());
+                    REQUIRE(std::memcmp(lazy[name].bytes_ptr(), var.bytes_ptr(), var.bytes()) == 0);
+                }
+            }
+        }
+    }
+}
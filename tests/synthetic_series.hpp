@@ -0,0 +1,45 @@
+#pragma once
+// Synthetic time series shared by the decimation and spectrogram tests.
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace synthetic
+{
+inline constexpr double fill = -1e31;
+
+template <typename time_t>
+struct series
+{
+    std::vector<double> values; // record after record, width values each
+    std::vector<time_t> time;
+};
+
+// Irregular sampling starting after start with a gap of gap ns a third of the way, every
+// 97th value is the fill value, every 101st a NaN and the others are signal(value index).
+template <typename time_t, typename signal_t>
+series<time_t> make_series(
+    std::size_t records, std::size_t width, int64_t start, int64_t gap, signal_t&& signal)
+{
+    series<time_t> s;
+    int64_t t = start;
+    for (std::size_t record = 0; record < records; ++record)
+    {
+        t += 1'000'000 + static_cast<int64_t>((record * 7919) % 1000) * 1000;
+        if (record == records / 3)
+            t += gap;
+        s.time.push_back(time_t { t });
+        for (std::size_t column = 0; column < width; ++column)
+        {
+            const auto i = record * width + column;
+            if (i % 97 == 0)
+                s.values.push_back(fill);
+            else if (i % 101 == 0)
+                s.values.push_back(std::numeric_limits<double>::quiet_NaN());
+            else
+                s.values.push_back(signal(i));
+        }
+    }
+    return s;
+}
+}
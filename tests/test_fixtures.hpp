@@ -0,0 +1,16 @@
+#pragma once
+// Helpers shared by the tests loading the files of tests/resources.
+#include <array>
+#include <string>
+
+#include "tests_config.hpp"
+
+inline std::string fixture(const std::string& name)
+{
+    return std::string(DATA_PATH) + "/" + name;
+}
+
+// One file per layout loaders must handle: plain, compressed as a whole, with compressed
+// variables, column major and with variables split over several blocks.
+inline constexpr std::array<const char*, 5> layout_fixtures { "a_cdf.cdf", "a_compressed_cdf.cdf",
+    "a_cdf_with_compressed_vars.cdf", "a_col_major_cdf.cdf", "fragmented.cdf" };
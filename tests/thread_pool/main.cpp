@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-io/cdf-io.hpp"
+#include "cdfpp/cdf-parallel.hpp"
+#include "cdfpp/chrono/cdf-chrono.hpp"
+
+using namespace cdf;
+
+SCENARIO("The library thread pool runs batches of tasks", "[parallel]")
+{
+    parallel::set_num_threads(4);
+    REQUIRE(parallel::num_threads() == 4);
+    GIVEN("a parallel_for over many tasks")
+    {
+        std::vector<int> hits(10'000, 0);
+        parallel::parallel_for(std::size(hits), [&hits](std::size_t i) { hits[i]++; });
+        THEN("every task runs exactly once")
+        {
+            REQUIRE(std::all_of(std::cbegin(hits), std::cend(hits), [](int h) { return h == 1; }));
+        }
+    }
+    GIVEN("a task that throws")
+    {
+        THEN("the exception reaches the caller")
+        {
+            REQUIRE_THROWS_AS(parallel::parallel_for(100,
+                                  [](std::size_t i)
+                                  {
+                                      if (i == 42)
+                                          throw std::runtime_error { "task failed" };
+                                  }),
+                std::runtime_error);
+        }
+    }
+    GIVEN("nested parallel_for calls from many threads at once")
+    {
+        std::atomic<std::size_t> total { 0 };
+        std::vector<std::thread> callers;
+        for (int c = 0; c < 8; c++)
+            callers.emplace_back(
+                [&total]()
+                {
+                    parallel::parallel_for(16,
+                        [&total](std::size_t)
+                        {
+                            parallel::parallel_for(
+                                16, [&total](std::size_t) { total.fetch_add(1); });
+                        });
+                });
+        for (auto& caller : callers)
+            caller.join();
+        THEN("they all complete")
+        {
+            REQUIRE(total.load() == 8 * 16 * 16);
+        }
+    }
+    GIVEN("parallel_chunks over an input larger than the minimum chunk size")
+    {
+        std::vector<int> hits(1000, 0);
+        std::atomic<std::size_t> chunks { 0 };
+        parallel::parallel_chunks(std::size(hits), 100,
+            [&](std::size_t first, std::size_t count)
+            {
+                chunks++;
+                for (auto i = first; i < first + count; i++)
+                    hits[i]++;
+            });
+        THEN("the input is covered once, in at most num_threads() chunks")
+        {
+            REQUIRE(std::all_of(std::cbegin(hits), std::cend(hits), [](int h) { return h == 1; }));
+            REQUIRE(chunks.load() <= parallel::num_threads());
+            REQUIRE(chunks.load() > 1);
+        }
+    }
+    GIVEN("submitted tasks")
+    {
+        auto a = parallel::submit([]() { return 21; });
+        auto b = parallel::submit([]() { return 2; });
+        THEN("their results come back")
+        {
+            REQUIRE(a.get() * b.get() == 42);
+        }
+        AND_WHEN("waiting on a task from inside the pool")
+        {
+            std::atomic<int> result { 0 };
+            parallel::parallel_for(8,
+                [&result](std::size_t)
+                { result += parallel::submit([]() { return 1; }).get(); });
+            THEN("it doesn't starve")
+            {
+                REQUIRE(result.load() == 8);
+            }
+        }
+    }
+    GIVEN("a single threaded configuration")
+    {
+        parallel::set_num_threads(1);
+        REQUIRE(parallel::num_threads() == 1);
+        std::vector<std::thread::id> ids(64);
+        parallel::parallel_for(
+            std::size(ids), [&ids](std::size_t i) { ids[i] = std::this_thread::get_id(); });
+        auto task = parallel::submit([]() { return std::this_thread::get_id(); });
+        THEN("everything runs on the calling thread")
+        {
+            REQUIRE(std::all_of(std::cbegin(ids), std::cend(ids),
+                [](auto id) { return id == std::this_thread::get_id(); }));
+            REQUIRE(task.get() == std::this_thread::get_id());
+        }
+        parallel::set_num_threads(4);
+    }
+    GIVEN("threads shrinking and growing the pool at the same time")
+    {
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < 8; i++)
+            threads.emplace_back(
+                [i]()
+                {
+                    for (std::size_t round = 0; round < 50; round++)
+                        parallel::set_num_threads((i + round) % 2 ? 1 : 4);
+                });
+        for (auto& thread : threads)
+            thread.join();
+        parallel::set_num_threads(4);
+        THEN("every resize returns and the pool still runs tasks")
+        {
+            REQUIRE(parallel::num_threads() == 4);
+            std::atomic<std::size_t> count { 0 };
+            parallel::parallel_for(1000, [&count](std::size_t) { count++; });
+            REQUIRE(count.load() == 1000);
+        }
+    }
+}
+
+SCENARIO("Time conversions split large inputs over the pool", "[parallel]")
+{
+    parallel::set_num_threads(4);
+    parallel::set_min_chunk_size(1000);
+    std::vector<int64_t> ns(100'003);
+    std::iota(std::begin(ns), std::end(ns), int64_t { 1'600'000'000'000'000'000 });
+    std::vector<tt2000_t> tt(std::size(ns));
+    from_ns_from_1970(ns, tt.data());
+    std::vector<int64_t> back(std::size(ns));
+    to_ns_from_1970(std::span<const tt2000_t> { tt }, back.data());
+    REQUIRE(back == ns);
+    parallel::set_min_chunk_size(1024 * 1024);
+}
+
+SCENARIO("Compressed variables deflate and inflate their CVVRs on the pool", "[parallel]")
+{
+    parallel::set_num_threads(4);
+    CDF cdf;
+    // 24MB and 12MB of values, several CVVRs each
+    no_init_vector<double> values(3'000'000);
+    std::iota(std::begin(values), std::end(values), 0.);
+    cdf.variables.emplace("gzip",
+        Variable { "gzip", 0, data_t { values, CDF_Types::CDF_DOUBLE }, { 1'000'000, 3 } });
+    cdf.variables["gzip"].set_compression_type(cdf_compression_type::gzip_compression);
+    no_init_vector<int32_t> counter(3'000'000);
+    std::iota(std::begin(counter), std::end(counter), 0);
+    cdf.variables.emplace(
+        "rle", Variable { "rle", 1, data_t { counter, CDF_Types::CDF_INT4 }, { 3'000'000 } });
+    cdf.variables["rle"].set_compression_type(cdf_compression_type::rle_compression);
+    WHEN("saving and reloading it")
+    {
+        const auto bytes = io::save(cdf);
+        const auto reloaded = io::load(std::vector<char> { std::cbegin(bytes), std::cend(bytes) });
+        THEN("values come back unchanged")
+        {
+            REQUIRE(reloaded.has_value());
+            REQUIRE(reloaded->variables.at("gzip") == cdf.variables.at("gzip"));
+            REQUIRE(reloaded->variables.at("rle") == cdf.variables.at("rle"));
+        }
+        AND_WHEN("doing the same single threaded")
+        {
+            parallel::set_num_threads(1);
+            const auto sequential_bytes = io::save(cdf);
+            const auto sequential
+                = io::load(std::vector<char> { std::cbegin(bytes), std::cend(bytes) });
+            parallel::set_num_threads(4);
+            THEN("it saves the same file and loads the same values")
+            {
+                REQUIRE(sequential_bytes == bytes);
+                REQUIRE(sequential.has_value());
+                REQUIRE(*sequential == *reloaded);
+            }
+        }
+    }
+}
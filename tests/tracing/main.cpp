@@ -0,0 +1,96 @@
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "cdfpp/cdf-file.hpp"
+#include "cdfpp/cdf-io/cdf-io.hpp"
+#include "cdfpp/cdf-trace.hpp"
+#include "cdfpp/chrono/cdf-chrono.hpp"
+
+#include "../test_fixtures.hpp"
+
+using namespace cdf;
+
+namespace
+{
+std::size_t count(const std::string& json, std::string_view pattern)
+{
+    std::size_t n = 0;
+    for (auto pos = json.find(pattern); pos != std::string::npos;
+         pos = json.find(pattern, pos + std::size(pattern)))
+        n++;
+    return n;
+}
+
+bool has_event(const std::string& json, std::string_view name)
+{
+    return json.find(fmt::format(R"("name":"{}","pid")", name)) != std::string::npos;
+}
+}
+
+SCENARIO("Tracing load and save phases", "[CDF]")
+{
+    REQUIRE(tracing::available());
+    tracing::stop();
+    tracing::clear();
+    GIVEN("tracing stopped")
+    {
+        REQUIRE(io::load(fixture("a_cdf.cdf"), true, false));
+        THEN("nothing is recorded")
+        {
+            REQUIRE(count(tracing::to_json(), R"("ph":)") == 0);
+        }
+    }
+    GIVEN("a traced load of a file with compressed variables")
+    {
+        tracing::start();
+        auto cdf = io::load(fixture("a_cdf_with_compressed_vars.cdf"), true, false);
+        tracing::stop();
+        REQUIRE(cdf != std::nullopt);
+        const auto json = tracing::to_json();
+        THEN("it is a Chrome trace with balanced begin and end events")
+        {
+            REQUIRE(json.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[)"));
+            REQUIRE(count(json, R"("ph":"B")") > 0);
+            REQUIRE(count(json, R"("ph":"B")") == count(json, R"("ph":"E")"));
+        }
+        THEN("phases carry the file, variables, byte ranges and codecs")
+        {
+            REQUIRE(has_event(json, "load file"));
+            REQUIRE(has_event(json, "attributes"));
+            REQUIRE(has_event(json, "variable"));
+            REQUIRE(has_event(json, "CVVR"));
+            REQUIRE(has_event(json, "inflate"));
+            REQUIRE(json.find(R"("path":")") != std::string::npos);
+            REQUIRE(json.find(R"("offset":)") != std::string::npos);
+            REQUIRE(json.find(R"("codec":")") != std::string::npos);
+            for (const auto& [name, _] : cdf->variables)
+                REQUIRE(json.find(fmt::format(R"("variable":"{}")", name)) != std::string::npos);
+        }
+        tracing::clear();
+    }
+    GIVEN("a traced save and time conversion")
+    {
+        auto cdf = io::load(fixture("a_cdf_with_compressed_vars.cdf"), true, false);
+        REQUIRE(cdf != std::nullopt);
+        no_init_vector<tt2000_t> times(100, tt2000_t { 0 });
+        no_init_vector<int64_t> ns(100);
+        tracing::start();
+        REQUIRE(std::size(io::save(*cdf)) > 0);
+        to_ns_from_1970(std::span<const tt2000_t> { times.data(), std::size(times) }, ns.data());
+        tracing::stop();
+        const auto json = tracing::to_json();
+        THEN("saving and conversion phases are recorded")
+        {
+            REQUIRE(has_event(json, "prepare records"));
+            REQUIRE(has_event(json, "deflate"));
+            REQUIRE(has_event(json, "write records"));
+            REQUIRE(has_event(json, "to_ns_from_1970"));
+            REQUIRE(count(json, R"("ph":"B")") == count(json, R"("ph":"E")"));
+        }
+        tracing::clear();
+    }
+}
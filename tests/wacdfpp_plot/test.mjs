@@ -2,7 +2,7 @@
 //   node test.mjs
 import {
     MAX_LINES, MAX_PLOT_DIMENSIONS, MAX_PLOT_POINTS,
-    recordLength, plotSpec, applyMask, decimateMinMax, toCSV, toJSON,
+    recordLength, plotSpec, applyMask, decimateMinMax, minMaxSeries, toCSV, toJSON,
 } from "../../wacdfpp/plot-model.js";
 import { viridis, normalizeLevel, cellEdges, scaleTypeOf, isMonotonic } from "../../wacdfpp/spectrogram.js";
 
@@ -93,6 +93,21 @@ check("decimate x aligned to y", dec.x.length === dec.y.length);
 const small = decimateMinMax([0, 1, 2], [10, 20, 30], 50);
 check("decimate passthrough when small", eq(small.y, [10, 20, 30]));
 
+// minMaxSeries: 2 buckets x 2 components from CdfFile.minmax
+const mm = minMaxSeries({
+    components: 2,
+    edges: new Float64Array([0, 2000, 4000]),
+    min: new Float64Array([-1, 5, NaN, 0]),
+    max: new Float64Array([3, 9, NaN, 7]),
+    first: new Float64Array([-1, 9, NaN, 2]),
+    last: new Float64Array([3, 6, NaN, 0]),
+});
+check("minMaxSeries x at bucket centers (s)", eq(Array.from(mm.x), [1, 1, 3, 3]));
+check("minMaxSeries min first", eq(Array.from(mm.ys[0].subarray(0, 2)), [-1, 3]));
+check("minMaxSeries max first", eq(Array.from(mm.ys[1].subarray(0, 2)), [9, 5]));
+check("minMaxSeries empty bucket is a gap", mm.ys[0].subarray(2).every(Number.isNaN));
+check("minMaxSeries last == min -> max first", eq(Array.from(mm.ys[1].subarray(2)), [7, 0]));
+
 const cols = [
     { name: "time", values: ["2020-01-01T00:00:00Z", "2020-01-01T00:00:01Z"] },
     { name: "Bx", values: [1.5, 2.5] },
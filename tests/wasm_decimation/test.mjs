@@ -0,0 +1,98 @@
+// Node test: CdfFile.minmax (C++ min/max decimation against DEPEND_0) matches a
+// record by record reduction done here from the full resolution values.
+//
+//   node test.mjs <path-to-cdfpp.js>
+
+import { readFileSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { dirname, join } from "node:path";
+import process from "node:process";
+
+const [, , modulePath] = process.argv;
+if (!modulePath)
+{
+    console.error("usage: node test.mjs <cdfpp.js>");
+    process.exit(2);
+}
+
+const resourcesDir = join(dirname(fileURLToPath(import.meta.url)), "..", "resources");
+
+const { default: createCdfModule } = await import(modulePath);
+const Module = await createCdfModule();
+
+let failures = 0;
+function check(name, ok)
+{
+    if (ok)
+        console.log(`ok   ${name}`);
+    else
+    {
+        failures += 1;
+        console.error(`FAIL ${name}`);
+    }
+}
+
+const same = (a, b) => a === b || (Number.isNaN(a) && Number.isNaN(b));
+
+const cdf = Module.load(new Uint8Array(readFileSync(join(resourcesDir, "ge_k0_cpi_19921231_v02.cdf"))));
+check("file loads", cdf.is_valid());
+
+const buckets = 37;
+for (const name of ["SW_V", "SW_P_Den", "GAP_FLAG"])
+{
+    const v = cdf.get_variable(name);
+    const values = v.copy_values;
+    const fill = v.attributes.FILLVAL[0];
+    const components = values.length / v.shape[0];
+    const ns = cdf.time_values_as_ns_since_1970(v.attributes.DEPEND_0);
+
+    const mm = cdf.minmax(name, buckets);
+    check(`${name} reduced`, mm !== undefined && mm.components === components
+        && mm.edges.length === buckets + 1 && mm.min.length === buckets * components);
+
+    // same evenly spaced edges as cdf::decimation::uniform_edges, over [first, last + 1ns)
+    const start = ns[0], span = ns[ns.length - 1] + 1n - start, n = BigInt(buckets);
+    const edge = k => start + (span / n) * BigInt(k) + (span % n) * BigInt(k) / n;
+    let ok = true;
+    for (let b = 0; b < buckets; b++)
+    {
+        for (let c = 0; c < components; c++)
+        {
+            let min = NaN, max = NaN, first = NaN, last = NaN;
+            for (let r = 0; r < ns.length; r++)
+            {
+                if (ns[r] < edge(b) || ns[r] >= edge(b + 1))
+                    continue;
+                const value = values[r * components + c];
+                if (Number.isNaN(value) || value === fill)
+                    continue;
+                if (Number.isNaN(first))
+                    first = min = max = value;
+                min = Math.min(min, value);
+                max = Math.max(max, value);
+                last = value;
+            }
+            const i = b * components + c;
+            ok &&= same(mm.min[i], min) && same(mm.max[i], max)
+                && same(mm.first[i], first) && same(mm.last[i], last);
+        }
+    }
+    check(`${name} matches a record by record reduction`, ok);
+
+    const startMs = Number(ns[0] / 1000000n) + 3600e3;
+    const ranged = cdf.minmax_range(name, 10, startMs, startMs + 600e3);
+    check(`${name} range edges`, ranged !== undefined && ranged.edges[0] === startMs
+        && ranged.edges[10] === startMs + 600e3);
+}
+
+check("time variable can't be reduced", cdf.minmax("Epoch", buckets) === undefined);
+check("unknown variable", cdf.minmax("nope", buckets) === undefined);
+
+cdf.delete();
+
+if (failures > 0)
+{
+    console.error(`\n${failures} check(s) failed`);
+    process.exit(1);
+}
+console.log("\nall checks passed");
@@ -0,0 +1,105 @@
+// Node test: Module.load_reader opens a local file through a read(offset, length)
+// callback (fs.readSync here, a File slice read with FileReaderSync in the viewer
+// worker) without copying it into WASM memory, and gives the same variables, values
+// and attributes as Module.load on the whole file. Listing variables with
+// get_variable_info must not read values.
+//
+//   node test.mjs <path-to-cdfpp.js>
+
+import { closeSync, fstatSync, openSync, readFileSync, readSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { dirname, join } from "node:path";
+import process from "node:process";
+
+const [, , modulePath] = process.argv;
+if (!modulePath)
+{
+    console.error("usage: node test.mjs <cdfpp.js>");
+    process.exit(2);
+}
+
+const resourcesDir = join(dirname(fileURLToPath(import.meta.url)), "..", "resources");
+
+const { default: createCdfModule } = await import(modulePath);
+const Module = await createCdfModule();
+
+let failures = 0;
+function check(name, ok)
+{
+    if (ok)
+        console.log(`ok   ${name}`);
+    else
+    {
+        failures += 1;
+        console.error(`FAIL ${name}`);
+    }
+}
+
+// read(offset, length) over a file descriptor, recording every request.
+function fileReader(fd, requests)
+{
+    return (offset, length) =>
+    {
+        requests.push([offset, length]);
+        const bytes = new Uint8Array(length);
+        readSync(fd, bytes, 0, length, offset);
+        return bytes;
+    };
+}
+
+const sameValues = (a, b) => a === b
+    || (a !== undefined && b !== undefined && a.length === b.length
+        && a.every((v, i) => v === b[i] || (Number.isNaN(v) && Number.isNaN(b[i]))));
+
+for (const file of ["a_cdf.cdf", "a_compressed_cdf.cdf", "a_cdf_with_compressed_vars.cdf",
+         "ge_k0_cpi_19921231_v02.cdf", "ia_k0_epi_19970102_v01.cdf"])
+{
+    const path = join(resourcesDir, file);
+    const fd = openSync(path, "r");
+    const size = fstatSync(fd).size;
+    const requests = [];
+    const lazy = Module.load_reader(size, fileReader(fd, requests));
+    const eager = Module.load(new Uint8Array(readFileSync(path)));
+    check(`${file} opens lazily`, lazy.is_valid() && eager.is_valid());
+    check(`${file} reads stay within the file`,
+        requests.length > 0 && requests.every(([o, l]) => o >= 0 && l > 0 && o + l <= size));
+
+    const names = lazy.variable_names();
+    check(`${file} same variables`, names.join() === eager.variable_names().join());
+    check(`${file} same global attributes`,
+        lazy.attribute_names().join() === eager.attribute_names().join());
+    check(`${file} listing reads no values`, names.every(
+        name => lazy.get_variable_info(name).values_loaded === false));
+    const mismatches = names.filter(name =>
+    {
+        const l = lazy.get_variable(name);
+        const e = eager.get_variable(name);
+        return !sameValues(l.copy_values, e.copy_values)
+            || l.attribute_names.join() !== e.attribute_names.join();
+    });
+    check(`${file} values match a whole file load ${mismatches.join()}`, mismatches.length === 0);
+
+    lazy.delete();
+    eager.delete();
+    closeSync(fd);
+}
+
+{
+    const fd = openSync(join(resourcesDir, "a_cdf.cdf"), "r");
+    const size = fstatSync(fd).size;
+    // a reader returning short reads makes the load fail cleanly
+    const truncated = Module.load_reader(size, (offset, length) => new Uint8Array(Math.max(0, length - 1)));
+    check("short reads are rejected", !truncated.is_valid());
+    truncated.delete();
+    const empty = Module.load_reader(0, fileReader(fd, []));
+    check("empty file is rejected", !empty.is_valid());
+    empty.delete();
+    closeSync(fd);
+}
+
+if (failures > 0)
+{
+    console.error(`\n${failures} check(s) failed`);
+    process.exit(1);
+}
+console.log("\nall checks passed");
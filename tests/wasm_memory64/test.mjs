@@ -0,0 +1,128 @@
+// Node test: files larger than 4 GiB through Module.load_reader. The variable data
+// of a small CDF is moved past 4 GiB in a virtual file served by the read callback
+// (its VXR offsets patched, nothing is allocated for the gap), so the 64-bit offsets
+// and sizes between the callback, the paged reader and the loader are exercised
+// without a multi-GB fixture. The Memory64 module (cdfpp-memory64.js) must read it
+// like the original file, a wasm32 module must refuse it instead of truncating.
+//
+//   node [--experimental-wasm-memory64] test.mjs <path-to-module.js> <memory64|wasm32>
+
+import { readFileSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { dirname, join } from "node:path";
+import process from "node:process";
+
+const [, , modulePath, kind] = process.argv;
+if (!modulePath || !["memory64", "wasm32"].includes(kind))
+{
+    console.error("usage: node test.mjs <module.js> <memory64|wasm32>");
+    process.exit(2);
+}
+
+const resourcesDir = join(dirname(fileURLToPath(import.meta.url)), "..", "resources");
+
+const { default: createCdfModule } = await import(modulePath);
+const Module = await createCdfModule();
+
+let failures = 0;
+function check(name, ok)
+{
+    if (ok)
+        console.log(`ok   ${name}`);
+    else
+    {
+        failures += 1;
+        console.error(`FAIL ${name}`);
+    }
+}
+
+const VXR = 6;
+const SHIFT = 5n * 1024n * 1024n * 1024n;
+
+// Copy of a CDF v3 file whose VXR entries and VXRnext links point SHIFT bytes further,
+// records are walked through their RecordSize field.
+function shiftedIndex(bytes)
+{
+    const patched = new Uint8Array(bytes);
+    const view = new DataView(patched.buffer);
+    let patchedEntries = 0;
+    for (let offset = 8; offset + 12 <= patched.length;)
+    {
+        const size = Number(view.getBigInt64(offset));
+        if (size <= 0)
+            break;
+        if (view.getInt32(offset + 8) === VXR)
+        {
+            const next = view.getBigInt64(offset + 12);
+            if (next !== 0n)
+                view.setBigInt64(offset + 12, next + SHIFT);
+            const entries = view.getInt32(offset + 20), used = view.getInt32(offset + 24);
+            const offsets = offset + 28 + 8 * entries;
+            for (let i = 0; i < used; i++)
+                view.setBigInt64(offsets + 8 * i, view.getBigInt64(offsets + 8 * i) + SHIFT);
+            patchedEntries += used;
+        }
+        offset += size;
+    }
+    return { patched, patchedEntries };
+}
+
+const path = join(resourcesDir, "a_cdf.cdf");
+const original = new Uint8Array(readFileSync(path));
+const { patched, patchedEntries } = shiftedIndex(original);
+check("VXR entries found", patchedEntries > 0);
+
+// patched file at 0 and again at SHIFT, zeros in between
+const virtualSize = Number(SHIFT) + patched.length;
+let farthest = 0;
+function read(offset, length)
+{
+    const bytes = new Uint8Array(length);
+    const shift = Number(SHIFT);
+    for (const base of [0, shift])
+    {
+        const first = Math.max(offset, base), last = Math.min(offset + length, base + patched.length);
+        if (first < last)
+            bytes.set(patched.subarray(first - base, last - base), first - offset);
+    }
+    farthest = Math.max(farthest, offset + length);
+    return bytes;
+}
+
+const errors = [];
+const consoleError = console.error;
+console.error = (...args) => errors.push(args.join(" "));
+const shifted = Module.load_reader(virtualSize, read);
+console.error = consoleError;
+
+if (kind === "wasm32")
+{
+    check("a 32-bit module refuses files over 4 GiB", !shifted.is_valid()
+        && errors.some(e => e.includes("too large")));
+}
+else
+{
+    const eager = Module.load(original);
+    check("opens a file over 4 GiB", shifted.is_valid() && eager.is_valid());
+    const names = eager.variable_names();
+    check("same variables", shifted.variable_names().join() === names.join());
+    const sameValues = (a, b) => a === b
+        || (a !== undefined && b !== undefined && a.length === b.length
+            && a.every((v, i) => v === b[i] || (Number.isNaN(v) && Number.isNaN(b[i]))));
+    const mismatches = names.filter(
+        name => !sameValues(shifted.get_variable(name).copy_values, eager.get_variable(name).copy_values));
+    check(`values read past 4 GiB match ${mismatches.join()}`, mismatches.length === 0
+        && farthest > 2 ** 32);
+    const saved = shifted.save();
+    check("saves back", saved !== undefined && saved.length > 0
+        && Module.load(saved).variable_names().join() === names.join());
+    eager.delete();
+}
+shifted.delete();
+
+if (failures > 0)
+{
+    console.error(`\n${failures} check(s) failed`);
+    process.exit(1);
+}
+console.log("\nall checks passed");
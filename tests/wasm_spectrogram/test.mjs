@@ -0,0 +1,134 @@
+// Node test: CdfFile.spectrogram (C++ binning and colour mapping against DEPEND_0 and
+// DEPEND_1) matches a pixel by pixel rasterization done here with the spectrogram.js
+// helpers the JS plotting path uses.
+//
+//   node test.mjs <path-to-cdfpp.js>
+
+import { readFileSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { dirname, join } from "node:path";
+import process from "node:process";
+import { viridis, normalizeLevel } from "../../wacdfpp/spectrogram.js";
+
+const [, , modulePath] = process.argv;
+if (!modulePath)
+{
+    console.error("usage: node test.mjs <cdfpp.js>");
+    process.exit(2);
+}
+
+const resourcesDir = join(dirname(fileURLToPath(import.meta.url)), "..", "resources");
+
+const { default: createCdfModule } = await import(modulePath);
+const Module = await createCdfModule();
+
+let failures = 0;
+function check(name, ok)
+{
+    if (ok)
+        console.log(`ok   ${name}`);
+    else
+    {
+        failures += 1;
+        console.error(`FAIL ${name}`);
+    }
+}
+
+// cells of the sorted centers drawn in pixel [low, high): the centers in it, else the
+// cell (midpoints between centers, outer ones extended by half a step) holding its middle
+function cellsOf(centers, low, high)
+{
+    const cells = [];
+    centers.forEach((c, i) => { if (c >= low && c < high) cells.push(i); });
+    if (cells.length)
+        return cells;
+    const n = centers.length, mid = low + (high - low) / 2;
+    const edge = k => k === 0 ? centers[0] - (centers[1] - centers[0]) / 2
+        : k === n ? centers[n - 1] + (centers[n - 1] - centers[n - 2]) / 2
+        : centers[k - 1] + (centers[k] - centers[k - 1]) / 2;
+    for (let i = 0; i < n; i++)
+        if (mid >= edge(i) && mid < edge(i + 1))
+            return [i];
+    return [];
+}
+
+const cdf = Module.load(new Uint8Array(readFileSync(join(resourcesDir, "ge_k0_cpi_19921231_v02.cdf"))));
+check("file loads", cdf.is_valid());
+
+const name = "SW_V";
+const v = cdf.get_variable(name);
+const values = v.copy_values;
+const bins = v.shape[1];
+const fill = v.attributes.FILLVAL?.[0];
+const validMin = v.attributes.VALIDMIN?.[0] ?? -Infinity;
+const validMax = v.attributes.VALIDMAX?.[0] ?? Infinity;
+const ns = cdf.time_values_as_ns_since_1970(v.attributes.DEPEND_0);
+const valid = x => Number.isFinite(x) && x !== fill && x >= validMin && x <= validMax;
+
+const auto = cdf.spectrogram(name, { width: 200, height: 30, zScale: "linear" });
+check("drawn with automatic ranges", auto !== undefined && auto.width === 200
+    && auto.height === 30 && auto.rgba.length === 200 * 30 * 4);
+// cartesian3 labels aren't numbers, rows are the bin indices
+check("bin indices", auto.yScale === "linear" && auto.yMin === -0.5 && auto.yMax === bins - 0.5);
+check("time range covers the records", auto.start < Number(ns[0]) / 1e6
+    && auto.stop > Number(ns[ns.length - 1]) / 1e6);
+
+let zMin = Infinity, zMax = -Infinity;
+for (const x of values)
+    if (valid(x)) { zMin = Math.min(zMin, x); zMax = Math.max(zMax, x); }
+// pixels show the max of their cells, so the automatic range keeps the largest value only
+check("z range of the drawn values", auto.zMin >= zMin && auto.zMax === zMax);
+
+// zoomed out then zoomed in, with explicit ranges
+const startMs = Math.floor(Number(ns[0]) / 1e6) - 30e3;
+for (const [width, height, spanMs] of [[300, 6, 86400e3 + 60e3], [500, 45, 3600e3]])
+{
+    const img = cdf.spectrogram(name, {
+        width, height, start: startMs, stop: startMs + spanMs,
+        yMin: -0.5, yMax: bins - 0.5, zMin, zMax, zScale: "linear",
+    });
+    const start = BigInt(startMs) * 1000000n, span = BigInt(spanMs) * 1000000n;
+    const n = BigInt(width);
+    const edge = k => Number(start + (span / n) * BigInt(k) + (span % n) * BigInt(k) / n);
+    const times = Array.from(ns, Number);
+    const centers = Array.from({ length: bins }, (_, i) => i);
+    let mismatches = 0, drawn = 0;
+    for (let row = 0; row < height; row++)
+    {
+        const y = height - 1 - row;
+        const rowBins = cellsOf(centers, -0.5 + bins * y / height, -0.5 + bins * (y + 1) / height);
+        for (let column = 0; column < width; column++)
+        {
+            let level = -Infinity;
+            for (const r of cellsOf(times, edge(column), edge(column + 1)))
+                for (const b of rowBins)
+                {
+                    const x = values[r * bins + b];
+                    if (valid(x) && x > level) level = x;
+                }
+            const expected = level === -Infinity ? [0, 0, 0, 0]
+                : [...viridis(Math.round(normalizeLevel(level, zMin, zMax, "linear") * 255) / 255), 255];
+            const i = (row * width + column) * 4;
+            const got = Array.from(img.rgba.slice(i, i + 4));
+            drawn += got[3] === 255;
+            if (got.some((c, k) => c !== expected[k]))
+                mismatches += 1;
+        }
+    }
+    // ns as doubles may land a record on the other side of a column edge
+    check(`${width}x${height} matches a pixel by pixel rasterization (${mismatches} off)`,
+        drawn > 0 && mismatches <= width * height / 100);
+}
+
+check("1-D variable can't be drawn", cdf.spectrogram("SW_P_Den", { width: 10, height: 10 }) === undefined);
+check("empty image can't be drawn", cdf.spectrogram(name, { width: 0, height: 10 }) === undefined);
+check("unknown variable", cdf.spectrogram("nope", { width: 10, height: 10 }) === undefined);
+
+cdf.delete();
+
+if (failures > 0)
+{
+    console.error(`\n${failures} check(s) failed`);
+    process.exit(1);
+}
+console.log("\nall checks passed");
@@ -0,0 +1,97 @@
+// Node test for the pthreads WASM module (cdfpp-threads.js, -Dwith_wasm_threads=true).
+//
+// Node runs emscripten pthreads on worker_threads. With the chunk size forced down to 1
+// every parallel path of the library runs on the pool even on the small resource files:
+// CVVR inflation when loading, time conversions and CVVR deflation when saving. Results
+// must match the single threaded module (cdfpp.js) exactly.
+//
+//   node test.mjs <path-to-cdfpp-threads.js> <path-to-cdfpp.js>
+
+import { readdirSync, readFileSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { dirname, join } from "node:path";
+import process from "node:process";
+
+const [, , modulePath, referencePath] = process.argv;
+if (!modulePath || !referencePath)
+{
+    console.error("usage: node test.mjs <cdfpp-threads.js> <cdfpp.js>");
+    process.exit(2);
+}
+
+const resourcesDir = join(dirname(fileURLToPath(import.meta.url)), "..", "resources");
+
+const { default: createThreaded } = await import(modulePath);
+const { default: createReference } = await import(referencePath);
+const Threaded = await createThreaded();
+const Reference = await createReference();
+
+let failures = 0;
+function check(name, ok)
+{
+    if (ok)
+        console.log(`ok   ${name}`);
+    else
+    {
+        failures += 1;
+        console.error(`FAIL ${name}`);
+    }
+}
+
+function sameArray(a, b)
+{
+    if (a === undefined || b === undefined)
+        return a === b;
+    // Object.is so NaN fill values compare equal (NaN !== NaN with ===).
+    return a.length === b.length && a.every((v, i) => Object.is(v, b[i]));
+}
+
+const TIME_TYPES = new Set([31, 32, 33]);
+
+function compareFile(file, bytes)
+{
+    const cdf = Threaded.load(bytes);
+    const ref = Reference.load(bytes);
+    check(`${file} loads`, cdf.is_valid() === ref.is_valid());
+    if (cdf.is_valid() && ref.is_valid())
+    {
+        const mismatches = [];
+        for (const name of ref.variable_names())
+        {
+            if (!sameArray(cdf.get_variable(name).copy_values, ref.get_variable(name).copy_values))
+                mismatches.push(name);
+            else if (TIME_TYPES.has(ref.get_variable_info(name).type)
+                && !sameArray(cdf.time_values_as_ns_since_1970(name),
+                    ref.time_values_as_ns_since_1970(name)))
+                mismatches.push(`${name} (ns)`);
+        }
+        check(`${file} values match the single threaded module`
+            + (mismatches.length ? ` [${mismatches.join(", ")}]` : ""), mismatches.length === 0);
+        check(`${file} saves the same bytes`, sameArray(cdf.save(), ref.save()));
+    }
+    cdf.delete();
+    ref.delete();
+}
+
+check("reference module is single threaded", Reference.num_threads() === 1);
+Reference.set_num_threads(4);
+check("set_num_threads is a no-op without pthreads", Reference.num_threads() === 1);
+
+Threaded.set_num_threads(4);
+check("threaded module runs 4 threads", Threaded.num_threads() === 4);
+Threaded.set_min_chunk_size(1);
+
+for (const file of readdirSync(resourcesDir).filter(f => f.endsWith(".cdf")).sort())
+    compareFile(file, new Uint8Array(readFileSync(join(resourcesDir, file))));
+
+Threaded.set_num_threads(1);
+check("threads can be released", Threaded.num_threads() === 1);
+
+if (failures > 0)
+{
+    console.error(`\n${failures} check(s) failed`);
+    process.exit(1);
+}
+console.log("\nall checks passed");
+// pool workers would keep Node alive
+process.exit(0);
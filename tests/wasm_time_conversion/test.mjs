@@ -1,18 +1,22 @@
-// Node test for CdfFile.time_values_as_ns_since_1970 (WASM build).
+// Node test for CdfFile.time_values_as_ns_since_1970 and time_values_as_strings (WASM build).
 //
 // Oracle values come from pycdfpp's to_datetime64() on the same resource files,
 // which uses the exact same cdf::to_ns_from_1970() leap-second-correct path.
 // Run after building the WASM module:
-//   node test.mjs <path-to-cdfpp.js> <path-to-tests/resources>
+//   node test.mjs <path-to-cdfpp.js> <path-to-tests/resources> [reference-cdfpp.js]
+//
+// With a reference module (the scalar cdfpp.js when testing cdfpp-simd128.js), every
+// time variable of every resource file must also convert to the exact same values in
+// both modules, and a small conversion benchmark of both is printed.
 
-import { readFileSync } from "node:fs";
+import { readdirSync, readFileSync } from "node:fs";
 import { join } from "node:path";
 import process from "node:process";
 
-const [, , modulePath, resourcesDir] = process.argv;
+const [, , modulePath, resourcesDir, referencePath] = process.argv;
 if (!modulePath || !resourcesDir)
 {
-    console.error("usage: node test.mjs <cdfpp.js> <resources_dir>");
+    console.error("usage: node test.mjs <cdfpp.js> <resources_dir> [reference_cdfpp.js]");
     process.exit(2);
 }
 
@@ -34,10 +38,10 @@ function check(name, actual, expected)
     }
 }
 
-function load(file)
+function load(file, module = Module)
 {
     const bytes = new Uint8Array(readFileSync(join(resourcesDir, file)));
-    const cdf = Module.load(bytes);
+    const cdf = module.load(bytes);
     if (!cdf.is_valid())
         throw new Error(`failed to load ${file}`);
     return cdf;
@@ -47,8 +51,8 @@ function load(file)
 //
 // Note on tt2000[0]: its raw J2000 value decodes to 1969-12-31T23:59:59, i.e. before
 // the NASA leap-second table's first entry (1972-01-01). In that undefined extrapolation
-// zone CDFpp's scalar conversion (this WASM build, xsimd gated off non-x86) and its SIMD
-// conversion (pycdfpp on x86) disagree by 9 s. We therefore don't pin element 0 here;
+// zone CDFpp's scalar conversion (cdfpp.js) and its SIMD conversions (cdfpp-simd128.js,
+// pycdfpp on x86) disagree by 9 s. We therefore don't pin element 0 here;
 // leap-second correctness is pinned by testutf8.cdf below (spans the 2015 leap second).
 {
     const cdf = load("a_cdf.cdf");
@@ -87,6 +91,17 @@ function load(file)
             check(`testutf8.cdf/${varname}[${i}]`, ns[i], exp[i]);
     }
 
+    // Same values formatted by the core time formatting engine.
+    const strings = cdf.time_values_as_strings("tt2000", "%Y-%jT%H:%M:%SZ");
+    check("testutf8.cdf/tt2000 strings length", strings.length, expected.tt2000.length);
+    check("testutf8.cdf/tt2000 strings[0]", strings[0], "2015-181T23:59:58.123456789Z");
+    check("testutf8.cdf/tt2000 strings[2]", strings[2], "2015-182T00:00:00.123456789Z");
+    check("testutf8.cdf/tt2000 strings[5]", strings[5], "2015-182T00:00:02.123456789Z");
+    check("unsupported format -> undefined",
+        cdf.time_values_as_strings("tt2000", "%Y %q") === undefined, true);
+    check("non-time var strings -> undefined",
+        cdf.time_values_as_strings("Latitude", "%Y") === undefined, true);
+
     // Non-time variable and missing variable both return undefined.
     check("non-time var -> undefined",
         cdf.time_values_as_ns_since_1970("Latitude") === undefined, true);
@@ -95,6 +110,64 @@ function load(file)
     cdf.delete();
 }
 
+if (referencePath)
+{
+    const { default: createReference } = await import(referencePath);
+    const Reference = await createReference();
+    const TIME_TYPES = new Set([31, 32, 33]);
+    // see the tt2000[0] note above: before 1972 the SIMD and scalar paths may disagree
+    const LEAP_TABLE_START_NS = 63072000000000000n;
+
+    const timeVariables = [];
+    for (const file of readdirSync(resourcesDir).filter(f => f.endsWith(".cdf")).sort())
+    {
+        const bytes = new Uint8Array(readFileSync(join(resourcesDir, file)));
+        const cdf = Module.load(bytes);
+        if (!cdf.is_valid())
+        {
+            cdf.delete();
+            continue;
+        }
+        const ref = Reference.load(bytes);
+        for (const name of cdf.variable_names())
+        {
+            const info = cdf.get_variable_info(name);
+            if (!TIME_TYPES.has(info.type))
+                continue;
+            const ns = cdf.time_values_as_ns_since_1970(name);
+            const expected = ref.time_values_as_ns_since_1970(name);
+            let mismatches = 0;
+            for (let i = 0; i < expected.length; i++)
+            {
+                if (expected[i] >= LEAP_TABLE_START_NS && ns[i] !== expected[i])
+                    mismatches += 1;
+            }
+            check(`${file}/${name} matches reference (${expected.length} values)`,
+                ns.length === expected.length && mismatches === 0, true);
+            timeVariables.push({ file, name, count: expected.length });
+        }
+        ref.delete();
+        cdf.delete();
+    }
+    check("reference comparison covered time variables", timeVariables.length > 0, true);
+
+    // Informational only: the conversion includes the copy into the returned BigInt64Array.
+    const longest = timeVariables.reduce((a, b) => (b.count > a.count ? b : a));
+    for (const [label, module] of [["module", Module], ["reference", Reference]])
+    {
+        const cdf = load(longest.file, module);
+        const rounds = Math.max(1, Math.ceil(2_000_000 / longest.count));
+        cdf.time_values_as_ns_since_1970(longest.name);
+        const start = process.hrtime.bigint();
+        for (let r = 0; r < rounds; r++)
+            cdf.time_values_as_ns_since_1970(longest.name);
+        const elapsed = Number(process.hrtime.bigint() - start);
+        console.log(`bench ${label} ${longest.file}/${longest.name}: `
+            + `${(elapsed / (rounds * longest.count)).toFixed(2)} ns/value`);
+        cdf.delete();
+    }
+}
+
 if (failures > 0)
 {
     console.error(`\n${failures} check(s) failed`);
@@ -2,8 +2,9 @@
 // selection, wire search and list selection to re-render.
 import { loadModule } from "./wasm.js";
 import { rawFromCdfFile, buildModel, filterModel, VAR_GROUPS } from "./cdf-model.js";
-import { renderList, renderDetail, setSelected } from "./render.js";
-import { renderPlot } from "./plot.js";
+import { renderList, renderDetail, renderVariableInfo, setSelected, esc } from "./render.js";
+import { renderPlot, renderMinMaxPlot, MINMAX_BUCKETS } from "./plot.js";
+import { openLazy } from "./lazy-cdf.js";
 import { openValidation, openValidationBytes } from "./astralint.js";
 import { runCompare, setView, setFilter } from "./compare.js";
 import { toYaml, buildSkeleton } from "./cdf-yaml.js";
@@ -38,8 +39,13 @@ const els = {
     filterToggle: document.getElementById("filterToggle"),
 };
 
+// Local files above this size are opened lazily in a worker (lazy-cdf.js) instead of
+// being read whole into WASM memory.
+const LAZY_LOAD_BYTES = 512 * 1024 * 1024;
+
 let Module;
 let currentCdf;          // live CdfFile — delete before replacing
+let currentLazy;         // LazyCdf of a file opened in a worker — close before replacing
 let currentModel;        // built once per file
 let currentUrl = null;   // source URL of the loaded file (null for local/drag-drop)
 let currentBytes = null; // raw bytes of the loaded file (for the postMessage handoff)
@@ -55,7 +61,7 @@ function updateValidate() {
     els.validateBtn.title = ready
         ? "Validate this CDF against ISTP in AstraLint"
         : "Load a CDF to validate it against ISTP in AstraLint";
-    const exportable = !!currentCdf;
+    const exportable = !!(currentCdf || currentLazy);
     els.exportYamlBtn.disabled = !exportable;
     els.exportYamlBtn.title = exportable
         ? "Download a YAML metadata skeleton of this CDF"
@@ -71,14 +77,69 @@ function refreshList() {
 
 function selectVariable(name) {
     selectedName = name;
+    if (currentLazy) { selectLazyVariable(name); return; }
     renderDetail(els.detail, currentCdf, name);
     const mount = els.detail.querySelector(".plot-panel");
     if (mount && currentCdf) renderPlot(mount, currentCdf, name);
     setSelected(els.varlist, name);   // highlight in place; don't rebuild (keeps groups' open state)
 }
 
-function inspect(data, name, sourceUrl) {
+// Lazily opened files: metadata comes from the worker, the plot from its min/max
+// decimation, so only the records of the selected variable and its DEPEND_0 are read.
+async function selectLazyVariable(name) {
+    const lazy = currentLazy;
+    const stale = () => lazy !== currentLazy || selectedName !== name;
+    setSelected(els.varlist, name);
+    els.detail.innerHTML = `<div class="log-dim">Reading ${esc(name)}...</div>`;
+    try {
+        const v = await lazy.info(name);
+        if (stale()) return;
+        els.detail.innerHTML = "";
+        if (!v) { els.detail.innerHTML = `<div class="log-err">Variable not found</div>`; return; }
+        renderVariableInfo(els.detail, name, v);
+        const mount = els.detail.querySelector(".plot-panel");
+        mount.innerHTML = `<div class="plot-note">Reading values...</div>`;
+        const mm = await lazy.minmax(name, MINMAX_BUCKETS);
+        if (!stale()) renderMinMaxPlot(mount, name, mm);
+    } catch (err) {
+        if (!stale()) els.detail.innerHTML = `<div class="log-err">ERROR: ${esc(err.message)}</div>`;
+    }
+}
+
+function closeCurrent() {
     if (currentCdf) { currentCdf.delete(); currentCdf = undefined; }
+    if (currentLazy) { currentLazy.close(); currentLazy = undefined; }
+}
+
+async function inspectLazy(file) {
+    closeCurrent();
+    const t0 = performance.now();
+    let lazy, opened;
+    try { [lazy, opened] = await openLazy(file); }
+    catch (err) {
+        setStatus("error", `Failed to parse ${file.name}: ${err.message}`);
+        return;
+    }
+    const dt = (performance.now() - t0).toFixed(1);
+    currentLazy = lazy;
+    currentModel = buildModel(opened.rawVars, opened.rawGlobals);
+    selectedName = null;
+    searchQuery = "";
+    els.search.value = "";
+    currentUrl = null;
+    currentBytes = null;   // never read whole, so no AstraLint handoff
+    currentName = file.name;
+    currentCompression = opened.compression;
+    updateValidate();
+    els.fileName.textContent = file.name;
+    els.parseTime.textContent = `metadata parsed in ${dt} ms`;
+    els.detail.innerHTML = `<div class="log-dim">Select a variable to inspect.</div>`;
+    refreshList();
+    setStatus("ready", `Opened ${file.name} lazily (${file.size.toLocaleString()} bytes)`);
+}
+
+function inspect(data, name, sourceUrl) {
+    closeCurrent();
     const t0 = performance.now();
     const cdf = Module.load(data);
     const dt = (performance.now() - t0).toFixed(1);
@@ -127,6 +188,10 @@ function loadFile(file) {
     if (!Module || busy) return;
     busy = true;
     setStatus("loading", `Loading ${file.name}...`);
+    if (file.size > LAZY_LOAD_BYTES && typeof Worker !== "undefined") {
+        inspectLazy(file).then(() => syncUrl(new URLSearchParams())).finally(() => { busy = false; });
+        return;
+    }
     const reader = new FileReader();
     reader.onload = (e) => {
         try { inspect(new Uint8Array(e.target.result), file.name, null); syncUrl(new URLSearchParams()); }
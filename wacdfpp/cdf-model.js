@@ -50,13 +50,12 @@ export function filterModel(model, query) {
     return { globalAttributes, groups };
 }
 
-// Browser-only: read a loaded CdfFile into raw records for buildModel.
-// NOTE: get_variable() currently force-loads values (see wacdfpp.cpp); we keep
-// only metadata here (attributes are owned copies, safe) and re-fetch values
-// lazily on selection. A metadata-only binding is a future (Phase 2+) optimization.
+// Read a loaded CdfFile into raw records for buildModel (browser or worker).
+// get_variable_info() leaves values alone, so listing a lazily loaded file only
+// reads its metadata; values are fetched on selection.
 export function rawFromCdfFile(cdf) {
     const rawVars = cdf.variable_names().map(name => {
-        const v = cdf.get_variable(name);
+        const v = cdf.get_variable_info(name);
         const attributes = {};
         const attributeTypes = {};
         for (const an of v.attribute_names) {
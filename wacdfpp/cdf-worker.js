@@ -0,0 +1,47 @@
+// Module worker hosting one lazily opened CdfFile (see lazy-cdf.js for the page side).
+// The File is never copied into WASM memory: the module reads the slices it needs
+// through FileReaderSync, which only exists in workers, so browsing a multi-GB file
+// costs its metadata plus the values of the variables actually plotted. Files over 4 GB
+// need the Memory64 module, the 32-bit one refuses them.
+// Protocol: { id, op, ...args } -> { id, result } | { id, error }.
+import { loadLargeFileModule, loadModule, WASM32_MAX_FILE_SIZE } from "./wasm.js";
+import { rawFromCdfFile } from "./cdf-model.js";
+
+let cdf;
+
+// read(offset, length) callback for Module.load_reader over a File/Blob.
+function blobReader(blob) {
+    const reader = new FileReaderSync();
+    return (offset, length) => new Uint8Array(reader.readAsArrayBuffer(blob.slice(offset, offset + length)));
+}
+
+function close() {
+    if (cdf) { cdf.delete(); cdf = undefined; }
+}
+
+const ops = {
+    async open({ file }) {
+        close();
+        const Module = file.size > WASM32_MAX_FILE_SIZE
+            ? await loadLargeFileModule() : await loadModule();
+        const opened = Module.load_reader(file.size, blobReader(file));
+        if (!opened.is_valid()) {
+            opened.delete();
+            throw new Error(`failed to parse ${file.name}`);
+        }
+        cdf = opened;
+        return { ...rawFromCdfFile(cdf), compression: cdf.compression() };
+    },
+    info({ name }) { return cdf?.get_variable_info(name); },
+    minmax({ name, buckets }) { return cdf?.minmax(name, buckets); },
+    close() { close(); },
+};
+
+self.onmessage = async ({ data: { id, op, ...args } }) => {
+    try {
+        if (!(op in ops)) throw new Error(`unknown operation ${op}`);
+        self.postMessage({ id, result: await ops[op](args) });
+    } catch (err) {
+        self.postMessage({ id, error: err?.message ?? String(err) });
+    }
+};
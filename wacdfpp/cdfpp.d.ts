@@ -53,6 +53,60 @@ export interface Variable {
     readonly copy_values: TypedArray | undefined;
 }
 
+/**
+ * Per bucket reduction of a variable, see CdfFile.minmax. `edges` holds the
+ * buckets + 1 bucket edges in ms since 1970 UTC, the other arrays one value per
+ * bucket and component ([bucket][component]).
+ */
+export interface MinMax {
+    readonly components: number;
+    readonly edges: Float64Array;
+    readonly min: Float64Array;
+    readonly max: Float64Array;
+    readonly first: Float64Array;
+    readonly last: Float64Array;
+}
+
+/**
+ * Options of CdfFile.spectrogram: the image size in pixels, then optional ranges
+ * (missing or NaN is automatic) and scales (default to the DEPEND_1 and variable
+ * SCALETYP, else linear bins and a log colour scale).
+ */
+export interface SpectrogramOptions {
+    width: number;
+    height: number;
+    /** time range in ms since 1970 UTC, the outer time cells by default */
+    start?: number;
+    stop?: number;
+    /** bins axis range, the outer bin cells by default */
+    yMin?: number;
+    yMax?: number;
+    yScale?: "log" | "linear";
+    /** colour range, the range of the drawn pixels by default */
+    zMin?: number;
+    zMax?: number;
+    zScale?: "log" | "linear";
+}
+
+/**
+ * Spectrogram image, see CdfFile.spectrogram. The ranges and scales are the ones
+ * actually drawn (zMin/zMax are NaN when no pixel has data), `rgba` is in ImageData
+ * layout (top row first) and transparent where there is no data.
+ */
+export interface Spectrogram {
+    readonly width: number;
+    readonly height: number;
+    readonly start: number;
+    readonly stop: number;
+    readonly yMin: number;
+    readonly yMax: number;
+    readonly yScale: "log" | "linear";
+    readonly zMin: number;
+    readonly zMax: number;
+    readonly zScale: "log" | "linear";
+    readonly rgba: Uint8ClampedArray;
+}
+
 /** A CDF global attribute with one or more entries */
 export interface Attribute {
     readonly name: string;
@@ -71,6 +125,11 @@ export interface CdfFile {
     variable_names(): string[];
     attribute_names(): string[];
     get_variable(name: string): Variable;
+    /**
+     * Variable metadata without its values (no `values`/`copy_values`): values of a
+     * lazily opened file (see CdfModule.load_reader) stay on the file.
+     */
+    get_variable_info(name: string): Omit<Variable, "values" | "copy_values"> | undefined;
 
     /**
      * UTC nanoseconds since 1970 (leap-second corrected) for a time variable
@@ -79,6 +138,32 @@ export interface CdfFile {
      */
     time_values_as_ns_since_1970(name: string): BigInt64Array | undefined;
 
+    /**
+     * Time variable values formatted with a strftime like format, supporting
+     * %Y %m %d %j %H %M %S (with sub-seconds) and %%. Same engine as pycdfpp's
+     * to_time_string. Returns undefined for non-time variables or unsupported formats.
+     */
+    time_values_as_strings(name: string, format: string): string[] | undefined;
+
+    /**
+     * Min/max decimation of a numeric variable against its DEPEND_0 time axis, for
+     * plotting: the time axis is split in `buckets` even buckets (one per pixel column)
+     * reduced to their min/max/first/last values per component, FILLVAL and NaN
+     * skipped (empty buckets are NaN). minmax covers the whole time axis, minmax_range
+     * [startMs, stopMs) in ms since 1970 UTC. Returns undefined when the variable has no
+     * usable DEPEND_0 or isn't numeric.
+     */
+    minmax(name: string, buckets: number): MinMax | undefined;
+    minmax_range(name: string, buckets: number, startMs: number, stopMs: number): MinMax | undefined;
+
+    /**
+     * Spectrogram of a 2-D variable against its DEPEND_0 time axis and DEPEND_1 bins
+     * (bin indices without a usable DEPEND_1), binned and colour mapped (viridis) in one
+     * pass: a pixel shows the max of the cells in it, FILLVAL, NaN and values out of
+     * VALIDMIN/VALIDMAX skipped. Returns undefined when the variable can't be drawn.
+     */
+    spectrogram(name: string, options: SpectrogramOptions): Spectrogram | undefined;
+
     get_attribute(name: string): Attribute;
     majority(): string;
     compression(): string;
@@ -94,6 +179,30 @@ export interface CdfModule {
     /** Load a CDF file from a Uint8Array buffer */
     load(data: Uint8Array): CdfFile;
 
+    /**
+     * Open a CDF file of `size` bytes without copying it into WASM memory:
+     * `read(offset, length)` must synchronously return a Uint8Array of exactly
+     * those bytes (e.g. a File slice read with FileReaderSync in a worker). Only
+     * metadata is read here, variable values are read on first access and the
+     * CdfFile keeps `read` alive until deleted. Limited to 4 GiB files on wasm32,
+     * the Memory64 module (cdfpp-memory64.js) has no such limit.
+     */
+    load_reader(size: number, read: (offset: number, length: number) => Uint8Array): CdfFile;
+
+    /**
+     * Threads (calling thread included) bulk operations may use: decompression,
+     * time conversions and saving. Always 1 except in the pthreads module
+     * (cdfpp-threads.js), where it defaults to the cores available, up to the
+     * web workers spawned at startup.
+     */
+    num_threads(): number;
+
+    /** 0 restores the default, 1 disables threading (no-op outside cdfpp-threads.js) */
+    set_num_threads(threads: number): void;
+
+    /** Smallest number of elements (or bytes) worth handing to another thread */
+    set_min_chunk_size(elements: number): void;
+
     /** Get the string name of a CDF data type */
     type_name(type: DataType): string;
 
@@ -135,5 +244,10 @@ export interface CdfModule {
     };
 }
 
-/** Initialize the CDFpp WASM module */
+/**
+ * Initialize the CDFpp WASM module. cdfpp-simd128.js, when built, exports the same
+ * API from a -msimd128 module that only loads on engines supporting WASM SIMD128,
+ * cdfpp-memory64.js from a 64-bit heap module (Memory64, Node >= 24 or
+ * --experimental-wasm-memory64) whose sizes and offsets are still plain numbers.
+ */
 export default function createCdfModule(): Promise<CdfModule>;
@@ -0,0 +1,59 @@
+// Page side of cdf-worker.js: a local File opened lazily in a dedicated worker, for
+// files too large to be read into memory. Every call is forwarded to the worker and
+// resolves with its answer, close() terminates the worker.
+
+export class LazyCdf {
+    #worker;
+    #pending = new Map();
+    #next = 0;
+
+    constructor(worker) {
+        this.#worker = worker;
+        worker.onmessage = ({ data: { id, result, error } }) => {
+            const call = this.#pending.get(id);
+            if (!call) return;
+            this.#pending.delete(id);
+            if (error !== undefined) call.reject(new Error(error));
+            else call.resolve(result);
+        };
+        worker.onerror = (e) => this.#failAll(new Error(e.message || "CDF worker failed"));
+    }
+
+    #call(op, args = {}) {
+        return new Promise((resolve, reject) => {
+            const id = this.#next++;
+            this.#pending.set(id, { resolve, reject });
+            this.#worker.postMessage({ id, op, ...args });
+        });
+    }
+
+    #failAll(err) {
+        for (const call of this.#pending.values()) call.reject(err);
+        this.#pending.clear();
+    }
+
+    /** Parse the file metadata: { rawVars, rawGlobals, compression } (see cdf-model.js). */
+    open(file) { return this.#call("open", { file }); }
+
+    /** CdfFile.get_variable_info, values aren't read. */
+    info(name) { return this.#call("info", { name }); }
+
+    /** CdfFile.minmax, only the records of `name` and its DEPEND_0 are read. */
+    minmax(name, buckets) { return this.#call("minmax", { name, buckets }); }
+
+    close() {
+        this.#worker.terminate();
+        this.#failAll(new Error("CDF worker closed"));
+    }
+}
+
+// Opens `file` in a new worker, resolves with [LazyCdf, metadata] once parsed.
+export async function openLazy(file) {
+    const lazy = new LazyCdf(new Worker(new URL("./cdf-worker.js", import.meta.url), { type: "module" }));
+    try {
+        return [lazy, await lazy.open(file)];
+    } catch (err) {
+        lazy.close();
+        throw err;
+    }
+}
@@ -97,6 +97,26 @@ export function decimateMinMax(x, y, targetCols) {
     return { x: rx, y: ry };
 }
 
+// Line series from a CdfFile.minmax result (C++ min/max decimation, see cdfpp.d.ts):
+// two points per bucket at its center (Unix seconds), min and max in the order they most
+// likely occurred according to the bucket first/last values. Empty buckets are NaN gaps.
+// Returns { x, ys } with one ys array per component.
+export function minMaxSeries({ components, edges, min, max, first, last }) {
+    const buckets = edges.length - 1;
+    const x = new Float64Array(2 * buckets);
+    const ys = Array.from({ length: components }, () => new Float64Array(2 * buckets));
+    for (let b = 0; b < buckets; b++) {
+        x[2 * b] = x[2 * b + 1] = (edges[b] + edges[b + 1]) / 2e3;
+        for (let c = 0; c < components; c++) {
+            const i = b * components + c;
+            const maxFirst = first[i] === max[i] || last[i] === min[i];
+            ys[c][2 * b] = maxFirst ? max[i] : min[i];
+            ys[c][2 * b + 1] = maxFirst ? min[i] : max[i];
+        }
+    }
+    return { x, ys };
+}
+
 // columns: [{ name, values: any[] }, ...] with equal-length value arrays.
 function csvCell(v) {
     const s = v == null ? "" : String(v);
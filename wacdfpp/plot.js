@@ -4,12 +4,13 @@
 // Reuses nsToISO from render.js for faithful time export (render.js has no import
 // side effects, so this stays one-directional: render.js never imports plot.js).
 import uPlot from "./uPlot.esm.js";
-import { plotSpec, applyMask, decimateMinMax, toCSV, toJSON } from "./plot-model.js";
+import { plotSpec, applyMask, decimateMinMax, minMaxSeries, toCSV, toJSON } from "./plot-model.js";
 import { viridis, normalizeLevel, cellEdges, scaleTypeOf, isMonotonic } from "./spectrogram.js";
 import { nsToISO } from "./render.js";
 
 const LINE_COLORS = ["#6c8aff", "#4ade80", "#fbbf24", "#f87171", "#22d3ee", "#c084fc", "#fb923c", "#a3e635"];
 const MAX_POINTS = 8000;   // line decimation cap
+export const MINMAX_BUCKETS = MAX_POINTS / 2;  // CdfFile.minmax buckets (2 points each)
 const MAX_COLS = 4000;     // spectrogram column cap
 const PLOT_HEIGHT = 320;
 
@@ -156,7 +157,15 @@ function drawLines(target, cdf, meta, spec, x, values) {
 
     const series = [{ label: x.isTime ? "time" : "record" }];
     const data = [];
-    if (comps === 1) {
+    const reduced = x.isTime && recCount > MAX_POINTS ? wasmMinMax(cdf, meta, spec) : null;
+    if (reduced) {
+        // Large time series: reduced in WASM, one min/max pair per column and component.
+        data.push(reduced.x);
+        for (let c = 0; c < comps; c++) {
+            data.push(reduced.ys[c]);
+            series.push({ label: labels[c], stroke: LINE_COLORS[c % LINE_COLORS.length], width: 1, spanGaps: false });
+        }
+    } else if (comps === 1) {
         // Single series: min/max decimation preserves spikes against a shared x.
         const masked = applyMask(deinterleave(values, comps, recCount, 0), spec);
         const reduced = decimateMinMax(xs, masked, MAX_POINTS / 2);
@@ -185,6 +194,18 @@ function drawLines(target, cdf, meta, spec, x, values) {
     new uPlot(opts, data, target);
 }
 
+// Min/max decimation against DEPEND_0 in C++ (CdfFile.minmax). It only skips FILLVAL,
+// so variables with a VALIDMIN/VALIDMAX keep the JS path and its applyMask.
+function wasmMinMax(cdf, meta, spec) {
+    if (!spec.depend0 || spec.validMin !== undefined || spec.validMax !== undefined) return null;
+    try {
+        const mm = cdf.minmax(meta.name, MINMAX_BUCKETS);
+        if (!mm) return null;
+        const { x, ys } = minMaxSeries(mm);
+        return { x: Array.from(x), ys: ys.map(y => Array.from(y)) };
+    } catch { return null; }
+}
+
 // Block-max decimate a column-major grid (grid[col*rows+row]) down to `outCols`
 // columns, taking the per-bin max over each block so bright features survive.
 function decimateGridCols(grid, fullCols, rows, step, outCols) {
@@ -257,7 +278,72 @@ function colorbar(min, max, scale, units) {
     return el;
 }
 
+// Spectrogram binned and colour mapped in C++ (CdfFile.spectrogram) at the plot area
+// size, re-rasterized on zoom: one image per draw instead of one rect per cell. The
+// colour range is pinned to the full view's so that the colorbar holds while zooming.
+// Returns false when it can't be drawn that way (no time DEPEND_0), keeping the JS path.
+function drawWasmSpectro(target, cdf, meta, spec, x, scale) {
+    if (!spec.depend0 || !x.isTime || typeof cdf.spectrogram !== "function") return false;
+    const rows = Math.max(1, spec.components);
+    let full;
+    try {
+        full = cdf.spectrogram(meta.name, {
+            width: Math.max(1, Math.min(x.values.length, MAX_COLS)), height: rows, zScale: scale,
+        });
+    } catch { return false; }
+    if (!full) return false;
+    if (!Number.isFinite(full.zMin) || full.zMin === full.zMax) {
+        target.appendChild(note("no finite values to display at this scale"));
+        return true;
+    }
+
+    const bins = resolveBins(cdf, spec, rows);
+    const units = typeof meta.attributes?.UNITS === "string" ? meta.attributes.UNITS : "";
+    const wrap = document.createElement("div");
+    wrap.className = "spectro-wrap";
+    const plotEl = document.createElement("div");
+    plotEl.className = "spectro-plot";
+    wrap.append(plotEl, colorbar(full.zMin, full.zMax, scale, units));
+    target.appendChild(wrap);
+
+    const scratch = document.createElement("canvas");
+    const paint = (u) => {
+        const width = Math.round(u.bbox.width), height = Math.round(u.bbox.height);
+        if (width < 1 || height < 1) return;
+        const img = cdf.spectrogram(meta.name, {
+            width, height,
+            start: u.scales.x.min * 1e3, stop: u.scales.x.max * 1e3,
+            yMin: u.scales.y.min, yMax: u.scales.y.max, yScale: full.yScale,
+            zMin: full.zMin, zMax: full.zMax, zScale: scale,
+        });
+        if (!img) return;
+        scratch.width = width;
+        scratch.height = height;
+        scratch.getContext("2d").putImageData(new ImageData(img.rgba, width, height), 0, 0);
+        u.ctx.drawImage(scratch, u.bbox.left, u.bbox.top);
+    };
+
+    // Two points spanning the outer time cells give uPlot its x auto-range, a range
+    // function (not a static array) keeps drag-zoom working as in drawSpectro.
+    const opts = {
+        width: (plotEl.clientWidth || 700),
+        height: PLOT_HEIGHT,
+        scales: {
+            x: { time: true, range: (u, dmin, dmax) => [dmin, dmax] },
+            y: { distr: full.yScale === "log" ? 3 : 1, range: [full.yMin, full.yMax] },
+        },
+        axes: [themeAxis(), themeAxis(bins.units ? { label: bins.units } : undefined)],
+        series: [{}, { paths: () => null, points: { show: false } }],
+        legend: { show: false },
+        cursor: { drag: { x: true, y: false } },
+        hooks: { draw: [paint] },
+    };
+    new uPlot(opts, [[full.start / 1e3, full.stop / 1e3], [null, null]], plotEl);
+    return true;
+}
+
 function drawSpectro(target, cdf, meta, spec, x, values, scale) {
+    if (drawWasmSpectro(target, cdf, meta, spec, x, scale)) return;
     const fullCols = x.values.length;
     const rows = Math.max(1, spec.components);
     const masked = applyMask(values, spec);
@@ -365,7 +451,7 @@ export function renderPlot(mount, cdf, name) {
     const v = cdf.get_variable(name);
     if (!v) return;
 
-    const meta = { type: v.type, shape: Array.from(v.shape), attributes: v.attributes };
+    const meta = { name, type: v.type, shape: Array.from(v.shape), attributes: v.attributes };
 
     // Gate from metadata BEFORE materializing values: copy_values copies the whole
     // variable, so a high-rank/oversized distribution would OOM here. plotSpec (no
@@ -416,3 +502,31 @@ export function renderPlot(mount, cdf, name) {
 
     redraw();
 }
+
+// Plot panel of a lazily opened file (lazy-cdf.js): only the min/max decimation done in
+// its worker is at hand, drawn as one line per component. `mm` is a CdfFile.minmax result,
+// undefined when the variable isn't a numeric series against a time DEPEND_0.
+export function renderMinMaxPlot(mount, name, mm) {
+    mount.innerHTML = "";
+    if (!mm) { mount.appendChild(note("not plottable: needs a numeric variable with a time DEPEND_0")); return; }
+    const { x, ys } = minMaxSeries(mm);
+    const data = [Array.from(x)];
+    const series = [{ label: "time" }];
+    ys.forEach((y, c) => {
+        data.push(Array.from(y));
+        series.push({ label: mm.components > 1 ? `comp ${c}` : name, stroke: LINE_COLORS[c % LINE_COLORS.length], width: 1, spanGaps: false });
+    });
+    const body = document.createElement("div");
+    body.className = "plot-body";
+    mount.appendChild(body);
+    const opts = {
+        width: body.clientWidth || 800,
+        height: PLOT_HEIGHT,
+        scales: { x: { time: true } },
+        axes: [themeAxis(), themeAxis()],
+        series,
+        legend: { show: mm.components > 1 },
+        cursor: { drag: { x: true, y: false } },
+    };
+    new uPlot(opts, data, body);
+}
@@ -227,7 +227,24 @@ export function renderDetail(container, cdf, name) {
         container.innerHTML = `<div class="log-err">Variable not found: ${esc(name)}</div>`;
         return;
     }
+    renderVariableInfo(container, name, v);
 
+    const { table, total, shown, reason } = previewTable(cdf, v);
+    if (reason) {
+        container.appendChild(sectionLabel(`Values (${total} records)`));
+        const skipped = document.createElement("div");
+        skipped.className = "plot-note";
+        skipped.textContent = reason;
+        container.appendChild(skipped);
+    } else {
+        container.appendChild(sectionLabel(`Values (showing ${shown} of ${total})`));
+        container.appendChild(table);
+    }
+}
+
+// Title, plot mount and attributes of a variable from its metadata alone (a
+// get_variable or get_variable_info object), appended to `container`.
+export function renderVariableInfo(container, name, v) {
     const head = document.createElement("div");
     head.className = "detail-title";
     head.innerHTML = `<span class="log-key">${esc(name)}</span> ` +
@@ -256,16 +273,4 @@ export function renderDetail(container, cdf, name) {
         attrs.appendChild(row);
     }
     container.append(sectionLabel("Attributes"), attrs);
-
-    const { table, total, shown, reason } = previewTable(cdf, v);
-    if (reason) {
-        container.appendChild(sectionLabel(`Values (${total} records)`));
-        const skipped = document.createElement("div");
-        skipped.className = "plot-note";
-        skipped.textContent = reason;
-        container.appendChild(skipped);
-    } else {
-        container.appendChild(sectionLabel(`Values (showing ${shown} of ${total})`));
-        container.appendChild(table);
-    }
 }
@@ -1,7 +1,8 @@
 // Pure helpers for the spectrogram (no DOM, Node unit-tested): viridis colormap,
 // normalizeLevel (log/linear), cellEdges (bin/time cell boundaries), scaleTypeOf
-// (ISTP SCALETYP), isMonotonic. The heatmap itself is painted in plot.js via a
-// uPlot draw hook using these helpers.
+// (ISTP SCALETYP), isMonotonic. The heatmap itself is rasterized in C++
+// (CdfFile.spectrogram, same colormap) when the variable has a time DEPEND_0, else
+// painted in plot.js via a uPlot draw hook using these helpers.
 
 const VIRIDIS_ANCHORS = [
     [68, 1, 84], [72, 40, 120], [62, 74, 137], [49, 104, 142], [38, 130, 142],
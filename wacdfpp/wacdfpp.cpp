@@ -24,16 +24,23 @@
 -- Mail : alexis.jeandet@member.fsf.org
 ----------------------------------------------------------------------------*/
 #include <cdfpp/cdf.hpp>
+#include <cdfpp/cdf-decimation.hpp>
 #include <cdfpp/cdf-io/saving/saving.hpp>
-#include <cdfpp/cdf-repr.hpp>
+#include <cdfpp/cdf-parallel.hpp>
+#include <cdfpp/cdf-spectrogram.hpp>
 #include <cdfpp/chrono/cdf-chrono.hpp>
+#include <cdfpp/chrono/cdf-time-format.hpp>
 
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
-#include <sstream>
+#include <limits>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace em = emscripten;
@@ -89,16 +96,109 @@ em::val typed_array_view(const char* ptr, std::size_t byte_count, cdf::CDF_Types
     }
 }
 
+// Sizes and offsets cross over to JS as doubles: in the Memory64 build (cdfpp-memory64.js)
+// embind hands size_t over as a BigInt, which typed array constructors and set() reject.
+// Doubles are exact up to 2^53 bytes, far beyond any wasm heap or file opened here.
+double js_size(std::size_t size)
+{
+    return static_cast<double>(size);
+}
+
+std::size_t js_length(const em::val& array)
+{
+    return static_cast<std::size_t>(array["length"].as<double>());
+}
+
 constexpr bool is_time_type(cdf::CDF_Types type)
 {
     using enum cdf::CDF_Types;
     return type == CDF_EPOCH || type == CDF_EPOCH16 || type == CDF_TIME_TT2000;
 }
 
+// Results handed to JS are produced chunk by chunk into a scratch buffer and copied into a
+// typed array allocated up front with its final size: peak memory is that array plus one
+// chunk instead of a second full size copy (a vector then a slice() of a view on it).
+// Chunks stay large enough for bulk conversions to still use the whole thread pool.
+template <typename T, typename fill_t>
+em::val to_js_array(const char* js_type, std::size_t size, fill_t&& fill)
+{
+    auto array = em::val::global(js_type).new_(js_size(size));
+    const auto chunk = std::min(size,
+        std::max<std::size_t>(
+            1 << 16, cdf::parallel::min_chunk_size() * cdf::parallel::num_threads()));
+    no_init_vector<T> scratch(chunk);
+    for (std::size_t first = 0; first < size; first += chunk)
+    {
+        const auto count = std::min(chunk, size - first);
+        fill(first, count, scratch.data());
+        array.call<void>(
+            "set", em::val(em::typed_memory_view(count, scratch.data())), js_size(first));
+    }
+    return array;
+}
+
+// Saving writer filling a Uint8Array allocated with the final file size (see
+// cdf::io::save(cdf, make_writer)): descriptor records are tiny and many, so they are batched
+// before crossing over to JS, large values are copied straight in. Flushes on destruction.
+struct js_array_writer
+{
+    static constexpr std::size_t batch_size = 1 << 16;
+    em::val array;
+    std::size_t global_offset = 0;
+    std::vector<char> batch = {};
+
+    js_array_writer(em::val array) : array { std::move(array) } { batch.reserve(batch_size); }
+    js_array_writer(js_array_writer&&) = default;
+    ~js_array_writer() { flush(); }
+
+    std::size_t write(const char* const data_ptr, std::size_t count)
+    {
+        if (std::size(batch) + count > batch_size)
+            flush();
+        if (count >= batch_size)
+            copy(data_ptr, count, global_offset);
+        else
+            batch.insert(std::end(batch), data_ptr, data_ptr + count);
+        return global_offset += count;
+    }
+
+    std::size_t fill(const char v, std::size_t count)
+    {
+        while (count != 0)
+        {
+            const auto n = std::min(count, batch_size - std::size(batch));
+            batch.insert(std::end(batch), n, v);
+            global_offset += n;
+            count -= n;
+            if (std::size(batch) == batch_size)
+                flush();
+        }
+        return global_offset;
+    }
+
+    [[nodiscard]] std::size_t offset() const noexcept { return global_offset; }
+
+private:
+    void copy(const char* data_ptr, std::size_t count, std::size_t offset)
+    {
+        array.call<void>("set",
+            em::val(em::typed_memory_view(count, reinterpret_cast<const uint8_t*>(data_ptr))),
+            js_size(offset));
+    }
+
+    void flush()
+    {
+        if (std::empty(batch))
+            return;
+        copy(batch.data(), std::size(batch), global_offset - std::size(batch));
+        batch.clear();
+    }
+};
+
 // Decode a contiguous buffer of CDF time values (CDF_TIME_TT2000 / CDF_EPOCH /
 // CDF_EPOCH16) to leap-second-corrected UTC nanoseconds since 1970, returned as
-// an owned BigInt64Array (the JS analog of datetime64[ns]). Returns undefined
-// for non-time types or an empty buffer.
+// an owned BigInt64Array (the JS analog of datetime64[ns]) converted into directly
+// (see to_js_array). Returns undefined for non-time types or an empty buffer.
 em::val time_buffer_to_ns(const char* ptr, std::size_t byte_count, cdf::CDF_Types type)
 {
     using enum cdf::CDF_Types;
@@ -108,37 +208,33 @@ em::val time_buffer_to_ns(const char* ptr, std::size_t byte_count, cdf::CDF_Type
     if (n == 0)
         return em::val::undefined();
 
-    std::vector<int64_t> out(n);
+    const auto convert = [n]<typename time_t>(const time_t* values)
+    {
+        return to_js_array<int64_t>("BigInt64Array", n,
+            [values](std::size_t first, std::size_t count, int64_t* out)
+            { cdf::to_ns_from_1970(std::span<const time_t>(values + first, count), out); });
+    };
     switch (type)
     {
         case CDF_TIME_TT2000:
-            cdf::to_ns_from_1970(
-                std::span<const cdf::tt2000_t>(reinterpret_cast<const cdf::tt2000_t*>(ptr), n),
-                out.data());
-            break;
+            return convert(reinterpret_cast<const cdf::tt2000_t*>(ptr));
         case CDF_EPOCH:
-            cdf::to_ns_from_1970(
-                std::span<const cdf::epoch>(reinterpret_cast<const cdf::epoch*>(ptr), n),
-                out.data());
-            break;
+            return convert(reinterpret_cast<const cdf::epoch*>(ptr));
         case CDF_EPOCH16:
-            cdf::to_ns_from_1970(
-                std::span<const cdf::epoch16>(reinterpret_cast<const cdf::epoch16*>(ptr), n),
-                out.data());
-            break;
+            return convert(reinterpret_cast<const cdf::epoch16*>(ptr));
         default:
             return em::val::undefined();
     }
-    // owned BigInt64Array copy (out dies after return)
-    return em::val(em::typed_memory_view(n, out.data())).call<em::val>("slice");
 }
 
-// Decode a buffer of CDF time values to an array of ISO-8601 date strings, reusing
-// cdfpp's repr formatters (cdf-repr.hpp). Those special-case the standard CDF fill
-// sentinels (e.g. EPOCH -1e31 / TT2000 INT64_MIN -> "9999-12-31...") and handle the
-// full date range, so a VALIDMIN/VALIDMAX/FILLVAL renders exactly as in pycdfpp
-// instead of as a raw number or an int64-ns overflow.
-em::val time_buffer_to_iso(const char* ptr, std::size_t byte_count, cdf::CDF_Types type)
+// Decode a buffer of CDF time values to an array of date strings with the core
+// time formatting engine (cdf-time-format.hpp), the same one pycdfpp's to_time_string
+// uses. It renders the standard CDF fill/pad sentinels (e.g. EPOCH -1e31 / TT2000
+// INT64_MIN -> "9999-12-31...") like cdf-repr.hpp and handles the full date range, so
+// a VALIDMIN/VALIDMAX/FILLVAL renders exactly as in pycdfpp instead of as a raw number
+// or an int64-ns overflow.
+em::val time_buffer_to_strings(const char* ptr, std::size_t byte_count, cdf::CDF_Types type,
+    std::string_view format = "%Y-%m-%dT%H:%M:%S")
 {
     using enum cdf::CDF_Types;
     if (ptr == nullptr || !is_time_type(type))
@@ -147,26 +243,33 @@ em::val time_buffer_to_iso(const char* ptr, std::size_t byte_count, cdf::CDF_Typ
     if (n == 0)
         return em::val::undefined();
 
-    auto arr = em::val::array();
-    for (std::size_t i = 0; i < n; ++i)
+    std::string buffer;
+    std::size_t width = 0;
+    const auto format_all = [&]<typename time_t>(const time_t* values)
     {
-        std::ostringstream ss;
-        switch (type)
-        {
-            case CDF_EPOCH:
-                ss << reinterpret_cast<const cdf::epoch*>(ptr)[i];
-                break;
-            case CDF_EPOCH16:
-                ss << reinterpret_cast<const cdf::epoch16*>(ptr)[i];
-                break;
-            case CDF_TIME_TT2000:
-                ss << reinterpret_cast<const cdf::tt2000_t*>(ptr)[i];
-                break;
-            default:
-                return em::val::undefined();
-        }
-        arr.call<void>("push", ss.str());
+        const auto plan = cdf::chrono::time_format::compile<time_t>(format);
+        width = plan.width();
+        buffer.resize(n * width);
+        cdf::chrono::time_format::format(
+            std::span<const time_t> { values, n }, buffer.data(), plan);
+    };
+    switch (type)
+    {
+        case CDF_EPOCH:
+            format_all(reinterpret_cast<const cdf::epoch*>(ptr));
+            break;
+        case CDF_EPOCH16:
+            format_all(reinterpret_cast<const cdf::epoch16*>(ptr));
+            break;
+        case CDF_TIME_TT2000:
+            format_all(reinterpret_cast<const cdf::tt2000_t*>(ptr));
+            break;
+        default:
+            return em::val::undefined();
     }
+    auto arr = em::val::array();
+    for (std::size_t i = 0; i < n; ++i)
+        arr.call<void>("push", buffer.substr(i * width, width));
     return arr;
 }
 
@@ -184,10 +287,15 @@ em::val data_to_string_or_copy(const cdf::data_t& data)
     if (cdf::is_string(data.type()))
         return em::val(std::string(ptr, data.bytes()));
     if (is_time_type(data.type()))
-        return time_buffer_to_iso(ptr, data.bytes(), data.type());
+        return time_buffer_to_strings(ptr, data.bytes(), data.type());
     return typed_array_view(ptr, data.bytes(), data.type()).call<em::val>("slice");
 }
 
+em::val to_float64_array(const double* values, std::size_t size)
+{
+    return em::val(em::typed_memory_view(size, values)).call<em::val>("slice");
+}
+
 em::val to_js_string_array(const auto& map)
 {
     auto arr = em::val::array();
@@ -196,6 +304,40 @@ em::val to_js_string_array(const auto& map)
     return arr;
 }
 
+// Metadata part of get_variable/get_variable_info: name, type, shape and attributes.
+em::val describe_variable(const cdf::Variable& var)
+{
+    auto obj = em::val::object();
+    obj.set("name", var.name());
+    obj.set("type", static_cast<int>(var.type()));
+    obj.set("type_name", std::string(cdf::cdf_type_str(var.type())));
+    obj.set("is_nrv", var.is_nrv());
+    obj.set("compression", std::string(cdf::cdf_compression_type_str(var.compression_type())));
+    obj.set("values_loaded", var.values_loaded());
+
+    auto& shape = var.shape();
+    auto js_shape = em::val::array();
+    for (std::size_t i = 0; i < std::size(shape); ++i)
+        js_shape.call<void>("push", shape[i]);
+    obj.set("shape", js_shape);
+
+    obj.set("attribute_names", to_js_string_array(var.attributes));
+
+    // Lazily provide attribute getter as a plain object, plus a parallel map
+    // of CDF type codes so callers can tell e.g. a time-typed VALIDMIN
+    // (returned as ISO date strings) from a plain numeric attribute.
+    auto attrs = em::val::object();
+    auto attr_types = em::val::object();
+    for (const auto& [aname, attr] : var.attributes)
+    {
+        attrs.set(aname, data_to_string_or_copy(attr.value()));
+        attr_types.set(aname, static_cast<int>(attr.value().type()));
+    }
+    obj.set("attributes", attrs);
+    obj.set("attribute_types", attr_types);
+    return obj;
+}
+
 } // namespace
 
 
@@ -219,6 +361,18 @@ struct CdfFile
         return to_js_string_array(cdf->attributes);
     }
 
+    // Variable metadata only: values aren't touched so lazily loaded values stay on the
+    // file, listing the variables of a huge file this way only costs its descriptor records.
+    em::val get_variable_info(const std::string& name) const
+    {
+        if (!cdf)
+            return em::val::undefined();
+        auto it = cdf->variables.find(name);
+        if (it == cdf->variables.end())
+            return em::val::undefined();
+        return describe_variable(it->second);
+    }
+
     em::val get_variable(const std::string& name)
     {
         if (!cdf)
@@ -228,34 +382,7 @@ struct CdfFile
             return em::val::undefined();
 
         auto& var = it->second;
-        auto obj = em::val::object();
-        obj.set("name", var.name());
-        obj.set("type", static_cast<int>(var.type()));
-        obj.set("type_name", std::string(cdf::cdf_type_str(var.type())));
-        obj.set("is_nrv", var.is_nrv());
-        obj.set("compression", std::string(cdf::cdf_compression_type_str(var.compression_type())));
-        obj.set("values_loaded", var.values_loaded());
-
-        auto& shape = var.shape();
-        auto js_shape = em::val::array();
-        for (std::size_t i = 0; i < std::size(shape); ++i)
-            js_shape.call<void>("push", shape[i]);
-        obj.set("shape", js_shape);
-
-        obj.set("attribute_names", to_js_string_array(var.attributes));
-
-        // Lazily provide attribute getter as a plain object, plus a parallel map
-        // of CDF type codes so callers can tell e.g. a time-typed VALIDMIN
-        // (returned as ISO date strings) from a plain numeric attribute.
-        auto attrs = em::val::object();
-        auto attr_types = em::val::object();
-        for (const auto& [aname, attr] : var.attributes)
-        {
-            attrs.set(aname, data_to_string_or_copy(attr.value()));
-            attr_types.set(aname, static_cast<int>(attr.value().type()));
-        }
-        obj.set("attributes", attrs);
-        obj.set("attribute_types", attr_types);
+        auto obj = describe_variable(var);
 
         // values: zero-copy typed array view into WASM memory
         var.load_values();
@@ -296,6 +423,194 @@ struct CdfFile
         return time_buffer_to_ns(var.bytes_ptr(), var.bytes(), var.type());
     }
 
+    // Time variable values formatted with a strftime like format (%Y %m %d %j %H %M %S
+    // and %%, %S includes sub-seconds), see cdf-time-format.hpp. Returns undefined for
+    // non-time variables or unsupported formats.
+    em::val time_values_as_strings(const std::string& name, const std::string& format)
+    {
+        if (!cdf)
+            return em::val::undefined();
+        auto it = cdf->variables.find(name);
+        if (it == cdf->variables.end())
+            return em::val::undefined();
+
+        auto& var = it->second;
+        if (!is_time_type(var.type()))
+            return em::val::undefined();
+
+        var.load_values();
+        try
+        {
+            return time_buffer_to_strings(var.bytes_ptr(), var.bytes(), var.type(), format);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            em::val::global("console").call<void>("error",
+                std::string("CDFpp time format error: ") + e.what());
+        }
+        return em::val::undefined();
+    }
+
+    // Min/max decimation of a numeric variable against its DEPEND_0 (see cdf-decimation.hpp):
+    // [start_ms, stop_ms) (ms since 1970 UTC, the whole time axis when NaN) is split in
+    // `buckets` buckets reduced to their min, max, first and last values per component,
+    // FILLVAL and NaN skipped. Returns { components, edges (ms), min, max, first, last } as
+    // owned Float64Arrays ([bucket][component]), or undefined if the variable can't be reduced.
+    em::val minmax_range(const std::string& name, unsigned buckets, double start_ms,
+        double stop_ms)
+    {
+        if (!cdf)
+            return em::val::undefined();
+        auto it = cdf->variables.find(name);
+        if (it == cdf->variables.end())
+            return em::val::undefined();
+        auto dep = it->second.attributes.find("DEPEND_0");
+        if (dep == it->second.attributes.cend() || !cdf::is_string(dep->second.type()))
+            return em::val::undefined();
+        const auto& depend_0 = dep->second.get<char>();
+        auto time = cdf->variables.find(std::string(std::cbegin(depend_0), std::cend(depend_0)));
+        if (time == cdf->variables.end())
+            return em::val::undefined();
+        try
+        {
+            auto [start, stop] = cdf::decimation::time_span(time->second);
+            if (!std::isnan(start_ms))
+                start = std::llround(start_ms * 1e6);
+            if (!std::isnan(stop_ms))
+                stop = std::llround(stop_ms * 1e6);
+            const auto result
+                = cdf::decimation::minmax(it->second, time->second, buckets, start, stop);
+            const auto edges_ns = cdf::decimation::uniform_edges(start, stop, buckets);
+            auto obj = em::val::object();
+            obj.set("components", js_size(result.components));
+            obj.set("edges",
+                to_js_array<double>("Float64Array", std::size(edges_ns),
+                    [&edges_ns](std::size_t first, std::size_t count, double* out)
+                    {
+                        std::transform(std::cbegin(edges_ns) + first,
+                            std::cbegin(edges_ns) + first + count, out,
+                            [](int64_t ns) { return static_cast<double>(ns) / 1e6; });
+                    }));
+            obj.set("min", to_float64_array(result.min.data(), std::size(result.min)));
+            obj.set("max", to_float64_array(result.max.data(), std::size(result.max)));
+            obj.set("first", to_float64_array(result.first.data(), std::size(result.first)));
+            obj.set("last", to_float64_array(result.last.data(), std::size(result.last)));
+            return obj;
+        }
+        catch (const std::invalid_argument& e)
+        {
+            em::val::global("console").call<void>("error",
+                std::string("CDFpp minmax error: ") + e.what());
+        }
+        return em::val::undefined();
+    }
+
+    em::val minmax(const std::string& name, unsigned buckets)
+    {
+        return minmax_range(name, buckets, std::nan(""), std::nan(""));
+    }
+
+    // Spectrogram image of a 2-D variable against its DEPEND_0 and DEPEND_1 (see
+    // cdf-spectrogram.hpp), so that plots blit one image instead of drawing every cell.
+    // `options`: width and height in pixels, then optional (missing or NaN is automatic)
+    // start and stop (ms since 1970 UTC), yMin, yMax, zMin, zMax, and yScale/zScale ("log" or
+    // "linear", from DEPEND_1 and the variable SCALETYP, else linear and log). Returns
+    // { width, height, start, stop, yMin, yMax, yScale, zMin, zMax, zScale, rgba } with rgba an
+    // owned Uint8ClampedArray in ImageData layout, or undefined if it can't be drawn.
+    em::val spectrogram(const std::string& name, em::val options)
+    {
+        using cdf::spectrogram::scale_t;
+        if (!cdf)
+            return em::val::undefined();
+        auto it = cdf->variables.find(name);
+        if (it == cdf->variables.end())
+            return em::val::undefined();
+        const auto depend = [this, &var = it->second](const char* attribute) -> cdf::Variable*
+        {
+            auto dep = var.attributes.find(attribute);
+            if (dep == var.attributes.cend() || !cdf::is_string(dep->second.type()))
+                return nullptr;
+            const auto& dep_name = dep->second.get<char>();
+            auto found
+                = cdf->variables.find(std::string(std::cbegin(dep_name), std::cend(dep_name)));
+            return found == cdf->variables.end() ? nullptr : &found->second;
+        };
+        const auto number = [&options](const char* key) -> std::optional<double>
+        {
+            const auto value = options[key];
+            if (!value.isNumber() || std::isnan(value.as<double>()))
+                return std::nullopt;
+            return value.as<double>();
+        };
+        const auto scale = [&options](const char* key, scale_t fallback)
+        {
+            const auto value = options[key];
+            if (!value.isString())
+                return fallback;
+            const auto text = value.as<std::string>();
+            return text == "log" ? scale_t::log : text == "linear" ? scale_t::linear : fallback;
+        };
+        const auto to_ns = [](std::optional<double> ms) -> std::optional<int64_t>
+        {
+            if (!ms)
+                return std::nullopt;
+            return std::llround(*ms * 1e6);
+        };
+        // negative or NaN sizes from JS become 0, which rasterize rejects like a missing one
+        const auto pixels = [&number](const char* key) -> std::size_t
+        {
+            const auto value = number(key).value_or(0.);
+            return value > 0. ? static_cast<std::size_t>(value) : 0;
+        };
+        const auto scale_name
+            = [](scale_t s) { return std::string(s == scale_t::log ? "log" : "linear"); };
+
+        auto* time = depend("DEPEND_0");
+        if (time == nullptr)
+            return em::val::undefined();
+        auto* bins = depend("DEPEND_1");
+        try
+        {
+            cdf::spectrogram::settings_t settings;
+            settings.width = pixels("width");
+            settings.height = pixels("height");
+            settings.start = to_ns(number("start"));
+            settings.stop = to_ns(number("stop"));
+            settings.y_min = number("yMin");
+            settings.y_max = number("yMax");
+            settings.z_min = number("zMin");
+            settings.z_max = number("zMax");
+            settings.y_scale = scale("yScale",
+                bins ? cdf::spectrogram::scale_type(*bins, scale_t::linear) : scale_t::linear);
+            settings.z_scale
+                = scale("zScale", cdf::spectrogram::scale_type(it->second, scale_t::log));
+            const auto image
+                = cdf::spectrogram::rasterize(it->second, *time, bins, settings);
+            auto obj = em::val::object();
+            obj.set("width", js_size(image.width));
+            obj.set("height", js_size(image.height));
+            obj.set("start", static_cast<double>(image.start) / 1e6);
+            obj.set("stop", static_cast<double>(image.stop) / 1e6);
+            obj.set("yMin", image.y_min);
+            obj.set("yMax", image.y_max);
+            obj.set("yScale", scale_name(image.y_scale));
+            obj.set("zMin", image.z_min);
+            obj.set("zMax", image.z_max);
+            obj.set("zScale", scale_name(image.z_scale));
+            obj.set("rgba",
+                to_js_array<uint8_t>("Uint8ClampedArray", std::size(image.rgba),
+                    [&image](std::size_t first, std::size_t count, uint8_t* out)
+                    { std::copy_n(image.rgba.data() + first, count, out); }));
+            return obj;
+        }
+        catch (const std::invalid_argument& e)
+        {
+            em::val::global("console").call<void>("error",
+                std::string("CDFpp spectrogram error: ") + e.what());
+        }
+        return em::val::undefined();
+    }
+
     em::val get_attribute(const std::string& name) const
     {
         if (!cdf)
@@ -337,13 +652,17 @@ struct CdfFile
     {
         if (!cdf)
             return em::val::undefined();
-        auto data = cdf::io::save(*cdf);
-        if (std::size(data) == 0)
+        // written straight into the returned Uint8Array, no intermediate copy of the file
+        auto bytes = em::val::undefined();
+        const bool saved = cdf::io::save(*cdf,
+            [&bytes](std::size_t size)
+            {
+                bytes = em::val::global("Uint8Array").new_(js_size(size));
+                return js_array_writer { bytes };
+            });
+        if (!saved || js_length(bytes) == 0)
             return em::val::undefined();
-        // Create an owned Uint8Array copy (the local vector dies after return)
-        return em::val(em::typed_memory_view(std::size(data),
-            reinterpret_cast<const uint8_t*>(data.data())))
-            .call<em::val>("slice");
+        return bytes;
     }
 };
 
@@ -352,7 +671,7 @@ CdfFile load_cdf(em::val js_array)
     CdfFile result;
     try
     {
-        auto length = js_array["length"].as<std::size_t>();
+        auto length = js_length(js_array);
         std::vector<char> buffer(length);
         em::val dest(em::typed_memory_view(length, reinterpret_cast<uint8_t*>(buffer.data())));
         dest.call<void>("set", js_array);
@@ -371,6 +690,43 @@ CdfFile load_cdf(em::val js_array)
     return result;
 }
 
+// Opens a file without copying it into WASM memory: read(offset, length) must return a
+// Uint8Array holding exactly those bytes (a File/Blob slice read with FileReaderSync in a
+// worker for instance). Only descriptor records are read here, variable values are fetched
+// through read on first access and the returned CdfFile keeps read alive until deleted.
+CdfFile load_cdf_reader(double size, em::val read)
+{
+    CdfFile result;
+    try
+    {
+        if (not(size >= 0.) or size > static_cast<double>(std::numeric_limits<std::size_t>::max()))
+            throw std::invalid_argument { "file is too large for this build" };
+        result.cdf = cdf::io::load(
+            [read](char* dest, std::size_t offset, std::size_t length)
+            {
+                auto bytes = read(js_size(offset), js_size(length));
+                if (bytes.isUndefined() or bytes.isNull() or js_length(bytes) != length)
+                    return false;
+                // the view is taken after the call since read may have grown the heap
+                em::val(em::typed_memory_view(length, reinterpret_cast<uint8_t*>(dest)))
+                    .call<void>("set", bytes);
+                return true;
+            },
+            static_cast<std::size_t>(size), true, true);
+    }
+    catch (const std::exception& e)
+    {
+        em::val::global("console").call<void>("error",
+            std::string("CDFpp load error: ") + e.what());
+    }
+    catch (...)
+    {
+        em::val::global("console").call<void>("error",
+            std::string("CDFpp load error: unknown exception"));
+    }
+    return result;
+}
+
 
 EMSCRIPTEN_BINDINGS(cdfpp)
 {
@@ -410,14 +766,29 @@ EMSCRIPTEN_BINDINGS(cdfpp)
         .function("variable_names", &CdfFile::variable_names)
         .function("attribute_names", &CdfFile::attribute_names)
         .function("get_variable", &CdfFile::get_variable)
+        .function("get_variable_info", &CdfFile::get_variable_info)
         .function("time_values_as_ns_since_1970", &CdfFile::time_values_as_ns_since_1970)
+        .function("time_values_as_strings", &CdfFile::time_values_as_strings)
+        .function("minmax", &CdfFile::minmax)
+        .function("minmax_range", &CdfFile::minmax_range)
+        .function("spectrogram", &CdfFile::spectrogram)
         .function("get_attribute", &CdfFile::get_attribute)
         .function("majority", &CdfFile::majority)
         .function("compression", &CdfFile::compression)
         .function("save", &CdfFile::save_to_bytes);
 
     em::function("load", &load_cdf);
+    em::function("load_reader", &load_cdf_reader);
+    // Only the pthreads module (cdfpp-threads.js) ever uses more than one thread.
+    // counts are unsigned rather than size_t so that they stay plain numbers with Memory64
+    em::function("num_threads",
+        +[]() { return static_cast<unsigned>(cdf::parallel::num_threads()); });
+    em::function("set_num_threads",
+        +[](unsigned threads) { cdf::parallel::set_num_threads(threads); });
+    em::function("set_min_chunk_size",
+        +[](unsigned elements) { cdf::parallel::set_min_chunk_size(elements); });
     em::function("type_name",
         +[](cdf::CDF_Types type) { return std::string(cdf::cdf_type_str(type)); });
-    em::function("type_size", &cdf::cdf_type_size);
+    em::function("type_size",
+        +[](cdf::CDF_Types type) { return static_cast<unsigned>(cdf::cdf_type_size(type)); });
 }
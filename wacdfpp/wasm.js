@@ -1,8 +1,76 @@
 // Single shared WASM module instance for all views (explorer + compare).
-import createCdfModule from "./cdfpp.js";
+// cdfpp-simd128.js is the same module built with -msimd128 (vectorized time conversions,
+// byte swapping, decompression and decimation). Engines without SIMD128 can't even
+// validate it, so they get the scalar cdfpp.js, as do builds without the SIMD variant.
+// cdfpp-threads.js (-Dwith_wasm_threads) also runs the library thread pool on web workers,
+// it needs SharedArrayBuffer, so only cross-origin isolated pages (COOP/COEP) get it.
+// cdfpp-memory64.js (cross file wasm64.txt) has a 64-bit heap, only files opened in
+// cdf-worker.js that the other modules can't address use it (loadLargeFileModule): 64-bit
+// bounds checks make it slower otherwise.
+
+// (module (func (result v128) i32.const 0 i8x16.splat i8x16.popcnt))
+const SIMD128_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0,
+    253, 15, 253, 98, 11,
+]);
+
+// (module (memory i64 1))
+const MEMORY64_PROBE = new Uint8Array([0, 97, 115, 109, 1, 0, 0, 0, 5, 3, 1, 4, 1]);
+
+export function simd128Supported() {
+    try { return WebAssembly.validate(SIMD128_PROBE); }
+    catch { return false; }
+}
+
+export function memory64Supported() {
+    try { return WebAssembly.validate(MEMORY64_PROBE); }
+    catch { return false; }
+}
+
+export function threadsSupported() {
+    return globalThis.crossOriginIsolated === true && typeof SharedArrayBuffer === "function";
+}
+
+// Most capable first, each one falls back to the next when it isn't built or can't run here.
+function candidates() {
+    const urls = [];
+    if (threadsSupported()) urls.push("./cdfpp-threads.js");
+    if (simd128Supported()) urls.push("./cdfpp-simd128.js");
+    return urls;
+}
+
+async function instantiate() {
+    for (const url of candidates()) {
+        try {
+            const { default: createCdfModule } = await import(url);
+            return await createCdfModule();
+        } catch { /* not built or not supported, try the next one */ }
+    }
+    const { default: createCdfModule } = await import("./cdfpp.js");
+    return createCdfModule();
+}
 
 let modulePromise;
 export function loadModule() {
-    if (!modulePromise) modulePromise = createCdfModule();
+    if (!modulePromise) modulePromise = instantiate();
     return modulePromise;
 }
+
+// largest file size_t can hold in the 32-bit modules, load_reader refuses anything bigger
+export const WASM32_MAX_FILE_SIZE = 2 ** 32 - 1;
+
+let largeFileModulePromise;
+export function loadLargeFileModule() {
+    if (!largeFileModulePromise) {
+        largeFileModulePromise = (async () => {
+            if (memory64Supported()) {
+                try {
+                    const { default: createCdfModule } = await import("./cdfpp-memory64.js");
+                    return await createCdfModule();
+                } catch { /* not built, fall back to the 32-bit module */ }
+            }
+            return loadModule();
+        })();
+    }
+    return largeFileModulePromise;
+}